@@ -0,0 +1,238 @@
+#include <benchmark/benchmark.h>
+
+#include <components/detournavigator/navmeshdb.hpp>
+#include <components/misc/compression.hpp>
+#include <components/sqlite3/db.hpp>
+#include <components/sqlite3/request.hpp>
+#include <components/sqlite3/statement.hpp>
+#include <components/sqlite3/transaction.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    using namespace DetourNavigator;
+
+    constexpr std::string_view worldspace = "sys::default";
+
+    // Tiles table of the schema before tiles were looked up by input hash. Tiles are keyed by the whole compressed
+    // input.
+    constexpr const char schemaBeforeMigration[] = R"(
+        CREATE TABLE tiles (
+            tile_id INTEGER PRIMARY KEY,
+            revision INTEGER NOT NULL DEFAULT 1,
+            worldspace TEXT NOT NULL,
+            tile_position_x INTEGER NOT NULL,
+            tile_position_y INTEGER NOT NULL,
+            version INTEGER NOT NULL,
+            input BLOB,
+            data BLOB
+        );
+
+        CREATE UNIQUE INDEX index_unique_tiles_by_worldspace_and_tile_position_and_input
+            ON tiles (worldspace, tile_position_x, tile_position_y, input);
+
+        CREATE INDEX index_tiles_by_worldspace_and_tile_position
+            ON tiles (worldspace, tile_position_x, tile_position_y);
+    )";
+
+    struct InsertTileBeforeMigration
+    {
+        static std::string_view text() noexcept
+        {
+            return R"(
+                INSERT INTO tiles ( tile_id,  worldspace,  version,  tile_position_x,  tile_position_y,  input,  data)
+                       VALUES     (:tile_id, :worldspace, :version, :tile_position_x, :tile_position_y, :input, :data)
+            )";
+        }
+
+        static void bind(sqlite3& db, sqlite3_stmt& statement, std::int64_t tileId, std::string_view worldspace,
+            const TilePosition& tilePosition, const std::vector<std::byte>& input, const std::vector<std::byte>& data)
+        {
+            Sqlite3::bindParameter(db, statement, ":tile_id", tileId);
+            Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
+            Sqlite3::bindParameter(db, statement, ":version", std::int64_t {1});
+            Sqlite3::bindParameter(db, statement, ":tile_position_x", tilePosition.x());
+            Sqlite3::bindParameter(db, statement, ":tile_position_y", tilePosition.y());
+            Sqlite3::bindParameter(db, statement, ":input", input);
+            Sqlite3::bindParameter(db, statement, ":data", data);
+        }
+    };
+
+    struct GetTileDataBeforeMigration
+    {
+        static std::string_view text() noexcept
+        {
+            return R"(
+                SELECT tile_id, version, data
+                  FROM tiles
+                 WHERE worldspace = :worldspace
+                   AND tile_position_x = :tile_position_x
+                   AND tile_position_y = :tile_position_y
+                   AND input = :input
+            )";
+        }
+
+        static void bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+            const TilePosition& tilePosition, const std::vector<std::byte>& input)
+        {
+            Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
+            Sqlite3::bindParameter(db, statement, ":tile_position_x", tilePosition.x());
+            Sqlite3::bindParameter(db, statement, ":tile_position_y", tilePosition.y());
+            Sqlite3::bindParameter(db, statement, ":input", input);
+        }
+    };
+
+    struct Tile
+    {
+        TilePosition mTilePosition;
+        std::vector<std::byte> mInput;
+    };
+
+    template <typename Random>
+    std::vector<std::byte> generateBytes(std::size_t size, Random& random)
+    {
+        std::uniform_int_distribution<int> distribution(0, 255);
+        std::vector<std::byte> result(size);
+        std::generate(result.begin(), result.end(), [&] { return static_cast<std::byte>(distribution(random)); });
+        return result;
+    }
+
+    // Tiles are placed in a square around the origin as for a worldspace processed by navmeshtool
+    template <typename Random, typename Insert>
+    std::vector<Tile> generateTiles(std::size_t tilesCount, std::size_t inputSize, Random& random, Insert&& insert)
+    {
+        const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(tilesCount))));
+        const std::vector<std::byte> data = generateBytes(4096, random);
+        std::vector<Tile> result;
+        result.reserve(tilesCount);
+        for (std::size_t i = 0; i < tilesCount; ++i)
+        {
+            const int index = static_cast<int>(i);
+            const TilePosition tilePosition(index % side - side / 2, index / side - side / 2);
+            std::vector<std::byte> input = generateBytes(inputSize, random);
+            insert(static_cast<std::int64_t>(i + 1), tilePosition, input, data);
+            result.push_back(Tile {tilePosition, std::move(input)});
+        }
+        return result;
+    }
+
+    std::filesystem::path makeDbPath()
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path()
+            / "openmw_detournavigator_navmeshdb_benchmark.db";
+        std::filesystem::remove(path);
+        return path;
+    }
+
+    void reportDb(benchmark::State& state, std::size_t found, const std::filesystem::path& path)
+    {
+        state.counters["Found"] = benchmark::Counter(static_cast<double>(found), benchmark::Counter::kAvgIterations);
+        state.counters["DbSize"] = benchmark::Counter(static_cast<double>(std::filesystem::file_size(path)),
+            benchmark::Counter::kDefaults, benchmark::Counter::OneK::kIs1024);
+        std::filesystem::remove(path);
+    }
+
+    // Reads tiles the way DbWorker did for each job before the migration: the input is compressed for every lookup
+    // and compared with the stored blob
+    void getTileDataBeforeMigration(benchmark::State& state)
+    {
+        const std::size_t tilesCount = static_cast<std::size_t>(state.range(0));
+        const std::size_t inputSize = static_cast<std::size_t>(state.range(1));
+        const std::filesystem::path path = makeDbPath();
+        std::minstd_rand random;
+        std::size_t found = 0;
+
+        {
+            const Sqlite3::Db db = Sqlite3::makeDb(path.string(), schemaBeforeMigration);
+            Sqlite3::Statement<InsertTileBeforeMigration> insertTile(*db);
+            Sqlite3::Statement<GetTileDataBeforeMigration> getTileData(*db);
+
+            Sqlite3::Transaction transaction(*db);
+            const std::vector<Tile> tiles = generateTiles(tilesCount, inputSize, random,
+                [&] (std::int64_t tileId, const TilePosition& tilePosition, const std::vector<std::byte>& input,
+                     const std::vector<std::byte>& data)
+                {
+                    Sqlite3::execute(*db, insertTile, tileId, worldspace, tilePosition, Misc::compress(input),
+                                     Misc::compress(data));
+                });
+            transaction.commit();
+
+            std::uniform_int_distribution<std::size_t> distribution(0, tiles.size() - 1);
+
+            for (auto _ : state)
+            {
+                const Tile& tile = tiles[distribution(random)];
+                std::tuple<std::int64_t, std::int64_t, std::vector<std::byte>> row;
+                const std::vector<std::byte> compressedInput = Misc::compress(tile.mInput);
+                if (&row != Sqlite3::request(*db, getTileData, &row, 1, worldspace, tile.mTilePosition, compressedInput))
+                {
+                    std::get<2>(row) = Misc::decompress(std::get<2>(row));
+                    ++found;
+                }
+                benchmark::DoNotOptimize(row);
+            }
+        }
+
+        reportDb(state, found, path);
+    }
+
+    // Reads tiles the same way as DbWorker does for each job, including input hashing
+    void getTileData(benchmark::State& state)
+    {
+        const std::size_t tilesCount = static_cast<std::size_t>(state.range(0));
+        const std::size_t inputSize = static_cast<std::size_t>(state.range(1));
+        const std::filesystem::path path = makeDbPath();
+        std::minstd_rand random;
+        std::size_t found = 0;
+
+        {
+            NavMeshDb db(path.string(), std::numeric_limits<std::uint64_t>::max());
+            auto transaction = db.startTransaction();
+            const std::vector<Tile> tiles = generateTiles(tilesCount, inputSize, random,
+                [&] (std::int64_t tileId, const TilePosition& tilePosition, const std::vector<std::byte>& input,
+                     const std::vector<std::byte>& data)
+                {
+                    db.insertTile(TileId {tileId}, worldspace, tilePosition, TileVersion {1},
+                                  makeTileInputHash(input), input, data);
+                });
+            transaction.commit();
+
+            const std::vector<std::byte> noInput;
+            std::uniform_int_distribution<std::size_t> distribution(0, tiles.size() - 1);
+
+            for (auto _ : state)
+            {
+                const Tile& tile = tiles[distribution(random)];
+                const std::optional<TileData> result = db.getTileData(worldspace, tile.mTilePosition,
+                    makeTileInputHash(tile.mInput), noInput);
+                found += static_cast<std::size_t>(result.has_value());
+                benchmark::DoNotOptimize(result);
+            }
+        }
+
+        reportDb(state, found, path);
+    }
+}
+
+// Arguments are tiles count and input size
+BENCHMARK(getTileDataBeforeMigration)
+    ->Args({1000, 4096})
+    ->Args({10000, 4096})
+    ->Args({1000, 65536});
+
+BENCHMARK(getTileData)
+    ->Args({1000, 4096})
+    ->Args({10000, 4096})
+    ->Args({1000, 65536});
+
+BENCHMARK_MAIN();
@@ -4,6 +4,7 @@
 #include <components/esm3/loadland.hpp>
 
 #include <algorithm>
+#include <memory>
 #include <random>
 
 namespace
@@ -272,6 +273,62 @@ namespace
     {
         setToBoundedNonEmptyCache<64 * 1024 * 1024>(state);
     }
+
+    struct SharedCache
+    {
+        std::unique_ptr<NavMeshTilesCache> mCache;
+        std::vector<Key> mKeys;
+    };
+
+    // Threads share one cache and get or set tiles as AsyncNavMeshUpdater workers do, first argument is shards count
+    template <std::size_t maxCacheSize, int hitPercentage>
+    void getOrSetConcurrently(benchmark::State& state)
+    {
+        static SharedCache shared;
+        static NavMeshTilesCache::Stats initialStats;
+
+        if (state.thread_index == 0)
+        {
+            shared.mCache = std::make_unique<NavMeshTilesCache>(maxCacheSize, static_cast<std::size_t>(state.range(0)));
+            shared.mKeys.clear();
+            std::minstd_rand random;
+            fillCache(std::back_inserter(shared.mKeys), random, *shared.mCache);
+            generateKeys(std::back_inserter(shared.mKeys), shared.mKeys.size() * (100 - hitPercentage) / 100, random);
+            initialStats = shared.mCache->getStats();
+        }
+
+        std::minstd_rand random(static_cast<std::minstd_rand::result_type>(state.thread_index + 1));
+        std::uniform_int_distribution<std::size_t> distribution;
+
+        for (auto _ : state)
+        {
+            const auto& key = shared.mKeys[distribution(random, decltype(distribution)::param_type(0, shared.mKeys.size() - 1))];
+            auto result = shared.mCache->get(key.mAgentBounds, key.mTilePosition, key.mRecastMesh);
+            if (!result)
+                result = shared.mCache->set(key.mAgentBounds, key.mTilePosition, key.mRecastMesh,
+                                            std::make_unique<PreparedNavMeshData>());
+            benchmark::DoNotOptimize(result);
+        }
+
+        if (state.thread_index == 0)
+        {
+            const NavMeshTilesCache::Stats stats = shared.mCache->getStats();
+            state.counters["HitRate"] = static_cast<double>(stats.mHitCount - initialStats.mHitCount)
+                / static_cast<double>(stats.mGetCount - initialStats.mGetCount);
+            shared.mCache.reset();
+            shared.mKeys.clear();
+        }
+    }
+
+    void getOrSetConcurrently_16m_70hit(benchmark::State& state)
+    {
+        getOrSetConcurrently<16 * 1024 * 1024, 70>(state);
+    }
+
+    void getOrSetConcurrently_16m_100hit(benchmark::State& state)
+    {
+        getOrSetConcurrently<16 * 1024 * 1024, 100>(state);
+    }
 } // namespace
 
 BENCHMARK(getFromFilledCache_1m_100hit);
@@ -286,5 +343,7 @@ BENCHMARK(setToBoundedNonEmptyCache_1m);
 BENCHMARK(setToBoundedNonEmptyCache_4m);
 BENCHMARK(setToBoundedNonEmptyCache_16m);
 BENCHMARK(setToBoundedNonEmptyCache_64m);
+BENCHMARK(getOrSetConcurrently_16m_70hit)->Arg(1)->Arg(8)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(getOrSetConcurrently_16m_100hit)->Arg(1)->Arg(8)->ThreadRange(1, 8)->UseRealTime();
 
 BENCHMARK_MAIN();
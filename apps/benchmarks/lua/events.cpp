@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include <components/debug/debuglog.hpp>
+#include <components/esm/luascripts.hpp>
+#include <components/lua/configuration.hpp>
+#include <components/lua/luastate.hpp>
+#include <components/lua/scriptscontainer.hpp>
+#include <components/lua/serialization.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <osg/Vec3f>
+
+#include "../../openmw_test_suite/testing_util.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace
+{
+    TestingOpenMW::VFSTestFile handlerScript(R"X(
+local received = 0
+return {
+    eventHandlers = {
+        Ping = function(data) received = received + 1 end,
+    },
+}
+)X");
+
+    struct Scripts
+    {
+        std::unique_ptr<VFS::Manager> mVFS;
+        LuaUtil::ScriptsConfiguration mCfg;
+        LuaUtil::LuaState mLua;
+        LuaUtil::ScriptsContainer mContainer;
+
+        Scripts()
+            : mVFS(TestingOpenMW::createTestVFS({{"handler.lua", &handlerScript}}))
+            , mLua(mVFS.get(), &mCfg)
+            , mContainer(&mLua, "Benchmark")
+        {
+            ESM::LuaScriptsCfg cfg;
+            LuaUtil::parseOMWScripts(cfg, "CUSTOM: handler.lua");
+            mCfg.init(std::move(cfg));
+            mContainer.addCustomScript(*mCfg.findId("handler.lua"));
+        }
+    };
+
+    // 0 - nil, 1 - number, 2 - flat table, 3 - nested table with vectors
+    sol::object makeEventData(sol::state_view& lua, std::int64_t kind)
+    {
+        switch (kind)
+        {
+            case 0:
+                return sol::nil;
+            case 1:
+                return sol::make_object(lua, 42.0);
+            case 2:
+            {
+                sol::table table(lua, sol::create);
+                for (int i = 0; i < 16; ++i)
+                    table["field" + std::to_string(i)] = i;
+                return table;
+            }
+            default:
+            {
+                sol::table table(lua, sol::create);
+                for (int i = 0; i < 16; ++i)
+                    table[i + 1] = lua.create_table_with("id", "object" + std::to_string(i),
+                                                         "position", osg::Vec3f(i, i, i), "active", i % 2 == 0);
+                return table;
+            }
+        }
+    }
+
+    void receiveSerializedEvent(benchmark::State& state)
+    {
+        Debug::CurrentDebugLevel = Debug::Error;
+        Scripts scripts;
+        const sol::object data = makeEventData(scripts.mLua.sol(), state.range(0));
+
+        for (auto _ : state)
+            scripts.mContainer.receiveEvent("Ping", LuaUtil::serialize(data));
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void receiveCopiedEvent(benchmark::State& state)
+    {
+        Debug::CurrentDebugLevel = Debug::Error;
+        Scripts scripts;
+        const sol::object data = makeEventData(scripts.mLua.sol(), state.range(0));
+
+        for (auto _ : state)
+            scripts.mContainer.receiveEvent("Ping", LuaUtil::copy(scripts.mLua.sol(), data));
+
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+BENCHMARK(receiveSerializedEvent)->DenseRange(0, 3);
+BENCHMARK(receiveCopiedEvent)->DenseRange(0, 3);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,256 @@
+#include <benchmark/benchmark.h>
+
+#include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
+#include <components/esm3/loaddial.hpp>
+#include <components/loadinglistener/loadinglistener.hpp>
+#include <components/misc/stringops.hpp>
+
+#include "apps/openmw/mwdialogue/conditionindex.hpp"
+#include "apps/openmw/mwdialogue/knowntopics.hpp"
+#include "apps/openmw/mwmechanics/spelllist.hpp"
+#include "apps/openmw/mwworld/esmstore.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace MWMechanics
+{
+    SpellList::SpellList(const std::string& id, int type) : mId(id), mType(type) {}
+}
+
+namespace
+{
+    using namespace MWDialogue;
+
+    constexpr int topicCount = 1000;
+    constexpr int actorCount = 2000;
+    constexpr int factionCount = 20;
+    constexpr int classCount = 30;
+    constexpr int raceCount = 10;
+
+    template <typename Random>
+    std::string pick(Random& random, const char* prefix, int count)
+    {
+        return std::string(prefix) + std::to_string(std::uniform_int_distribution<int>(0, count - 1)(random));
+    }
+
+    template <typename Random>
+    ESM::DialInfo::SelectStruct generateSelect(Random& random)
+    {
+        static const char* const rules[] = {
+            "01000", "01063", "01244", "02005Global", "03000Local", "04003Journal", "05002Item", "0B000Balmora",
+        };
+        ESM::DialInfo::SelectStruct result;
+        result.mSelectRule = rules[std::uniform_int_distribution<std::size_t>(0, std::size(rules) - 1)(random)];
+        result.mValue.setType(ESM::VT_Int);
+        result.mValue.setInteger(std::uniform_int_distribution<int>(0, 100)(random));
+        return result;
+    }
+
+    /// Infos spread over the speaker requirements roughly like in a large content file set.
+    template <typename Random>
+    ESM::DialInfo generateInfo(Random& random, int id)
+    {
+        ESM::DialInfo result;
+        result.blank();
+        result.mId = std::to_string(id);
+        const int kind = std::uniform_int_distribution<int>(0, 9)(random);
+        if (kind < 3)
+            result.mActor = pick(random, "Actor", actorCount);
+        else if (kind < 5)
+            result.mFaction = pick(random, "Faction", factionCount);
+        else if (kind < 6)
+            result.mClass = pick(random, "Class", classCount);
+        else if (kind < 7)
+            result.mRace = pick(random, "Race", raceCount);
+        const int selects = std::uniform_int_distribution<int>(0, 4)(random);
+        for (int i = 0; i < selects; ++i)
+            result.mSelects.push_back(generateSelect(random));
+        result.mResponse = "Response " + result.mId;
+        return result;
+    }
+
+    /// Write the topics to an in-memory content file the way the construction set does, each DIAL record followed
+    /// by its INFO records linked to the previous one.
+    std::unique_ptr<std::istream> generateContentFile(int infosPerTopic)
+    {
+        std::minstd_rand random;
+        ESM::ESMWriter writer;
+        auto stream = std::make_unique<std::stringstream>();
+        writer.setFormat(0);
+        writer.save(*stream);
+        int id = 0;
+        for (int i = 0; i < topicCount; ++i)
+        {
+            ESM::Dialogue dialogue;
+            dialogue.blank();
+            dialogue.mId = "topic" + std::to_string(i);
+            dialogue.mType = ESM::Dialogue::Topic;
+            writer.startRecord(ESM::Dialogue::sRecordId);
+            dialogue.save(writer);
+            writer.endRecord(ESM::Dialogue::sRecordId);
+            std::string prev;
+            for (int j = 0; j < infosPerTopic; ++j)
+            {
+                ESM::DialInfo info = generateInfo(random, id++);
+                info.mPrev = prev;
+                writer.startRecord(ESM::DialInfo::sRecordId);
+                info.save(writer);
+                writer.endRecord(ESM::DialInfo::sRecordId);
+                prev = info.mId;
+            }
+        }
+        writer.close();
+        return stream;
+    }
+
+    void loadStore(MWWorld::ESMStore& store, int infosPerTopic)
+    {
+        Loading::Listener listener;
+        ESM::ESMReader reader;
+        ESM::Dialogue* dialogue = nullptr;
+        reader.open(generateContentFile(infosPerTopic), "conditionindex.esm");
+        store.load(reader, &listener, dialogue);
+        store.setUp();
+    }
+
+    ConditionIndex::Actor makeActor()
+    {
+        ConditionIndex::Actor result;
+        result.mId = "actor42";
+        result.mRace = "race3";
+        result.mClass = "class7";
+        result.mFaction = "faction5";
+        return result;
+    }
+
+    /// Replaces Filter in DialogueManager::updateActorKnownTopics. Candidates are selected like Filter::list does,
+    /// with a per-call index for an unindexed store, and select rules are evaluated against a fixed value instead of
+    /// the game state.
+    class Context final : public KnownTopicsContext
+    {
+        public:
+
+            Context(const ConditionIndex* index)
+                : mIndex(index)
+                , mActor(makeActor())
+            {}
+
+            const ESM::DialInfo* search(const ESM::Dialogue& dialogue) const override
+            {
+                ConditionIndex unindexed;
+                const ConditionIndex::Topic* topic = mIndex != nullptr ? mIndex->find(dialogue) : nullptr;
+                if (topic == nullptr)
+                    topic = &unindexed.add(dialogue);
+
+                topic->getCandidates(mActor, mCandidates);
+
+                for (const ConditionIndex::Info* candidate : mCandidates)
+                    if (testActor(*candidate->mInfo) && testSelectStructs(*candidate))
+                        return candidate->mInfo;
+
+                return nullptr;
+            }
+
+            bool inJournal(const std::string& /*topicId*/, const std::string& /*infoId*/) const override
+            {
+                return false;
+            }
+
+            std::vector<std::string> parseTopicIds(const std::string& /*text*/) const override
+            {
+                return {};
+            }
+
+        private:
+
+            const ConditionIndex* mIndex;
+            const ConditionIndex::Actor mActor;
+            mutable std::vector<const ConditionIndex::Info*> mCandidates;
+
+            bool testActor(const ESM::DialInfo& info) const
+            {
+                using Misc::StringUtils;
+                if (!info.mActor.empty() && !StringUtils::ciEqual(info.mActor, mActor.mId))
+                    return false;
+                if (!info.mRace.empty() && !StringUtils::ciEqual(info.mRace, mActor.mRace))
+                    return false;
+                if (!info.mClass.empty() && !StringUtils::ciEqual(info.mClass, mActor.mClass))
+                    return false;
+                if (!info.mFaction.empty() && !StringUtils::ciEqual(info.mFaction, mActor.mFaction))
+                    return false;
+                return true;
+            }
+
+            static bool testSelectStructs(const ConditionIndex::Info& info)
+            {
+                for (const SelectWrapper& select : info.mSelects)
+                    if (select.getType() != SelectWrapper::Type_None && !select.selectCompare(50))
+                        return false;
+                return true;
+            }
+    };
+
+    void buildConditionIndex(benchmark::State& state)
+    {
+        MWWorld::ESMStore store;
+        loadStore(store, static_cast<int>(state.range(0)));
+        const MWWorld::Store<ESM::Dialogue>& dialogues = store.get<ESM::Dialogue>();
+
+        for (auto _ : state)
+        {
+            ConditionIndex index;
+            for (const ESM::Dialogue& dialogue : dialogues)
+                index.add(dialogue);
+            benchmark::DoNotOptimize(index);
+        }
+
+        state.SetItemsProcessed(state.iterations() * topicCount * state.range(0));
+    }
+
+    void updateActorKnownTopics(benchmark::State& state, const MWWorld::ESMStore& store, const ConditionIndex* index)
+    {
+        const std::set<std::string, Misc::StringUtils::CiComp> knownTopics;
+        const Context context(index);
+        ActorKnownTopics actorKnownTopics;
+
+        for (auto _ : state)
+        {
+            findActorKnownTopics(store.get<ESM::Dialogue>(), "actor42", knownTopics, context, actorKnownTopics);
+            benchmark::DoNotOptimize(actorKnownTopics);
+        }
+
+        state.counters["Topics"] = static_cast<double>(actorKnownTopics.size());
+    }
+
+    // As DialogueManager did before the condition index, every update scans all infos of each topic
+    void updateActorKnownTopicsUnindexed(benchmark::State& state)
+    {
+        MWWorld::ESMStore store;
+        loadStore(store, static_cast<int>(state.range(0)));
+        updateActorKnownTopics(state, store, nullptr);
+    }
+
+    void updateActorKnownTopicsIndexed(benchmark::State& state)
+    {
+        MWWorld::ESMStore store;
+        loadStore(store, static_cast<int>(state.range(0)));
+        ConditionIndex index;
+        for (const ESM::Dialogue& dialogue : store.get<ESM::Dialogue>())
+            index.add(dialogue);
+        updateActorKnownTopics(state, store, &index);
+    }
+}
+
+// Argument is infos per topic
+BENCHMARK(buildConditionIndex)->Arg(10)->Arg(50);
+BENCHMARK(updateActorKnownTopicsUnindexed)->Arg(10)->Arg(50);
+BENCHMARK(updateActorKnownTopicsIndexed)->Arg(10)->Arg(50);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+
+#include "apps/openmw/mwdialogue/keywordsearch.hpp"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using KeywordSearch = MWDialogue::KeywordSearch<std::string, std::intptr_t>;
+
+    // Written in the style of journal entries and topic responses, with the usual mix of names, places and long
+    // multi-word topics.
+    const std::string journalText =
+        "I have been told to report to Caius Cosades in Balmora. He lives in a small house near the South Wall "
+        "Cornerclub, and I should ask around town if I can't find it. Before leaving Seyda Neen I spoke with "
+        "Fargoth, who asked me to look for his missing ring. The census and excise office gave me a package and a "
+        "letter, and I was told that the Imperial Legion keeps a fort nearby. "
+        "Caius Cosades wants me to gather information about the Nerevarine prophecies, the Sixth House and the "
+        "Ashlanders. He suggested I join the Fighters Guild or the Mages Guild to earn some money, and to speak with "
+        "Hasphat Antabolis at the Fighters Guild in Balmora about the secret Dwemer puzzle box. "
+        "In Vivec I should look for Mehra Milo in the library of the Hall of Wisdom. Sharn gra-Muzgob in the Balmora "
+        "Mages Guild asked for a skull of Llevule Andrano from the Andrano Ancestral Tomb. The Redoran councilors in "
+        "Ald'ruhn say the Ashlanders of the Urshilaku Camp know more about the Nerevarine than any temple priest. "
+        "The Dunmer do not trust outlanders, and the Great Houses Hlaalu, Redoran and Telvanni each have their own "
+        "rules for those who want to join them. Tel Mora, Tel Aruhn and Sadrith Mora belong to House Telvanni, "
+        "while the Dwemer ruins of Arkngthand lie east of Balmora across the Odai River. ";
+
+    const char* const knownTopics[] = {
+        "Caius Cosades", "Balmora", "South Wall Cornerclub", "Seyda Neen", "Fargoth", "census and excise office",
+        "Imperial Legion", "Nerevarine", "Nerevarine prophecies", "Sixth House", "Ashlanders", "Fighters Guild",
+        "Mages Guild", "Hasphat Antabolis", "Dwemer", "Dwemer puzzle box", "Vivec", "Mehra Milo", "Hall of Wisdom",
+        "Sharn gra-Muzgob", "Llevule Andrano", "Andrano Ancestral Tomb", "Redoran", "Ald'ruhn", "Urshilaku Camp",
+        "temple", "Dunmer", "outlanders", "Great Houses", "Hlaalu", "Telvanni", "Tel Mora", "Tel Aruhn",
+        "Sadrith Mora", "House Telvanni", "Arkngthand", "Odai River", "latest rumors", "little advice", "little secret",
+        "my trade", "specific place", "someone in particular", "services", "join the Fighters Guild",
+        "join the Mages Guild", "join House Hlaalu", "join House Redoran", "join House Telvanni",
+    };
+
+    // Pads the topic set to the size of a game with many mods, with topics that share prefixes with the real ones.
+    std::vector<std::string> generateTopics(std::size_t count)
+    {
+        std::vector<std::string> result(std::begin(knownTopics), std::end(knownTopics));
+        std::minstd_rand random;
+        std::uniform_int_distribution<std::size_t> distribution(0, std::size(knownTopics) - 1);
+        for (std::size_t i = 0; result.size() < count; ++i)
+            result.push_back(std::string(knownTopics[distribution(random)]) + " " + std::to_string(i));
+        return result;
+    }
+
+    void seedKeywords(KeywordSearch& search, const std::vector<std::string>& topics)
+    {
+        for (std::size_t i = 0; i < topics.size(); ++i)
+            search.seed(topics[i], static_cast<std::intptr_t>(i));
+    }
+
+    void highlightJournalText(benchmark::State& state)
+    {
+        KeywordSearch search;
+        seedKeywords(search, generateTopics(static_cast<std::size_t>(state.range(0))));
+        std::vector<KeywordSearch::Match> matches;
+
+        for (auto _ : state)
+        {
+            matches.clear();
+            search.highlightKeywords(journalText.begin(), journalText.end(), matches);
+            benchmark::DoNotOptimize(matches);
+        }
+
+        state.SetBytesProcessed(state.iterations() * journalText.size());
+        state.counters["Matches"] = static_cast<double>(matches.size());
+    }
+
+    // Cost paid once each time the topic set changes, e.g. when a dialogue window is opened.
+    void seedAndHighlightJournalText(benchmark::State& state)
+    {
+        const std::vector<std::string> topics = generateTopics(static_cast<std::size_t>(state.range(0)));
+        std::vector<KeywordSearch::Match> matches;
+
+        for (auto _ : state)
+        {
+            KeywordSearch search;
+            seedKeywords(search, topics);
+            matches.clear();
+            search.highlightKeywords(journalText.begin(), journalText.end(), matches);
+            benchmark::DoNotOptimize(matches);
+        }
+    }
+}
+
+BENCHMARK(highlightJournalText)->Arg(50)->Arg(1000)->Arg(10000);
+BENCHMARK(seedAndHighlightJournalText)->Arg(50)->Arg(1000)->Arg(10000);
+
+BENCHMARK_MAIN();
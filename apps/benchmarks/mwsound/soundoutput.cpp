@@ -0,0 +1,471 @@
+#include <benchmark/benchmark.h>
+
+#include <components/debug/debuglog.hpp>
+#include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
+#include <components/esm3/loadcell.hpp>
+#include <components/esm3/loadgmst.hpp>
+#include <components/esm3/loadregn.hpp>
+#include <components/esm3/loadsoun.hpp>
+#include <components/fallback/fallback.hpp>
+#include <components/loadinglistener/loadinglistener.hpp>
+#include <components/settings/settings.hpp>
+#include <components/vfs/archive.hpp>
+#include <components/vfs/manager.hpp>
+
+#include "apps/openmw/mwmechanics/actorutil.hpp"
+#include "apps/openmw/mwmechanics/spelllist.hpp"
+#include "apps/openmw/mwsound/decodedsoundcache.hpp"
+#include "apps/openmw/mwsound/null_output.hpp"
+#include "apps/openmw/mwsound/sound.hpp"
+#include "apps/openmw/mwsound/soundmanagerimp.hpp"
+#include "apps/openmw/mwworld/cellstore.hpp"
+#include "apps/openmw/mwworld/esmstore.hpp"
+#include "apps/openmw/mwworld/ptr.hpp"
+#include "apps/openmw/mwworld/refdata.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The sound manager refers to game objects only for sounds played on them, which the benchmarks don't do
+namespace MWMechanics
+{
+    SpellList::SpellList(const std::string& id, int type) : mId(id), mType(type) {}
+
+    MWWorld::Ptr getPlayer()
+    {
+        return MWWorld::Ptr();
+    }
+}
+
+namespace MWWorld
+{
+    const ESM::Position& RefData::getPosition() const
+    {
+        return mPosition;
+    }
+
+    const ESM::Cell* CellStore::getCell() const
+    {
+        return mCell;
+    }
+
+    bool CellStore::isExterior() const
+    {
+        return mCell->isExterior();
+    }
+
+    float CellStore::getWaterLevel() const
+    {
+        return isExterior() ? -1 : mWaterLevel;
+    }
+}
+
+namespace
+{
+    using namespace MWSound;
+
+    constexpr int sampleRate = 44100;
+    constexpr double frameDuration = 1.0 / 60.0;
+    constexpr double twoPi = 6.283185307179586;
+    constexpr int soundCount = 64;
+    constexpr int musicTrackCount = 4;
+    constexpr const char regionId[] = "bench region";
+    constexpr const char waterSoundId[] = "water layer";
+
+    /// Generates a stereo 16 bit sine wave, to measure the cost of decoding without reading any files.
+    class SineDecoder final : public Sound_Decoder
+    {
+    public:
+        explicit SineDecoder(double duration)
+            : Sound_Decoder(nullptr)
+            , mTotalFrames(static_cast<std::size_t>(duration * sampleRate))
+        {
+        }
+
+        void open(const std::string& /*fname*/) override {}
+
+        void close() override {}
+
+        std::string getName() override { return "sine"; }
+
+        void getInfo(int* samplerate, ChannelConfig* chans, SampleType* type) override
+        {
+            *samplerate = sampleRate;
+            *chans = ChannelConfig_Stereo;
+            *type = SampleType_Int16;
+        }
+
+        size_t read(char* buffer, size_t bytes) override
+        {
+            const std::size_t frames = std::min(bytesToFrames(bytes, ChannelConfig_Stereo, SampleType_Int16),
+                mTotalFrames - mFrame);
+            std::int16_t* const samples = reinterpret_cast<std::int16_t*>(buffer);
+            for (std::size_t i = 0; i < frames; ++i, ++mFrame)
+            {
+                const auto value = static_cast<std::int16_t>(16384 * std::sin(mFrame * 440.0 * twoPi / sampleRate));
+                samples[2 * i] = value;
+                samples[2 * i + 1] = value;
+            }
+            return framesToBytes(frames, ChannelConfig_Stereo, SampleType_Int16);
+        }
+
+        size_t getSampleOffset() override { return mFrame; }
+
+    private:
+        std::size_t mTotalFrames;
+        std::size_t mFrame = 0;
+    };
+
+    DecodedSound makeDecodedSound(double duration)
+    {
+        DecodedSound result;
+        SineDecoder decoder(duration);
+        decoder.getInfo(&result.mSampleRate, &result.mChannelConfig, &result.mSampleType);
+        decoder.readAll(result.mData);
+        return result;
+    }
+
+    template <typename T>
+    void writeLittleEndian(std::string& out, T value)
+    {
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+
+    /// A stereo 16 bit sine wave in a WAV file, for the game's decoder to read from the VFS.
+    std::string makeWavFile(double duration)
+    {
+        DecodedSound sound = makeDecodedSound(duration);
+        std::string result = "RIFF";
+        writeLittleEndian(result, static_cast<std::uint32_t>(36 + sound.mData.size()));
+        result += "WAVEfmt ";
+        writeLittleEndian(result, std::uint32_t {16});
+        writeLittleEndian(result, std::uint16_t {1});
+        writeLittleEndian(result, std::uint16_t {2});
+        writeLittleEndian(result, static_cast<std::uint32_t>(sampleRate));
+        writeLittleEndian(result, static_cast<std::uint32_t>(sampleRate * 4));
+        writeLittleEndian(result, std::uint16_t {4});
+        writeLittleEndian(result, std::uint16_t {16});
+        result += "data";
+        writeLittleEndian(result, static_cast<std::uint32_t>(sound.mData.size()));
+        result.append(sound.mData.begin(), sound.mData.end());
+        return result;
+    }
+
+    class MemoryFile final : public VFS::File
+    {
+    public:
+        explicit MemoryFile(std::string content) : mContent(std::move(content)) {}
+
+        Files::IStreamPtr open() override
+        {
+            return std::make_unique<std::istringstream>(mContent, std::ios_base::in | std::ios_base::binary);
+        }
+
+        std::string getPath() override { return "memory"; }
+
+    private:
+        const std::string mContent;
+    };
+
+    class MemoryArchive final : public VFS::Archive
+    {
+    public:
+        void add(const std::string& name, std::string content)
+        {
+            mFiles.emplace(name, std::make_unique<MemoryFile>(std::move(content)));
+        }
+
+        void listResources(std::map<std::string, VFS::File*>& out, char (*/*normalize_function*/) (char)) override
+        {
+            for (const auto& [name, file] : mFiles)
+                out[name] = file.get();
+        }
+
+        bool contains(const std::string& file, char (*/*normalize_function*/) (char)) const override
+        {
+            return mFiles.count(file) != 0;
+        }
+
+        std::string getDescription() const override { return "memory"; }
+
+    private:
+        std::map<std::string, std::unique_ptr<MemoryFile>> mFiles;
+    };
+
+    std::string getSoundId(int index)
+    {
+        return "bench sound " + std::to_string(index);
+    }
+
+    /// Sound files of a few lengths for the sound records, and the tracks of the Explore playlist.
+    std::unique_ptr<VFS::Manager> makeVfs()
+    {
+        auto archive = std::make_unique<MemoryArchive>();
+        const double durations[] = {0.25, 0.5, 1.0, 2.0};
+        for (int i = 0; i < soundCount; ++i)
+            archive->add("sound/fx/" + std::to_string(i) + ".wav", makeWavFile(durations[i % std::size(durations)]));
+        for (int i = 0; i < musicTrackCount; ++i)
+            archive->add("music/explore/" + std::to_string(i) + ".wav", makeWavFile(5.0));
+        auto vfs = std::make_unique<VFS::Manager>(false);
+        vfs->addArchive(std::move(archive));
+        vfs->buildIndex();
+        return vfs;
+    }
+
+    template <typename T>
+    void writeRecord(ESM::ESMWriter& writer, const T& record)
+    {
+        writer.startRecord(T::sRecordId);
+        record.save(writer);
+        writer.endRecord(T::sRecordId);
+    }
+
+    /// The records the sound manager looks up: audio distance settings, the sounds and a region playing them.
+    std::unique_ptr<std::istream> makeContentFile()
+    {
+        ESM::ESMWriter writer;
+        auto stream = std::make_unique<std::stringstream>();
+        writer.setFormat(0);
+        writer.save(*stream);
+
+        const std::pair<const char*, float> settings[] = {
+            {"fAudioDefaultMinDistance", 5}, {"fAudioDefaultMaxDistance", 4000},
+            {"fAudioMinDistanceMult", 20}, {"fAudioMaxDistanceMult", 1},
+        };
+        for (const auto& [id, value] : settings)
+        {
+            ESM::GameSetting setting;
+            setting.blank();
+            setting.mId = id;
+            setting.mValue.setType(ESM::VT_Float);
+            setting.mValue.setFloat(value);
+            writeRecord(writer, setting);
+        }
+
+        ESM::Region region;
+        region.blank();
+        region.mId = regionId;
+        for (int i = 0; i <= soundCount; ++i)
+        {
+            ESM::Sound sound;
+            sound.blank();
+            sound.mId = i < soundCount ? getSoundId(i) : waterSoundId;
+            sound.mSound = "fx\\" + std::to_string(i % soundCount) + ".wav";
+            sound.mData.mVolume = 255;
+            writeRecord(writer, sound);
+            if (i % 8 == 0)
+                region.mSoundList.push_back(ESM::Region::SoundRef {sound.mId, 10});
+        }
+        writeRecord(writer, region);
+
+        writer.close();
+        return stream;
+    }
+
+    void loadStore(MWWorld::ESMStore& store)
+    {
+        Loading::Listener listener;
+        ESM::ESMReader reader;
+        ESM::Dialogue* dialogue = nullptr;
+        reader.open(makeContentFile(), "soundoutput.esm");
+        store.load(reader, &listener, dialogue);
+        store.setUp();
+    }
+
+    void initSettings()
+    {
+        Debug::CurrentDebugLevel = Debug::Error;
+
+        Settings::Manager::mDefaultSettings = {
+            {{"Sound", "null output"}, "true"},
+            {{"Sound", "device"}, ""},
+            {{"Sound", "hrtf"}, ""},
+            {{"Sound", "hrtf enable"}, "0"},
+            {{"Sound", "decoded cache max"}, "32"},
+            {{"Sound", "buffer cache min"}, "56"},
+            {{"Sound", "buffer cache max"}, "64"},
+            {{"Sound", "master volume"}, "1.0"},
+            {{"Sound", "footsteps volume"}, "1.0"},
+            {{"Sound", "music volume"}, "1.0"},
+            {{"Sound", "sfx volume"}, "1.0"},
+            {{"Sound", "voice volume"}, "1.0"},
+        };
+
+        // Environmental sounds are much more frequent than in the game to exercise the region sound selection
+        Fallback::Map::init({
+            {"Water_NearWaterRadius", "1000"},
+            {"Water_NearWaterPoints", "8"},
+            {"Water_NearWaterIndoorTolerance", "512.0"},
+            {"Water_NearWaterOutdoorTolerance", "1024.0"},
+            {"Water_NearWaterIndoorID", waterSoundId},
+            {"Water_NearWaterOutdoorID", waterSoundId},
+            {"Weather_Minimum_Time_Between_Environmental_Sounds", "0.1"},
+            {"Weather_Maximum_Time_Between_Environmental_Sounds", "0.5"},
+        });
+    }
+
+    ESM::Cell makeExteriorCell()
+    {
+        ESM::Cell result;
+        result.blank();
+        result.mData.mFlags = 0;
+        result.mData.mX = 0;
+        result.mData.mY = 0;
+        result.mRegion = regionId;
+        return result;
+    }
+
+    template <typename Random>
+    osg::Vec3f generatePosition(Random& random)
+    {
+        std::uniform_real_distribution<float> distribution(-8192, 8192);
+        return osg::Vec3f(distribution(random), distribution(random), distribution(random));
+    }
+
+    /// A sound manager of the game with a null output, a generated store and sound files.
+    struct Game
+    {
+        const std::unique_ptr<VFS::Manager> mVfs;
+        MWWorld::ESMStore mStore;
+        const ESM::Cell mCell;
+        std::unique_ptr<SoundManager> mManager;
+
+        Game()
+            : mVfs(makeVfs())
+            , mCell(makeExteriorCell())
+        {
+            initSettings();
+            loadStore(mStore);
+            mManager = std::make_unique<SoundManager>(mVfs.get(), true);
+            mManager->setStore(mStore);
+        }
+
+        /// Move the listener across the emitters, so that their sounds are culled and faded back in.
+        void update(std::size_t frame, const WaterSoundUpdate& waterSound)
+        {
+            const float angle = static_cast<float>(frame * frameDuration * 0.1);
+            const osg::Vec3f position(6000 * std::cos(angle), 6000 * std::sin(angle), 0);
+            const osg::Vec3f direction(-std::sin(angle), std::cos(angle), 0);
+            mManager->setListenerPosDir(position, direction, osg::Vec3f(0, 0, 1), false);
+            mManager->update(static_cast<float>(frameDuration), &mCell, waterSound);
+        }
+    };
+
+    // Frames of the game with looping sounds on a number of emitters and a one-shot sound at one of them every
+    // frame, along with region, near water and music sounds.
+    void updateSoundManager(benchmark::State& state)
+    {
+        Game game;
+        std::minstd_rand random;
+        std::vector<osg::Vec3f> emitters;
+        std::size_t looping = 0;
+        for (std::int64_t i = 0; i < state.range(0); ++i)
+        {
+            emitters.push_back(generatePosition(random));
+            if (game.mManager->playSound3D(emitters.back(), getSoundId(static_cast<int>(i % soundCount)), 1.0f, 1.0f,
+                    Type::Sfx, PlayMode::Loop) != nullptr)
+                ++looping;
+        }
+        game.mManager->playPlaylist("Explore");
+        const WaterSoundUpdate waterSound {waterSoundId, 0.5f};
+        std::uniform_int_distribution<std::size_t> emitterDistribution(0, emitters.size() - 1);
+        std::uniform_int_distribution<int> soundDistribution(0, soundCount - 1);
+        std::size_t frame = 0;
+
+        for (auto _ : state)
+        {
+            game.mManager->playSound3D(emitters[emitterDistribution(random)], getSoundId(soundDistribution(random)),
+                1.0f, 1.0f, Type::Sfx, PlayMode::Normal);
+            game.update(frame++, waterSound);
+        }
+
+        // The output has a limited number of sources, loops beyond that are not played
+        state.counters["Looping"] = static_cast<double>(looping);
+    }
+
+    // Frames of the game with only music and region sounds playing
+    void streamMusic(benchmark::State& state)
+    {
+        Game game;
+        game.mManager->playPlaylist("Explore");
+        const WaterSoundUpdate noWaterSound {waterSoundId, 0.0f};
+        std::size_t frame = 0;
+
+        for (auto _ : state)
+            game.update(frame++, noWaterSound);
+    }
+
+    std::unique_ptr<NullOutput> makeOutput()
+    {
+        Debug::CurrentDebugLevel = Debug::Error;
+        auto output = std::make_unique<NullOutput>(nullptr, 256, false);
+        output->init(std::string(), std::string(), HrtfMode::Disable);
+        return output;
+    }
+
+    void decodeStreams(benchmark::State& state)
+    {
+        const auto output = makeOutput();
+        std::vector<std::unique_ptr<Stream>> streams;
+        for (std::int64_t i = 0; i < state.range(0); ++i)
+        {
+            auto& stream = streams.emplace_back(std::make_unique<Stream>());
+            stream->init(SoundParams());
+        }
+
+        for (auto _ : state)
+        {
+            output->startUpdate();
+            for (const auto& stream : streams)
+            {
+                if (output->isStreamPlaying(stream.get()))
+                {
+                    benchmark::DoNotOptimize(output->getStreamLoudness(stream.get()));
+                    continue;
+                }
+                output->finishStream(stream.get());
+                output->streamSound(std::make_shared<SineDecoder>(5.0), stream.get(), true);
+            }
+            output->advance(frameDuration);
+            output->finishUpdate();
+        }
+
+        for (const auto& stream : streams)
+            output->finishStream(stream.get());
+
+        state.SetBytesProcessed(output->getStats().mDecodedBytes);
+    }
+
+    void churnDecodedSoundCache(benchmark::State& state)
+    {
+        DecodedSoundCache cache(static_cast<std::size_t>(state.range(0)) * 1024 * 1024);
+        const auto sound = std::make_shared<const DecodedSound>(makeDecodedSound(1.0));
+        std::minstd_rand random;
+        std::uniform_int_distribution<int> distribution(0, 999);
+        std::vector<std::string> names;
+        for (int i = 0; i < 1000; ++i)
+            names.push_back("sound/fx/" + std::to_string(i) + ".wav");
+
+        for (auto _ : state)
+        {
+            const std::string& name = names[distribution(random)];
+            if (cache.get(name) == nullptr)
+                cache.insert(name, sound);
+        }
+    }
+} // namespace
+
+BENCHMARK(updateSoundManager)->Arg(64)->Arg(128)->Arg(256);
+BENCHMARK(streamMusic);
+BENCHMARK(decodeStreams)->Arg(1)->Arg(8)->Arg(64);
+BENCHMARK(churnDecodedSoundCache)->Arg(16)->Arg(64)->Arg(256);
+
+BENCHMARK_MAIN();
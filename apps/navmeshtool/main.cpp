@@ -1,10 +1,12 @@
 #include "worldspacedata.hpp"
 #include "navmesh.hpp"
+#include "tilesources.hpp"
 
 #include <components/debug/debugging.hpp>
 #include <components/detournavigator/navmeshdb.hpp>
 #include <components/detournavigator/recastglobalallocator.hpp>
 #include <components/esm3/esmreader.hpp>
+#include <components/esm3/loadcell.hpp>
 #include <components/esm3/variant.hpp>
 #include <components/esmloader/esmdata.hpp>
 #include <components/esmloader/load.hpp>
@@ -29,7 +31,11 @@
 #include <boost/program_options.hpp>
 
 #include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <set>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -97,6 +103,12 @@ namespace NavMeshTool
 
                 ("write-binary-log", bpo::value<bool>()->implicit_value(true)
                     ->default_value(false), "write progress in binary messages to be consumed by the launcher")
+
+                ("incremental", bpo::value<bool>()->implicit_value(true)
+                    ->default_value(false), "process only tiles affected by content files changed since the previous run")
+
+                ("dry-run", bpo::value<bool>()->implicit_value(true)
+                    ->default_value(false), "report how many tiles would be processed without changing the database")
             ;
             Files::ConfigurationManager::addCommonOptions(result);
 
@@ -159,6 +171,8 @@ namespace NavMeshTool
             const bool processInteriorCells = variables["process-interior-cells"].as<bool>();
             const bool removeUnusedTiles = variables["remove-unused-tiles"].as<bool>();
             const bool writeBinaryLog = variables["write-binary-log"].as<bool>();
+            const bool incremental = variables["incremental"].as<bool>();
+            const bool dryRun = variables["dry-run"].as<bool>();
 
 #ifdef WIN32
             if (writeBinaryLog)
@@ -180,7 +194,24 @@ namespace NavMeshTool
             const std::uint64_t maxDbFileSize = static_cast<std::uint64_t>(Settings::Manager::getInt64("max navmeshdb file size", "Navigator"));
             const std::string dbPath = (config.getUserDataPath() / "navmesh.db").string();
 
-            DetourNavigator::NavMeshDb db(dbPath, maxDbFileSize);
+            const bool verifyDbInput = Settings::Manager::getBool("verify navmeshdb input", "Navigator");
+
+            std::optional<DetourNavigator::NavMeshDb> db;
+            if (!dryRun)
+                db.emplace(dbPath, maxDbFileSize, verifyDbInput);
+            else if (std::filesystem::exists(dbPath))
+            {
+                // Dry run must not create the db schema or migrate it
+                try
+                {
+                    db.emplace(dbPath, maxDbFileSize, verifyDbInput, DetourNavigator::NavMeshDbMode::ReadOnly);
+                }
+                catch (const std::exception& e)
+                {
+                    Log(Debug::Warning) << "Navmesh db can't be used for dry run, all tiles are considered changed: "
+                        << e.what();
+                }
+            }
 
             ESM::ReadersCache readers;
             EsmLoader::Query query;
@@ -191,6 +222,7 @@ namespace NavMeshTool
             query.mLoadGameSettings = true;
             query.mLoadLands = true;
             query.mLoadStatics = true;
+            query.mLoadRefIdContentFiles = true;
             const EsmLoader::EsmData esmData = EsmLoader::loadEsmData(query, contentFiles, fileCollections, readers, &encoder);
 
             Resource::ImageManager imageManager(&vfs);
@@ -201,11 +233,75 @@ namespace NavMeshTool
             DetourNavigator::Settings navigatorSettings = DetourNavigator::makeSettingsFromSettingsManager();
             navigatorSettings.mRecast.mSwimHeightScale = EsmLoader::getGameSetting(esmData.mGameSettings, "fSwimHeightScale").getFloat();
 
-            WorldspaceData cellsData = gatherWorldspaceData(navigatorSettings, readers, vfs, bulletShapeManager,
-                                                            esmData, processInteriorCells, writeBinaryLog);
+            const std::vector<DetourNavigator::ContentFileHash> contentFilesHashes
+                = getContentFilesHashes(contentFiles, fileCollections);
+            const std::vector<std::byte> tileSourcesSettings
+                = makeTileSourcesSettings(navigatorSettings.mRecast, agentBounds, processInteriorCells);
+
+            std::optional<std::set<std::string>> changedContentFiles;
+            if (incremental && db.has_value())
+                changedContentFiles = getChangedContentFiles(*db, contentFilesHashes, tileSourcesSettings);
+
+            WorldspaceData cellsData;
+            std::optional<Tiles> tiles;
+            Cells changedCells;
+
+            if (changedContentFiles.has_value())
+            {
+                const std::set<std::string> changedRefIds = getChangedRefIds(esmData, contentFiles, *changedContentFiles);
+                changedCells = findCellsBySources(*db, *changedContentFiles, changedRefIds);
+
+                const auto isChanged = [&] (const ESM::Cell& cell)
+                {
+                    return contains(changedCells, cell)
+                        || hasChangedContentFile(cell, esmData, contentFiles, *changedContentFiles);
+                };
+
+                Log(Debug::Info) << "Processing changed cells...";
+
+                const WorldspaceData changedCellsData = gatherWorldspaceData(navigatorSettings, readers, vfs,
+                    bulletShapeManager, esmData, processInteriorCells, writeBinaryLog, isChanged);
+
+                tiles = getChangedTiles(*db, changedCells, getTiles(changedCellsData, navigatorSettings.mRecast));
+
+                if (dryRun)
+                {
+                    Log(Debug::Info) << getTilesCount(*tiles) << " navmesh tiles would be processed";
+                    return 0;
+                }
+
+                // Changed tiles may have objects from unchanged cells
+                const Cells tilesCells = findCellsByTiles(*db, *tiles);
+
+                Log(Debug::Info) << "Processing cells covering " << getTilesCount(*tiles) << " changed tiles...";
+
+                cellsData = gatherWorldspaceData(navigatorSettings, readers, vfs, bulletShapeManager, esmData,
+                    processInteriorCells, writeBinaryLog,
+                    [&] (const ESM::Cell& cell) { return isChanged(cell) || contains(tilesCells, cell); });
+            }
+            else
+            {
+                cellsData = gatherWorldspaceData(navigatorSettings, readers, vfs, bulletShapeManager, esmData,
+                    processInteriorCells, writeBinaryLog, [] (const ESM::Cell&) { return true; });
+
+                if (dryRun)
+                {
+                    Log(Debug::Info) << getTilesCount(getTiles(cellsData, navigatorSettings.mRecast))
+                        << " navmesh tiles would be processed";
+                    return 0;
+                }
+            }
+
+            const auto saveTileSources = [&] (DetourNavigator::NavMeshDb& navMeshDb)
+            {
+                writeTileSources(navMeshDb, cellsData, tiles, changedCells, esmData, contentFiles,
+                                              navigatorSettings.mRecast);
+                navMeshDb.setContentFiles(contentFilesHashes);
+                navMeshDb.setTileSourcesSettings(tileSourcesSettings);
+            };
 
             const Status status = generateAllNavMeshTiles(agentBounds, navigatorSettings, threadsNumber,
-                removeUnusedTiles, writeBinaryLog, cellsData, std::move(db));
+                removeUnusedTiles, writeBinaryLog, cellsData, tiles, saveTileSources, std::move(*db));
 
             switch (status)
             {
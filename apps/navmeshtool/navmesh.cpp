@@ -20,6 +20,7 @@
 
 #include <osg/Vec3f>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
@@ -111,7 +112,7 @@ namespace NavMeshTool
             {
                 std::optional<NavMeshTileInfo> result;
                 std::lock_guard lock(mMutex);
-                if (const auto tile = mDb.findTile(worldspace, tilePosition, input))
+                if (const auto tile = mDb.findTile(worldspace, tilePosition, makeTileInputHash(input), input))
                 {
                     NavMeshTileInfo info;
                     info.mTileId = tile->mTileId;
@@ -149,7 +150,8 @@ namespace NavMeshTool
                     if (mRemoveUnusedTiles)
                         mDeleted += static_cast<std::size_t>(mDb.deleteTilesAt(worldspace, tilePosition));
                     data.mUserId = static_cast<unsigned>(mNextTileId);
-                    mDb.insertTile(mNextTileId, worldspace, tilePosition, TileVersion {version}, input, serialize(data));
+                    mDb.insertTile(mNextTileId, worldspace, tilePosition, TileVersion {version}, makeTileInputHash(input),
+                                   input, serialize(data));
                     ++mNextTileId;
                 }
                 ++mInserted;
@@ -208,6 +210,12 @@ namespace NavMeshTool
                 mTransaction.commit();
             }
 
+            void writeTileSources(const WriteTileSources& write)
+            {
+                const std::lock_guard lock(mMutex);
+                write(mDb);
+            }
+
             void vacuum()
             {
                 const std::lock_guard lock(mMutex);
@@ -253,7 +261,7 @@ namespace NavMeshTool
 
     Status generateAllNavMeshTiles(const AgentBounds& agentBounds, const Settings& settings,
         std::size_t threadsNumber, bool removeUnusedTiles, bool writeBinaryLog, WorldspaceData& data,
-        NavMeshDb&& db)
+        const std::optional<Tiles>& tilesToGenerate, const WriteTileSources& writeTileSources, NavMeshDb&& db)
     {
         Log(Debug::Info) << "Generating navmesh tiles by " << threadsNumber << " parallel workers...";
 
@@ -264,19 +272,24 @@ namespace NavMeshTool
 
         for (const std::unique_ptr<WorldspaceNavMeshInput>& input : data.mNavMeshInputs)
         {
-            const auto range = DetourNavigator::makeTilesPositionsRange(
-                Misc::Convert::toOsgXY(input->mAabb.m_min),
-                Misc::Convert::toOsgXY(input->mAabb.m_max),
-                settings.mRecast
-            );
+            std::vector<TilePosition> worldspaceTiles;
 
-            if (removeUnusedTiles)
-                navMeshTileConsumer->removeTilesOutsideRange(input->mWorldspace, range);
+            if (tilesToGenerate.has_value())
+            {
+                // Only part of the cells is processed so the range doesn't cover all used tiles
+                if (const auto it = tilesToGenerate->find(input->mWorldspace); it != tilesToGenerate->end())
+                    worldspaceTiles.assign(it->second.begin(), it->second.end());
+            }
+            else
+            {
+                const TilesPositionsRange range = getTilesPositionsRange(*input, settings.mRecast);
 
-            std::vector<TilePosition> worldspaceTiles;
+                if (removeUnusedTiles)
+                    navMeshTileConsumer->removeTilesOutsideRange(input->mWorldspace, range);
 
-            DetourNavigator::getTilesPositions(range,
-                [&] (const TilePosition& tilePosition) { worldspaceTiles.push_back(tilePosition); });
+                DetourNavigator::getTilesPositions(range,
+                    [&] (const TilePosition& tilePosition) { worldspaceTiles.push_back(tilePosition); });
+            }
 
             tiles += worldspaceTiles.size();
 
@@ -298,9 +311,35 @@ namespace NavMeshTool
                 ));
         }
 
+        if (tilesToGenerate.has_value())
+        {
+            // Tiles of worldspaces without cells anymore have nothing to generate
+            for (const auto& worldspaceTiles : *tilesToGenerate)
+            {
+                const std::string& worldspace = worldspaceTiles.first;
+                const bool hasInput = std::any_of(data.mNavMeshInputs.begin(), data.mNavMeshInputs.end(),
+                    [&] (const std::unique_ptr<WorldspaceNavMeshInput>& v) { return v->mWorldspace == worldspace; });
+                if (hasInput)
+                    continue;
+
+                tiles += worldspaceTiles.second.size();
+
+                if (writeBinaryLog)
+                    serializeToStderr(ExpectedTiles {static_cast<std::uint64_t>(tiles)});
+
+                navMeshTileConsumer->mExpected = tiles;
+
+                for (const TilePosition& tilePosition : worldspaceTiles.second)
+                    navMeshTileConsumer->ignore(worldspace, tilePosition);
+            }
+        }
+
         const Status status = navMeshTileConsumer->wait();
         if (status == Status::Ok)
+        {
+            navMeshTileConsumer->writeTileSources(writeTileSources);
             navMeshTileConsumer->commit();
+        }
 
         const auto inserted = navMeshTileConsumer->getInserted();
         const auto updated = navMeshTileConsumer->getUpdated();
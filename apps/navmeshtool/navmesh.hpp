@@ -1,9 +1,13 @@
 #ifndef OPENMW_NAVMESHTOOL_NAVMESH_H
 #define OPENMW_NAVMESHTOOL_NAVMESH_H
 
+#include "tilesources.hpp"
+
 #include <osg/Vec3f>
 
 #include <cstddef>
+#include <functional>
+#include <optional>
 
 namespace DetourNavigator
 {
@@ -23,9 +27,15 @@ namespace NavMeshTool
         NotEnoughSpace,
     };
 
+    // Called in the same transaction as the last generated tiles when all tiles are generated
+    using WriteTileSources = std::function<void (DetourNavigator::NavMeshDb& db)>;
+
+    /**
+     * @param tilesToGenerate tiles to generate, all tiles covered by cellsData are generated when there is no value.
+     */
     Status generateAllNavMeshTiles(const DetourNavigator::AgentBounds& agentBounds, const DetourNavigator::Settings& settings,
         std::size_t threadsNumber, bool removeUnusedTiles, bool writeBinaryLog, WorldspaceData& cellsData,
-        DetourNavigator::NavMeshDb&& db);
+        const std::optional<Tiles>& tilesToGenerate, const WriteTileSources& writeTileSources, DetourNavigator::NavMeshDb&& db);
 }
 
 #endif
@@ -0,0 +1,310 @@
+#include "tilesources.hpp"
+
+#include "worldspacedata.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/detournavigator/agentbounds.hpp>
+#include <components/detournavigator/gettilespositions.hpp>
+#include <components/detournavigator/serialization.hpp>
+#include <components/esm3/loadcell.hpp>
+#include <components/esmloader/esmdata.hpp>
+#include <components/esmloader/lessbyid.hpp>
+#include <components/files/collections.hpp>
+#include <components/files/hash.hpp>
+#include <components/files/multidircollection.hpp>
+#include <components/misc/stringops.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+namespace NavMeshTool
+{
+    namespace
+    {
+        using DetourNavigator::CellSourceType;
+        using DetourNavigator::ContentFileHash;
+        using DetourNavigator::NavMeshDb;
+        using DetourNavigator::TilePosition;
+        using DetourNavigator::TilesPositionsRange;
+
+        template <class F>
+        void forEachRefIdContentFile(const EsmLoader::EsmData& esmData, std::string_view refId, F&& f)
+        {
+            auto it = std::lower_bound(esmData.mRefIdContentFiles.begin(), esmData.mRefIdContentFiles.end(), refId,
+                                       EsmLoader::LessById {});
+            for (; it != esmData.mRefIdContentFiles.end() && it->mId == refId; ++it)
+                f(it->mContentFile);
+        }
+
+        template <class F>
+        void forEachCellTile(const CellSource& cellSource, const TilesPositionsRange& worldspaceRange, F&& f)
+        {
+            DetourNavigator::getTilesPositions(cellSource.mRange.value_or(worldspaceRange), f);
+            for (const RefSource& ref : cellSource.mRefs)
+                DetourNavigator::getTilesPositions(ref.mRange, f);
+        }
+
+        std::map<std::string_view, TilesPositionsRange> getWorldspacesRanges(const WorldspaceData& data,
+            const DetourNavigator::RecastSettings& settings)
+        {
+            std::map<std::string_view, TilesPositionsRange> result;
+            for (const std::unique_ptr<WorldspaceNavMeshInput>& input : data.mNavMeshInputs)
+                result.emplace(input->mWorldspace, getTilesPositionsRange(*input, settings));
+            return result;
+        }
+    }
+
+    std::size_t getTilesCount(const Tiles& tiles)
+    {
+        std::size_t result = 0;
+        for (const auto& [worldspace, positions] : tiles)
+            result += positions.size();
+        return result;
+    }
+
+    bool contains(const Cells& cells, const ESM::Cell& cell)
+    {
+        const auto it = cells.find(cell.mCellId.mWorldspace);
+        return it != cells.end() && it->second.count(getCellSourceName(cell)) > 0;
+    }
+
+    std::vector<ContentFileHash> getContentFilesHashes(const std::vector<std::string>& contentFiles,
+        const Files::Collections& fileCollections)
+    {
+        std::vector<ContentFileHash> result;
+        result.reserve(contentFiles.size());
+        for (const std::string& file : contentFiles)
+        {
+            const std::string extension = Misc::StringUtils::lowerCase(boost::filesystem::path(file).extension().string());
+            const std::string path = fileCollections.getCollection(extension).getPath(file).string();
+            std::ifstream stream(path, std::ios::binary);
+            if (!stream)
+                throw std::runtime_error("Failed to open content file \"" + path + "\" to get hash");
+            const std::array<std::uint64_t, 2> hash = Files::getHash(path, stream);
+            std::vector<std::byte> value(sizeof(hash));
+            std::memcpy(value.data(), hash.data(), sizeof(hash));
+            result.push_back(ContentFileHash {file, std::move(value)});
+        }
+        return result;
+    }
+
+    std::vector<std::byte> makeTileSourcesSettings(const DetourNavigator::RecastSettings& settings,
+        const DetourNavigator::AgentBounds& agentBounds, bool processInteriorCells)
+    {
+        std::vector<std::byte> result = DetourNavigator::serialize(settings, agentBounds);
+        result.push_back(static_cast<std::byte>(processInteriorCells));
+        return result;
+    }
+
+    std::optional<std::set<std::string>> getChangedContentFiles(NavMeshDb& db,
+        const std::vector<ContentFileHash>& contentFiles, const std::vector<std::byte>& settings)
+    {
+        const std::optional<std::vector<std::byte>> previousSettings = db.getTileSourcesSettings();
+        if (!previousSettings.has_value())
+        {
+            Log(Debug::Info) << "There are no tile sources from a previous run, all tiles will be processed";
+            return {};
+        }
+        if (*previousSettings != settings)
+        {
+            Log(Debug::Info) << "Navigator settings are changed since the previous run, all tiles will be processed";
+            return {};
+        }
+
+        const std::vector<ContentFileHash> previous = db.getContentFiles();
+
+        const auto findByName = [] (const std::vector<ContentFileHash>& values, std::string_view name)
+        {
+            return std::find_if(values.begin(), values.end(), [&] (const ContentFileHash& v) { return v.mName == name; });
+        };
+
+        std::set<std::string> result;
+        std::vector<std::string_view> kept;
+        for (const ContentFileHash& contentFile : contentFiles)
+        {
+            const auto it = findByName(previous, contentFile.mName);
+            if (it == previous.end() || it->mHash != contentFile.mHash)
+                result.insert(contentFile.mName);
+            if (it != previous.end())
+                kept.push_back(contentFile.mName);
+        }
+
+        // Records override each other in load order so the same files in a different order give different data
+        std::vector<std::string_view> previousKept;
+        for (const ContentFileHash& contentFile : previous)
+        {
+            if (findByName(contentFiles, contentFile.mName) == contentFiles.end())
+                result.insert(contentFile.mName);
+            else
+                previousKept.push_back(contentFile.mName);
+        }
+        if (kept != previousKept)
+        {
+            Log(Debug::Info) << "Content files are reordered since the previous run, all tiles will be processed";
+            return {};
+        }
+
+        Log(Debug::Info) << result.size() << " content files are changed since the previous run";
+        for (const std::string& name : result)
+            Log(Debug::Verbose) << "Changed content file: " << name;
+
+        return result;
+    }
+
+    std::set<std::string> getChangedRefIds(const EsmLoader::EsmData& esmData,
+        const std::vector<std::string>& contentFiles, const std::set<std::string>& changedContentFiles)
+    {
+        std::set<std::string> result;
+        for (const EsmLoader::RefIdContentFile& v : esmData.mRefIdContentFiles)
+            if (changedContentFiles.count(contentFiles[v.mContentFile]) > 0)
+                result.insert(v.mId);
+        return result;
+    }
+
+    bool hasChangedContentFile(const ESM::Cell& cell, const EsmLoader::EsmData& esmData,
+        const std::vector<std::string>& contentFiles, const std::set<std::string>& changedContentFiles)
+    {
+        const std::vector<std::size_t> cellContentFiles = getCellContentFiles(cell, esmData);
+        return std::any_of(cellContentFiles.begin(), cellContentFiles.end(),
+            [&] (std::size_t v) { return changedContentFiles.count(contentFiles[v]) > 0; });
+    }
+
+    Cells findCellsBySources(NavMeshDb& db, const std::set<std::string>& contentFiles,
+        const std::set<std::string>& refIds)
+    {
+        Cells result;
+        const auto add = [&] (CellSourceType type, const std::string& name)
+        {
+            for (DetourNavigator::CellLocation& v : db.findCellsBySource(type, name))
+                result[std::move(v.mWorldspace)].insert(std::move(v.mCell));
+        };
+        for (const std::string& name : contentFiles)
+            add(CellSourceType::ContentFile, name);
+        for (const std::string& name : refIds)
+            add(CellSourceType::RefId, name);
+        return result;
+    }
+
+    Tiles findTilesByCells(NavMeshDb& db, const Cells& cells)
+    {
+        Tiles result;
+        for (const auto& [worldspace, names] : cells)
+        {
+            std::set<TilePosition>& tiles = result[worldspace];
+            for (const std::string& name : names)
+                for (const TilePosition& position : db.findTilesByCell(worldspace, name))
+                    tiles.insert(position);
+        }
+        return result;
+    }
+
+    Cells findCellsByTiles(NavMeshDb& db, const Tiles& tiles)
+    {
+        Cells result;
+        for (const auto& [worldspace, positions] : tiles)
+        {
+            std::set<std::string>& cells = result[worldspace];
+            for (const TilePosition& position : positions)
+                for (std::string& name : db.getTileCells(worldspace, position))
+                    cells.insert(std::move(name));
+        }
+        return result;
+    }
+
+    Tiles getTiles(const WorldspaceData& data, const DetourNavigator::RecastSettings& settings)
+    {
+        const std::map<std::string_view, TilesPositionsRange> ranges = getWorldspacesRanges(data, settings);
+        Tiles result;
+        for (const CellSource& cellSource : data.mCellSources)
+        {
+            std::set<TilePosition>& tiles = result[cellSource.mWorldspace];
+            forEachCellTile(cellSource, ranges.at(cellSource.mWorldspace),
+                [&] (const TilePosition& position) { tiles.insert(position); });
+        }
+        return result;
+    }
+
+    void merge(const Tiles& tiles, Tiles& target)
+    {
+        for (const auto& [worldspace, positions] : tiles)
+            target[worldspace].insert(positions.begin(), positions.end());
+    }
+
+    Tiles getChangedTiles(NavMeshDb& db, const Cells& changedCells, const Tiles& changedCellsTiles)
+    {
+        Tiles result = findTilesByCells(db, changedCells);
+        merge(changedCellsTiles, result);
+        return result;
+    }
+
+    void writeTileSources(NavMeshDb& db, const WorldspaceData& data, const std::optional<Tiles>& tiles,
+        const Cells& removedCells, const EsmLoader::EsmData& esmData, const std::vector<std::string>& contentFiles,
+        const DetourNavigator::RecastSettings& settings)
+    {
+        Log(Debug::Info) << "Writing tile sources...";
+
+        if (tiles.has_value())
+        {
+            for (const auto& [worldspace, positions] : *tiles)
+                for (const TilePosition& position : positions)
+                    db.deleteTileCellsAt(worldspace, position);
+            for (const auto& [worldspace, names] : removedCells)
+                for (const std::string& name : names)
+                    db.deleteCellSources(worldspace, name);
+        }
+        else
+        {
+            db.deleteAllTileSources();
+        }
+
+        const std::map<std::string_view, TilesPositionsRange> ranges = getWorldspacesRanges(data, settings);
+
+        for (const CellSource& cellSource : data.mCellSources)
+        {
+            db.deleteCellSources(cellSource.mWorldspace, cellSource.mCell);
+
+            std::set<std::size_t> cellContentFiles(cellSource.mContentFiles.begin(), cellSource.mContentFiles.end());
+            std::set<std::string_view> refIds;
+            for (const RefSource& ref : cellSource.mRefs)
+            {
+                if (!refIds.insert(ref.mRefId).second)
+                    continue;
+                forEachRefIdContentFile(esmData, ref.mRefId,
+                    [&] (std::size_t contentFile) { cellContentFiles.insert(contentFile); });
+            }
+
+            for (std::size_t contentFile : cellContentFiles)
+                db.insertCellSource(cellSource.mWorldspace, cellSource.mCell, CellSourceType::ContentFile,
+                                    contentFiles[contentFile]);
+            for (std::string_view refId : refIds)
+                db.insertCellSource(cellSource.mWorldspace, cellSource.mCell, CellSourceType::RefId, refId);
+
+            const std::set<TilePosition>* const worldspaceTiles = [&] () -> const std::set<TilePosition>*
+            {
+                if (!tiles.has_value())
+                    return nullptr;
+                const auto it = tiles->find(cellSource.mWorldspace);
+                if (it == tiles->end())
+                    return nullptr;
+                return &it->second;
+            } ();
+
+            if (tiles.has_value() && worldspaceTiles == nullptr)
+                continue;
+
+            std::set<TilePosition> cellTiles;
+            forEachCellTile(cellSource, ranges.at(cellSource.mWorldspace), [&] (const TilePosition& position)
+            {
+                if (worldspaceTiles == nullptr || worldspaceTiles->count(position) > 0)
+                    cellTiles.insert(position);
+            });
+
+            for (const TilePosition& position : cellTiles)
+                db.insertTileCell(cellSource.mWorldspace, position, cellSource.mCell);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef OPENMW_NAVMESHTOOL_TILESOURCES_H
+#define OPENMW_NAVMESHTOOL_TILESOURCES_H
+
+#include <components/detournavigator/navmeshdb.hpp>
+#include <components/detournavigator/tileposition.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ESM
+{
+    struct Cell;
+}
+
+namespace Files
+{
+    class Collections;
+}
+
+namespace EsmLoader
+{
+    struct EsmData;
+}
+
+namespace DetourNavigator
+{
+    struct AgentBounds;
+    struct RecastSettings;
+}
+
+namespace NavMeshTool
+{
+    struct WorldspaceData;
+
+    // Tiles and cells grouped by worldspace
+    using Tiles = std::map<std::string, std::set<DetourNavigator::TilePosition>, std::less<>>;
+    using Cells = std::map<std::string, std::set<std::string>, std::less<>>;
+
+    std::size_t getTilesCount(const Tiles& tiles);
+
+    bool contains(const Cells& cells, const ESM::Cell& cell);
+
+    std::vector<DetourNavigator::ContentFileHash> getContentFilesHashes(const std::vector<std::string>& contentFiles,
+        const Files::Collections& fileCollections);
+
+    std::vector<std::byte> makeTileSourcesSettings(const DetourNavigator::RecastSettings& settings,
+        const DetourNavigator::AgentBounds& agentBounds, bool processInteriorCells);
+
+    /**
+     * @brief getChangedContentFiles compares content files with the ones used for tile sources stored in the db.
+     * @return names of changed, added and removed content files, no value when all tiles have to be processed:
+     * there are no tile sources, settings are different or content files are reordered.
+     */
+    std::optional<std::set<std::string>> getChangedContentFiles(DetourNavigator::NavMeshDb& db,
+        const std::vector<DetourNavigator::ContentFileHash>& contentFiles, const std::vector<std::byte>& settings);
+
+    std::set<std::string> getChangedRefIds(const EsmLoader::EsmData& esmData,
+        const std::vector<std::string>& contentFiles, const std::set<std::string>& changedContentFiles);
+
+    bool hasChangedContentFile(const ESM::Cell& cell, const EsmLoader::EsmData& esmData,
+        const std::vector<std::string>& contentFiles, const std::set<std::string>& changedContentFiles);
+
+    // Cells having any of given sources in the previous run
+    Cells findCellsBySources(DetourNavigator::NavMeshDb& db, const std::set<std::string>& contentFiles,
+        const std::set<std::string>& refIds);
+
+    // Tiles covered by given cells in the previous run
+    Tiles findTilesByCells(DetourNavigator::NavMeshDb& db, const Cells& cells);
+
+    // Cells covering given tiles in the previous run
+    Cells findCellsByTiles(DetourNavigator::NavMeshDb& db, const Tiles& tiles);
+
+    // Tiles covered by the cells of data
+    Tiles getTiles(const WorldspaceData& data, const DetourNavigator::RecastSettings& settings);
+
+    void merge(const Tiles& tiles, Tiles& target);
+
+    /**
+     * @brief getChangedTiles finds tiles to process in an incremental run without writing to the db.
+     * @param changedCells cells having changed sources in the previous run.
+     * @param changedCellsTiles tiles covered by the changed cells now.
+     * @return tiles covered by the changed cells before and after the change.
+     */
+    Tiles getChangedTiles(DetourNavigator::NavMeshDb& db, const Cells& changedCells, const Tiles& changedCellsTiles);
+
+    /**
+     * @brief writeTileSources replaces sources of the cells of data and of the given tiles.
+     * @param tiles processed tiles, all tile sources are replaced when there is no value.
+     * @param removedCells cells with sources from the previous run that may not exist anymore.
+     */
+    void writeTileSources(DetourNavigator::NavMeshDb& db, const WorldspaceData& data,
+        const std::optional<Tiles>& tiles, const Cells& removedCells, const EsmLoader::EsmData& esmData,
+        const std::vector<std::string>& contentFiles, const DetourNavigator::RecastSettings& settings);
+}
+
+#endif
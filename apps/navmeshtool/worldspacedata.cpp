@@ -21,9 +21,11 @@
 #include <components/debug/debugging.hpp>
 #include <components/navmeshtool/protocol.hpp>
 #include <components/esm3/readerscache.hpp>
+#include <components/misc/convert.hpp>
 
 #include <LinearMath/btVector3.h>
 
+#include <osg/Vec2f>
 #include <osg/Vec2i>
 #include <osg/ref_ptr>
 
@@ -100,10 +102,10 @@ namespace NavMeshTool
             return result;
         }
 
-        template <class F>
+        template <class F, class I>
         void forEachObject(const ESM::Cell& cell, const EsmLoader::EsmData& esmData, const VFS::Manager& vfs,
             Resource::BulletShapeManager& bulletShapeManager, ESM::ReadersCache& readers,
-            F&& f)
+            F&& f, I&& ignore)
         {
             std::vector<CellRef> cellRefs = loadCellRefs(cell, esmData, readers);
 
@@ -113,7 +115,10 @@ namespace NavMeshTool
             {
                 std::string model(getModel(esmData, cellRef.mRefId, cellRef.mType));
                 if (model.empty())
+                {
+                    ignore(cellRef);
                     continue;
+                }
 
                 if (cellRef.mType != ESM::REC_STAT)
                     model = Misc::ResourceHelpers::correctActorModelPath(model, &vfs);
@@ -132,7 +137,10 @@ namespace NavMeshTool
                 } ();
 
                 if (shape == nullptr || shape->mCollisionShape == nullptr)
+                {
+                    ignore(cellRef);
                     continue;
+                }
 
                 osg::ref_ptr<Resource::BulletShapeInstance> shapeInstance(new Resource::BulletShapeInstance(std::move(shape)));
 
@@ -142,7 +150,7 @@ namespace NavMeshTool
                     case ESM::REC_CONT:
                     case ESM::REC_DOOR:
                     case ESM::REC_STAT:
-                        f(BulletObject(std::move(shapeInstance), cellRef.mPos, cellRef.mScale));
+                        f(cellRef, BulletObject(std::move(shapeInstance), cellRef.mPos, cellRef.mScale));
                         break;
                     default:
                         break;
@@ -226,6 +234,38 @@ namespace NavMeshTool
         }
     }
 
+    std::string getCellSourceName(const ESM::Cell& cell)
+    {
+        // Interior cell is the only cell of its worldspace
+        if (!cell.isExterior())
+            return {};
+        return std::to_string(cell.mData.mX) + "," + std::to_string(cell.mData.mY);
+    }
+
+    std::vector<std::size_t> getCellContentFiles(const ESM::Cell& cell, const EsmLoader::EsmData& esmData)
+    {
+        std::vector<std::size_t> result;
+        for (const ESM::ESM_Context& context : cell.mContextList)
+            result.push_back(static_cast<std::size_t>(context.index));
+        if (cell.isExterior())
+        {
+            const osg::Vec2i cellPosition(cell.mData.mX, cell.mData.mY);
+            const auto it = std::lower_bound(esmData.mLands.begin(), esmData.mLands.end(), cellPosition, LessByXY {});
+            if (it != esmData.mLands.end() && GetXY {}(*it) == cellPosition)
+                result.push_back(static_cast<std::size_t>(it->getPlugin()));
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    DetourNavigator::TilesPositionsRange getTilesPositionsRange(const WorldspaceNavMeshInput& input,
+        const DetourNavigator::RecastSettings& settings)
+    {
+        return DetourNavigator::makeTilesPositionsRange(Misc::Convert::toOsgXY(input.mAabb.m_min),
+            Misc::Convert::toOsgXY(input.mAabb.m_max), settings);
+    }
+
     WorldspaceNavMeshInput::WorldspaceNavMeshInput(std::string worldspace, const DetourNavigator::RecastSettings& settings)
         : mWorldspace(std::move(worldspace))
         , mTileCachedRecastMeshManager(settings)
@@ -236,7 +276,7 @@ namespace NavMeshTool
 
     WorldspaceData gatherWorldspaceData(const DetourNavigator::Settings& settings, ESM::ReadersCache& readers,
         const VFS::Manager& vfs, Resource::BulletShapeManager& bulletShapeManager, const EsmLoader::EsmData& esmData,
-        bool processInteriorCells, bool writeBinaryLog)
+        bool processInteriorCells, bool writeBinaryLog, const CellFilter& filter)
     {
         Log(Debug::Info) << "Processing " << esmData.mCells.size() << " cells...";
 
@@ -262,6 +302,15 @@ namespace NavMeshTool
                 continue;
             }
 
+            if (!filter(cell))
+            {
+                if (writeBinaryLog)
+                    serializeToStderr(ProcessedCells {static_cast<std::uint64_t>(i + 1)});
+                Log(Debug::Debug) << "Skipped unchanged " << (exterior ? "exterior" : "interior")
+                    << " cell (" << (i + 1) << "/" << esmData.mCells.size() << ") \"" << cell.getDescription() << "\"";
+                continue;
+            }
+
             Log(Debug::Debug) << "Processing " << (exterior ? "exterior" : "interior")
                 << " cell (" << (i + 1) << "/" << esmData.mCells.size() << ") \"" << cell.getDescription() << "\"";
 
@@ -280,6 +329,11 @@ namespace NavMeshTool
                 return *it->second;
             } ();
 
+            CellSource& cellSource = data.mCellSources.emplace_back();
+            cellSource.mWorldspace = cell.mCellId.mWorldspace;
+            cellSource.mCell = getCellSourceName(cell);
+            cellSource.mContentFiles = getCellContentFiles(cell, esmData);
+
             if (exterior)
             {
                 const auto it = std::lower_bound(esmData.mLands.begin(), esmData.mLands.end(), cellPosition, LessByXY {});
@@ -288,8 +342,12 @@ namespace NavMeshTool
                     cellPosition, data.mHeightfields, data.mLandData
                 );
 
-                mergeOrAssign(getAabb(cellPosition, minHeight, maxHeight),
-                              navMeshInput.mAabb, navMeshInput.mAabbInitialized);
+                const btAABB cellAabb = getAabb(cellPosition, minHeight, maxHeight);
+
+                mergeOrAssign(cellAabb, navMeshInput.mAabb, navMeshInput.mAabbInitialized);
+
+                cellSource.mRange = DetourNavigator::makeTilesPositionsRange(Misc::Convert::toOsgXY(cellAabb.m_min),
+                    Misc::Convert::toOsgXY(cellAabb.m_max), settings.mRecast);
 
                 navMeshInput.mTileCachedRecastMeshManager.addHeightfield(cellPosition, ESM::Land::REAL_SIZE, heightfieldShape);
 
@@ -302,13 +360,20 @@ namespace NavMeshTool
             }
 
             forEachObject(cell, esmData, vfs, bulletShapeManager, readers,
-                [&] (BulletObject object)
+                [&] (const CellRef& cellRef, BulletObject object)
                 {
                     const btTransform& transform = object.getCollisionObject().getWorldTransform();
-                    const btAABB aabb = BulletHelpers::getAabb(*object.getCollisionObject().getCollisionShape(), transform);
+                    const btCollisionShape& collisionShape = *object.getCollisionObject().getCollisionShape();
+                    const btAABB aabb = BulletHelpers::getAabb(collisionShape, transform);
                     mergeOrAssign(aabb, navMeshInput.mAabb, navMeshInput.mAabbInitialized);
+                    cellSource.mRefs.push_back(RefSource {cellRef.mRefId,
+                        DetourNavigator::makeTilesPositionsRange(collisionShape, transform, settings.mRecast)});
                     if (const btCollisionShape* avoid = object.getShapeInstance()->mAvoidCollisionShape.get())
+                    {
                         navMeshInput.mAabb.merge(BulletHelpers::getAabb(*avoid, transform));
+                        cellSource.mRefs.push_back(RefSource {cellRef.mRefId,
+                            DetourNavigator::makeTilesPositionsRange(*avoid, transform, settings.mRecast)});
+                    }
 
                     const ObjectId objectId(++objectsCounter);
                     const CollisionShape shape(object.getShapeInstance(), *object.getCollisionObject().getCollisionShape(), object.getObjectTransform());
@@ -324,6 +389,13 @@ namespace NavMeshTool
                     }
 
                     data.mObjects.emplace_back(std::move(object));
+                },
+                [&] (const CellRef& cellRef)
+                {
+                    // Keep refs without collision in the tile they are placed at in case their model gets one
+                    const osg::Vec2f position(cellRef.mPos.pos[0], cellRef.mPos.pos[1]);
+                    cellSource.mRefs.push_back(RefSource {cellRef.mRefId,
+                        DetourNavigator::makeTilesPositionsRange(position, position, settings.mRecast)});
                 });
 
             const auto cellDescription = cell.getDescription();
@@ -3,6 +3,7 @@
 
 #include <components/bullethelpers/collisionobject.hpp>
 #include <components/detournavigator/tilecachedrecastmeshmanager.hpp>
+#include <components/detournavigator/tilespositionsrange.hpp>
 #include <components/esm3/loadland.hpp>
 #include <components/misc/convert.hpp>
 #include <components/resource/bulletshape.hpp>
@@ -10,12 +11,16 @@
 #include <BulletCollision/CollisionDispatch/btCollisionObject.h>
 #include <LinearMath/btVector3.h>
 
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace ESM
 {
+    struct Cell;
     class ESMReader;
     class ReadersCache;
 }
@@ -81,17 +86,44 @@ namespace NavMeshTool
         std::unique_ptr<btCollisionObject> mCollisionObject;
     };
 
+    struct RefSource
+    {
+        std::string mRefId;
+        DetourNavigator::TilesPositionsRange mRange;
+    };
+
+    // What a cell puts into navmesh tiles: content files with its records and cell refs, heightfield and water tiles
+    // and tiles of each object. Interior cell water covers all tiles of the worldspace so it has no range.
+    struct CellSource
+    {
+        std::string mWorldspace;
+        std::string mCell;
+        std::vector<std::size_t> mContentFiles;
+        std::optional<DetourNavigator::TilesPositionsRange> mRange;
+        std::vector<RefSource> mRefs;
+    };
+
     struct WorldspaceData
     {
         std::vector<std::unique_ptr<WorldspaceNavMeshInput>> mNavMeshInputs;
         std::vector<BulletObject> mObjects;
         std::vector<std::unique_ptr<ESM::Land::LandData>> mLandData;
         std::vector<std::vector<float>> mHeightfields;
+        std::vector<CellSource> mCellSources;
     };
 
+    using CellFilter = std::function<bool (const ESM::Cell& cell)>;
+
+    std::string getCellSourceName(const ESM::Cell& cell);
+
+    std::vector<std::size_t> getCellContentFiles(const ESM::Cell& cell, const EsmLoader::EsmData& esmData);
+
+    DetourNavigator::TilesPositionsRange getTilesPositionsRange(const WorldspaceNavMeshInput& input,
+        const DetourNavigator::RecastSettings& settings);
+
     WorldspaceData gatherWorldspaceData(const DetourNavigator::Settings& settings, ESM::ReadersCache& readers,
         const VFS::Manager& vfs, Resource::BulletShapeManager& bulletShapeManager, const EsmLoader::EsmData& esmData,
-        bool processInteriorCells, bool writeBinaryLog);
+        bool processInteriorCells, bool writeBinaryLog, const CellFilter& filter);
 }
 
 #endif
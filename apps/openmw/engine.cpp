@@ -28,6 +28,7 @@
 #include <components/resource/resourcesystem.hpp>
 #include <components/resource/scenemanager.hpp>
 #include <components/resource/stats.hpp>
+#include <components/shader/shadermanager.hpp>
 
 #include <components/compiler/extensions0.hpp>
 
@@ -501,6 +502,8 @@ OMW::Engine::~Engine()
     mScriptContext = nullptr;
 
     mUnrefQueue = nullptr;
+    if (mResourceSystem != nullptr)
+        mResourceSystem->getSceneManager()->setWorkQueue(nullptr);
     mWorkQueue = nullptr;
 
     mViewer = nullptr;
@@ -760,6 +763,7 @@ void OMW::Engine::prepareEngine()
     if (numThreads <= 0)
         throw std::runtime_error("Invalid setting: 'preload num threads' must be >0");
     mWorkQueue = new SceneUtil::WorkQueue(numThreads);
+    mResourceSystem->getSceneManager()->setWorkQueue(mWorkQueue);
     mUnrefQueue = std::make_unique<SceneUtil::UnrefQueue>();
 
     mScreenCaptureOperation = new SceneUtil::AsyncScreenCaptureOperation(
@@ -814,6 +818,8 @@ void OMW::Engine::prepareEngine()
 
     // gui needs our shaders path before everything else
     mResourceSystem->getSceneManager()->setShaderPath((mResDir / "shaders").string());
+    if (Settings::Manager::getBool("shader source cache", "Shaders"))
+        mResourceSystem->getSceneManager()->getShaderManager().setSourceCachePath((mCfgMgr.getCachePath() / "shaders").string());
 
     osg::ref_ptr<osg::GLExtensions> exts = osg::GLExtensions::Get(0, false);
     bool shadersSupported = exts && (exts->glslLanguageVersion >= 1.2f);
@@ -831,7 +837,7 @@ void OMW::Engine::prepareEngine()
     rootNode->addChild(guiRoot);
 
     mWindowManager = std::make_unique<MWGui::WindowManager>(mWindow, mViewer, guiRoot, mResourceSystem.get(), mWorkQueue.get(),
-                mCfgMgr.getLogPath().string() + std::string("/"),
+                mCfgMgr.getLogPath().string() + std::string("/"), mCfgMgr.getCachePath().string(),
                 mScriptConsoleMode, mTranslationDataStorage, mEncoding,
                 Version::getOpenmwVersionDescription(mResDir.string()), shadersSupported);
     mEnvironment.setWindowManager(*mWindowManager);
@@ -860,6 +866,7 @@ void OMW::Engine::prepareEngine()
     mEnvironment.setWorld(*mWorld);
 
     mWindowManager->setStore(mWorld->getStore());
+    mSoundManager->setStore(mWorld->getStore());
     mLuaManager->initL10n();
     mWindowManager->initUI();
 
@@ -1,6 +1,7 @@
 #ifndef GAME_MWBASE_LUAMANAGER_H
 #define GAME_MWBASE_LUAMANAGER_H
 
+#include <string>
 #include <variant>
 #include <SDL_events.h>
 
@@ -94,6 +95,9 @@ namespace MWBase
         // Drops script cache and reloads all scripts. Calls `onSave` and `onLoad` for every script.
         virtual void reloadAllScripts() = 0;
 
+        // Memory usage and executed instructions per script in a human-readable form. Used by the debug window.
+        virtual std::string getResourceUsageReport() = 0;
+
         virtual void handleConsoleCommand(const std::string& consoleMode, const std::string& command, const MWWorld::Ptr& selectedPtr) = 0;
     };
 
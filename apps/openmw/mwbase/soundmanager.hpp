@@ -150,6 +150,9 @@ namespace MWBase
                                        PlayMode mode=PlayMode::Normal, float offset=0) = 0;
             ///< Play a 3D sound at \a initialPos. If the sound should be moving, it must be updated using Sound::setPosition.
 
+            virtual void preloadSound(std::string_view soundId) = 0;
+            ///< Decode the given sound in the background, to avoid stalling when it's played for the first time.
+
             virtual void stopSound(Sound *sound) = 0;
             ///< Stop the given sound from playing
 
@@ -4,6 +4,11 @@
 #include <list>
 #include <string>
 
+namespace osg
+{
+    class Stats;
+}
+
 namespace MWState
 {
     struct Slot;
@@ -86,6 +91,8 @@ namespace MWBase
             /// iterator.
 
             virtual CharacterIterator characterEnd() = 0;
+
+            virtual void reportStats(unsigned int frameNumber, osg::Stats& stats) const = 0;
     };
 }
 
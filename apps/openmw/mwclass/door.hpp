@@ -52,6 +52,8 @@ namespace MWClass
 
             std::string getModel(const MWWorld::ConstPtr &ptr) const override;
 
+            void getSoundsToPreload(const MWWorld::Ptr& ptr, std::vector<std::string>& sounds) const override;
+
             MWWorld::DoorState getDoorState (const MWWorld::ConstPtr &ptr) const override;
             /// This does not actually cause the door to move. Use World::activateDoor instead.
             void setDoorState (const MWWorld::Ptr &ptr, MWWorld::DoorState state) const override;
@@ -0,0 +1,82 @@
+#include "conditionindex.hpp"
+
+#include <algorithm>
+
+#include <components/esm3/loaddial.hpp>
+#include <components/misc/stringops.hpp>
+
+MWDialogue::ConditionIndex::Topic::Topic (const ESM::Dialogue& dialogue)
+{
+    mInfos.reserve (dialogue.mInfo.size());
+
+    for (const ESM::DialInfo& info : dialogue.mInfo)
+    {
+        const auto index = static_cast<std::uint32_t> (mInfos.size());
+
+        Info& indexed = mInfos.emplace_back();
+        indexed.mInfo = &info;
+        indexed.mSelects.reserve (info.mSelects.size());
+        for (const ESM::DialInfo::SelectStruct& select : info.mSelects)
+            indexed.mSelects.emplace_back (select);
+
+        // Every info goes to a single bucket, chosen by its most specific requirement
+        Bucket* bucket = &mUnrestricted;
+        if (!info.mActor.empty())
+            bucket = &mByActor[Misc::StringUtils::lowerCase (info.mActor)];
+        else if (!info.mFactionLess && !info.mFaction.empty())
+            bucket = &mByFaction[Misc::StringUtils::lowerCase (info.mFaction)];
+        else if (!info.mClass.empty())
+            bucket = &mByClass[Misc::StringUtils::lowerCase (info.mClass)];
+        else if (!info.mRace.empty())
+            bucket = &mByRace[Misc::StringUtils::lowerCase (info.mRace)];
+
+        bucket->push_back (index);
+    }
+}
+
+void MWDialogue::ConditionIndex::Topic::getCandidates (const Actor& actor, std::vector<const Info*>& out) const
+{
+    out.clear();
+
+    const auto append = [&] (const std::unordered_map<std::string, Bucket>& buckets, const std::string& key)
+    {
+        if (key.empty())
+            return;
+
+        const auto it = buckets.find (key);
+        if (it == buckets.end())
+            return;
+
+        for (std::uint32_t index : it->second)
+            out.push_back (&mInfos[index]);
+    };
+
+    append (mByActor, actor.mId);
+
+    // Creatures only get infos meant for their id
+    if (!actor.mIsCreature)
+    {
+        append (mByFaction, actor.mFaction);
+        append (mByClass, actor.mClass);
+        append (mByRace, actor.mRace);
+
+        for (std::uint32_t index : mUnrestricted)
+            out.push_back (&mInfos[index]);
+    }
+
+    // All candidates point into mInfos, so this restores the order of the dialogue
+    std::sort (out.begin(), out.end());
+}
+
+const MWDialogue::ConditionIndex::Topic& MWDialogue::ConditionIndex::add (const ESM::Dialogue& dialogue)
+{
+    return mTopics.insert_or_assign (&dialogue, Topic (dialogue)).first->second;
+}
+
+const MWDialogue::ConditionIndex::Topic* MWDialogue::ConditionIndex::find (const ESM::Dialogue& dialogue) const
+{
+    const auto it = mTopics.find (&dialogue);
+    if (it == mTopics.end())
+        return nullptr;
+    return &it->second;
+}
@@ -0,0 +1,82 @@
+#ifndef GAME_MWDIALOGUE_CONDITIONINDEX_H
+#define GAME_MWDIALOGUE_CONDITIONINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "selectwrapper.hpp"
+
+namespace ESM
+{
+    struct Dialogue;
+}
+
+namespace MWDialogue
+{
+    /// \brief Infos of all dialogues, partitioned by the speaker they are meant for
+    ///
+    /// Looking up the infos that may match a speaker only touches the infos requiring the speaker's id, faction,
+    /// class or race and the infos without such requirements, instead of all infos of the dialogue.
+    class ConditionIndex
+    {
+        public:
+
+            /// Properties of a speaker used to select infos, in lower case.
+            struct Actor
+            {
+                std::string mId;
+                std::string mRace;
+                std::string mClass;
+                std::string mFaction;
+                bool mIsCreature = false;
+            };
+
+            struct Info
+            {
+                const ESM::DialInfo* mInfo;
+                std::vector<SelectWrapper> mSelects;
+            };
+
+            class Topic
+            {
+                public:
+
+                    explicit Topic (const ESM::Dialogue& dialogue);
+
+                    void getCandidates (const Actor& actor, std::vector<const Info*>& out) const;
+                    ///< Replace the contents of \a out with the infos that may match \a actor, in dialogue order.
+                    ///
+                    /// \note Only the requirements used for partitioning are checked, the candidates still need to
+                    /// be tested.
+
+                    std::size_t getInfoCount() const { return mInfos.size(); }
+
+                private:
+
+                    using Bucket = std::vector<std::uint32_t>;
+
+                    std::vector<Info> mInfos;
+                    std::unordered_map<std::string, Bucket> mByActor;
+                    std::unordered_map<std::string, Bucket> mByFaction;
+                    std::unordered_map<std::string, Bucket> mByClass;
+                    std::unordered_map<std::string, Bucket> mByRace;
+                    Bucket mUnrestricted;
+            };
+
+            const Topic& add (const ESM::Dialogue& dialogue);
+            ///< Index \a dialogue, which must outlive the index.
+
+            const Topic* find (const ESM::Dialogue& dialogue) const;
+            ///< \return nullptr if \a dialogue is not indexed.
+
+            std::size_t getTopicCount() const { return mTopics.size(); }
+
+        private:
+
+            std::unordered_map<const ESM::Dialogue*, Topic> mTopics;
+    };
+}
+
+#endif
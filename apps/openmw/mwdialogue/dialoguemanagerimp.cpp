@@ -61,6 +61,9 @@ namespace MWDialogue
         mIsInChoice = false;
         mGoodbye = false;
         mCompilerContext.setExtensions (&extensions);
+
+        for (const ESM::Dialogue& dialogue : MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>())
+            mConditionIndex.add (dialogue);
     }
 
     void DialogueManager::clear()
@@ -155,7 +158,7 @@ namespace MWDialogue
         const MWWorld::Store<ESM::Dialogue> &dialogs =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
 
-        Filter filter (actor, mChoice, mTalkedTo);
+        Filter filter (actor, mChoice, mTalkedTo, &mConditionIndex);
 
         for (MWWorld::Store<ESM::Dialogue>::iterator it = dialogs.begin(); it != dialogs.end(); ++it)
         {
@@ -283,7 +286,7 @@ namespace MWDialogue
 
     void DialogueManager::executeTopic (const std::string& topic, ResponseCallback* callback)
     {
-        Filter filter (mActor, mChoice, mTalkedTo);
+        Filter filter (mActor, mChoice, mTalkedTo, &mConditionIndex);
 
         const MWWorld::Store<ESM::Dialogue> &dialogues =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
@@ -354,56 +357,38 @@ namespace MWDialogue
     {
         updateGlobals();
 
-        mActorKnownTopics.clear();
-
-        const auto& dialogs = MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
-
-        Filter filter (mActor, -1, mTalkedTo);
-
-        for (const auto& dialog : dialogs)
+        class Context final : public KnownTopicsContext
         {
-            if (dialog.mType == ESM::Dialogue::Topic)
-            {
-                const auto* answer = filter.search(dialog, true);
-                auto topicId = Misc::StringUtils::lowerCase(dialog.mId);
+            public:
 
-                if (answer != nullptr)
+                Context (DialogueManager& manager)
+                    : mManager (manager)
+                    , mFilter (manager.mActor, -1, manager.mTalkedTo, &manager.mConditionIndex)
+                {}
+
+                const ESM::DialInfo* search (const ESM::Dialogue& dialogue) const override
                 {
-                    int topicFlags = 0;
-                    if(!inJournal(topicId, answer->mId))
-                    {
-                        // Does this dialogue contains some actor-specific answer?
-                        if (Misc::StringUtils::ciEqual(answer->mActor, mActor.getCellRef().getRefId()))
-                            topicFlags |= MWBase::DialogueManager::TopicType::Specific;
-                    }
-                    else
-                        topicFlags |= MWBase::DialogueManager::TopicType::Exhausted;
-                    mActorKnownTopics.insert (std::make_pair(dialog.mId, ActorKnownTopicInfo {topicFlags, answer}));
+                    return mFilter.search (dialogue, true);
                 }
 
-            }
-        }
+                bool inJournal (const std::string& topicId, const std::string& infoId) const override
+                {
+                    return mManager.inJournal (topicId, infoId);
+                }
 
-        // If response to a topic leads to a new topic, the original topic is not exhausted.
+                std::vector<std::string> parseTopicIds (const std::string& text) const override
+                {
+                    return mManager.parseTopicIdsFromText (text);
+                }
 
-        for (auto& [dialogId, topicInfo] : mActorKnownTopics)
-        {
-            // If the topic is not marked as exhausted, we don't need to do anything about it.
-            // If the topic will not be shown to the player, the flag actually does not matter.
+            private:
 
-            if (!(topicInfo.mFlags & MWBase::DialogueManager::TopicType::Exhausted) ||
-                !mKnownTopics.count(dialogId))
-                continue;
+                DialogueManager& mManager;
+                const Filter mFilter;
+        };
 
-            for (const auto& topicId : parseTopicIdsFromText(topicInfo.mInfo->mResponse))
-            {
-                if (mActorKnownTopics.count( topicId ) && !mKnownTopics.count( topicId ))
-                {
-                    topicInfo.mFlags &= ~MWBase::DialogueManager::TopicType::Exhausted;
-                    break;
-                }
-            }
-        }
+        findActorKnownTopics (MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>(),
+            mActor.getCellRef().getRefId(), mKnownTopics, Context (*this), mActorKnownTopics);
     }
 
     std::list<std::string> DialogueManager::getAvailableTopics()
@@ -472,7 +457,7 @@ namespace MWDialogue
         const ESM::Dialogue* dialogue = searchDialogue(mLastTopic);
         if (dialogue)
         {
-            Filter filter (mActor, mChoice, mTalkedTo);
+            Filter filter (mActor, mChoice, mTalkedTo, &mConditionIndex);
 
             if (dialogue->mType == ESM::Dialogue::Topic || dialogue->mType == ESM::Dialogue::Greeting)
             {
@@ -602,7 +587,7 @@ namespace MWDialogue
 
     bool DialogueManager::checkServiceRefused(ResponseCallback* callback, ServiceType service)
     {
-        Filter filter (mActor, service, mTalkedTo);
+        Filter filter (mActor, service, mTalkedTo, &mConditionIndex);
 
         const MWWorld::Store<ESM::Dialogue> &dialogues =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
@@ -654,7 +639,7 @@ namespace MWDialogue
         const ESM::Dialogue *dial = store.get<ESM::Dialogue>().find(topic);
 
         const MWMechanics::CreatureStats& creatureStats = actor.getClass().getCreatureStats(actor);
-        Filter filter(actor, 0, creatureStats.hasTalkedToPlayer());
+        Filter filter(actor, 0, creatureStats.hasTalkedToPlayer(), &mConditionIndex);
         const ESM::DialInfo *info = filter.search(*dial, false);
         if(info != nullptr)
         {
@@ -16,6 +16,9 @@
 
 #include "../mwscript/compilercontext.hpp"
 
+#include "conditionindex.hpp"
+#include "knowntopics.hpp"
+
 namespace ESM
 {
     struct Dialogue;
@@ -25,19 +28,16 @@ namespace MWDialogue
 {
     class DialogueManager : public MWBase::DialogueManager
     {
-            struct ActorKnownTopicInfo
-            {
-                int mFlags;
-                const ESM::DialInfo* mInfo;
-            };
-
             std::set<std::string, Misc::StringUtils::CiComp> mKnownTopics;// Those are the topics the player knows.
 
             // Modified faction reactions. <Faction1, <Faction2, Difference> >
             typedef std::map<std::string, std::map<std::string, int> > ModFactionReactionMap;
             ModFactionReactionMap mChangedFactionReaction;
 
-            std::map<std::string, ActorKnownTopicInfo, Misc::StringUtils::CiComp> mActorKnownTopics;
+            ActorKnownTopics mActorKnownTopics;
+
+            // Built once on creation, dialogue records don't change after the content files are loaded
+            ConditionIndex mConditionIndex;
 
             Translation::Storage& mTranslationDataStorage;
             MWScript::CompilerContext mCompilerContext;
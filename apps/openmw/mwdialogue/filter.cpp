@@ -148,11 +148,10 @@ bool MWDialogue::Filter::testPlayer (const ESM::DialInfo& info) const
     return true;
 }
 
-bool MWDialogue::Filter::testSelectStructs (const ESM::DialInfo& info) const
+bool MWDialogue::Filter::testSelectStructs (const ConditionIndex::Info& info) const
 {
-    for (std::vector<ESM::DialInfo::SelectStruct>::const_iterator iter (info.mSelects.begin());
-        iter != info.mSelects.end(); ++iter)
-        if (!testSelectStruct (*iter))
+    for (const SelectWrapper& select : info.mSelects)
+        if (!testSelectStruct (select))
             return false;
 
     return true;
@@ -178,7 +177,7 @@ bool MWDialogue::Filter::testFunctionLocal(const MWDialogue::SelectWrapper& sele
     if (scriptName.empty())
         return false; // no script
 
-    std::string name = Misc::StringUtils::lowerCase (select.getName());
+    const std::string& name = select.getName();
 
     const Compiler::Locals& localDefs =
         MWBase::Environment::get().getScriptManager()->getLocals (scriptName);
@@ -605,9 +604,34 @@ bool MWDialogue::Filter::hasFactionRankReputationRequirements (const MWWorld::Pt
     return stats.getFactionReputation (factionId)>=faction.mData.mRankData[rank].mFactReaction;
 }
 
-MWDialogue::Filter::Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer)
-: mActor (actor), mChoice (choice), mTalkedToPlayer (talkedToPlayer)
-{}
+MWDialogue::Filter::Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer, const ConditionIndex* index)
+: mActor (actor), mChoice (choice), mTalkedToPlayer (talkedToPlayer), mIndex (index)
+{
+    if (mActor.isEmpty())
+        return;
+
+    mIndexActor.mId = Misc::StringUtils::lowerCase (mActor.getCellRef().getRefId());
+    mIndexActor.mIsCreature = (mActor.getType() != ESM::NPC::sRecordId);
+
+    if (!mIndexActor.mIsCreature)
+    {
+        const ESM::NPC* npc = mActor.get<ESM::NPC>()->mBase;
+        mIndexActor.mRace = Misc::StringUtils::lowerCase (npc->mRace);
+        mIndexActor.mClass = Misc::StringUtils::lowerCase (npc->mClass);
+        mIndexActor.mFaction = Misc::StringUtils::lowerCase (mActor.getClass().getPrimaryFaction (mActor));
+    }
+}
+
+void MWDialogue::Filter::getCandidates (const ESM::Dialogue& dialogue, ConditionIndex& unindexed,
+    std::vector<const ConditionIndex::Info*>& out) const
+{
+    const ConditionIndex::Topic* topic = mIndex != nullptr ? mIndex->find (dialogue) : nullptr;
+
+    if (topic == nullptr)
+        topic = &unindexed.add (dialogue);
+
+    topic->getCandidates (mIndexActor, out);
+}
 
 const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue, const bool fallbackToInfoRefusal) const
 {
@@ -621,11 +645,15 @@ const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue,
 
 std::vector<const ESM::DialInfo *> MWDialogue::Filter::listAll (const ESM::Dialogue& dialogue) const
 {
+    ConditionIndex unindexed;
+    std::vector<const ConditionIndex::Info*> candidates;
+    getCandidates (dialogue, unindexed, candidates);
+
     std::vector<const ESM::DialInfo *> infos;
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin(); iter!=dialogue.mInfo.end(); ++iter)
+    for (const ConditionIndex::Info* candidate : candidates)
     {
-        if (testActor (*iter))
-            infos.push_back(&*iter);
+        if (testActor (*candidate->mInfo))
+            infos.push_back(candidate->mInfo);
     }
     return infos;
 }
@@ -637,14 +665,18 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
     bool infoRefusal = false;
 
+    ConditionIndex unindexed;
+    std::vector<const ConditionIndex::Info*> candidates;
+    getCandidates (dialogue, unindexed, candidates);
+
     // Iterate over topic responses to find a matching one
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
-        iter!=dialogue.mInfo.end(); ++iter)
+    for (const ConditionIndex::Info* candidate : candidates)
     {
-        if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter))
+        const ESM::DialInfo& info = *candidate->mInfo;
+        if (testActor (info) && testPlayer (info) && testSelectStructs (*candidate))
         {
-            if (testDisposition (*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+            if (testDisposition (info, invertDisposition)) {
+                infos.push_back(&info);
                 if (!searchAll)
                     break;
             }
@@ -663,13 +695,17 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
         const ESM::Dialogue& infoRefusalDialogue = *dialogues.find ("Info Refusal");
 
-        for (ESM::Dialogue::InfoContainer::const_iterator iter = infoRefusalDialogue.mInfo.begin();
-            iter!=infoRefusalDialogue.mInfo.end(); ++iter)
-            if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter) && testDisposition(*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+        getCandidates (infoRefusalDialogue, unindexed, candidates);
+
+        for (const ConditionIndex::Info* candidate : candidates)
+        {
+            const ESM::DialInfo& info = *candidate->mInfo;
+            if (testActor (info) && testPlayer (info) && testSelectStructs (*candidate) && testDisposition(info, invertDisposition)) {
+                infos.push_back(&info);
                 if (!searchAll)
                     break;
             }
+        }
     }
 
     return infos;
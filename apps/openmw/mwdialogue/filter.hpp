@@ -5,6 +5,8 @@
 
 #include "../mwworld/ptr.hpp"
 
+#include "conditionindex.hpp"
+
 namespace ESM
 {
     struct DialInfo;
@@ -13,13 +15,18 @@ namespace ESM
 
 namespace MWDialogue
 {
-    class SelectWrapper;
-
     class Filter
     {
             MWWorld::Ptr mActor;
             int mChoice;
             bool mTalkedToPlayer;
+            const ConditionIndex* mIndex;
+            ConditionIndex::Actor mIndexActor;
+
+            void getCandidates (const ESM::Dialogue& dialogue, ConditionIndex& unindexed,
+                std::vector<const ConditionIndex::Info*>& out) const;
+            ///< Infos of \a dialogue that may be meant for the actor. \a unindexed is used when \a dialogue is not
+            /// in the index.
 
             bool testActor (const ESM::DialInfo& info) const;
             ///< Is this the right actor for this \a info?
@@ -27,7 +34,7 @@ namespace MWDialogue
             bool testPlayer (const ESM::DialInfo& info) const;
             ///< Do the player and the cell the player is currently in match \a info?
 
-            bool testSelectStructs (const ESM::DialInfo& info) const;
+            bool testSelectStructs (const ConditionIndex::Info& info) const;
             ///< Are all select structs matching?
 
             bool testDisposition (const ESM::DialInfo& info, bool invert=false) const;
@@ -53,7 +60,8 @@ namespace MWDialogue
 
         public:
 
-            Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer);
+            Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer, const ConditionIndex* index = nullptr);
+            ///< \param index Infos of all dialogues. Dialogues missing from it are indexed on the fly.
 
             std::vector<const ESM::DialInfo *> list (const ESM::Dialogue& dialogue,
                 bool fallbackToInfoRefusal, bool searchAll, bool invertDisposition=false) const;
@@ -1,17 +1,22 @@
 #ifndef GAME_MWDIALOGUE_KEYWORDSEARCH_H
 #define GAME_MWDIALOGUE_KEYWORDSEARCH_H
 
-#include <cctype>
-#include <map>
+#include <algorithm>
+#include <cstdint>
 #include <stdexcept>
+#include <utility>
 #include <vector>
-#include <algorithm>    // std::reverse
 
 #include <components/misc/stringops.hpp>
 
 namespace MWDialogue
 {
 
+/// Finds keywords in a text, case-insensitively for ASCII characters.
+///
+/// Keywords are stored in a trie that is turned into an Aho-Corasick automaton with flat transition arrays the first
+/// time a text is searched after the keywords changed, so a text is searched in a single pass regardless of the
+/// number of keywords.
 template <typename string_t, typename value_t>
 class KeywordSearch
 {
@@ -30,44 +35,48 @@ public:
     {
         if (keyword.empty())
             return;
-        seed_impl  (std::move(keyword), std::move (value), 0, mRoot);
+
+        std::uint32_t state = 0;
+        for (auto c : keyword)
+            state = getOrAddChild (state, fold (c));
+
+        Node& node = mNodes[state];
+        if (node.mKeyword >= 0)
+        {
+            if (keyword == mKeywords[node.mKeyword].first)
+                throw std::runtime_error ("duplicate keyword inserted");
+            return; // the same keyword in a different case, keep the first one
+        }
+
+        node.mKeyword = static_cast<std::int32_t> (mKeywords.size());
+        mKeywords.emplace_back (std::move (keyword), std::move (value));
+        mAutomaton.mValid = false;
     }
 
     void clear ()
     {
-        mRoot.mChildren.clear ();
-        mRoot.mKeyword.clear ();
+        mNodes.assign (1, Node());
+        mKeywords.clear ();
+        mAutomaton.mValid = false;
     }
 
-    bool containsKeyword (const string_t& keyword, value_t& value)
+    bool containsKeyword (const string_t& keyword, value_t& value) const
     {
-        typename Entry::childen_t::iterator current;
-        typename Entry::childen_t::iterator next;
-
-        current = mRoot.mChildren.find (Misc::StringUtils::toLower (*keyword.begin()));
-        if (current == mRoot.mChildren.end())
-            return false;
-        else if (current->second.mKeyword.size() && Misc::StringUtils::ciEqual(current->second.mKeyword, keyword))
-        {
-            value = current->second.mValue;
-            return true;
-        }
-
-        for (Point i = ++keyword.begin(); i != keyword.end(); ++i)
+        std::uint32_t state = 0;
+        for (auto c : keyword)
         {
-            next = current->second.mChildren.find(Misc::StringUtils::toLower (*i));
-            if (next == current->second.mChildren.end())
+            const auto child = findChild (mNodes[state], fold (c));
+            if (child == mNodes[state].mChildren.end())
                 return false;
-            if (Misc::StringUtils::ciEqual(next->second.mKeyword, keyword))
-            {
-                value = next->second.mValue;
-                return true;
-            }
-            current = next;
+            state = child->second;
         }
-        return false;
-    }
 
+        if (state == 0 || mNodes[state].mKeyword < 0)
+            return false;
+
+        value = mKeywords[mNodes[state].mKeyword].second;
+        return true;
+    }
 
     static bool sortMatches(const Match& left, const Match& right)
     {
@@ -76,76 +85,38 @@ public:
 
     void highlightKeywords (Point beg, Point end, std::vector<Match>& out) const
     {
-        std::vector<Match> matches;
-        for (Point i = beg; i != end; ++i)
+        const Automaton& automaton = getAutomaton();
+
+        // Collect the longest keyword starting at each position. All keywords ending at the current position are
+        // found through the dictionary links, and a longer keyword with the same beginning always ends later.
+        std::vector<std::pair<std::size_t, std::int32_t>> found;
+        std::uint32_t state = 0;
+        std::size_t position = 0;
+        for (Point i = beg; i != end; ++i, ++position)
         {
-            // check first character
-            typename Entry::childen_t::const_iterator candidate = mRoot.mChildren.find (Misc::StringUtils::toLower (*i));
-
-            // no match, on to next character
-            if (candidate == mRoot.mChildren.end ())
-                continue;
-
-            // see how far the match goes
-            Point j = i;
-
-            // some keywords might be longer variations of other keywords, so we definitely need a list of candidates
-            // the first element in the pair is length of the match, i.e. depth from the first character on
-            std::vector< typename std::pair<int, typename Entry::childen_t::const_iterator> > candidates;
-
-            while ((j + 1) != end)
+            state = automaton.next (state, fold (*i));
+            for (std::uint32_t s = automaton.mKeyword[state] >= 0 ? state : automaton.mDictionary[state]; s != 0;
+                s = automaton.mDictionary[s])
             {
-                typename Entry::childen_t::const_iterator next = candidate->second.mChildren.find (Misc::StringUtils::toLower (*++j));
-
-                if (next == candidate->second.mChildren.end ())
-                {
-                    if (candidate->second.mKeyword.size() > 0)
-                        candidates.push_back(std::make_pair((j-i), candidate));
-                    break;
-                }
-
-                candidate = next;
-
-                if (candidate->second.mKeyword.size() > 0)
-                    candidates.push_back(std::make_pair((j-i), candidate));
+                const std::int32_t keyword = automaton.mKeyword[s];
+                found.emplace_back (position + 1 - mKeywords[keyword].first.size(), keyword);
             }
+        }
 
-            if (candidates.empty())
-                continue; // didn't match enough to disambiguate, on to next character
-
-            // shorter candidates will be added to the vector first. however, we want to check against longer candidates first
-            std::reverse(candidates.begin(), candidates.end());
-
-            for (typename std::vector< std::pair<int, typename Entry::childen_t::const_iterator> >::iterator it = candidates.begin();
-                 it != candidates.end(); ++it)
-            {
-                candidate = it->second;
-                // try to match the rest of the keyword
-                Point k = i + it->first;
-                typename string_t::const_iterator t = candidate->second.mKeyword.begin () + (k - i);
-
-
-                while (k != end && t != candidate->second.mKeyword.end ())
-                {
-                    if (Misc::StringUtils::toLower (*k) != Misc::StringUtils::toLower (*t))
-                        break;
+        std::stable_sort (found.begin(), found.end(),
+            [] (const auto& left, const auto& right) { return left.first < right.first; });
 
-                    ++k, ++t;
-                }
-
-                // didn't match full keyword, try the next candidate
-                if (t != candidate->second.mKeyword.end ())
-                    continue;
-
-                // found a keyword, but there might still be longer keywords that start somewhere _within_ this keyword
-                // we will resolve these overlapping keywords later, choosing the longest one in case of conflict
-                Match match;
-                match.mValue = candidate->second.mValue;
-                match.mBeg = i;
-                match.mEnd = k;
-                matches.push_back(match);
-                break;
-            }
+        std::vector<Match> matches;
+        for (std::size_t i = 0; i < found.size(); ++i)
+        {
+            if (i + 1 < found.size() && found[i + 1].first == found[i].first)
+                continue;
+            const auto& [start, keyword] = found[i];
+            Match match;
+            match.mValue = mKeywords[keyword].second;
+            match.mBeg = beg + start;
+            match.mEnd = match.mBeg + mKeywords[keyword].first.size();
+            matches.push_back(match);
         }
 
         // resolve overlapping keywords
@@ -192,54 +163,133 @@ public:
 
 private:
 
-    struct Entry
-    {
-        typedef std::map <wchar_t, Entry> childen_t;
+    typedef std::vector<std::pair<unsigned char, std::uint32_t>> Children;
 
-        string_t mKeyword;
-        value_t mValue;
-        childen_t mChildren;
+    struct Node
+    {
+        Children mChildren; // sorted by character
+        std::int32_t mKeyword = -1;
     };
 
-    void seed_impl (string_t keyword, value_t value, size_t depth, Entry  & entry)
+    struct Automaton
     {
-        int ch = Misc::StringUtils::toLower (keyword.at (depth));
-
-        typename Entry::childen_t::iterator j = entry.mChildren.find (ch);
-
-        if (j == entry.mChildren.end ())
+        bool mValid = false;
+        std::uint32_t mRoot[256] = {};
+        // Transitions of state s are mEdgeChars/mEdgeTargets in [mFirstEdge[s], mFirstEdge[s + 1])
+        std::vector<std::uint32_t> mFirstEdge;
+        std::vector<unsigned char> mEdgeChars;
+        std::vector<std::uint32_t> mEdgeTargets;
+        std::vector<std::uint32_t> mFail;
+        // Closest state on the failure chain that ends a keyword, 0 if there is none
+        std::vector<std::uint32_t> mDictionary;
+        std::vector<std::int32_t> mKeyword;
+
+        std::uint32_t findEdge (std::uint32_t state, unsigned char c) const
         {
-            entry.mChildren [ch].mValue = std::move (value);
-            entry.mChildren [ch].mKeyword = std::move (keyword);
+            if (state == 0)
+                return mRoot[c];
+            const auto first = mEdgeChars.begin() + mFirstEdge[state];
+            const auto last = mEdgeChars.begin() + mFirstEdge[state + 1];
+            const auto it = std::lower_bound (first, last, c);
+            if (it == last || *it != c)
+                return 0;
+            return mEdgeTargets[it - mEdgeChars.begin()];
         }
-        else
+
+        std::uint32_t next (std::uint32_t state, unsigned char c) const
         {
-            if (j->second.mKeyword.size () > 0)
+            while (true)
             {
-                if (keyword == j->second.mKeyword)
-                    throw std::runtime_error ("duplicate keyword inserted");
+                const std::uint32_t target = findEdge (state, c);
+                if (target != 0 || state == 0)
+                    return target;
+                state = mFail[state];
+            }
+        }
+    };
 
-                value_t pushValue = j->second.mValue;
-                string_t pushKeyword = j->second.mKeyword;
+    std::vector<Node> mNodes = std::vector<Node> (1); // the first node is the root
+    std::vector<std::pair<string_t, value_t>> mKeywords;
+    mutable Automaton mAutomaton;
 
-                if (depth >= pushKeyword.size ())
-                    throw std::runtime_error ("unexpected");
+    static unsigned char fold (char c)
+    {
+        return static_cast<unsigned char> (Misc::StringUtils::toLower (c));
+    }
 
-                if (depth+1 < pushKeyword.size())
-                {
-                    seed_impl (std::move (pushKeyword), std::move (pushValue), depth+1, j->second);
-                    j->second.mKeyword.clear ();
-                }
+    static typename Children::const_iterator findChild (const Node& node, unsigned char c)
+    {
+        const auto it = std::lower_bound (node.mChildren.begin(), node.mChildren.end(), c,
+            [] (const auto& child, unsigned char value) { return child.first < value; });
+        if (it != node.mChildren.end() && it->first == c)
+            return it;
+        return node.mChildren.end();
+    }
+
+    std::uint32_t getOrAddChild (std::uint32_t state, unsigned char c)
+    {
+        Children& children = mNodes[state].mChildren;
+        const auto it = std::lower_bound (children.begin(), children.end(), c,
+            [] (const auto& child, unsigned char value) { return child.first < value; });
+        if (it != children.end() && it->first == c)
+            return it->second;
+        const auto child = static_cast<std::uint32_t> (mNodes.size());
+        children.emplace (it, c, child);
+        mNodes.emplace_back();
+        return child;
+    }
+
+    const Automaton& getAutomaton () const
+    {
+        if (mAutomaton.mValid)
+            return mAutomaton;
+
+        Automaton& automaton = mAutomaton;
+        const std::size_t count = mNodes.size();
+
+        std::fill (std::begin (automaton.mRoot), std::end (automaton.mRoot), 0);
+        for (const auto& [c, child] : mNodes[0].mChildren)
+            automaton.mRoot[c] = child;
+
+        automaton.mFirstEdge.resize (count + 1);
+        automaton.mEdgeChars.clear();
+        automaton.mEdgeTargets.clear();
+        automaton.mKeyword.resize (count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            automaton.mFirstEdge[i] = static_cast<std::uint32_t> (automaton.mEdgeChars.size());
+            for (const auto& [c, child] : mNodes[i].mChildren)
+            {
+                automaton.mEdgeChars.push_back (c);
+                automaton.mEdgeTargets.push_back (child);
+            }
+            automaton.mKeyword[i] = mNodes[i].mKeyword;
+        }
+        automaton.mFirstEdge[count] = static_cast<std::uint32_t> (automaton.mEdgeChars.size());
+
+        // Failure links point to the state of the longest proper suffix that is also in the trie, computed in
+        // breadth-first order so that the links of shallower states are ready when needed.
+        automaton.mFail.assign (count, 0);
+        automaton.mDictionary.assign (count, 0);
+        std::vector<std::uint32_t> queue;
+        queue.reserve (count);
+        for (const auto& child : mNodes[0].mChildren)
+            queue.push_back (child.second);
+        for (std::size_t head = 0; head < queue.size(); ++head)
+        {
+            const std::uint32_t state = queue[head];
+            for (const auto& [c, child] : mNodes[state].mChildren)
+            {
+                const std::uint32_t fail = automaton.next (automaton.mFail[state], c);
+                automaton.mFail[child] = fail;
+                automaton.mDictionary[child] = automaton.mKeyword[fail] >= 0 ? fail : automaton.mDictionary[fail];
+                queue.push_back (child);
             }
-            if (depth+1 == keyword.size())
-                j->second.mKeyword = value;
-            else // depth+1 < keyword.size()
-                seed_impl (std::move (keyword), std::move (value), depth+1, j->second);
         }
 
+        automaton.mValid = true;
+        return automaton;
     }
-
-    Entry mRoot;
 };
 
 }
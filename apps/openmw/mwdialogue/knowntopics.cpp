@@ -0,0 +1,59 @@
+#include "knowntopics.hpp"
+
+#include <components/esm3/loaddial.hpp>
+
+#include "../mwbase/dialoguemanager.hpp"
+
+#include "../mwworld/store.hpp"
+
+void MWDialogue::findActorKnownTopics (const MWWorld::Store<ESM::Dialogue>& dialogues, std::string_view actorId,
+    const std::set<std::string, Misc::StringUtils::CiComp>& knownTopics, const KnownTopicsContext& context,
+    ActorKnownTopics& result)
+{
+    result.clear();
+
+    for (const ESM::Dialogue& dialog : dialogues)
+    {
+        if (dialog.mType == ESM::Dialogue::Topic)
+        {
+            const ESM::DialInfo* answer = context.search (dialog);
+            auto topicId = Misc::StringUtils::lowerCase(dialog.mId);
+
+            if (answer != nullptr)
+            {
+                int topicFlags = 0;
+                if(!context.inJournal(topicId, answer->mId))
+                {
+                    // Does this dialogue contains some actor-specific answer?
+                    if (Misc::StringUtils::ciEqual(answer->mActor, actorId))
+                        topicFlags |= MWBase::DialogueManager::TopicType::Specific;
+                }
+                else
+                    topicFlags |= MWBase::DialogueManager::TopicType::Exhausted;
+                result.insert (std::make_pair(dialog.mId, ActorKnownTopicInfo {topicFlags, answer}));
+            }
+
+        }
+    }
+
+    // If response to a topic leads to a new topic, the original topic is not exhausted.
+
+    for (auto& [dialogId, topicInfo] : result)
+    {
+        // If the topic is not marked as exhausted, we don't need to do anything about it.
+        // If the topic will not be shown to the player, the flag actually does not matter.
+
+        if (!(topicInfo.mFlags & MWBase::DialogueManager::TopicType::Exhausted) ||
+            !knownTopics.count(dialogId))
+            continue;
+
+        for (const auto& topicId : context.parseTopicIds(topicInfo.mInfo->mResponse))
+        {
+            if (result.count( topicId ) && !knownTopics.count( topicId ))
+            {
+                topicInfo.mFlags &= ~MWBase::DialogueManager::TopicType::Exhausted;
+                break;
+            }
+        }
+    }
+}
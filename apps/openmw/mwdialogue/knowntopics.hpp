@@ -0,0 +1,58 @@
+#ifndef GAME_MWDIALOGUE_KNOWNTOPICS_H
+#define GAME_MWDIALOGUE_KNOWNTOPICS_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <components/misc/stringops.hpp>
+
+namespace ESM
+{
+    struct Dialogue;
+    struct DialInfo;
+}
+
+namespace MWWorld
+{
+    template <class T>
+    class Store;
+}
+
+namespace MWDialogue
+{
+    struct ActorKnownTopicInfo
+    {
+        int mFlags;
+        const ESM::DialInfo* mInfo;
+    };
+
+    using ActorKnownTopics = std::map<std::string, ActorKnownTopicInfo, Misc::StringUtils::CiComp>;
+
+    /// \brief Game state the topics known by an actor depend on
+    class KnownTopicsContext
+    {
+        public:
+
+            virtual ~KnownTopicsContext() = default;
+
+            virtual const ESM::DialInfo* search (const ESM::Dialogue& dialogue) const = 0;
+            ///< \return The response of the actor to the topic, nullptr if there is none.
+
+            virtual bool inJournal (const std::string& topicId, const std::string& infoId) const = 0;
+
+            virtual std::vector<std::string> parseTopicIds (const std::string& text) const = 0;
+            ///< \return Ids of the topics linked from \a text.
+    };
+
+    void findActorKnownTopics (const MWWorld::Store<ESM::Dialogue>& dialogues, std::string_view actorId,
+        const std::set<std::string, Misc::StringUtils::CiComp>& knownTopics, const KnownTopicsContext& context,
+        ActorKnownTopics& result);
+    ///< Replace the contents of \a result with the topics \a actorId has a response to, and their flags.
+    ///
+    /// \param knownTopics The topics the player knows.
+}
+
+#endif
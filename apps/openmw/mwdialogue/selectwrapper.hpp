@@ -5,10 +5,9 @@
 
 namespace MWDialogue
 {
+    /// \brief Select rule of a dialogue info, decoded once so that testing it doesn't need to parse the rule string
     class SelectWrapper
     {
-            const ESM::DialInfo::SelectStruct& mSelect;
-
         public:
 
             enum Function
@@ -57,11 +56,19 @@ namespace MWDialogue
 
         private:
 
-            Function decodeFunction() const;
+            Function mFunction;
+            Type mType;
+            int mArgument;
+            bool mNpcOnly;
+            char mComparison;
+            ESM::VarType mValueType;
+            int mIntValue;
+            float mFloatValue;
+            std::string mName;
 
         public:
 
-            SelectWrapper (const ESM::DialInfo::SelectStruct& select);
+            explicit SelectWrapper (const ESM::DialInfo::SelectStruct& select);
 
             Function getFunction() const;
 
@@ -78,7 +85,7 @@ namespace MWDialogue
 
             bool selectCompare (bool value) const;
 
-            std::string getName() const;
+            const std::string& getName() const;
             ///< Return case-smashed name.
     };
 }
@@ -10,6 +10,9 @@
 
 #include <mutex>
 
+#include "../mwbase/environment.hpp"
+#include "../mwbase/luamanager.hpp"
+
 #ifndef BT_NO_PROFILE
 
 namespace
@@ -97,6 +100,12 @@ namespace MWGui
                 ("LogEdit", MyGUI::FloatCoord(0,0,1,1), MyGUI::Align::Stretch);
         mLogView->setEditReadOnly(true);
 
+        MyGUI::TabItem* itemLuaProfiler = mTabControl->addItem("Lua Profiler");
+        itemLuaProfiler->setCaptionWithReplacing("#{DebugMenu:LuaProfiler}");
+        mLuaProfiler = itemLuaProfiler->createWidgetReal<MyGUI::EditBox>
+                ("LogEdit", MyGUI::FloatCoord(0,0,1,1), MyGUI::Align::Stretch);
+        mLuaProfiler->setEditReadOnly(true);
+
 #ifndef BT_NO_PROFILE
         MyGUI::TabItem* item = mTabControl->addItem("Physics Profiler");
         item->setCaptionWithReplacing("#{DebugMenu:PhysicsProfiler}");
@@ -191,6 +200,20 @@ namespace MWGui
             mLogView->setVScrollPosition(scrollPos);
     }
 
+    void DebugWindow::updateLuaProfile()
+    {
+        if (mLuaProfiler->isTextSelection()) // pause updating while user is trying to copy text
+            return;
+
+        std::string report = MWBase::Environment::get().getLuaManager()->getResourceUsageReport();
+        for (size_t pos = report.find('#'); pos != std::string::npos; pos = report.find('#', pos + 2))
+            report.insert(pos, 1, '#');
+
+        size_t previousPos = mLuaProfiler->getVScrollPosition();
+        mLuaProfiler->setCaption(report);
+        mLuaProfiler->setVScrollPosition(std::min(previousPos, mLuaProfiler->getVScrollRange()-1));
+    }
+
     void DebugWindow::updateBulletProfile()
     {
 #ifndef BT_NO_PROFILE
@@ -216,6 +239,8 @@ namespace MWGui
 
         if (mTabControl->getIndexSelected() == 0)
             updateLogView();
+        else if (mTabControl->getIndexSelected() == 1)
+            updateLuaProfile();
         else
             updateBulletProfile();
     }
@@ -430,8 +430,17 @@ namespace MWGui
 
 
         // Decode screenshot
-        const std::vector<char>& data = mCurrentSlot->mProfile.mScreenshot;
-        Files::IMemStream instream (&data[0], data.size());
+        std::vector<char> data;
+        try
+        {
+            data = MWState::readScreenshot(*mCurrentSlot);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Error: Failed to read savegame screenshot: " << e.what();
+            return;
+        }
+        Files::IMemStream instream (data.data(), data.size());
 
         osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
         if (!readerwriter)
@@ -46,6 +46,24 @@ namespace MWLua
             });
         };
 
+        api["getScriptStats"] = [lua = context.mLua, manager = context.mLuaManager]
+        {
+            sol::table res = lua->newTable();
+            const std::vector<LuaUtil::ScriptStats>& stats = manager->getScriptStats();
+            const LuaUtil::ScriptsConfiguration& conf = lua->getConfiguration();
+            for (size_t i = 0; i < stats.size() && i < conf.size(); ++i)
+            {
+                if (stats[i].mMemoryUsage == 0 && stats[i].mAvgInstructionCount < 1)
+                    continue;
+                sol::table scriptStats = lua->newTable();
+                scriptStats["path"] = conf[i].mScriptPath;
+                scriptStats["memoryUsage"] = stats[i].mMemoryUsage;
+                scriptStats["instructionCount"] = stats[i].mAvgInstructionCount;
+                res.add(scriptStats);
+            }
+            return res;
+        };
+
         return LuaUtil::makeReadOnly(api);
     }
 }
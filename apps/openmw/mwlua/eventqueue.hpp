@@ -14,30 +14,29 @@ namespace LuaUtil
     class UserdataSerializer;
 }
 
-namespace sol
-{
-    class state;
-}
-
 namespace MWLua
 {
+    // Event data is a copy made in the receiver's format by LuaUtil::copy, so it can be passed to the receiver
+    // without serialization. It is serialized only when queued events are saved.
     struct GlobalEvent
     {
         std::string mEventName;
-        std::string mEventData;
+        sol::main_object mEventData;
     };
     struct LocalEvent
     {
         ObjectId mDest;
         std::string mEventName;
-        std::string mEventData;
+        sol::main_object mEventData;
     };
     using GlobalEventQueue = std::vector<GlobalEvent>;
     using LocalEventQueue = std::vector<LocalEvent>;
 
-    void loadEvents(sol::state& lua, ESM::ESMReader& esm, GlobalEventQueue&, LocalEventQueue&,
-                    const std::map<int, int>& contentFileMapping, const LuaUtil::UserdataSerializer* serializer);
-    void saveEvents(ESM::ESMWriter& esm, const GlobalEventQueue&, const LocalEventQueue&);
+    void loadEvents(sol::state_view& lua, ESM::ESMReader& esm, GlobalEventQueue&, LocalEventQueue&,
+                    const std::map<int, int>& contentFileMapping, const LuaUtil::UserdataSerializer* globalSerializer,
+                    const LuaUtil::UserdataSerializer* localSerializer);
+    void saveEvents(ESM::ESMWriter& esm, const GlobalEventQueue&, const LocalEventQueue&,
+                    const LuaUtil::UserdataSerializer* serializer);
 }
 
 #endif // MWLUA_EVENTQUEUE_H
@@ -82,19 +82,25 @@ namespace MWLua
         aiPackage["sideWithTarget"] = sol::readonly_property([](const AiPackage& p) { return p.sideWithTarget(); });
         aiPackage["destPosition"] = sol::readonly_property([](const AiPackage& p) { return p.getDestination(); });
 
-        selfAPI["_getActiveAiPackage"] = [](SelfObject& self) -> sol::optional<std::shared_ptr<AiPackage>>
+        selfAPI["_getActiveAiPackage"] = [worldView=context.mWorldView](SelfObject& self) -> sol::optional<std::shared_ptr<AiPackage>>
         {
             const MWWorld::Ptr& ptr = self.ptr();
+            const auto lock = worldView->lockEngine();
             MWMechanics::AiSequence& ai = ptr.getClass().getCreatureStats(ptr).getAiSequence();
             if (ai.isEmpty())
                 return sol::nullopt;
             else
                 return *ai.begin();
         };
-        selfAPI["_iterateAndFilterAiSequence"] = [](SelfObject& self, sol::function callback)
+        selfAPI["_iterateAndFilterAiSequence"] = [worldView=context.mWorldView](SelfObject& self, sol::function callback)
         {
             const MWWorld::Ptr& ptr = self.ptr();
-            MWMechanics::AiSequence& ai = ptr.getClass().getCreatureStats(ptr).getAiSequence();
+            // The callback is a Lua function, so the lock is not held while it runs
+            MWMechanics::AiSequence& ai = [&] () -> MWMechanics::AiSequence&
+            {
+                const auto lock = worldView->lockEngine();
+                return ptr.getClass().getCreatureStats(ptr).getAiSequence();
+            }();
 
             ai.erasePackagesIf([&](auto& entry)
             {
@@ -102,28 +108,32 @@ namespace MWLua
                 return !keep;
             });
         };
-        selfAPI["_startAiCombat"] = [](SelfObject& self, const LObject& target)
+        selfAPI["_startAiCombat"] = [worldView=context.mWorldView](SelfObject& self, const LObject& target)
         {
             const MWWorld::Ptr& ptr = self.ptr();
+            const auto lock = worldView->lockEngine();
             MWMechanics::AiSequence& ai = ptr.getClass().getCreatureStats(ptr).getAiSequence();
             ai.stack(MWMechanics::AiCombat(target.ptr()), ptr);
         };
-        selfAPI["_startAiPursue"] = [](SelfObject& self, const LObject& target)
+        selfAPI["_startAiPursue"] = [worldView=context.mWorldView](SelfObject& self, const LObject& target)
         {
             const MWWorld::Ptr& ptr = self.ptr();
+            const auto lock = worldView->lockEngine();
             MWMechanics::AiSequence& ai = ptr.getClass().getCreatureStats(ptr).getAiSequence();
             ai.stack(MWMechanics::AiPursue(target.ptr()), ptr);
         };
-        selfAPI["_startAiFollow"] = [](SelfObject& self, const LObject& target)
+        selfAPI["_startAiFollow"] = [worldView=context.mWorldView](SelfObject& self, const LObject& target)
         {
             const MWWorld::Ptr& ptr = self.ptr();
+            const auto lock = worldView->lockEngine();
             MWMechanics::AiSequence& ai = ptr.getClass().getCreatureStats(ptr).getAiSequence();
             ai.stack(MWMechanics::AiFollow(target.ptr()), ptr);
         };
-        selfAPI["_startAiEscort"] = [](SelfObject& self, const LObject& target, LCell cell,
+        selfAPI["_startAiEscort"] = [worldView=context.mWorldView](SelfObject& self, const LObject& target, LCell cell,
                                        float duration, const osg::Vec3f& dest)
         {
             const MWWorld::Ptr& ptr = self.ptr();
+            const auto lock = worldView->lockEngine();
             MWMechanics::AiSequence& ai = ptr.getClass().getCreatureStats(ptr).getAiSequence();
             // TODO: change AiEscort implementation to accept ptr instead of a non-unique refId.
             const std::string& refId = target.ptr().getCellRef().getRefId();
@@ -134,16 +144,18 @@ namespace MWLua
             else
                 ai.stack(MWMechanics::AiEscort(refId, esmCell->mName, gameHoursDuration, dest.x(), dest.y(), dest.z(), false), ptr);
         };
-        selfAPI["_startAiWander"] = [](SelfObject& self, int distance, float duration)
+        selfAPI["_startAiWander"] = [worldView=context.mWorldView](SelfObject& self, int distance, float duration)
         {
             const MWWorld::Ptr& ptr = self.ptr();
+            const auto lock = worldView->lockEngine();
             MWMechanics::AiSequence& ai = ptr.getClass().getCreatureStats(ptr).getAiSequence();
             int gameHoursDuration = static_cast<int>(std::ceil(duration / 3600.0));
             ai.stack(MWMechanics::AiWander(distance, gameHoursDuration, 0, {}, false), ptr);
         };
-        selfAPI["_startAiTravel"] = [](SelfObject& self, const osg::Vec3f& target)
+        selfAPI["_startAiTravel"] = [worldView=context.mWorldView](SelfObject& self, const osg::Vec3f& target)
         {
             const MWWorld::Ptr& ptr = self.ptr();
+            const auto lock = worldView->lockEngine();
             MWMechanics::AiSequence& ai = ptr.getClass().getCreatureStats(ptr).getAiSequence();
             ai.stack(MWMechanics::AiTravel(target.x(), target.y(), target.z(), false), ptr);
         };
@@ -54,7 +54,7 @@ namespace MWLua
     {
         auto* lua = context.mLua;
         sol::table api(lua->sol(), sol::create);
-        api["API_REVISION"] = 29;
+        api["API_REVISION"] = 32;
         api["quit"] = [lua]()
         {
             Log(Debug::Warning) << "Quit requested by a Lua script.\n" << lua->debugTraceback();
@@ -62,7 +62,8 @@ namespace MWLua
         };
         api["sendGlobalEvent"] = [context](std::string eventName, const sol::object& eventData)
         {
-            context.mGlobalEventQueue->push_back({std::move(eventName), LuaUtil::serialize(eventData, context.mSerializer)});
+            context.mGlobalEventQueue->push_back({std::move(eventName),
+                LuaUtil::copy(context.mLua->sol(), eventData, context.mSerializer, context.mGlobalEventSerializer)});
         };
         addTimeBindings(api, context, false);
         api["l10n"] = [l10n=context.mL10n](const std::string& context, const sol::object &fallbackLocale) {
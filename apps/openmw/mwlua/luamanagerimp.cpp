@@ -1,6 +1,13 @@
 #include "luamanagerimp.hpp"
 
+#include <algorithm>
+#include <condition_variable>
 #include <filesystem>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
 
 #include <components/debug/debuglog.hpp>
 
@@ -10,6 +17,7 @@
 
 #include <components/settings/settings.hpp>
 
+#include <components/lua/serialization.hpp>
 #include <components/lua/utilpackage.hpp>
 
 #include <components/lua_ui/util.hpp>
@@ -29,9 +37,144 @@
 
 namespace MWLua
 {
+    namespace
+    {
+        uint64_t getUnsignedSetting(const std::string& name)
+        {
+            return static_cast<uint64_t>(std::max<int64_t>(0, Settings::Manager::getInt64(name, "Lua")));
+        }
+
+        // All Lua states of a LuaManager share the memory limit.
+        LuaUtil::LuaStateSettings createLuaStateSettings(const std::shared_ptr<std::atomic<int64_t>>& memoryUsage)
+        {
+            LuaUtil::LuaStateSettings settings;
+            settings.mSharedMemoryUsage = memoryUsage;
+            settings.mInstructionLimit = getUnsignedSetting("instruction limit per call");
+            settings.mMemoryLimit = getUnsignedSetting("memory limit");
+            settings.mSmallAllocMaxSize = getUnsignedSetting("small alloc max size");
+            settings.mProfiler = Settings::Manager::getBool("lua profiler", "Lua");
+            return settings;
+        }
+
+        // Event data is a reference to a value in the sender's Lua state, so it has to be copied if the receiver
+        // is in another one.
+        sol::main_object transferEventData(const sol::main_object& data, LuaUtil::LuaState& receiver,
+                                           const LuaUtil::UserdataSerializer* serializer)
+        {
+            if (data.get_type() == sol::type::lua_nil || data.lua_state() == receiver.sol().lua_state())
+                return data;
+            return LuaUtil::deserialize(receiver.sol(), LuaUtil::serialize(data, serializer), serializer);
+        }
+
+        std::string formatMemory(int64_t bytes)
+        {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(1) << static_cast<double>(bytes) / (1024 * 1024) << " MiB";
+            return out.str();
+        }
+    }
+
+    class LuaManager::ShardWorker
+    {
+    public:
+        ShardWorker() : mThread([this] { threadBody(); }) {}
+
+        ~ShardWorker()
+        {
+            {
+                std::lock_guard<std::mutex> lk(mMutex);
+                mJoinRequest = true;
+            }
+            mCV.notify_all();
+            mThread.join();
+        }
+
+        void run(std::function<void()> job)
+        {
+            {
+                std::lock_guard<std::mutex> lk(mMutex);
+                mJob = std::move(job);
+            }
+            mCV.notify_all();
+        }
+
+        // Waits until the job is finished and rethrows the exception if the job has thrown one.
+        void wait()
+        {
+            std::unique_lock<std::mutex> lk(mMutex);
+            mCV.wait(lk, [&]{ return !mJob; });
+            if (mError)
+                std::rethrow_exception(std::exchange(mError, nullptr));
+        }
+
+    private:
+        void threadBody()
+        {
+            std::unique_lock<std::mutex> lk(mMutex);
+            while (true)
+            {
+                mCV.wait(lk, [&]{ return mJob || mJoinRequest; });
+                if (mJoinRequest)
+                    break;
+                try
+                {
+                    mJob();
+                }
+                catch (...)
+                {
+                    mError = std::current_exception();
+                }
+                mJob = nullptr;
+                mCV.notify_all();
+            }
+        }
+
+        std::mutex mMutex;
+        std::condition_variable mCV;
+        std::function<void()> mJob;
+        std::exception_ptr mError;
+        bool mJoinRequest = false;
+        std::thread mThread;
+    };
+
+    struct LuaManager::Shard
+    {
+        Shard(const VFS::Manager* vfs, const LuaUtil::ScriptsConfiguration* conf, const std::string& libsDir,
+              const std::shared_ptr<std::atomic<int64_t>>& memoryUsage)
+            : mLua(vfs, conf, createLuaStateSettings(memoryUsage))
+            , mL10n(vfs, &mLua)
+        {
+            mLua.addInternalLibSearchPath(libsDir);
+        }
+
+        LuaUtil::LuaState mLua;
+        LuaUtil::L10nManager mL10n;
+        LuaUtil::LuaStorage mGlobalStorage{mLua.sol()};  // read-only copy of LuaManager::mGlobalStorage
+        sol::table mNearbyPackage;
+        sol::table mLocalStoragePackage;
+        GlobalEventQueue mGlobalEvents;
+        LocalEventQueue mLocalEvents;
+        std::vector<CallbackWithData> mQueuedCallbacks;
+        std::vector<std::unique_ptr<Action>> mActionQueue;
+        ShardWorker mWorker;  // Should be the last, so the thread is stopped before the rest is destroyed.
+    };
+
+    void LuaManager::GlobalStorageMirror::valueChanged(std::string_view section, std::string_view key,
+                                                       const sol::object& value) const
+    {
+        for (const std::unique_ptr<Shard>& shard : *mShards)
+            shard->mGlobalStorage.setSingleValue(section, key, value);
+    }
+
+    void LuaManager::GlobalStorageMirror::sectionReplaced(std::string_view section,
+                                                          const sol::optional<sol::table>& values) const
+    {
+        for (const std::unique_ptr<Shard>& shard : *mShards)
+            shard->mGlobalStorage.setSectionValues(section, values);
+    }
 
     LuaManager::LuaManager(const VFS::Manager* vfs, const std::string& libsDir)
-        : mLua(vfs, &mConfiguration)
+        : mLua(vfs, &mConfiguration, createLuaStateSettings(mMemoryUsage))
         , mUiResourceManager(vfs)
         , mL10n(vfs, &mLua)
     {
@@ -44,8 +187,23 @@ namespace MWLua
         mLocalLoader = createUserdataSerializer(true, mWorldView.getObjectRegistry(), &mContentFileMapping);
 
         mGlobalScripts.setSerializer(mGlobalSerializer.get());
+
+        const int numThreads = Settings::Manager::getInt("lua num threads", "Lua");
+        mLuaStates.push_back(&mLua);
+        for (int i = 1; i < numThreads; ++i)
+        {
+            mShards.push_back(std::make_unique<Shard>(vfs, &mConfiguration, libsDir, mMemoryUsage));
+            mLuaStates.push_back(&mShards.back()->mLua);
+        }
+        if (!mShards.empty())
+        {
+            Log(Debug::Info) << "Local Lua scripts are processed in " << numThreads << " Lua states";
+            mGlobalStorage.setListener(&mGlobalStorageMirror);
+        }
     }
 
+    LuaManager::~LuaManager() = default;
+
     void LuaManager::initConfiguration()
     {
         mConfiguration.init(MWBase::Environment::get().getWorld()->getStore().getLuaScriptsCfg());
@@ -57,8 +215,14 @@ namespace MWLua
 
     void LuaManager::initL10n()
     {
+        const std::vector<std::string> preferredLocales = Settings::Manager::getStringArray("preferred locales", "General");
         mL10n.init();
-        mL10n.setPreferredLocales(Settings::Manager::getStringArray("preferred locales", "General"));
+        mL10n.setPreferredLocales(preferredLocales);
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            shard->mL10n.init();
+            shard->mL10n.setPreferredLocales(preferredLocales);
+        }
     }
 
     void LuaManager::init()
@@ -72,6 +236,8 @@ namespace MWLua
         context.mLocalEventQueue = &mLocalEvents;
         context.mGlobalEventQueue = &mGlobalEvents;
         context.mSerializer = mGlobalSerializer.get();
+        context.mGlobalEventSerializer = mGlobalSerializer.get();
+        context.mLocalEventSerializer = mLocalSerializer.get();
 
         Context localContext = context;
         localContext.mIsGlobal = false;
@@ -100,10 +266,102 @@ namespace MWLua
         mPostprocessingPackage = initPostprocessingPackage(localContext);
         mDebugPackage = initDebugPackage(localContext);
 
+        for (const std::unique_ptr<Shard>& shard : mShards)
+            initShard(*shard, localContext);
+
         initConfiguration();
         mInitialized = true;
     }
 
+    void LuaManager::initShard(Shard& shard, const Context& localContext)
+    {
+        Context context = localContext;
+        context.mLua = &shard.mLua;
+        context.mL10n = &shard.mL10n;
+        context.mLocalEventQueue = &shard.mLocalEvents;
+        context.mGlobalEventQueue = &shard.mGlobalEvents;
+
+        // Local scripts can't get global objects, but copies of event data sent to global scripts contain them
+        // until the events are moved to the main Lua state.
+        Context globalContext = context;
+        globalContext.mIsGlobal = true;
+        globalContext.mSerializer = mGlobalSerializer.get();
+        initObjectBindingsForGlobalScripts(globalContext);
+        initCellBindingsForGlobalScripts(globalContext);
+
+        initObjectBindingsForLocalScripts(context);
+        initCellBindingsForLocalScripts(context);
+        LocalScripts::initializeSelfPackage(context);
+        LuaUtil::LuaStorage::initLuaBindings(shard.mLua.sol());
+
+        shard.mLua.addCommonPackage("openmw.async", getAsyncPackageInitializer(context));
+        shard.mLua.addCommonPackage("openmw.util", LuaUtil::initUtilPackage(shard.mLua.sol()));
+        shard.mLua.addCommonPackage("openmw.core", initCorePackage(context));
+        shard.mLua.addCommonPackage("openmw.types", initTypesPackage(context));
+
+        shard.mNearbyPackage = initNearbyPackage(context);
+        shard.mLocalStoragePackage = initLocalStoragePackage(context, &shard.mGlobalStorage);
+    }
+
+    size_t LuaManager::getShardIndex(const MWWorld::Ptr& ptr) const
+    {
+        const bool isPlayer = getLiveCellRefType(ptr.mRef) == ESM::REC_INTERNAL_PLAYER;
+        return MWLua::getShardIndex(getId(ptr), isPlayer, mLuaStates.size());
+    }
+
+    size_t LuaManager::getShardIndex(const LuaUtil::LuaState& lua) const
+    {
+        return MWLua::getShardIndex(lua, mLuaStates);
+    }
+
+    LuaUtil::LuaState& LuaManager::getShardLua(size_t index)
+    {
+        return index == 0 ? mLua : mShards[index - 1]->mLua;
+    }
+
+    void LuaManager::runInShards(const std::function<void(size_t)>& fn)
+    {
+        for (size_t i = 0; i < mShards.size(); ++i)
+            mShards[i]->mWorker.run([&fn, i] { fn(i + 1); });
+        std::exception_ptr error;
+        try
+        {
+            fn(0);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            try
+            {
+                shard->mWorker.wait();
+            }
+            catch (...)
+            {
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    void LuaManager::collectShardEvents()
+    {
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            for (GlobalEvent& e : shard->mGlobalEvents)
+                mGlobalEvents.push_back({std::move(e.mEventName),
+                                         transferEventData(e.mEventData, mLua, mGlobalSerializer.get())});
+            shard->mGlobalEvents.clear();
+            for (LocalEvent& e : shard->mLocalEvents)
+                mLocalEvents.push_back(std::move(e));
+            shard->mLocalEvents.clear();
+        }
+    }
+
     std::string LuaManager::translate(const std::string& contextName, const std::string& key)
     {
         return mL10n.translate(contextName, key);
@@ -114,7 +372,15 @@ namespace MWLua
         auto globalPath = std::filesystem::path(userConfigPath) / "global_storage.bin";
         auto playerPath = std::filesystem::path(userConfigPath) / "player_storage.bin";
         if (std::filesystem::exists(globalPath))
+        {
+            // Copy the whole storage once instead of mirroring every loaded value.
+            mGlobalStorage.setListener(nullptr);
             mGlobalStorage.load(globalPath.string());
+            for (const std::unique_ptr<Shard>& shard : mShards)
+                shard->mGlobalStorage.assign(mGlobalStorage);
+            if (!mShards.empty())
+                mGlobalStorage.setListener(&mGlobalStorageMirror);
+        }
         if (std::filesystem::exists(playerPath))
             mPlayerStorage.load(playerPath.string());
     }
@@ -146,11 +412,18 @@ namespace MWLua
 
         mWorldView.update();
 
+        collectShardEvents();
         std::vector<GlobalEvent> globalEvents = std::move(mGlobalEvents);
         std::vector<LocalEvent> localEvents = std::move(mLocalEvents);
         mGlobalEvents = std::vector<GlobalEvent>();
         mLocalEvents = std::vector<LocalEvent>();
 
+        // Local scripts are grouped by Lua state, every group is processed in its own thread.
+        // Everything that touches global scripts or several Lua states is done between `runInShards` calls.
+        std::vector<std::vector<LocalScripts*>> activeScripts(mShards.size() + 1);
+        for (LocalScripts* scripts : mActiveLocalScripts)
+            activeScripts[getShardIndex(scripts->getLuaState())].push_back(scripts);
+
         if (!mWorldView.isPaused())
         {  // Update time and process timers
             double simulationTime = mWorldView.getSimulationTime() + frameDuration;
@@ -158,30 +431,49 @@ namespace MWLua
             double gameTime = mWorldView.getGameTime();
 
             mGlobalScripts.processTimers(simulationTime, gameTime);
-            for (LocalScripts* scripts : mActiveLocalScripts)
-                scripts->processTimers(simulationTime, gameTime);
+            runInShards([&](size_t shard)
+            {
+                for (LocalScripts* scripts : activeScripts[shard])
+                    scripts->processTimers(simulationTime, gameTime);
+            });
         }
 
         // Receive events
         for (GlobalEvent& e : globalEvents)
             mGlobalScripts.receiveEvent(e.mEventName, e.mEventData);
+        std::vector<std::vector<std::pair<LocalScripts*, const LocalEvent*>>> localEventsByShard(mShards.size() + 1);
         for (LocalEvent& e : localEvents)
         {
             LObject obj(e.mDest, objectRegistry);
             LocalScripts* scripts = obj.isValid() ? obj.ptr().getRefData().getLuaScripts() : nullptr;
             if (scripts)
-                scripts->receiveEvent(e.mEventName, e.mEventData);
+            {
+                LuaUtil::LuaState& lua = scripts->getLuaState();
+                e.mEventData = transferEventData(e.mEventData, lua, mLocalSerializer.get());
+                localEventsByShard[getShardIndex(lua)].emplace_back(scripts, &e);
+            }
             else
                 Log(Debug::Debug) << "Ignored event " << e.mEventName << " to L" << idToString(e.mDest)
                                   << ". Object not found or has no attached scripts";
         }
+        runInShards([&](size_t shard)
+        {
+            for (const auto& [scripts, e] : localEventsByShard[shard])
+                scripts->receiveEvent(e->mEventName, e->mEventData);
+        });
 
         // Run queued callbacks
-        for (CallbackWithData& c : mQueuedCallbacks)
-            c.mCallback.call(c.mArg);
-        mQueuedCallbacks.clear();
+        runInShards([&](size_t shard)
+        {
+            std::vector<CallbackWithData>& callbacks = shard == 0 ? mQueuedCallbacks : mShards[shard - 1]->mQueuedCallbacks;
+            for (CallbackWithData& c : callbacks)
+                c.mCallback.call(c.mArg);
+            callbacks.clear();
+        });
 
         // Engine handlers in local scripts
+        std::vector<std::vector<std::pair<LocalScripts*, const LocalScripts::EngineEvent*>>> engineEventsByShard(
+            mShards.size() + 1);
         for (const LocalEngineEvent& e : mLocalEngineEvents)
         {
             LObject obj(e.mDest, objectRegistry);
@@ -193,15 +485,19 @@ namespace MWLua
             }
             LocalScripts* scripts = obj.ptr().getRefData().getLuaScripts();
             if (scripts)
-                scripts->receiveEngineEvent(e.mEvent);
+                engineEventsByShard[getShardIndex(scripts->getLuaState())].emplace_back(scripts, &e.mEvent);
         }
-        mLocalEngineEvents.clear();
-
-        if (!mWorldView.isPaused())
+        runInShards([&](size_t shard)
         {
-            for (LocalScripts* scripts : mActiveLocalScripts)
-                scripts->update(frameDuration);
-        }
+            for (const auto& [scripts, event] : engineEventsByShard[shard])
+                scripts->receiveEngineEvent(*event);
+            if (!mWorldView.isPaused())
+            {
+                for (LocalScripts* scripts : activeScripts[shard])
+                    scripts->update(frameDuration);
+            }
+        });
+        mLocalEngineEvents.clear();
 
         // Engine handlers in global scripts
         if (mPlayerChanged)
@@ -266,10 +562,89 @@ namespace MWLua
         for (std::unique_ptr<Action>& action : mActionQueue)
             action->safeApply(mWorldView);
         mActionQueue.clear();
-        
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            for (std::unique_ptr<Action>& action : shard->mActionQueue)
+                action->safeApply(mWorldView);
+            shard->mActionQueue.clear();
+        }
+
         if (mTeleportPlayerAction)
             mTeleportPlayerAction->safeApply(mWorldView);
         mTeleportPlayerAction.reset();
+
+        // The Lua thread is finished at this point, so the stats are consistent.
+        updateScriptStats();
+        if (mResourceUsageReportRequested)
+        {
+            mResourceUsageReport = formatResourceUsageReport();
+            mResourceUsageReportRequested = false;
+        }
+    }
+
+    std::string LuaManager::getResourceUsageReport()
+    {
+        mResourceUsageReportRequested = true;
+        return mResourceUsageReport;
+    }
+
+    std::string LuaManager::formatResourceUsageReport() const
+    {
+        if (!mLua.getSettings().mProfiler)
+            return "Lua profiler is disabled; set \"[Lua] lua profiler\" to true in settings.cfg to enable it.";
+
+        std::ostringstream out;
+        if (mLua.isMemoryTracked())
+        {
+            int64_t totalMemoryUsage = mLua.getTotalMemoryUsage();
+            int64_t smallAllocMemoryUsage = mLua.getSmallAllocMemoryUsage();
+            for (const std::unique_ptr<Shard>& shard : mShards)
+            {
+                totalMemoryUsage += shard->mLua.getTotalMemoryUsage();
+                smallAllocMemoryUsage += shard->mLua.getSmallAllocMemoryUsage();
+            }
+            out << "Total memory usage: " << formatMemory(totalMemoryUsage) << "\n";
+            out << "Small allocations (not attributed to scripts): " << formatMemory(smallAllocMemoryUsage) << "\n";
+        }
+        else
+            out << "Memory usage is not available with this Lua implementation\n";
+        if (!mShards.empty())
+            out << "Lua states: " << mShards.size() + 1 << "\n";
+        out << "\n";
+
+        const std::vector<LuaUtil::ScriptStats>& stats = mScriptStats;
+        std::vector<size_t> order;
+        for (size_t i = 0; i < stats.size() && i < mConfiguration.size(); ++i)
+            if (stats[i].mMemoryUsage > 0 || stats[i].mAvgInstructionCount >= 1)
+                order.push_back(i);
+        std::sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+            return stats[l].mAvgInstructionCount > stats[r].mAvgInstructionCount;
+        });
+
+        out << std::setw(16) << "Instructions" << std::setw(12) << "Memory" << "   Script\n";
+        out << std::setw(16) << "per frame" << std::setw(12) << "(KiB)" << "\n";
+        for (size_t i : order)
+            out << std::setw(16) << static_cast<int64_t>(stats[i].mAvgInstructionCount)
+                << std::setw(12) << stats[i].mMemoryUsage / 1024 << "   " << mConfiguration[i].mScriptPath << "\n";
+        return out.str();
+    }
+
+    void LuaManager::updateScriptStats()
+    {
+        mLua.updateScriptStats();
+        mScriptStats = mLua.getScriptStats();
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            shard->mLua.updateScriptStats();
+            const std::vector<LuaUtil::ScriptStats>& stats = shard->mLua.getScriptStats();
+            if (stats.size() > mScriptStats.size())
+                mScriptStats.resize(stats.size());
+            for (size_t i = 0; i < stats.size(); ++i)
+            {
+                mScriptStats[i].mMemoryUsage += stats[i].mMemoryUsage;
+                mScriptStats[i].mAvgInstructionCount += stats[i].mAvgInstructionCount;
+            }
+        }
     }
 
     void LuaManager::clear()
@@ -297,6 +672,14 @@ namespace MWLua
         }
         mGlobalStorage.clearTemporaryAndRemoveCallbacks();
         mPlayerStorage.clearTemporaryAndRemoveCallbacks();
+        mQueuedCallbacks.clear();
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            shard->mGlobalEvents.clear();
+            shard->mLocalEvents.clear();
+            shard->mQueuedCallbacks.clear();
+            shard->mGlobalStorage.assign(mGlobalStorage);
+        }
     }
 
     void LuaManager::setupPlayer(const MWWorld::Ptr& ptr)
@@ -430,16 +813,27 @@ namespace MWLua
             scripts->addPackage("openmw.storage", mPlayerStoragePackage);
             scripts->addPackage("openmw.postprocessing", mPostprocessingPackage);
             scripts->addPackage("openmw.debug", mDebugPackage);
+            scripts->addPackage("openmw.nearby", mNearbyPackage);
         }
         else
         {
-            scripts = std::make_shared<LocalScripts>(&mLua, LObject(getId(ptr), mWorldView.getObjectRegistry()));
+            const size_t shardIndex = getShardIndex(ptr);
+            scripts = std::make_shared<LocalScripts>(&getShardLua(shardIndex),
+                                                     LObject(getId(ptr), mWorldView.getObjectRegistry()));
             if (!autoStartConf.has_value())
                 autoStartConf = mConfiguration.getLocalConf(type, ptr.getCellRef().getRefId(), getId(ptr));
             scripts->setAutoStartConf(std::move(*autoStartConf));
-            scripts->addPackage("openmw.storage", mLocalStoragePackage);
+            if (shardIndex == 0)
+            {
+                scripts->addPackage("openmw.storage", mLocalStoragePackage);
+                scripts->addPackage("openmw.nearby", mNearbyPackage);
+            }
+            else
+            {
+                scripts->addPackage("openmw.storage", mShards[shardIndex - 1]->mLocalStoragePackage);
+                scripts->addPackage("openmw.nearby", mShards[shardIndex - 1]->mNearbyPackage);
+            }
         }
-        scripts->addPackage("openmw.nearby", mNearbyPackage);
         scripts->setSerializer(mLocalSerializer.get());
 
         MWWorld::RefData& refData = ptr.getRefData();
@@ -455,7 +849,8 @@ namespace MWLua
         ESM::LuaScripts globalScripts;
         mGlobalScripts.save(globalScripts);
         globalScripts.save(writer);
-        saveEvents(writer, mGlobalEvents, mLocalEvents);
+        collectShardEvents();
+        saveEvents(writer, mGlobalEvents, mLocalEvents, mGlobalSerializer.get());
 
         writer.endRecord(ESM::REC_LUAM);
     }
@@ -468,7 +863,8 @@ namespace MWLua
         mWorldView.load(reader);
         ESM::LuaScripts globalScripts;
         globalScripts.load(reader);
-        loadEvents(mLua.sol(), reader, mGlobalEvents, mLocalEvents, mContentFileMapping, mGlobalLoader.get());
+        loadEvents(mLua.sol(), reader, mGlobalEvents, mLocalEvents, mContentFileMapping, mGlobalLoader.get(),
+                   mLocalLoader.get());
 
         mGlobalScripts.setSavedDataDeserializer(mGlobalLoader.get());
         mGlobalScripts.load(globalScripts);
@@ -512,6 +908,11 @@ namespace MWLua
         mUiResourceManager.clear();
         mLua.dropScriptCache();
         mL10n.clear();
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            shard->mLua.dropScriptCache();
+            shard->mL10n.clear();
+        }
         initConfiguration();
 
         {  // Reload global scripts
@@ -521,9 +922,16 @@ namespace MWLua
             mGlobalScripts.load(data);
         }
 
-        for (const auto& [id, ptr] : mWorldView.getObjectRegistry()->mObjectMapping)
-        {  // Reload local scripts
-            LocalScripts* scripts = ptr.getRefData().getLuaScripts();
+        // Reload local scripts. The mapping is unordered, so sort the ids to reload in the same order every time.
+        const auto& objectMapping = mWorldView.getObjectRegistry()->mObjectMapping;
+        std::vector<ObjectId> ids;
+        ids.reserve(objectMapping.size());
+        for (const auto& [id, ptr] : objectMapping)
+            ids.push_back(id);
+        std::sort(ids.begin(), ids.end());
+        for (const ObjectId& id : ids)
+        {
+            LocalScripts* scripts = objectMapping.at(id).getRefData().getLuaScripts();
             if (scripts == nullptr)
                 continue;
             scripts->setSavedDataDeserializer(mLocalSerializer.get());
@@ -555,6 +963,7 @@ namespace MWLua
     }
 
     LuaManager::Action::Action(LuaUtil::LuaState* state)
+        : mState(state)
     {
         static const bool luaDebug = Settings::Manager::getBool("lua debug", "Lua");
         if (luaDebug)
@@ -595,9 +1004,28 @@ namespace MWLua
         };
     }
 
-    void LuaManager::addAction(std::function<void()> action, std::string_view name)
+    void LuaManager::queueCallback(LuaUtil::Callback callback, sol::object arg)
+    {
+        const size_t shardIndex = MWLua::getShardIndex(callback, mLuaStates);
+        if (shardIndex == 0)
+            mQueuedCallbacks.push_back({std::move(callback), std::move(arg)});
+        else
+            mShards[shardIndex - 1]->mQueuedCallbacks.push_back({std::move(callback), std::move(arg)});
+    }
+
+    void LuaManager::addAction(std::function<void()> action, std::string_view name, LuaUtil::LuaState* lua)
     {
-        mActionQueue.push_back(std::make_unique<FunctionAction>(&mLua, std::move(action), name));
+        addAction(std::make_unique<FunctionAction>(lua ? lua : &mLua, std::move(action), name));
+    }
+
+    void LuaManager::addAction(std::unique_ptr<Action>&& action)
+    {
+        // Every Lua state has its own queue, because local scripts of different states run in parallel.
+        const size_t shardIndex = action->getLuaState() ? getShardIndex(*action->getLuaState()) : 0;
+        if (shardIndex == 0)
+            mActionQueue.push_back(std::move(action));
+        else
+            mShards[shardIndex - 1]->mActionQueue.push_back(std::move(action));
     }
 
 }
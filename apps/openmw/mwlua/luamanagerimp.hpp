@@ -1,8 +1,12 @@
 #ifndef MWLUA_LUAMANAGERIMP_H
 #define MWLUA_LUAMANAGERIMP_H
 
+#include <atomic>
+#include <functional>
 #include <map>
+#include <memory>
 #include <set>
+#include <vector>
 
 #include <components/lua/l10n.hpp>
 #include <components/lua/luastate.hpp>
@@ -19,6 +23,7 @@
 #include "globalscripts.hpp"
 #include "localscripts.hpp"
 #include "playerscripts.hpp"
+#include "shardindex.hpp"
 #include "worldview.hpp"
 
 namespace MWLua
@@ -28,6 +33,7 @@ namespace MWLua
     {
     public:
         LuaManager(const VFS::Manager* vfs, const std::string& libsDir);
+        ~LuaManager() override;
 
         // Called by engine.cpp before UI setup.
         void initL10n();
@@ -40,6 +46,8 @@ namespace MWLua
 
         // Called by engine.cpp every frame. For performance reasons it works in a separate
         // thread (in parallel with osg Cull). Can not use scene graph.
+        // If "lua num threads" > 1, local scripts of different objects are processed in parallel in several
+        // Lua states (see `Shard`).
         void update();
 
         std::string translate(const std::string& contextName, const std::string& key) override;
@@ -85,12 +93,17 @@ namespace MWLua
             virtual void apply(WorldView&) const = 0;
             virtual std::string toString() const = 0;
 
+            // The Lua state of the caller. Actions are applied in the order of Lua states, then in the order of adding.
+            LuaUtil::LuaState* getLuaState() const { return mState; }
+
         private:
+            LuaUtil::LuaState* mState;
             std::string mCallerTraceback;
         };
 
-        void addAction(std::function<void()> action, std::string_view name = "");
-        void addAction(std::unique_ptr<Action>&& action) { mActionQueue.push_back(std::move(action)); }
+        // `lua` is the Lua state of the caller; nullptr means the main Lua state.
+        void addAction(std::function<void()> action, std::string_view name = "", LuaUtil::LuaState* lua = nullptr);
+        void addAction(std::unique_ptr<Action>&& action);
         void addTeleportPlayerAction(std::unique_ptr<Action>&& action) { mTeleportPlayerAction = std::move(action); }
 
         // Saving
@@ -107,11 +120,8 @@ namespace MWLua
 
         void handleConsoleCommand(const std::string& consoleMode, const std::string& command, const MWWorld::Ptr& selectedPtr) override;
 
-        // Used to call Lua callbacks from C++
-        void queueCallback(LuaUtil::Callback callback, sol::object arg)
-        {
-            mQueuedCallbacks.push_back({std::move(callback), std::move(arg)});
-        }
+        // Used to call Lua callbacks from C++. The callback runs in the Lua state of the script that created it.
+        void queueCallback(LuaUtil::Callback callback, sol::object arg);
 
         // Wraps Lua callback into an std::function.
         // NOTE: Resulted function is not thread safe. Can not be used while LuaManager::update() or
@@ -126,16 +136,64 @@ namespace MWLua
 
         bool isProcessingInputEvents() const { return mProcessingInputEvents; }
 
+        // The report is generated in `synchronizedUpdate`, so the returned one can be one frame old.
+        std::string getResourceUsageReport() override;
+
+        // Sum over all Lua states. Updated in `synchronizedUpdate`.
+        const std::vector<LuaUtil::ScriptStats>& getScriptStats() const { return mScriptStats; }
+
     private:
+        // An additional Lua state that runs local scripts of a part of the objects in its own thread, in parallel
+        // with the main Lua state. Objects are assigned to shards by ObjectId, the player always stays in the main
+        // state. Scripts in different states interact only via events (copied between the states by LuaManager)
+        // and actions. Has its own read-only copy of the global storage.
+        struct Shard;
+        class ShardWorker;
+
+        // Copies changes of the global storage to the shards.
+        class GlobalStorageMirror final : public LuaUtil::LuaStorage::Listener
+        {
+        public:
+            explicit GlobalStorageMirror(const std::vector<std::unique_ptr<Shard>>* shards) : mShards(shards) {}
+            void valueChanged(std::string_view section, std::string_view key, const sol::object& value) const override;
+            void sectionReplaced(std::string_view section, const sol::optional<sol::table>& values) const override;
+
+        private:
+            const std::vector<std::unique_ptr<Shard>>* mShards;
+        };
+
         void initConfiguration();
+        void initShard(Shard& shard, const Context& localContext);
         LocalScripts* createLocalScripts(const MWWorld::Ptr& ptr,
                                          std::optional<LuaUtil::ScriptIdsWithInitializationData> autoStartConf = std::nullopt);
+        std::string formatResourceUsageReport() const;
+        void updateScriptStats();
 
+        // Index 0 is the main Lua state, index i > 0 is mShards[i - 1].
+        size_t getShardIndex(const MWWorld::Ptr& ptr) const;
+        size_t getShardIndex(const LuaUtil::LuaState& lua) const;
+        LuaUtil::LuaState& getShardLua(size_t index);
+
+        // Calls `fn(shardIndex)` for the main Lua state in the current thread and for every shard in its own
+        // thread. Returns when all calls are finished.
+        void runInShards(const std::function<void(size_t)>& fn);
+
+        // Moves events sent from shards to mGlobalEvents and mLocalEvents.
+        void collectShardEvents();
         bool mInitialized = false;
         bool mGlobalScriptsStarted = false;
         bool mProcessingInputEvents = false;
+        bool mResourceUsageReportRequested = false;
+        std::string mResourceUsageReport;
+        std::vector<LuaUtil::ScriptStats> mScriptStats;
         LuaUtil::ScriptsConfiguration mConfiguration;
+        // Memory used by mLua and all shards, the memory limit is applied to it.
+        std::shared_ptr<std::atomic<int64_t>> mMemoryUsage = std::make_shared<std::atomic<int64_t>>(0);
         LuaUtil::LuaState mLua;
+        // Declared before everything that can hold Lua values of the shards (event and action queues, callbacks),
+        // so the shards' Lua states are closed last, like mLua.
+        std::vector<std::unique_ptr<Shard>> mShards;
+        LuaStates mLuaStates;
         LuaUi::ResourceManager mUiResourceManager;
         LuaUtil::L10nManager mL10n;
         sol::table mNearbyPackage;
@@ -190,6 +248,8 @@ namespace MWLua
 
         LuaUtil::LuaStorage mGlobalStorage{mLua.sol()};
         LuaUtil::LuaStorage mPlayerStorage{mLua.sol()};
+
+        GlobalStorageMirror mGlobalStorageMirror{&mShards};
     };
 
 }
@@ -1,5 +1,10 @@
 #include "luabindings.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
 #include <components/lua/luastate.hpp>
 #include <components/detournavigator/navigator.hpp>
 #include <components/detournavigator/navigatorutils.hpp>
@@ -11,6 +16,7 @@
 
 #include "luamanagerimp.hpp"
 #include "worldview.hpp"
+#include "types/types.hpp"
 
 namespace sol
 {
@@ -20,6 +26,100 @@ namespace sol
 
 namespace MWLua
 {
+    namespace
+    {
+        struct RayCastingOptions
+        {
+            MWWorld::Ptr mIgnore;
+            int mCollisionType = MWPhysics::CollisionType_Default;
+            float mRadius = 0;
+        };
+
+        RayCastingOptions parseRayCastingOptions(const sol::optional<sol::table>& options)
+        {
+            RayCastingOptions res;
+            if (options)
+            {
+                sol::optional<LObject> ignoreObj = options->get<sol::optional<LObject>>("ignore");
+                if (ignoreObj) res.mIgnore = ignoreObj->ptr();
+                res.mCollisionType = options->get<sol::optional<int>>("collisionType").value_or(res.mCollisionType);
+                res.mRadius = options->get<sol::optional<float>>("radius").value_or(0);
+            }
+            return res;
+        }
+
+        MWPhysics::RayCastingResult castRay(const osg::Vec3f& from, const osg::Vec3f& to, const RayCastingOptions& options)
+        {
+            const MWPhysics::RayCastingInterface* rayCasting = MWBase::Environment::get().getWorld()->getRayCasting();
+            if (options.mRadius <= 0)
+                return rayCasting->castRay(from, to, options.mIgnore, std::vector<MWWorld::Ptr>(), options.mCollisionType);
+            else
+            {
+                if (!options.mIgnore.isEmpty()) throw std::logic_error("Currently castRay doesn't support `ignore` when radius > 0");
+                return rayCasting->castSphere(from, to, options.mRadius, options.mCollisionType);
+            }
+        }
+
+        sol::optional<unsigned int> getTypeOption(const sol::table& options, const sol::table& packageToType,
+            std::string_view functionName)
+        {
+            const auto& t = options.get<sol::optional<sol::table>>("type");
+            if (!t)
+                return sol::nullopt;
+            const sol::optional<unsigned int> type = packageToType.get<sol::optional<unsigned int>>(*t);
+            if (!type)
+                throw std::runtime_error("Incorrect type argument in nearby." + std::string(functionName));
+            return type;
+        }
+
+        struct ObjectQuery
+        {
+            sol::optional<unsigned int> mType;
+            int mCollisionType = MWPhysics::CollisionType_World | MWPhysics::CollisionType_Door
+                | MWPhysics::CollisionType_Actor;
+            std::size_t mLimit = std::numeric_limits<std::size_t>::max();
+        };
+
+        ObjectQuery parseObjectQuery(const sol::optional<sol::table>& options, const sol::table& packageToType,
+            std::string_view functionName)
+        {
+            ObjectQuery res;
+            if (options)
+            {
+                res.mType = getTypeOption(*options, packageToType, functionName);
+                res.mCollisionType = options->get<sol::optional<int>>("collisionType").value_or(res.mCollisionType);
+                res.mLimit = options->get<sol::optional<std::size_t>>("limit").value_or(res.mLimit);
+            }
+            return res;
+        }
+
+        // Takes the candidates from the physics broadphase and keeps the ones for which `getDistance` returns
+        // a value. The result is sorted by this distance.
+        template <class GetDistance>
+        LObjectList findObjects(const osg::Vec3f& min, const osg::Vec3f& max, const ObjectQuery& query,
+            GetDistance&& getDistance)
+        {
+            std::vector<MWWorld::Ptr> candidates;
+            MWBase::Environment::get().getWorld()->getRayCasting()->getObjectsInBox(min, max, query.mCollisionType,
+                candidates);
+            std::vector<std::pair<float, ObjectId>> found;
+            for (const MWWorld::Ptr& ptr : candidates)
+            {
+                if (ptr.isEmpty() || (query.mType && getLiveCellRefType(ptr.mRef) != *query.mType))
+                    continue;
+                if (const std::optional<float> distance = getDistance(ptr.getRefData().getPosition().asVec3()))
+                    found.emplace_back(*distance, getId(ptr));
+            }
+            const std::size_t size = std::min(found.size(), query.mLimit);
+            std::partial_sort(found.begin(), found.begin() + size, found.end());
+            ObjectIdList res = std::make_shared<std::vector<ObjectId>>();
+            res->reserve(size);
+            for (std::size_t i = 0; i < size; ++i)
+                res->push_back(found[i].second);
+            return LObjectList{res};
+        }
+    }
+
     sol::table initNearbyPackage(const Context& context)
     {
         sol::table api(context.mLua->sol(), sol::create);
@@ -65,24 +165,39 @@ namespace MWLua
 
         api["castRay"] = [](const osg::Vec3f& from, const osg::Vec3f& to, sol::optional<sol::table> options)
         {
-            MWWorld::Ptr ignore;
-            int collisionType = MWPhysics::CollisionType_Default;
-            float radius = 0;
-            if (options)
+            return castRay(from, to, parseRayCastingOptions(options));
+        };
+        api["castRays"] = [](const sol::object& from, const sol::table& to, sol::optional<sol::table> options,
+            sol::this_state lua)
+        {
+            const RayCastingOptions rayOptions = parseRayCastingOptions(options);
+            // `to` is either a list of vectors or a flat list of coordinates as returned by getPositions
+            const bool flat = to.get<sol::object>(1).get_type() == sol::type::number;
+            if (flat && to.size() % 3 != 0)
+                throw std::runtime_error("nearby.castRays: the length of a list of coordinates must be a multiple of 3");
+            const std::size_t count = flat ? to.size() / 3 : to.size();
+            sol::optional<osg::Vec3f> commonFrom;
+            sol::optional<sol::table> fromList;
+            if (from.is<osg::Vec3f>())
+                commonFrom = from.as<osg::Vec3f>();
+            else if (from.is<sol::table>())
             {
-                sol::optional<LObject> ignoreObj = options->get<sol::optional<LObject>>("ignore");
-                if (ignoreObj) ignore = ignoreObj->ptr();
-                collisionType = options->get<sol::optional<int>>("collisionType").value_or(collisionType);
-                radius = options->get<sol::optional<float>>("radius").value_or(0);
+                fromList = from.as<sol::table>();
+                if (fromList->size() != count)
+                    throw std::runtime_error("nearby.castRays: `from` and `to` must have the same length");
             }
-            const MWPhysics::RayCastingInterface* rayCasting = MWBase::Environment::get().getWorld()->getRayCasting();
-            if (radius <= 0)
-                return rayCasting->castRay(from, to, ignore, std::vector<MWWorld::Ptr>(), collisionType);
             else
+                throw std::runtime_error("nearby.castRays: `from` must be a vector or a list of vectors");
+            sol::table res(lua, sol::new_table(static_cast<int>(count)));
+            for (std::size_t i = 1; i <= count; ++i)
             {
-                if (!ignore.isEmpty()) throw std::logic_error("Currently castRay doesn't support `ignore` when radius > 0");
-                return rayCasting->castSphere(from, to, radius, collisionType);
+                const osg::Vec3f source = commonFrom ? *commonFrom : fromList->get<osg::Vec3f>(i);
+                const osg::Vec3f target = flat
+                    ? osg::Vec3f(to.get<float>(3 * i - 2), to.get<float>(3 * i - 1), to.get<float>(3 * i))
+                    : to.get<osg::Vec3f>(i);
+                res[i] = castRay(source, target, rayOptions);
             }
+            return res;
         };
         // TODO: async raycasting
         /*api["asyncCastRay"] = [luaManager = context.mLuaManager](
@@ -110,14 +225,14 @@ namespace MWLua
             return res;
         };
         api["asyncCastRenderingRay"] =
-            [manager=context.mLuaManager](const LuaUtil::Callback& callback, const osg::Vec3f& from, const osg::Vec3f& to)
+            [manager=context.mLuaManager, lua=context.mLua](const LuaUtil::Callback& callback, const osg::Vec3f& from, const osg::Vec3f& to)
         {
             manager->addAction([manager, callback, from, to]
             {
                 MWPhysics::RayCastingResult res;
                 MWBase::Environment::get().getWorld()->castRenderingRay(res, from, to, false, false);
                 manager->queueCallback(callback, sol::make_object(callback.mFunc.lua_state(), res));
-            });
+            }, "AsyncCastRenderingRay", lua);
         };
 
         api["activators"] = LObjectList{worldView->getActivatorsInScene()};
@@ -126,6 +241,95 @@ namespace MWLua
         api["doors"] = LObjectList{worldView->getDoorsInScene()};
         api["items"] = LObjectList{worldView->getItemsInScene()};
 
+        api["getPositions"] = [worldView](const LObjectList& list, sol::this_state lua)
+        {
+            // Plain numbers, so no userdata is created per object
+            ObjectRegistry* registry = worldView->getObjectRegistry();
+            sol::table res(lua, sol::new_table(static_cast<int>(list.mIds->size() * 3)));
+            for (std::size_t i = 0; i < list.mIds->size(); ++i)
+            {
+                const ObjectId& id = (*list.mIds)[i];
+                const MWWorld::Ptr ptr = registry->getPtr(id, true);
+                if (ptr.isEmpty())
+                    throw std::runtime_error("Object is not available: " + idToString(id));
+                const ESM::Position& position = ptr.getRefData().getPosition();
+                res[3 * i + 1] = position.pos[0];
+                res[3 * i + 2] = position.pos[1];
+                res[3 * i + 3] = position.pos[2];
+            }
+            return res;
+        };
+        api["selectObjects"] = [worldView, ids=getPackageToTypeTable(context.mLua->sol())](
+            const LObjectList& list, const sol::table& options)
+        {
+            const sol::optional<unsigned int> type = getTypeOption(options, ids, "selectObjects");
+            const sol::optional<osg::Vec3f> position = options.get<sol::optional<osg::Vec3f>>("position");
+            const sol::optional<float> maxDistance = options.get<sol::optional<float>>("maxDistance");
+            if (maxDistance && !position)
+                throw std::runtime_error("nearby.selectObjects requires `position` if `maxDistance` is set");
+            const float maxDistance2 = maxDistance ? *maxDistance * *maxDistance : 0;
+
+            ObjectRegistry* registry = worldView->getObjectRegistry();
+            ObjectIdList res = std::make_shared<std::vector<ObjectId>>();
+            for (const ObjectId& id : *list.mIds)
+            {
+                const MWWorld::Ptr ptr = registry->getPtr(id, true);
+                if (ptr.isEmpty())
+                    continue;
+                if (type && getLiveCellRefType(ptr.mRef) != *type)
+                    continue;
+                if (maxDistance && (ptr.getRefData().getPosition().asVec3() - *position).length2() > maxDistance2)
+                    continue;
+                res->push_back(id);
+            }
+            return LObjectList{res};
+        };
+
+        api["getObjectsInRadius"] = [ids=getPackageToTypeTable(context.mLua->sol())](
+            const osg::Vec3f& center, float radius, sol::optional<sol::table> options)
+        {
+            const osg::Vec3f extents(radius, radius, radius);
+            return findObjects(center - extents, center + extents, parseObjectQuery(options, ids, "getObjectsInRadius"),
+                [&](const osg::Vec3f& position) -> std::optional<float>
+                {
+                    const float distance = (position - center).length();
+                    if (distance > radius)
+                        return std::nullopt;
+                    return distance;
+                });
+        };
+        api["getObjectsInBox"] = [ids=getPackageToTypeTable(context.mLua->sol())](
+            const osg::Vec3f& min, const osg::Vec3f& max, sol::optional<sol::table> options)
+        {
+            const osg::Vec3f center = (min + max) / 2;
+            return findObjects(min, max, parseObjectQuery(options, ids, "getObjectsInBox"),
+                [&](const osg::Vec3f& position) -> std::optional<float>
+                {
+                    for (int i = 0; i < 3; ++i)
+                        if (position[i] < min[i] || position[i] > max[i])
+                            return std::nullopt;
+                    return (position - center).length();
+                });
+        };
+        api["getObjectsInCone"] = [ids=getPackageToTypeTable(context.mLua->sol())](
+            const osg::Vec3f& origin, osg::Vec3f direction, float angle, float maxDistance,
+            sol::optional<sol::table> options)
+        {
+            if (direction.normalize() == 0)
+                throw std::runtime_error("nearby.getObjectsInCone: direction can not be zero");
+            const float cosAngle = std::cos(angle);
+            const osg::Vec3f extents(maxDistance, maxDistance, maxDistance);
+            return findObjects(origin - extents, origin + extents, parseObjectQuery(options, ids, "getObjectsInCone"),
+                [&](const osg::Vec3f& position) -> std::optional<float>
+                {
+                    const osg::Vec3f offset = position - origin;
+                    const float distance = offset.length();
+                    if (distance > maxDistance || offset * direction < distance * cosAngle)
+                        return std::nullopt;
+                    return distance;
+                });
+        };
+
         api["NAVIGATOR_FLAGS"] = LuaUtil::makeStrictReadOnly(
             context.mLua->tableFromPairs<std::string_view, DetourNavigator::Flag>({
                 {"Walk", DetourNavigator::Flag_walk},
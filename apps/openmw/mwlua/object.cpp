@@ -65,6 +65,7 @@ namespace MWLua
 
     void ObjectRegistry::clear()
     {
+        std::unique_lock lock(mMutex);
         mObjectMapping.clear();
         mChanged = false;
         mUpdateCounter = 0;
@@ -74,6 +75,7 @@ namespace MWLua
     MWWorld::Ptr ObjectRegistry::getPtr(ObjectId id, bool local)
     {
         MWWorld::Ptr ptr;
+        std::shared_lock lock(mMutex);
         auto it = mObjectMapping.find(id);
         if (it != mObjectMapping.end())
             ptr = it->second;
@@ -91,6 +93,7 @@ namespace MWLua
 
     ObjectId ObjectRegistry::registerPtr(const MWWorld::Ptr& ptr)
     {
+        std::unique_lock lock(mMutex);
         ObjectId id = ptr.getCellRef().getOrAssignRefNum(mLastAssignedId);
         mChanged = true;
         mObjectMapping[id] = ptr;
@@ -100,6 +103,7 @@ namespace MWLua
     ObjectId ObjectRegistry::deregisterPtr(const MWWorld::Ptr& ptr)
     {
         ObjectId id = getId(ptr);
+        std::unique_lock lock(mMutex);
         mChanged = true;
         mObjectMapping.erase(id);
         return id;
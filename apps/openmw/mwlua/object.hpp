@@ -3,6 +3,10 @@
 
 #include <typeindex>
 #include <map>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <sol/sol.hpp>
 
@@ -21,6 +25,7 @@ namespace MWLua
     bool isMarker(const MWWorld::Ptr& ptr);
 
     // Holds a mapping ObjectId -> MWWord::Ptr.
+    // `getPtr`, `registerPtr` and `deregisterPtr` are thread safe, because local scripts can run in several threads.
     class ObjectRegistry
     {
     public:
@@ -47,8 +52,9 @@ namespace MWLua
 
         bool mChanged = false;
         int64_t mUpdateCounter = 0;
-        std::map<ObjectId, MWWorld::Ptr> mObjectMapping;
+        std::unordered_map<ObjectId, MWWorld::Ptr> mObjectMapping;
         ObjectId mLastAssignedId;
+        mutable std::shared_mutex mMutex;
     };
 
     // Lua scripts can't use MWWorld::Ptr directly, because lifetime of a script can be longer than lifetime of Ptr.
@@ -110,7 +116,15 @@ namespace MWLua
 
     using ObjectIdList = std::shared_ptr<std::vector<ObjectId>>;
     template <typename Obj>
-    struct ObjectList { ObjectIdList mIds; };
+    struct ObjectList
+    {
+        ObjectIdList mIds;
+
+        // Lua objects returned by indexing the list. An object is reused while the same id stays at its index,
+        // so iterating over a list that changes only a bit per frame doesn't create new userdata every time.
+        // The list can be indexed from a coroutine, so the cache refers to the main thread.
+        mutable std::vector<std::pair<ObjectId, sol::main_object>> mCache = {};
+    };
     using GObjectList = ObjectList<GObject>;
     using LObjectList = ObjectList<LObject>;
 
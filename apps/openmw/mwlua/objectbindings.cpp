@@ -123,18 +123,25 @@ namespace MWLua
         void registerObjectList(const std::string& prefix, const Context& context)
         {
             using ListT = ObjectList<ObjectT>;
-            sol::state& lua = context.mLua->sol();
+            sol::state_view& lua = context.mLua->sol();
             ObjectRegistry* registry = context.mWorldView->getObjectRegistry();
             sol::usertype<ListT> listT = lua.new_usertype<ListT>(prefix + "ObjectList");
             listT[sol::meta_function::to_string] =
                 [](const ListT& list) { return "{" + std::to_string(list.mIds->size()) + " objects}"; };
             listT[sol::meta_function::length] = [](const ListT& list) { return list.mIds->size(); };
-            listT[sol::meta_function::index] = [registry](const ListT& list, size_t index)
+            listT[sol::meta_function::index] = [registry](const ListT& list, size_t index, sol::this_state lua)
             {
-                if (index > 0 && index <= list.mIds->size())
-                    return ObjectT((*list.mIds)[index - 1], registry);
-                else
+                if (index == 0 || index > list.mIds->size())
                     throw std::runtime_error("Index out of range");
+                list.mCache.resize(list.mIds->size());
+                const ObjectId id = (*list.mIds)[index - 1];
+                auto& [cachedId, object] = list.mCache[index - 1];
+                if (!object.valid() || !(cachedId == id))
+                {
+                    cachedId = id;
+                    object = sol::main_object(sol::make_object(lua, ObjectT(id, registry)));
+                }
+                return object;
             };
             listT[sol::meta_function::pairs] = lua["ipairsForArray"].template get<sol::function>();
             listT[sol::meta_function::ipairs] = lua["ipairsForArray"].template get<sol::function>();
@@ -175,7 +182,8 @@ namespace MWLua
             objectT[sol::meta_function::to_string] = &ObjectT::toString;
             objectT["sendEvent"] = [context](const ObjectT& dest, std::string eventName, const sol::object& eventData)
             {
-                context.mLocalEventQueue->push_back({dest.id(), std::move(eventName), LuaUtil::serialize(eventData, context.mSerializer)});
+                context.mLocalEventQueue->push_back({dest.id(), std::move(eventName),
+                    LuaUtil::copy(context.mLua->sol(), eventData, context.mSerializer, context.mLocalEventSerializer)});
             };
 
             objectT["activateBy"] = [context](const ObjectT& o, const ObjectT& actor)
@@ -286,6 +294,8 @@ namespace MWLua
                     throw std::runtime_error(std::string("Incorrect type argument in inventory:getAll: " + LuaUtil::toString(*type)));
 
                 const MWWorld::Ptr& ptr = inventory.mObj.ptr();
+                // Both getContainerStore and the iteration can resolve levelled lists
+                const auto lock = worldView->lockEngine();
                 MWWorld::ContainerStore& store = ptr.getClass().getContainerStore(ptr);
                 ObjectIdList list = std::make_shared<std::vector<ObjectId>>();
                 auto it = store.begin(mask);
@@ -298,9 +308,10 @@ namespace MWLua
                 return ObjectList<ObjectT>{list};
             };
 
-            inventoryT["countOf"] = [](const InventoryT& inventory, const std::string& recordId)
+            inventoryT["countOf"] = [worldView=context.mWorldView](const InventoryT& inventory, const std::string& recordId)
             {
                 const MWWorld::Ptr& ptr = inventory.mObj.ptr();
+                const auto lock = worldView->lockEngine();
                 MWWorld::ContainerStore& store = ptr.getClass().getContainerStore(ptr);
                 return store.count(recordId);
             };
@@ -0,0 +1,48 @@
+#ifndef MWLUA_SHARDINDEX_H
+#define MWLUA_SHARDINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <components/esm3/cellref.hpp>
+#include <components/lua/luastate.hpp>
+#include <components/lua/scriptscontainer.hpp>
+
+namespace MWLua
+{
+    // Local scripts run in several Lua states. Index 0 is the main Lua state, index i > 0 is the shard i - 1.
+    using LuaStates = std::vector<const LuaUtil::LuaState*>;
+
+    // All scripts of an object run in the same Lua state. Player scripts need packages of the main Lua state.
+    inline std::size_t getShardIndex(const ESM::RefNum& id, bool isPlayer, std::size_t numStates)
+    {
+        if (isPlayer || numStates <= 1)
+            return 0;
+        return (id.mIndex + static_cast<std::uint32_t>(id.mContentFile)) % numStates;
+    }
+
+    // Unknown Lua states are treated as the main one.
+    inline std::size_t getShardIndex(const LuaUtil::LuaState& lua, const LuaStates& states)
+    {
+        for (std::size_t i = 1; i < states.size(); ++i)
+        {
+            if (states[i] == &lua)
+                return i;
+        }
+        return 0;
+    }
+
+    // A callback runs in the Lua state of the script that created it.
+    // Callbacks of removed scripts do nothing, so they can go anywhere.
+    inline std::size_t getShardIndex(const LuaUtil::Callback& callback, const LuaStates& states)
+    {
+        using ScriptId = LuaUtil::ScriptsContainer::ScriptId;
+        const sol::object id = callback.mHiddenData[LuaUtil::ScriptsContainer::sScriptIdKey];
+        if (!id.is<ScriptId>())
+            return 0;
+        return getShardIndex(id.as<ScriptId>().mContainer->getLuaState(), states);
+    }
+}
+
+#endif // MWLUA_SHARDINDEX_H
@@ -57,6 +57,7 @@ namespace
     template<class G>
     sol::object getValue(const MWLua::Context& context, const StatObject& obj, SelfObject::CachedStat::Setter setter, int index, std::string_view prop, G getter)
     {
+        const auto lock = context.mWorldView->lockEngine();
         return std::visit([&] (auto&& variant)
         {
             using T = std::decay_t<decltype(variant)>;
@@ -125,6 +126,7 @@ namespace MWLua
             const auto& ptr = getObject(mObject)->ptr();
             if(!ptr.getClass().isNpc())
                 return sol::nil;
+            const auto lock = context.mWorldView->lockEngine();
             return sol::make_object(context.mLua->sol(), ptr.getClass().getNpcStats(ptr).getLevelProgress());
         }
 
@@ -142,8 +142,9 @@ namespace MWLua
             {"Ammunition", MWWorld::InventoryStore::Slot_Ammunition}
         }));
 
-        actor["stance"] = [](const Object& o)
+        actor["stance"] = [worldView=context.mWorldView](const Object& o)
         {
+            const auto lock = worldView->lockEngine();
             const MWWorld::Class& cls = o.ptr().getClass();
             if (cls.isActor())
                 return cls.getCreatureStats(o.ptr()).getDrawState();
@@ -151,23 +152,27 @@ namespace MWLua
                 throw std::runtime_error("Actor expected");
         };
 
-        actor["canMove"] = [](const Object& o)
+        actor["canMove"] = [worldView=context.mWorldView](const Object& o)
         {
+            const auto lock = worldView->lockEngine();
             const MWWorld::Class& cls = o.ptr().getClass();
             return cls.getMaxSpeed(o.ptr()) > 0;
         };
-        actor["runSpeed"] = [](const Object& o)
+        actor["runSpeed"] = [worldView=context.mWorldView](const Object& o)
         {
+            const auto lock = worldView->lockEngine();
             const MWWorld::Class& cls = o.ptr().getClass();
             return cls.getRunSpeed(o.ptr());
         };
-        actor["walkSpeed"] = [](const Object& o)
+        actor["walkSpeed"] = [worldView=context.mWorldView](const Object& o)
         {
+            const auto lock = worldView->lockEngine();
             const MWWorld::Class& cls = o.ptr().getClass();
             return cls.getWalkSpeed(o.ptr());
         };
-        actor["currentSpeed"] = [](const Object& o)
+        actor["currentSpeed"] = [worldView=context.mWorldView](const Object& o)
         {
+            const auto lock = worldView->lockEngine();
             const MWWorld::Class& cls = o.ptr().getClass();
             return cls.getCurrentSpeed(o.ptr());
         };
@@ -192,6 +197,7 @@ namespace MWLua
             if (!ptr.getClass().hasInventoryStore(ptr))
                 return equipment;
 
+            const auto lock = context.mWorldView->lockEngine();
             MWWorld::InventoryStore& store = ptr.getClass().getInventoryStore(ptr);
             for (int slot = 0; slot < MWWorld::InventoryStore::Slots; ++slot)
             {
@@ -209,6 +215,7 @@ namespace MWLua
             sol::table equipment(context.mLua->sol(), sol::create);
             if (!ptr.getClass().hasInventoryStore(ptr))
                 return sol::nil;
+            const auto lock = context.mWorldView->lockEngine();
             MWWorld::InventoryStore& store = ptr.getClass().getInventoryStore(ptr);
             auto it = store.getSlot(slot);
             if (it == store.end())
@@ -217,11 +224,12 @@ namespace MWLua
             return o.getObject(context.mLua->sol(), getId(*it));
         };
         actor["equipment"] = sol::overload(getAllEquipment, getEquipmentFromSlot);
-        actor["hasEquipped"] = [](const Object& o, const Object& item)
+        actor["hasEquipped"] = [worldView=context.mWorldView](const Object& o, const Object& item)
         {
             const MWWorld::Ptr& ptr = o.ptr();
             if (!ptr.getClass().hasInventoryStore(ptr))
                 return false;
+            const auto lock = worldView->lockEngine();
             MWWorld::InventoryStore& store = ptr.getClass().getInventoryStore(ptr);
             return store.isEquipped(item.ptr());
         };
@@ -26,12 +26,14 @@ namespace MWLua
             [](const LObject& o) { containerPtr(o); return Inventory<LObject>{o}; },
             [](const GObject& o) { containerPtr(o); return Inventory<GObject>{o}; }
         );
-        container["encumbrance"] = [](const Object& obj) -> float {
+        container["encumbrance"] = [worldView=context.mWorldView](const Object& obj) -> float {
             const MWWorld::Ptr& ptr = containerPtr(obj);
+            const auto lock = worldView->lockEngine();
             return ptr.getClass().getEncumbrance(ptr);
         };
-        container["capacity"] = [](const Object& obj) -> float {
+        container["capacity"] = [worldView=context.mWorldView](const Object& obj) -> float {
             const MWWorld::Ptr& ptr = containerPtr(obj);
+            const auto lock = worldView->lockEngine();
             return ptr.getClass().getCapacity(ptr);
         };
 
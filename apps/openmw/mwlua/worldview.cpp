@@ -18,11 +18,6 @@ namespace MWLua
     void WorldView::update()
     {
         mObjectRegistry.update();
-        mActivatorsInScene.updateList();
-        mActorsInScene.updateList();
-        mContainersInScene.updateList();
-        mDoorsInScene.updateList();
-        mItemsInScene.updateList();
         mPaused = MWBase::Environment::get().getWindowManager()->isGuiMode();
     }
 
@@ -61,14 +56,14 @@ namespace MWLua
         mObjectRegistry.registerPtr(ptr);
         ObjectGroup* group = chooseGroup(ptr);
         if (group)
-            addToGroup(*group, ptr);
+            group->add(getId(ptr));
     }
 
     void WorldView::objectRemovedFromScene(const MWWorld::Ptr& ptr)
     {
         ObjectGroup* group = chooseGroup(ptr);
         if (group)
-            removeFromGroup(*group, ptr);
+            group->remove(getId(ptr));
     }
 
     double WorldView::getGameTime() const
@@ -92,39 +87,36 @@ namespace MWLua
         mObjectRegistry.getLastAssignedId().save(esm, true);
     }
 
-    void WorldView::ObjectGroup::updateList()
+    void WorldView::ObjectGroup::add(const ObjectId& id)
     {
-        if (mChanged)
+        if (mIndex.emplace(id, mList->size()).second)
+            mList->push_back(id);
+    }
+
+    void WorldView::ObjectGroup::remove(const ObjectId& id)
+    {
+        const auto it = mIndex.find(id);
+        if (it == mIndex.end())
+            return;
+        const std::size_t index = it->second;
+        mIndex.erase(it);
+        if (index + 1 != mList->size())
         {
-            mList->clear();
-            for (const ObjectId& id : mSet)
-                mList->push_back(id);
-            mChanged = false;
+            (*mList)[index] = mList->back();
+            mIndex[(*mList)[index]] = index;
         }
+        mList->pop_back();
     }
 
     void WorldView::ObjectGroup::clear()
     {
-        mChanged = false;
         mList->clear();
-        mSet.clear();
-    }
-
-    void WorldView::addToGroup(ObjectGroup& group, const MWWorld::Ptr& ptr)
-    {
-        group.mSet.insert(getId(ptr));
-        group.mChanged = true;
-    }
-
-    void WorldView::removeFromGroup(ObjectGroup& group, const MWWorld::Ptr& ptr)
-    {
-        group.mSet.erase(getId(ptr));
-        group.mChanged = true;
+        mIndex.clear();
     }
 
-    // TODO: If Lua scripts will use several threads at the same time, then `find*Cell` functions should have critical sections.
     MWWorld::CellStore* WorldView::findCell(const std::string& name, osg::Vec3f position)
     {
+        const auto lock = lockEngine();
         MWBase::World* world = MWBase::Environment::get().getWorld();
         bool exterior = name.empty() || world->getExterior(name);
         if (exterior)
@@ -138,6 +130,7 @@ namespace MWLua
 
     MWWorld::CellStore* WorldView::findNamedCell(const std::string& name)
     {
+        const auto lock = lockEngine();
         MWBase::World* world = MWBase::Environment::get().getWorld();
         const ESM::Cell* esmCell = world->getExterior(name);
         if (esmCell)
@@ -148,6 +141,7 @@ namespace MWLua
 
     MWWorld::CellStore* WorldView::findExteriorCell(int x, int y)
     {
+        const auto lock = lockEngine();
         MWBase::World* world = MWBase::Environment::get().getWorld();
         return world->getExterior(x, y);
     }
@@ -6,7 +6,8 @@
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
 
-#include <set>
+#include <mutex>
+#include <unordered_map>
 
 namespace ESM
 {
@@ -54,6 +55,11 @@ namespace MWLua
         // If onlyActive = true, then search only among the objects that are currently in the scene.
         // TODO: ObjectIdList selectObjects(const Queries::Query& query, bool onlyActive);
 
+        // Local scripts of different Lua states run in parallel (see "lua num threads"). Bindings available to them
+        // should hold this lock while calling engine functions that initialize data on first access (custom data of
+        // objects, levelled lists in containers, cells).
+        std::unique_lock<std::recursive_mutex> lockEngine() { return std::unique_lock(mEngineMutex); }
+
         MWWorld::CellStore* findCell(const std::string& name, osg::Vec3f position);
         MWWorld::CellStore* findNamedCell(const std::string& name);
         MWWorld::CellStore* findExteriorCell(int x, int y);
@@ -65,19 +71,19 @@ namespace MWLua
         bool isItem(const MWWorld::Ptr& ptr) { return chooseGroup(ptr) == &mItemsInScene; }
 
     private:
+        // Dense list of objects that is updated in place, so Lua always sees the current content without rebuilding
+        // the whole list. Removal moves the last object to the freed index, so the order is deterministic but not sorted.
         struct ObjectGroup
         {
-            void updateList();
+            void add(const ObjectId& id);
+            void remove(const ObjectId& id);
             void clear();
 
-            bool mChanged = false;
             ObjectIdList mList = std::make_shared<std::vector<ObjectId>>();
-            std::set<ObjectId> mSet;
+            std::unordered_map<ObjectId, std::size_t> mIndex;
         };
 
         ObjectGroup* chooseGroup(const MWWorld::Ptr& ptr);
-        void addToGroup(ObjectGroup& group, const MWWorld::Ptr& ptr);
-        void removeFromGroup(ObjectGroup& group, const MWWorld::Ptr& ptr);
 
         ObjectRegistry mObjectRegistry;
         ObjectGroup mActivatorsInScene;
@@ -88,6 +94,8 @@ namespace MWLua
 
         double mSimulationTime = 0;
         bool mPaused = false;
+
+        std::recursive_mutex mEngineMutex;
     };
 
 }
@@ -133,6 +133,35 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const osg::Vec3f&
     const bool isDestReached = (distToTarget <= destTolerance);
     const bool actorCanMoveByZ = canActorMoveByZAxis(actor);
 
+    const auto addDestinationToPath = [&]
+    {
+        if (!mPathFinder.getPath().empty()) //Path has points in it
+        {
+            const osg::Vec3f& lastPos = mPathFinder.getPath().back(); //Get the end of the proposed path
+
+            if(distance(dest, lastPos) > 100) //End of the path is far from the destination
+                mPathFinder.addPointToPath(dest); //Adds the final destination to the path, to try to get to where you want to go
+        }
+    };
+
+    // A requested path is used as soon as it is found, not only on reaction
+    switch (mPathFinder.updateRequestedPath())
+    {
+        case PathRequestStatus::None:
+        case PathRequestStatus::Pending:
+            break;
+        case PathRequestStatus::Failed:
+            if (isDestReached)
+                break;
+            mPathFinder.buildLimitedPath(actor, position, dest, actor.getCell(), getPathGridGraph(actor.getCell()),
+                agentBounds, getNavigatorFlags(actor), getAreaCosts(actor), endTolerance, pathType);
+            [[fallthrough]];
+        case PathRequestStatus::Ready:
+            mRotateOnTheRunChecks = 3;
+            addDestinationToPath();
+            break;
+    }
+
     if (!isDestReached && timerStatus == Misc::TimerStatus::Elapsed)
     {
         if (canOpenDoors(actor))
@@ -147,34 +176,37 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const osg::Vec3f&
 
         if (!mIsShortcutting)
         {
-            if (wasShortcutting || doesPathNeedRecalc(dest, actor)) // if need to rebuild path
+            // if need to rebuild path
+            if (wasShortcutting || (!mPathFinder.isPathRequested() && doesPathNeedRecalc(dest, actor)))
             {
-                mPathFinder.buildLimitedPath(actor, position, dest, actor.getCell(), getPathGridGraph(actor.getCell()),
-                    agentBounds, getNavigatorFlags(actor), getAreaCosts(actor), endTolerance, pathType);
-                mRotateOnTheRunChecks = 3;
+                // An actor following a path keeps it while the new one is found in background
+                const bool isRequested = !wasShortcutting && mPathFinder.isPathConstructed()
+                    && mPathFinder.requestLimitedPath(actor, position, dest, actor.getCell(), agentBounds,
+                        getNavigatorFlags(actor), getAreaCosts(actor), endTolerance, pathType);
 
-                // give priority to go directly on target if there is minimal opportunity
-                if (destInLOS && mPathFinder.getPath().size() > 1)
+                if (!isRequested)
                 {
-                    // get point just before dest
-                    auto pPointBeforeDest = mPathFinder.getPath().rbegin() + 1;
+                    mPathFinder.buildLimitedPath(actor, position, dest, actor.getCell(), getPathGridGraph(actor.getCell()),
+                        agentBounds, getNavigatorFlags(actor), getAreaCosts(actor), endTolerance, pathType);
+                    mRotateOnTheRunChecks = 3;
 
-                    // if start point is closer to the target then last point of path (excluding target itself) then go straight on the target
-                    if (distance(position, dest) <= distance(dest, *pPointBeforeDest))
+                    // give priority to go directly on target if there is minimal opportunity
+                    if (destInLOS && mPathFinder.getPath().size() > 1)
                     {
-                        mPathFinder.clearPath();
-                        mPathFinder.addPointToPath(dest);
+                        // get point just before dest
+                        auto pPointBeforeDest = mPathFinder.getPath().rbegin() + 1;
+
+                        // if start point is closer to the target then last point of path (excluding target itself) then go straight on the target
+                        if (distance(position, dest) <= distance(dest, *pPointBeforeDest))
+                        {
+                            mPathFinder.clearPath();
+                            mPathFinder.addPointToPath(dest);
+                        }
                     }
                 }
             }
 
-            if (!mPathFinder.getPath().empty()) //Path has points in it
-            {
-                const osg::Vec3f& lastPos = mPathFinder.getPath().back(); //Get the end of the proposed path
-
-                if(distance(dest, lastPos) > 100) //End of the path is far from the destination
-                    mPathFinder.addPointToPath(dest); //Adds the final destination to the path, to try to get to where you want to go
-            }
+            addDestinationToPath();
         }
     }
 
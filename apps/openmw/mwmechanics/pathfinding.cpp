@@ -1,5 +1,6 @@
 #include "pathfinding.hpp"
 
+#include <chrono>
 #include <iterator>
 #include <limits>
 
@@ -84,6 +85,20 @@ namespace
         return 2 * std::max(realHalfExtents.x(), realHalfExtents.y());
     }
 
+    osg::Vec3f getLimitedEndPoint(const DetourNavigator::Navigator& navigator, const osg::Vec3f& startPoint,
+        const osg::Vec3f& endPoint)
+    {
+        const auto maxDistance = std::min(
+            navigator.getMaxNavmeshAreaRealRadius(),
+            static_cast<float>(Constants::CellSizeInUnits)
+        );
+        const auto startToEnd = endPoint - startPoint;
+        const auto distance = startToEnd.length();
+        if (distance <= maxDistance)
+            return endPoint;
+        return startPoint + startToEnd * maxDistance / distance;
+    }
+
     float getHeight(const MWWorld::ConstPtr& actor)
     {
         const auto world = MWBase::Environment::get().getWorld();
@@ -361,6 +376,7 @@ namespace MWMechanics
 
     void PathFinder::buildStraightPath(const osg::Vec3f& endPoint)
     {
+        mRequestedPath.reset();
         mPath.clear();
         mPath.push_back(endPoint);
         mConstructed = true;
@@ -369,6 +385,7 @@ namespace MWMechanics
     void PathFinder::buildPathByPathgrid(const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
         const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph)
     {
+        mRequestedPath.reset();
         mPath.clear();
         mCell = cell;
 
@@ -381,6 +398,7 @@ namespace MWMechanics
         const osg::Vec3f& endPoint, const DetourNavigator::AgentBounds& agentBounds, const DetourNavigator::Flags flags,
         const DetourNavigator::AreaCosts& areaCosts, float endTolerance, PathType pathType)
     {
+        mRequestedPath.reset();
         mPath.clear();
 
         // If it's not possible to build path over navmesh due to disabled navmesh generation fallback to straight path
@@ -401,6 +419,7 @@ namespace MWMechanics
         const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts, float endTolerance,
         PathType pathType)
     {
+        mRequestedPath.reset();
         mPath.clear();
         mCell = cell;
 
@@ -503,16 +522,63 @@ namespace MWMechanics
         const DetourNavigator::AreaCosts& areaCosts, float endTolerance, PathType pathType)
     {
         const auto navigator = MWBase::Environment::get().getWorld()->getNavigator();
-        const auto maxDistance = std::min(
-            navigator->getMaxNavmeshAreaRealRadius(),
-            static_cast<float>(Constants::CellSizeInUnits)
-        );
-        const auto startToEnd = endPoint - startPoint;
-        const auto distance = startToEnd.length();
-        if (distance <= maxDistance)
-            return buildPath(actor, startPoint, endPoint, cell, pathgridGraph, agentBounds, flags, areaCosts,
-                             endTolerance, pathType);
-        const auto end = startPoint + startToEnd * maxDistance / distance;
+        const auto end = getLimitedEndPoint(*navigator, startPoint, endPoint);
         buildPath(actor, startPoint, end, cell, pathgridGraph, agentBounds, flags, areaCosts, endTolerance, pathType);
     }
+
+    bool PathFinder::requestLimitedPath(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint,
+        const osg::Vec3f& endPoint, const MWWorld::CellStore* cell, const DetourNavigator::AgentBounds& agentBounds,
+        const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts, float endTolerance,
+        PathType pathType)
+    {
+        if (actor.getClass().isPureWaterCreature(actor) || actor.getClass().isPureFlyingCreature(actor))
+            return false;
+
+        const auto navigator = MWBase::Environment::get().getWorld()->getNavigator();
+        DetourNavigator::PathRequest request;
+        request.mAgentBounds = agentBounds;
+        request.mStepSize = getPathStepSize(actor);
+        request.mStart = startPoint;
+        request.mEnd = getLimitedEndPoint(*navigator, startPoint, endPoint);
+        request.mIncludeFlags = flags;
+        request.mAreaCosts = areaCosts;
+        request.mEndTolerance = endTolerance;
+
+        mRequestedPath = RequestedPath {navigator->findPathAsync(request), cell, pathType};
+
+        return true;
+    }
+
+    PathRequestStatus PathFinder::updateRequestedPath()
+    {
+        if (!mRequestedPath.has_value())
+            return PathRequestStatus::None;
+
+        if (mRequestedPath->mResult.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return PathRequestStatus::Pending;
+
+        const RequestedPath requested = std::move(*mRequestedPath);
+        mRequestedPath.reset();
+
+        try
+        {
+            const DetourNavigator::PathResult& result = requested.mResult.get();
+            const bool found = result.mStatus == DetourNavigator::Status::Success
+                || (requested.mPathType == PathType::Partial && result.mStatus == DetourNavigator::Status::PartialPath);
+            // Fallbacks to other flags and pathgrid are left to buildLimitedPath
+            if (!found || result.mPath.empty())
+                return PathRequestStatus::Failed;
+            mPath.assign(result.mPath.begin(), result.mPath.end());
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to get requested path: " << e.what();
+            return PathRequestStatus::Failed;
+        }
+
+        mCell = requested.mCell;
+        mConstructed = true;
+
+        return PathRequestStatus::Ready;
+    }
 }
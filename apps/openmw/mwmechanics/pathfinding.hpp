@@ -3,10 +3,13 @@
 
 #include <deque>
 #include <cassert>
+#include <future>
 #include <iterator>
+#include <optional>
 
 #include <components/detournavigator/flags.hpp>
 #include <components/detournavigator/areatype.hpp>
+#include <components/detournavigator/pathrequest.hpp>
 #include <components/detournavigator/status.hpp>
 #include <components/esm/defs.hpp>
 #include <components/esm3/loadpgrd.hpp>
@@ -81,6 +84,14 @@ namespace MWMechanics
         Partial,
     };
 
+    enum class PathRequestStatus
+    {
+        None,
+        Pending,
+        Ready,
+        Failed,
+    };
+
     class PathFinder
     {
         public:
@@ -95,6 +106,7 @@ namespace MWMechanics
                 mConstructed = false;
                 mPath.clear();
                 mCell = nullptr;
+                mRequestedPath.reset();
             }
 
             void buildStraightPath(const osg::Vec3f& endPoint);
@@ -120,6 +132,23 @@ namespace MWMechanics
                 const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts, float endTolerance,
                 PathType pathType);
 
+            /// Find a path over navmesh like buildLimitedPath but in background, the current path is kept until
+            /// updateRequestedPath replaces it.
+            /// @return false if the actor can't use navmesh, the path has to be built with buildLimitedPath then.
+            bool requestLimitedPath(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint,
+                const osg::Vec3f& endPoint, const MWWorld::CellStore* cell,
+                const DetourNavigator::AgentBounds& agentBounds, const DetourNavigator::Flags flags,
+                const DetourNavigator::AreaCosts& areaCosts, float endTolerance, PathType pathType);
+
+            /// Replace the path by the requested one if it is found. Failed means the path has to be built with
+            /// buildLimitedPath, the current path is kept.
+            PathRequestStatus updateRequestedPath();
+
+            bool isPathRequested() const
+            {
+                return mRequestedPath.has_value();
+            }
+
             /// Remove front point if exist and within tolerance
             void update(const osg::Vec3f& position, float pointTolerance, float destinationTolerance,
                         bool shortenIfAlmostStraight, bool canMoveByZ, const DetourNavigator::AgentBounds& agentBounds,
@@ -216,11 +245,20 @@ namespace MWMechanics
             }
 
         private:
+            struct RequestedPath
+            {
+                std::shared_future<DetourNavigator::PathResult> mResult;
+                const MWWorld::CellStore* mCell;
+                PathType mPathType;
+            };
+
             bool mConstructed;
             std::deque<osg::Vec3f> mPath;
 
             const MWWorld::CellStore* mCell;
 
+            std::optional<RequestedPath> mRequestedPath;
+
             void buildPathByPathgridImpl(const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
                 const PathgridGraph& pathgridGraph, std::back_insert_iterator<std::deque<osg::Vec3f>> out);
 
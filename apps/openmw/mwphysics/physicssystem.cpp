@@ -90,6 +90,29 @@ namespace
         ptr.getClass().getMovementSettings(ptr).mPosition[2] = 0;
     }
 
+    class CollectPtrsCallback final : public btBroadphaseAabbCallback
+    {
+    public:
+        CollectPtrsCallback(int mask, std::vector<MWWorld::Ptr>& out)
+            : mCollisionFilterMask(mask)
+            , mOut(out)
+        {
+        }
+
+        bool process(const btBroadphaseProxy* proxy) override
+        {
+            if ((proxy->m_collisionFilterGroup & mCollisionFilterMask) == 0)
+                return true;
+            const auto collisionObject = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+            if (const auto holder = static_cast<const MWPhysics::PtrHolder*>(collisionObject->getUserPointer()))
+                mOut.push_back(holder->getPtr());
+            return true;
+        }
+
+    private:
+        int mCollisionFilterMask;
+        std::vector<MWWorld::Ptr>& mOut;
+    };
 }
 
 namespace MWPhysics
@@ -369,6 +392,13 @@ namespace MWPhysics
         return mTaskScheduler->getLineOfSight(it1->second, it2->second);
     }
 
+    void PhysicsSystem::getObjectsInBox(const osg::Vec3f& min, const osg::Vec3f& max, int mask,
+        std::vector<MWWorld::Ptr>& out) const
+    {
+        CollectPtrsCallback callback(mask, out);
+        mTaskScheduler->aabbTest(Misc::Convert::toBullet(min), Misc::Convert::toBullet(max), callback);
+    }
+
     bool PhysicsSystem::isOnGround(const MWWorld::Ptr &actor)
     {
         Actor* physactor = getActor(actor);
@@ -221,6 +221,9 @@ namespace MWPhysics
             /// Return true if actor1 can see actor2.
             bool getLineOfSight(const MWWorld::ConstPtr& actor1, const MWWorld::ConstPtr& actor2) const override;
 
+            void getObjectsInBox(const osg::Vec3f& min, const osg::Vec3f& max, int mask,
+                    std::vector<MWWorld::Ptr>& out) const override;
+
             bool isOnGround (const MWWorld::Ptr& actor);
 
             bool canMoveToWaterSurface (const MWWorld::ConstPtr &actor, const float waterlevel);
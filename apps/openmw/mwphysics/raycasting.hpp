@@ -1,6 +1,8 @@
 #ifndef OPENMW_MWPHYSICS_RAYCASTING_H
 #define OPENMW_MWPHYSICS_RAYCASTING_H
 
+#include <vector>
+
 #include <osg/Vec3f>
 
 #include "../mwworld/ptr.hpp"
@@ -37,6 +39,11 @@ namespace MWPhysics
 
             /// Return true if actor1 can see actor2.
             virtual bool getLineOfSight(const MWWorld::ConstPtr& actor1, const MWWorld::ConstPtr& actor2) const = 0;
+
+            /// Append to \a out the objects whose collision bounds intersect the box from \a min to \a max.
+            /// Uses only the broadphase, so the actual collision shapes are not tested.
+            virtual void getObjectsInBox(const osg::Vec3f& min, const osg::Vec3f& max, int mask,
+                    std::vector<MWWorld::Ptr>& out) const = 0;
     };
 }
 
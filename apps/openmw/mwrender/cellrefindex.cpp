@@ -0,0 +1,90 @@
+#include "cellrefindex.hpp"
+
+#include <components/misc/stringops.hpp>
+
+namespace MWRender
+{
+
+    PagedCellRef::PagedCellRef(ESM::CellRef&& ref, bool deleted)
+        : mRefNum(ref.mRefNum)
+        , mRefID(std::move(ref.mRefID))
+        , mPos(ref.mPos)
+        , mScale(ref.mScale)
+        , mDeleted(deleted)
+    {
+        Misc::StringUtils::lowerCaseInPlace(mRefID);
+    }
+
+    CellRefIndex::CellRefIndex(Loader&& loader, std::size_t maxRefs)
+        : mLoader(std::move(loader))
+        , mMaxRefs(maxRefs)
+    {
+    }
+
+    std::shared_ptr<const PagedCellRefs> CellRefIndex::getRefs(int cellX, int cellY)
+    {
+        const Key key(cellX, cellY);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            const auto found = mCells.find(key);
+            if (found != mCells.end())
+            {
+                mUsage.splice(mUsage.end(), mUsage, found->second.mUsage);
+                return found->second.mRefs;
+            }
+        }
+
+        auto refs = std::make_shared<PagedCellRefs>();
+        mLoader(cellX, cellY, *takeReaders(), *refs);
+        refs->shrink_to_fit();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto [it, inserted] = mCells.emplace(key, Item {std::move(refs), mUsage.end()});
+        if (!inserted)
+            return it->second.mRefs;
+
+        it->second.mUsage = mUsage.insert(mUsage.end(), key);
+        mNumRefs += it->second.mRefs->size();
+
+        while (mNumRefs > mMaxRefs && mUsage.front() != key)
+        {
+            const auto oldest = mCells.find(mUsage.front());
+            mNumRefs -= oldest->second.mRefs->size();
+            mCells.erase(oldest);
+            mUsage.pop_front();
+        }
+
+        return it->second.mRefs;
+    }
+
+    CellRefIndex::ReadersPtr CellRefIndex::takeReaders()
+    {
+        std::lock_guard<std::mutex> lock(mReadersMutex);
+        if (mFreeReaders.empty())
+            return ReadersPtr(new ESM::ReadersCache, ReadersDeleter(*this));
+        ReadersPtr result(mFreeReaders.back().release(), ReadersDeleter(*this));
+        mFreeReaders.pop_back();
+        return result;
+    }
+
+    void CellRefIndex::ReadersDeleter::operator()(ESM::ReadersCache* readers) const
+    {
+        std::unique_ptr<ESM::ReadersCache> owned(readers);
+        std::lock_guard<std::mutex> lock(mIndex->mReadersMutex);
+        mIndex->mFreeReaders.push_back(std::move(owned));
+    }
+
+    std::size_t CellRefIndex::getNumCells() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mCells.size();
+    }
+
+    std::size_t CellRefIndex::getNumRefs() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mNumRefs;
+    }
+
+}
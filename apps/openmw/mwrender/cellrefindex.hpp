@@ -0,0 +1,94 @@
+#ifndef OPENMW_MWRENDER_CELLREFINDEX_H
+#define OPENMW_MWRENDER_CELLREFINDEX_H
+
+#include <components/esm3/cellref.hpp>
+#include <components/esm3/readerscache.hpp>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MWRender
+{
+
+    /// @brief The part of an ESM::CellRef paged chunks are built from.
+    struct PagedCellRef
+    {
+        ESM::RefNum mRefNum;
+        std::string mRefID; // lower case
+        ESM::Position mPos;
+        float mScale;
+        bool mDeleted;
+
+        PagedCellRef(ESM::CellRef&& ref, bool deleted);
+    };
+
+    using PagedCellRefs = std::vector<PagedCellRef>;
+
+    /// @brief Per cell copy of the references as they appear in the content files, so that chunk builders don't have to
+    /// parse the content files again each time a chunk covering the cell is built.
+    /// @par A cell is indexed on first access. Least recently used cells are dropped once the index holds more than the
+    /// given number of references, content files don't change at runtime so nothing else invalidates it.
+    class CellRefIndex
+    {
+    public:
+        /// Append the references of the cell in the order they should be applied.
+        using Loader = std::function<void(int cellX, int cellY, ESM::ReadersCache& readers, PagedCellRefs& refs)>;
+
+        explicit CellRefIndex(Loader&& loader, std::size_t maxRefs = 200000);
+
+        /// @note Thread safe.
+        std::shared_ptr<const PagedCellRefs> getRefs(int cellX, int cellY);
+
+        /// @return number of indexed cells
+        std::size_t getNumCells() const;
+
+        /// @return number of indexed references
+        std::size_t getNumRefs() const;
+
+    private:
+        using Key = std::pair<int, int>;
+
+        struct Item
+        {
+            std::shared_ptr<const PagedCellRefs> mRefs;
+            std::list<Key>::iterator mUsage;
+        };
+
+        Loader mLoader;
+        const std::size_t mMaxRefs;
+
+        mutable std::mutex mMutex;
+        std::map<Key, Item> mCells;
+        std::list<Key> mUsage;
+        std::size_t mNumRefs = 0;
+
+        // Each loading thread takes its own readers, so content files stay open between cells without serializing reads
+        std::mutex mReadersMutex;
+        std::vector<std::unique_ptr<ESM::ReadersCache>> mFreeReaders;
+
+        /// Returns readers to the index once the loader is done with them, also when it throws.
+        class ReadersDeleter
+        {
+        public:
+            explicit ReadersDeleter(CellRefIndex& index) : mIndex(&index) {}
+
+            void operator()(ESM::ReadersCache* readers) const;
+
+        private:
+            CellRefIndex* mIndex;
+        };
+
+        using ReadersPtr = std::unique_ptr<ESM::ReadersCache, ReadersDeleter>;
+
+        ReadersPtr takeReaders();
+    };
+
+}
+
+#endif
@@ -8,7 +8,14 @@
 
 #include <osgDB/WriteFile>
 
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
 #include <components/settings/settings.hpp>
+#include <components/files/hash.hpp>
 #include <components/files/memorystream.hpp>
 
 #include <components/debug/debuglog.hpp>
@@ -113,6 +120,114 @@ namespace
         std::string data = ostream.str();
         return std::vector<char>(data.begin(), data.end());
     }
+
+    // Increment when the way the map is painted is changed to invalidate cached images
+    constexpr std::uint32_t globalMapCacheVersion = 1;
+
+    struct MapColor
+    {
+        unsigned char mR, mG, mB, mAlpha;
+    };
+
+    MapColor getMapColor(float y2)
+    {
+        MapColor result;
+        result.mAlpha = (y2 < 0) ? static_cast<unsigned char>(0) : static_cast<unsigned char>(255);
+        if (y2 < 0)
+        {
+            result.mR = static_cast<unsigned char>(14 * y2 + 38);
+            result.mG = static_cast<unsigned char>(20 * y2 + 56);
+            result.mB = static_cast<unsigned char>(18 * y2 + 51);
+        }
+        else if (y2 < 0.3f)
+        {
+            if (y2 < 0.1f)
+                y2 *= 8.f;
+            else
+            {
+                y2 -= 0.1f;
+                y2 += 0.8f;
+            }
+            result.mR = static_cast<unsigned char>(66 - 32 * y2);
+            result.mG = static_cast<unsigned char>(48 - 23 * y2);
+            result.mB = static_cast<unsigned char>(33 - 16 * y2);
+        }
+        else
+        {
+            y2 -= 0.3f;
+            y2 *= 1.428f;
+            result.mR = static_cast<unsigned char>(34 - 29 * y2);
+            result.mG = static_cast<unsigned char>(25 - 20 * y2);
+            result.mB = static_cast<unsigned char>(17 - 12 * y2);
+        }
+        return result;
+    }
+
+    // WNAM has only 256 possible values so the colors are computed once, indexed by the value as unsigned char
+    const std::array<MapColor, 256>& getMapColors()
+    {
+        static const std::array<MapColor, 256> colors = []
+        {
+            std::array<MapColor, 256> result;
+            for (int value = SCHAR_MIN; value <= SCHAR_MAX; ++value)
+                result[static_cast<unsigned char>(value)] = getMapColor(value / 128.f);
+            return result;
+        } ();
+        return colors;
+    }
+
+    template <class T>
+    void append(std::vector<char>& buffer, const T& value)
+    {
+        const char* const begin = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), begin, begin + sizeof(value));
+    }
+
+    struct GlobalMapCacheHeader
+    {
+        std::array<std::uint64_t, 2> mKey;
+        std::int32_t mWidth;
+        std::int32_t mHeight;
+    };
+
+    bool readGlobalMapCache(const std::filesystem::path& path, const std::array<std::uint64_t, 2>& key,
+        osg::Image& image, osg::Image& alphaImage)
+    {
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream)
+            return false;
+        GlobalMapCacheHeader header;
+        if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return false;
+        if (header.mKey != key || header.mWidth != image.s() || header.mHeight != image.t())
+            return false;
+        return stream.read(reinterpret_cast<char*>(image.data()), image.getTotalSizeInBytes())
+            && stream.read(reinterpret_cast<char*>(alphaImage.data()), alphaImage.getTotalSizeInBytes());
+    }
+
+    void writeGlobalMapCache(const std::filesystem::path& path, const std::array<std::uint64_t, 2>& key,
+        const osg::Image& image, const osg::Image& alphaImage)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        std::filesystem::path tmpPath = path;
+        tmpPath += ".tmp";
+        {
+            std::ofstream stream(tmpPath, std::ios::binary);
+            const GlobalMapCacheHeader header {key, image.s(), image.t()};
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.write(reinterpret_cast<const char*>(image.data()), image.getTotalSizeInBytes());
+            stream.write(reinterpret_cast<const char*>(alphaImage.data()), alphaImage.getTotalSizeInBytes());
+            if (!stream)
+            {
+                Log(Debug::Warning) << "Failed to write global map cache " << tmpPath.string();
+                return;
+            }
+        }
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec)
+            Log(Debug::Warning) << "Failed to write global map cache " << path.string() << ": " << ec.message();
+    }
 }
 
 namespace MWRender
@@ -121,8 +236,10 @@ namespace MWRender
     class CreateMapWorkItem : public SceneUtil::WorkItem
     {
     public:
-        CreateMapWorkItem(int width, int height, int minX, int minY, int maxX, int maxY, int cellSize, const MWWorld::Store<ESM::Land>& landStore)
+        CreateMapWorkItem(int width, int height, int minX, int minY, int maxX, int maxY, int cellSize, const MWWorld::Store<ESM::Land>& landStore,
+                          const std::string& cachePath)
             : mWidth(width), mHeight(height), mMinX(minX), mMinY(minY), mMaxX(maxX), mMaxY(maxY), mCellSize(cellSize), mLandStore(landStore)
+            , mCachePath(cachePath)
         {
         }
 
@@ -130,70 +247,22 @@ namespace MWRender
         {
             osg::ref_ptr<osg::Image> image = new osg::Image;
             image->allocateImage(mWidth, mHeight, 1, GL_RGB, GL_UNSIGNED_BYTE);
-            unsigned char* data = image->data();
 
             osg::ref_ptr<osg::Image> alphaImage = new osg::Image;
             alphaImage->allocateImage(mWidth, mHeight, 1, GL_ALPHA, GL_UNSIGNED_BYTE);
-            unsigned char* alphaData = alphaImage->data();
 
-            for (int x = mMinX; x <= mMaxX; ++x)
+            if (mCachePath.empty())
+                paint(*image, *alphaImage);
+            else
             {
-                for (int y = mMinY; y <= mMaxY; ++y)
+                const std::filesystem::path path = std::filesystem::path(mCachePath) / "globalmap.bin";
+                const std::array<std::uint64_t, 2> key = getLandKey();
+                if (readGlobalMapCache(path, key, *image, *alphaImage))
+                    Log(Debug::Verbose) << "Using cached global map " << path.string();
+                else
                 {
-                    const ESM::Land* land = mLandStore.search (x,y);
-
-                    for (int cellY=0; cellY<mCellSize; ++cellY)
-                    {
-                        for (int cellX=0; cellX<mCellSize; ++cellX)
-                        {
-                            int vertexX = static_cast<int>(float(cellX) / float(mCellSize) * 9);
-                            int vertexY = static_cast<int>(float(cellY) / float(mCellSize) * 9);
-
-                            int texelX = (x-mMinX) * mCellSize + cellX;
-                            int texelY = (y-mMinY) * mCellSize + cellY;
-
-                            unsigned char r,g,b;
-
-                            float y2 = 0;
-                            if (land && (land->mDataTypes & ESM::Land::DATA_WNAM))
-                                y2 = land->mWnam[vertexY * 9 + vertexX] / 128.f;
-                            else
-                                y2 = SCHAR_MIN / 128.f;
-                            if (y2 < 0)
-                            {
-                                r = static_cast<unsigned char>(14 * y2 + 38);
-                                g = static_cast<unsigned char>(20 * y2 + 56);
-                                b = static_cast<unsigned char>(18 * y2 + 51);
-                            }
-                            else if (y2 < 0.3f)
-                            {
-                                if (y2 < 0.1f)
-                                    y2 *= 8.f;
-                                else
-                                {
-                                    y2 -= 0.1f;
-                                    y2 += 0.8f;
-                                }
-                                r = static_cast<unsigned char>(66 - 32 * y2);
-                                g = static_cast<unsigned char>(48 - 23 * y2);
-                                b = static_cast<unsigned char>(33 - 16 * y2);
-                            }
-                            else
-                            {
-                                y2 -= 0.3f;
-                                y2 *= 1.428f;
-                                r = static_cast<unsigned char>(34 - 29 * y2);
-                                g = static_cast<unsigned char>(25 - 20 * y2);
-                                b = static_cast<unsigned char>(17 - 12 * y2);
-                            }
-
-                            data[texelY * mWidth * 3 + texelX * 3] = r;
-                            data[texelY * mWidth * 3 + texelX * 3+1] = g;
-                            data[texelY * mWidth * 3 + texelX * 3+2] = b;
-
-                            alphaData[texelY * mWidth+ texelX] = (y2 < 0) ? static_cast<unsigned char>(0) : static_cast<unsigned char>(255);
-                        }
-                    }
+                    paint(*image, *alphaImage);
+                    writeGlobalMapCache(path, key, *image, *alphaImage);
                 }
             }
 
@@ -233,12 +302,88 @@ namespace MWRender
         int mMinX, mMinY, mMaxX, mMaxY;
         int mCellSize;
         const MWWorld::Store<ESM::Land>& mLandStore;
+        std::string mCachePath;
 
         osg::ref_ptr<osg::Texture2D> mBaseTexture;
         osg::ref_ptr<osg::Texture2D> mAlphaTexture;
 
         osg::ref_ptr<osg::Image> mOverlayImage;
         osg::ref_ptr<osg::Texture2D> mOverlayTexture;
+
+    private:
+        const signed char* getWnam(int x, int y) const
+        {
+            static const std::array<signed char, ESM::Land::LAND_GLOBAL_MAP_LOD_SIZE> noWnam = []
+            {
+                std::array<signed char, ESM::Land::LAND_GLOBAL_MAP_LOD_SIZE> result;
+                result.fill(SCHAR_MIN);
+                return result;
+            } ();
+
+            const ESM::Land* land = mLandStore.search(x, y);
+            if (land && (land->mDataTypes & ESM::Land::DATA_WNAM))
+                return land->mWnam;
+            return noWnam.data();
+        }
+
+        // Hash of everything the painted image depends on
+        std::array<std::uint64_t, 2> getLandKey() const
+        {
+            std::vector<char> buffer;
+            buffer.reserve(static_cast<std::size_t>(mMaxX - mMinX + 1) * static_cast<std::size_t>(mMaxY - mMinY + 1)
+                * ESM::Land::LAND_GLOBAL_MAP_LOD_SIZE + 64);
+            append(buffer, globalMapCacheVersion);
+            for (int value : {mWidth, mHeight, mMinX, mMinY, mMaxX, mMaxY, mCellSize})
+                append(buffer, value);
+            for (int x = mMinX; x <= mMaxX; ++x)
+            {
+                for (int y = mMinY; y <= mMaxY; ++y)
+                {
+                    const signed char* const wnam = getWnam(x, y);
+                    buffer.insert(buffer.end(), wnam, wnam + ESM::Land::LAND_GLOBAL_MAP_LOD_SIZE);
+                }
+            }
+            Files::IMemStream stream(buffer.data(), buffer.size());
+            return Files::getHash("global map", stream);
+        }
+
+        void paint(osg::Image& image, osg::Image& alphaImage) const
+        {
+            unsigned char* const data = image.data();
+            unsigned char* const alphaData = alphaImage.data();
+            const std::array<MapColor, 256>& colors = getMapColors();
+
+            // WNAM vertex sampled by each texel of a cell along one axis
+            std::vector<int> vertices(static_cast<std::size_t>(mCellSize));
+            for (int i = 0; i < mCellSize; ++i)
+                vertices[i] = static_cast<int>(float(i) / float(mCellSize) * 9);
+
+            for (int x = mMinX; x <= mMaxX; ++x)
+            {
+                for (int y = mMinY; y <= mMaxY; ++y)
+                {
+                    const signed char* const wnam = getWnam(x, y);
+
+                    for (int cellY=0; cellY<mCellSize; ++cellY)
+                    {
+                        const signed char* const row = wnam + vertices[cellY] * 9;
+                        const int texelY = (y-mMinY) * mCellSize + cellY;
+                        const int texelX = (x-mMinX) * mCellSize;
+                        unsigned char* texel = data + texelY * mWidth * 3 + texelX * 3;
+                        unsigned char* alphaTexel = alphaData + texelY * mWidth + texelX;
+
+                        for (int cellX=0; cellX<mCellSize; ++cellX)
+                        {
+                            const MapColor& color = colors[static_cast<unsigned char>(row[vertices[cellX]])];
+                            *texel++ = color.mR;
+                            *texel++ = color.mG;
+                            *texel++ = color.mB;
+                            *alphaTexel++ = color.mAlpha;
+                        }
+                    }
+                }
+            }
+        }
     };
 
     struct GlobalMap::WritePng final : public SceneUtil::WorkItem
@@ -255,9 +400,10 @@ namespace MWRender
         }
     };
 
-    GlobalMap::GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue)
+    GlobalMap::GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue, const std::string& cachePath)
         : mRoot(root)
         , mWorkQueue(workQueue)
+        , mCachePath(cachePath)
         , mWidth(0)
         , mHeight(0)
         , mMinX(0), mMaxX(0)
@@ -300,7 +446,7 @@ namespace MWRender
         mWidth = mCellSize*(mMaxX-mMinX+1);
         mHeight = mCellSize*(mMaxY-mMinY+1);
 
-        mWorkItem = new CreateMapWorkItem(mWidth, mHeight, mMinX, mMinY, mMaxX, mMaxY, mCellSize, esmStore.get<ESM::Land>());
+        mWorkItem = new CreateMapWorkItem(mWidth, mHeight, mMinX, mMinY, mMaxX, mMaxY, mCellSize, esmStore.get<ESM::Land>(), mCachePath);
         mWorkQueue->addWorkItem(mWorkItem);
     }
 
@@ -409,6 +555,13 @@ namespace MWRender
         if (cellX > mMaxX || cellX < mMinX || cellY > mMaxY || cellY < mMinY)
             return;
 
+        // The overlay already has this local map texture, don't render and read it back again
+        osg::observer_ptr<osg::Texture2D>& explored = mExploredCells[std::make_pair(cellX, cellY)];
+        osg::ref_ptr<osg::Texture2D> previous;
+        if (explored.lock(previous) && previous == localMapTexture)
+            return;
+        explored = localMapTexture;
+
         requestOverlayTextureUpdate(originX, mHeight - originY, mCellSize, mCellSize, localMapTexture, false, true);
     }
 
@@ -419,6 +572,7 @@ namespace MWRender
         memset(mOverlayImage->data(), 0, mOverlayImage->getTotalSizeInBytes());
 
         mPendingImageDest.clear();
+        mExploredCells.clear();
 
         // just push a Camera to clear the FBO, instead of setImage()/dirty()
         // easier, since we don't need to worry about synchronizing access :)
@@ -465,6 +619,9 @@ namespace MWRender
 
         const ESM::GlobalMap::Bounds& bounds = map.mBounds;
 
+        // Cells explored later are drawn over the loaded overlay
+        mExploredCells.clear();
+
         if (bounds.mMaxX-bounds.mMinX < 0)
             return;
         if (bounds.mMaxY-bounds.mMinY < 0)
@@ -5,6 +5,7 @@
 #include <vector>
 #include <map>
 
+#include <osg/observer_ptr>
 #include <osg/ref_ptr>
 
 namespace osg
@@ -33,7 +34,8 @@ namespace MWRender
     class GlobalMap
     {
     public:
-        GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue);
+        /// @param cachePath directory to keep the base map image between runs, empty disables it.
+        GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue, const std::string& cachePath);
         ~GlobalMap();
 
         void render();
@@ -111,7 +113,9 @@ namespace MWRender
 
         ImageDestMap mPendingImageDest;
 
-        std::vector< std::pair<int,int> > mExploredCells;
+        // Local map textures drawn onto the overlay since it was cleared or read.
+        // A re-rendered local map segment gets a new texture, so the cell is drawn again.
+        std::map<std::pair<int, int>, osg::observer_ptr<osg::Texture2D>> mExploredCells;
 
         osg::ref_ptr<osg::Texture2D> mBaseTexture;
         osg::ref_ptr<osg::Texture2D> mAlphaTexture;
@@ -124,6 +128,7 @@ namespace MWRender
         osg::ref_ptr<osg::Image> mOverlayImage;
 
         osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        std::string mCachePath;
         osg::ref_ptr<CreateMapWorkItem> mWorkItem;
         osg::ref_ptr<WritePng> mWritePng;
 
@@ -113,7 +113,7 @@ namespace MWRender
         osg::BoundingBox mBox;
     };
 
-    inline bool isInChunkBorders(ESM::CellRef& ref, osg::Vec2f& minBound, osg::Vec2f& maxBound)
+    inline bool isInChunkBorders(const PagedCellRef& ref, osg::Vec2f& minBound, osg::Vec2f& maxBound)
     {
         osg::Vec2f size = maxBound - minBound;
         if (size.x() >=1 && size.y() >=1) return true;
@@ -151,6 +151,22 @@ namespace MWRender
          , mDensity(density)
          , mStateset(new osg::StateSet)
          , mGroundcoverStore(store)
+         , mRefIndex([&store] (int cellX, int cellY, ESM::ReadersCache& readers, PagedCellRefs& refs)
+            {
+                ESM::Cell cell;
+                store.initCell(cell, cellX, cellY);
+                for (size_t i=0; i<cell.mContextList.size(); ++i)
+                {
+                    const std::size_t index = static_cast<std::size_t>(cell.mContextList[i].index);
+                    const ESM::ReadersCache::BusyItem reader = readers.get(index);
+                    cell.restore(*reader, i);
+                    ESM::CellRef ref;
+                    ref.mRefNum.unset();
+                    bool deleted = false;
+                    while (cell.getNextRef(*reader, ref, deleted))
+                        refs.emplace_back(std::move(ref), deleted);
+                }
+            })
     {
          setViewDistance(viewDistance);
          // MGE uses default alpha settings for groundcover, so we can not rely on alpha properties
@@ -178,42 +194,32 @@ namespace MWRender
         osg::Vec2f minBound = (center - osg::Vec2f(size/2.f, size/2.f));
         osg::Vec2f maxBound = (center + osg::Vec2f(size/2.f, size/2.f));
         DensityCalculator calculator(mDensity);
-        ESM::ReadersCache readers;
         osg::Vec2i startCell = osg::Vec2i(std::floor(center.x() - size/2.f), std::floor(center.y() - size/2.f));
         for (int cellX = startCell.x(); cellX < startCell.x() + size; ++cellX)
         {
             for (int cellY = startCell.y(); cellY < startCell.y() + size; ++cellY)
             {
-                ESM::Cell cell;
-                mGroundcoverStore.initCell(cell, cellX, cellY);
-                if (cell.mContextList.empty()) continue;
+                const std::shared_ptr<const PagedCellRefs> cellRefs = mRefIndex.getRefs(cellX, cellY);
+                if (cellRefs->empty()) continue;
 
                 calculator.reset();
-                std::map<ESM::RefNum, ESM::CellRef> refs;
-                for (size_t i=0; i<cell.mContextList.size(); ++i)
+                std::map<ESM::RefNum, const PagedCellRef*> refs;
+                for (const PagedCellRef& ref : *cellRefs)
                 {
-                    const std::size_t index = static_cast<std::size_t>(cell.mContextList[i].index);
-                    const ESM::ReadersCache::BusyItem reader = readers.get(index);
-                    cell.restore(*reader, i);
-                    ESM::CellRef ref;
-                    ref.mRefNum.unset();
-                    bool deleted = false;
-                    while (cell.getNextRef(*reader, ref, deleted))
-                    {
-                        if (!deleted && refs.find(ref.mRefNum) == refs.end() && !calculator.isInstanceEnabled()) deleted = true;
-                        if (!deleted && !isInChunkBorders(ref, minBound, maxBound)) deleted = true;
+                    bool deleted = ref.mDeleted;
+                    if (!deleted && refs.find(ref.mRefNum) == refs.end() && !calculator.isInstanceEnabled()) deleted = true;
+                    if (!deleted && !isInChunkBorders(ref, minBound, maxBound)) deleted = true;
 
-                        if (deleted) { refs.erase(ref.mRefNum); continue; }
-                        refs[ref.mRefNum] = std::move(ref);
-                    }
+                    if (deleted) { refs.erase(ref.mRefNum); continue; }
+                    refs[ref.mRefNum] = &ref;
                 }
 
-                for (auto& pair : refs)
+                for (const auto& pair : refs)
                 {
-                    ESM::CellRef& ref = pair.second;
+                    const PagedCellRef& ref = *pair.second;
                     const std::string& model = mGroundcoverStore.getGroundcoverModel(ref.mRefID);
                     if (!model.empty())
-                        instances[model].emplace_back(std::move(ref));
+                        instances[model].emplace_back(ref);
                 }
             }
         }
@@ -259,5 +265,6 @@ namespace MWRender
     void Groundcover::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Groundcover Chunk", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Groundcover Refs", mRefIndex.getNumRefs());
     }
 }
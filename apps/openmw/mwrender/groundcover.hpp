@@ -5,6 +5,8 @@
 #include <components/resource/scenemanager.hpp>
 #include <components/esm3/loadcell.hpp>
 
+#include "cellrefindex.hpp"
+
 namespace MWWorld
 {
     class ESMStore;
@@ -35,7 +37,7 @@ namespace MWRender
             ESM::Position mPos;
             float mScale;
 
-            GroundcoverEntry(const ESM::CellRef& ref) : mPos(ref.mPos), mScale(ref.mScale)
+            GroundcoverEntry(const PagedCellRef& ref) : mPos(ref.mPos), mScale(ref.mScale)
             {}
         };
 
@@ -45,6 +47,7 @@ namespace MWRender
         osg::ref_ptr<osg::StateSet> mStateset;
         osg::ref_ptr<osg::Program> mProgramTemplate;
         const MWWorld::GroundcoverStore& mGroundcoverStore;
+        CellRefIndex mRefIndex;
 
         typedef std::map<std::string, std::vector<GroundcoverEntry>> InstanceMap;
         osg::ref_ptr<osg::Node> createChunk(InstanceMap& instances, const osg::Vec2f& center);
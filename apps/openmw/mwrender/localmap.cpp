@@ -1,5 +1,6 @@
 #include "localmap.hpp"
 
+#include <algorithm>
 #include <cstdint>
 
 #include <osg/Fog>
@@ -118,9 +119,10 @@ void LocalMap::saveFogOfWar(MWWorld::CellStore* cell)
 {
     if (!mInterior)
     {
-        const MapSegment& segment = mExteriorSegments[std::make_pair(cell->getCell()->getGridX(), cell->getCell()->getGridY())];
+        MapSegment& segment = mExteriorSegments[std::make_pair(cell->getCell()->getGridX(), cell->getCell()->getGridY())];
 
-        if (segment.mFogOfWarImage && segment.mHasFogState)
+        // The CellStore already has the same fog state unless it's changed
+        if (segment.mFogOfWarImage && segment.mHasFogState && (segment.mFogChanged || !cell->getFog()))
         {
             auto fog = std::make_unique<ESM::FogState>();
             fog->mFogTextures.emplace_back();
@@ -134,6 +136,17 @@ void LocalMap::saveFogOfWar(MWWorld::CellStore* cell)
     {
         auto segments = divideIntoSegments(mBounds, mMapWorldSize);
 
+        if (const ESM::FogState* fog = cell->getFog())
+        {
+            const bool changed = std::any_of(mInteriorSegments.begin(), mInteriorSegments.end(),
+                [] (const auto& v) { return v.second.mFogChanged; });
+            if (!changed && fog->mBounds.mMinX == mBounds.xMin() && fog->mBounds.mMaxX == mBounds.xMax()
+                && fog->mBounds.mMinY == mBounds.yMin() && fog->mBounds.mMaxY == mBounds.yMax()
+                && fog->mNorthMarkerAngle == mAngle
+                && fog->mFogTextures.size() == static_cast<std::size_t>(segments.first * segments.second))
+                return;
+        }
+
         auto fog = std::make_unique<ESM::FogState>();
 
         fog->mBounds.mMinX = mBounds.xMin();
@@ -148,12 +161,12 @@ void LocalMap::saveFogOfWar(MWWorld::CellStore* cell)
         {
             for (int y = 0; y < segments.second; ++y)
             {
-                const MapSegment& segment = mInteriorSegments[std::make_pair(x,y)];
+                MapSegment& segment = mInteriorSegments[std::make_pair(x,y)];
 
                 fog->mFogTextures.emplace_back();
 
-                // saving even if !segment.mHasFogState so we don't mess up the segmenting
-                // plus, older openmw versions can't deal with empty images
+                // saving even if !segment.mHasFogState so we don't mess up the segmenting,
+                // an unexplored segment has no image data
                 segment.saveFogOfWar(fog->mFogTextures.back());
 
                 fog->mFogTextures.back().mX = x;
@@ -555,6 +568,7 @@ void LocalMap::updatePlayer (const osg::Vec3f& position, const osg::Quat& orient
             if (changed)
             {
                 segment.mHasFogState = true;
+                segment.mFogChanged = true;
                 segment.mFogOfWarImage->dirty();
             }
         }
@@ -605,6 +619,24 @@ void LocalMap::MapSegment::loadFogOfWar(const ESM::FogTexture &esm)
         return;
     }
 
+    if (!ESM::isPngFogTexture(data))
+    {
+        const std::vector<unsigned char> alpha = ESM::decompressFogTexture(data);
+        if (alpha.size() != static_cast<std::size_t>(sFogOfWarResolution * sFogOfWarResolution))
+        {
+            Log(Debug::Error) << "Error: Failed to read fog: invalid data";
+            return;
+        }
+
+        initFogOfWar();
+        uint32_t* texel = reinterpret_cast<uint32_t*>(mFogOfWarImage->data());
+        for (unsigned char value : alpha)
+            *texel++ = static_cast<uint32_t>(value) << 24;
+        mFogOfWarImage->dirty();
+        mHasFogState = true;
+        return;
+    }
+
     osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("png");
     if (!readerwriter)
     {
@@ -629,11 +661,42 @@ void LocalMap::MapSegment::loadFogOfWar(const ESM::FogTexture &esm)
     mHasFogState = true;
 }
 
-void LocalMap::MapSegment::saveFogOfWar(ESM::FogTexture &fog) const
+void LocalMap::MapSegment::saveFogOfWar(ESM::FogTexture &fog)
 {
     if (!mFogOfWarImage)
         return;
 
+    mFogChanged = false;
+
+    // Images loaded from older saves may have a different size, keep them as they are
+    if (mFogOfWarImage->s() != sFogOfWarResolution || mFogOfWarImage->t() != sFogOfWarResolution
+        || mFogOfWarImage->getPixelFormat() != GL_RGBA || mFogOfWarImage->getDataType() != GL_UNSIGNED_BYTE)
+    {
+        savePngFogOfWar(fog);
+        return;
+    }
+
+    std::vector<unsigned char> alpha(sFogOfWarResolution * sFogOfWarResolution);
+    const uint32_t* texel = reinterpret_cast<const uint32_t*>(mFogOfWarImage->data());
+    bool explored = false;
+    for (unsigned char& value : alpha)
+    {
+        value = static_cast<unsigned char>(*texel++ >> 24);
+        explored = explored || value != 255;
+    }
+
+    // Unexplored texture is loaded by initFogOfWar
+    if (!explored)
+    {
+        fog.mImageData.clear();
+        return;
+    }
+
+    fog.mImageData = ESM::compressFogTexture(alpha);
+}
+
+void LocalMap::MapSegment::savePngFogOfWar(ESM::FogTexture &fog) const
+{
     std::ostringstream ostream;
 
     osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("png");
@@ -112,7 +112,8 @@ namespace MWRender
 
             void initFogOfWar();
             void loadFogOfWar(const ESM::FogTexture& fog);
-            void saveFogOfWar(ESM::FogTexture& fog) const;
+            void saveFogOfWar(ESM::FogTexture& fog);
+            void savePngFogOfWar(ESM::FogTexture& fog) const;
             void createFogOfWarTexture();
 
             osg::ref_ptr<osg::Texture2D> mMapTexture;
@@ -122,6 +123,9 @@ namespace MWRender
             bool needUpdate = true;
 
             bool mHasFogState;
+
+            // Fog of war is changed since it was loaded from or saved to the CellStore
+            bool mFogChanged = false;
         };
 
         typedef std::map<std::pair<int, int>, MapSegment> SegmentMap;
@@ -252,7 +252,7 @@ namespace MWRender
             }
         }
 
-        const auto version = navMesh->lock()->getVersion();
+        const auto version = navMesh->getVersion();
 
         if (!mTiles.empty() && mId == id && mVersion == version)
             return;
@@ -5,7 +5,6 @@
 
 #include <components/detournavigator/version.hpp>
 #include <components/detournavigator/tileposition.hpp>
-#include <components/misc/guarded.hpp>
 
 #include <osg/ref_ptr>
 
@@ -26,7 +25,7 @@ namespace osg
 
 namespace DetourNavigator
 {
-    class NavMeshCacheItem;
+    class GuardedNavMeshCacheItem;
     struct Settings;
 }
 
@@ -46,7 +45,7 @@ namespace MWRender
 
         bool toggle();
 
-        void update(const std::shared_ptr<Misc::ScopeGuarded<DetourNavigator::NavMeshCacheItem>>& navMesh,
+        void update(const std::shared_ptr<DetourNavigator::GuardedNavMeshCacheItem>& navMesh,
             std::size_t id, const DetourNavigator::Settings& settings);
 
         void reset();
@@ -1,12 +1,17 @@
 #include "objectpaging.hpp"
 
+#include <chrono>
 #include <unordered_map>
 
+#include <osg/AlphaFunc>
 #include <osg/LOD>
 #include <osg/Switch>
 #include <osg/Sequence>
 #include <osg/MatrixTransform>
 #include <osg/Material>
+#include <osg/Program>
+#include <osg/VertexAttribDivisor>
+#include <osgUtil/CullVisitor>
 #include <osgUtil/IncrementalCompileOperation>
 
 #include <components/esm3/esmreader.hpp>
@@ -16,6 +21,8 @@
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/clone.hpp>
 #include <components/sceneutil/util.hpp>
+#include <components/sceneutil/nodecallback.hpp>
+#include <components/shader/shadermanager.hpp>
 #include <components/vfs/manager.hpp>
 #include <components/esm3/readerscache.hpp>
 
@@ -397,10 +404,324 @@ namespace MWRender
         }
     };
 
+    class InstancingCheckVisitor : public osg::NodeVisitor
+    {
+    public:
+        InstancingCheckVisitor(osg::Node::NodeMask checkMask) : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) { setTraversalMask(checkMask); }
+
+        void apply(osg::Node& node) override
+        {
+            // Billboards need a per-instance orientation and custom shaders do not know about instancing
+            for (const osg::Callback* callback = node.getCullCallback(); callback != nullptr; callback = callback->getNestedCallback())
+                if (callback->className() == std::string("BillboardCallback"))
+                    mInstanceable = false;
+            std::string shaderPrefix;
+            if (node.getUserValue("shaderPrefix", shaderPrefix))
+                mInstanceable = false;
+            // The transparent depth postpass and the alpha tested shadow casting program do not apply the instance transforms
+            if (const osg::StateSet* stateset = node.getStateSet())
+            {
+                if (stateset->getRenderingHint() == osg::StateSet::TRANSPARENT_BIN || (stateset->getMode(GL_BLEND) & osg::StateAttribute::ON))
+                    mInstanceable = false;
+                const osg::AlphaFunc* alphaFunc = static_cast<const osg::AlphaFunc*>(stateset->getAttribute(osg::StateAttribute::ALPHAFUNC));
+                if (alphaFunc && alphaFunc->getFunction() != osg::AlphaFunc::ALWAYS)
+                    mInstanceable = false;
+            }
+
+            if (const osg::LOD* lod = dynamic_cast<const osg::LOD*>(&node))
+                mLODs.push_back(lod);
+
+            traverse(node);
+        }
+
+        /// @return the LOD children which CopyOp would pick for the given distance
+        std::vector<bool> getLODKey(float sqrDistance) const
+        {
+            std::vector<bool> key;
+            for (const osg::LOD* lod : mLODs)
+                for (unsigned int i=0; i<lod->getNumChildren(); ++i)
+                    key.push_back(lod->getMinRange(i) * lod->getMinRange(i) <= sqrDistance && sqrDistance < lod->getMaxRange(i) * lod->getMaxRange(i));
+            return key;
+        }
+
+        bool mInstanceable = true;
+        std::vector<const osg::LOD*> mLODs;
+    };
+
+    class InstancingCompatibleVisitor : public osg::NodeVisitor
+    {
+    public:
+        InstancingCompatibleVisitor() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+        // The instance transform is applied to the vertices before the model view matrix,
+        // so no transforms may be left between the instanced geometry and the chunk.
+        void apply(osg::Transform& node) override { mCompatible = false; }
+        void apply(osg::Drawable& drawable) override { mCompatible = false; }
+        void apply(osg::Geometry& geom) override {}
+
+        bool mCompatible = true;
+    };
+
+    class CollectPrimitiveSetsVisitor : public osg::NodeVisitor
+    {
+    public:
+        CollectPrimitiveSetsVisitor() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+        void apply(osg::Geometry& geom) override
+        {
+            for (unsigned int i = 0; i < geom.getNumPrimitiveSets(); ++i)
+                mPrimitiveSets.insert(geom.getPrimitiveSet(i));
+        }
+
+        std::set<const osg::PrimitiveSet*> mPrimitiveSets;
+    };
+
+    class InstancedGeometryVisitor : public osg::NodeVisitor
+    {
+    public:
+        /// @param shared primitive sets of the template, copies of the template still refer to them
+        InstancedGeometryVisitor(osg::Vec4Array* offsets, osg::Vec4Array* rotations, const std::set<const osg::PrimitiveSet*>& shared)
+         : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+         , mOffsets(offsets)
+         , mRotations(rotations)
+         , mShared(shared)
+        {
+        }
+
+        void apply(osg::Geometry& geom) override
+        {
+            osg::ref_ptr<osg::ElementBufferObject> ebo;
+            for (unsigned int i = 0; i < geom.getNumPrimitiveSets(); ++i)
+            {
+                osg::ref_ptr<osg::PrimitiveSet> primitiveSet = geom.getPrimitiveSet(i);
+                if (mShared.count(primitiveSet.get()))
+                {
+                    primitiveSet = static_cast<osg::PrimitiveSet*>(primitiveSet->clone(osg::CopyOp::DEEP_COPY_ALL));
+                    if (osg::DrawElements* drawElements = primitiveSet->getDrawElements())
+                    {
+                        if (!ebo)
+                            ebo = new osg::ElementBufferObject;
+                        drawElements->setElementBufferObject(ebo);
+                    }
+                    geom.setPrimitiveSet(i, primitiveSet);
+                }
+                primitiveSet->setNumInstances(mOffsets->getNumElements());
+            }
+
+            const osg::BoundingBox& localBox = geom.getBoundingBox();
+            float radius = localBox.center().length() + localBox.radius();
+            osg::BoundingBox box;
+            for (const osg::Vec4f& offset : *mOffsets)
+                box.expandBy(osg::BoundingSphere(osg::Vec3f(offset.x(), offset.y(), offset.z()), radius * offset.w()));
+            geom.setInitialBound(box);
+
+            // Display lists do not support instancing in OSG 3.4
+            geom.setUseDisplayList(false);
+            geom.setUseVertexBufferObjects(true);
+
+            geom.setVertexAttribArray(6, mOffsets, osg::Array::BIND_PER_VERTEX);
+            geom.setVertexAttribArray(7, mRotations, osg::Array::BIND_PER_VERTEX);
+        }
+
+    private:
+        osg::ref_ptr<osg::Vec4Array> mOffsets;
+        osg::ref_ptr<osg::Vec4Array> mRotations;
+        const std::set<const osg::PrimitiveSet*>& mShared;
+    };
+
+    class InstancedChunkCullCallback : public SceneUtil::NodeCallback<InstancedChunkCullCallback, osg::Node*, osgUtil::CullVisitor*>
+    {
+    public:
+        void operator()(osg::Node* node, osgUtil::CullVisitor* cv)
+        {
+            // The shadow casting program does not apply the instance transforms
+            if (cv->getCurrentCamera()->getName() == "ShadowCamera")
+                return;
+            traverse(node, cv);
+        }
+    };
+
+    class ChunkStats : public osg::Object
+    {
+    public:
+        ChunkStats() {}
+        ChunkStats(const ChunkStats& copy, const osg::CopyOp&) : mNumDrawCalls(copy.mNumDrawCalls), mVertexMemory(copy.mVertexMemory), mBuildTime(copy.mBuildTime) {}
+        META_Object(MWRender, ChunkStats)
+
+        ~ChunkStats()
+        {
+            if (mTotals)
+                mTotals->remove(*this);
+        }
+
+        /// Count this chunk in totals until it is destroyed
+        void addTo(ChunkStatsTotals& totals)
+        {
+            mTotals = &totals;
+            totals.add(*this);
+        }
+
+        unsigned int mNumDrawCalls = 0;
+        std::size_t mVertexMemory = 0;
+        double mBuildTime = 0; // ms
+
+    private:
+        osg::ref_ptr<ChunkStatsTotals> mTotals;
+    };
+
+    void ChunkStatsTotals::add(const ChunkStats& stats)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        ++mNumChunks;
+        mNumDrawCalls += stats.mNumDrawCalls;
+        mVertexMemory += stats.mVertexMemory;
+        mBuildTime += stats.mBuildTime;
+    }
+
+    void ChunkStatsTotals::remove(const ChunkStats& stats)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        --mNumChunks;
+        mNumDrawCalls -= stats.mNumDrawCalls;
+        mVertexMemory -= stats.mVertexMemory;
+        mBuildTime -= stats.mBuildTime;
+    }
+
+    class ChunkStatsVisitor : public osg::NodeVisitor
+    {
+    public:
+        ChunkStatsVisitor() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+        void apply(osg::Drawable& drawable) override
+        {
+            ++mStats->mNumDrawCalls;
+        }
+        void apply(osg::Geometry& geom) override
+        {
+            mStats->mNumDrawCalls += geom.getNumPrimitiveSets();
+            osg::Geometry::ArrayList arrays;
+            geom.getArrayList(arrays);
+            for (const osg::ref_ptr<osg::Array>& array : arrays)
+                if (mArrays.insert(array.get()).second)
+                    mStats->mVertexMemory += array->getTotalDataSize();
+        }
+
+        osg::ref_ptr<ChunkStats> mStats = new ChunkStats;
+        std::set<const osg::Array*> mArrays;
+    };
+
+    osg::Quat getAttitude(const ESM::Position& pos)
+    {
+        return osg::Quat(pos.rot[2], osg::Vec3f(0,0,-1)) *
+               osg::Quat(pos.rot[1], osg::Vec3f(0,-1,0)) *
+               osg::Quat(pos.rot[0], osg::Vec3f(-1,0,0));
+    }
+
+    /// Emit one instanced draw per unique mesh and LOD selection instead of copying the vertices of every instance.
+    /// @return false if the template can not be instanced, nothing is added to attachTo in that case
+    bool addInstancedNodes(const osg::Node* cnode, const std::vector<const PagedCellRef*>& instances, CopyOp& copyop,
+                           const osg::Vec3f& worldCenter, const osg::Vec3f& viewPoint, osg::Group& attachTo)
+    {
+        InstancingCheckVisitor checkVisitor(copyop.mCopyMask);
+        const_cast<osg::Node*>(cnode)->accept(checkVisitor);
+        if (!checkVisitor.mInstanceable)
+            return false;
+
+        CollectPrimitiveSetsVisitor sharedVisitor;
+        const_cast<osg::Node*>(cnode)->accept(sharedVisitor);
+
+        std::map<std::vector<bool>, std::vector<const PagedCellRef*>> lodGroups;
+        for (const PagedCellRef* ref : instances)
+            lodGroups[checkVisitor.getLODKey((viewPoint - ref->mPos.asVec3()).length2())].push_back(ref);
+
+        std::vector<osg::ref_ptr<osg::Group>> nodes;
+        for (const auto& [key, refs] : lodGroups)
+        {
+            osg::ref_ptr<osg::Group> node = new osg::Group;
+            copyop.setCopyFlags(osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES);
+            copyop.mOptimizeBillboards = false;
+            copyop.mSqrDistance = (viewPoint - refs.front()->mPos.asVec3()).length2();
+            copyop.copy(cnode, node);
+
+            // Bake the transforms of the template into its vertices once, rather than once per instance
+            SceneUtil::Optimizer optimizer;
+            optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
+            optimizer.optimize(node, SceneUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS|SceneUtil::Optimizer::REMOVE_REDUNDANT_NODES|SceneUtil::Optimizer::MERGE_GEOMETRY);
+
+            InstancingCompatibleVisitor compatibleVisitor;
+            node->accept(compatibleVisitor);
+            if (!compatibleVisitor.mCompatible)
+                return false;
+
+            osg::ref_ptr<osg::Vec4Array> offsets = new osg::Vec4Array;
+            osg::ref_ptr<osg::Vec4Array> rotations = new osg::Vec4Array;
+            offsets->reserve(refs.size());
+            rotations->reserve(refs.size());
+            for (const PagedCellRef* ref : refs)
+            {
+                offsets->push_back(osg::Vec4f(ref->mPos.asVec3() - worldCenter, ref->mScale));
+                rotations->push_back(osg::Vec4f(getAttitude(ref->mPos).asVec4()));
+            }
+            // Explicitly forbid the instance arrays from joining a BufferObject of the template geometry
+            osg::ref_ptr<osg::VertexBufferObject> vbo = new osg::VertexBufferObject;
+            offsets->setVertexBufferObject(vbo);
+            rotations->setVertexBufferObject(vbo);
+
+            InstancedGeometryVisitor instancedGeometryVisitor(offsets, rotations, sharedVisitor.mPrimitiveSets);
+            node->accept(instancedGeometryVisitor);
+            nodes.push_back(node);
+        }
+
+        for (const osg::ref_ptr<osg::Group>& node : nodes)
+            attachTo.addChild(node);
+        return true;
+    }
+
+    void loadStaticCellRefs(int cellX, int cellY, ESM::ReadersCache& readers, PagedCellRefs& refs)
+    {
+        const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
+        const ESM::Cell* cell = store.get<ESM::Cell>().searchStatic(cellX, cellY);
+        if (!cell)
+            return;
+        for (size_t i=0; i<cell->mContextList.size(); ++i)
+        {
+            try
+            {
+                const std::size_t index = static_cast<std::size_t>(cell->mContextList[i].index);
+                const ESM::ReadersCache::BusyItem reader = readers.get(index);
+                cell->restore(*reader, i);
+                ESM::CellRef ref;
+                ref.mRefNum.unset();
+                ESM::MovedCellRef cMRef;
+                cMRef.mRefNum.mIndex = 0;
+                bool deleted = false;
+                bool moved = false;
+                while (ESM::Cell::getNextRef(*reader, ref, deleted, cMRef, moved, ESM::Cell::GetNextRefMode::LoadOnlyNotMoved))
+                {
+                    if (moved)
+                        continue;
+
+                    if (std::find(cell->mMovedRefs.begin(), cell->mMovedRefs.end(), ref.mRefNum) != cell->mMovedRefs.end())
+                        continue;
+
+                    refs.emplace_back(std::move(ref), deleted);
+                }
+            }
+            catch (std::exception&)
+            {
+                continue;
+            }
+        }
+        for (auto [ref, deleted] : cell->mLeasedRefs)
+            refs.emplace_back(std::move(ref), deleted);
+    }
+
     ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager)
             : GenericResourceManager<ChunkId>(nullptr)
          , mSceneManager(sceneManager)
          , mRefTrackerLocked(false)
+         , mRefIndex(loadStaticCellRefs)
+         , mChunkStatsTotals(new ChunkStatsTotals)
     {
         mActiveGrid = Settings::Manager::getBool("object paging active grid", "Terrain");
         mDebugBatches = Settings::Manager::getBool("debug chunks", "Terrain");
@@ -408,69 +729,44 @@ namespace MWRender
         mMinSize = Settings::Manager::getFloat("object paging min size", "Terrain");
         mMinSizeMergeFactor = Settings::Manager::getFloat("object paging min size merge factor", "Terrain");
         mMinSizeCostMultiplier = Settings::Manager::getFloat("object paging min size cost multiplier", "Terrain");
+        mInstancing = Settings::Manager::getBool("object paging instancing", "Terrain");
+
+        if (mInstancing)
+        {
+            mInstancingStateSet = new osg::StateSet;
+            mInstancingStateSet->setAttribute(new osg::VertexAttribDivisor(6, 1));
+            mInstancingStateSet->setAttribute(new osg::VertexAttribDivisor(7, 1));
+
+            mInstancingProgramTemplate = mSceneManager->getShaderManager().getProgramTemplate() ? Shader::ShaderManager::cloneProgram(mSceneManager->getShaderManager().getProgramTemplate()) : osg::ref_ptr<osg::Program>(new osg::Program);
+            mInstancingProgramTemplate->addBindAttribLocation("aInstanceOffset", 6);
+            mInstancingProgramTemplate->addBindAttribLocation("aInstanceRotation", 7);
+        }
     }
 
     osg::ref_ptr<osg::Node> ObjectPaging::createChunk(float size, const osg::Vec2f& center, bool activeGrid, const osg::Vec3f& viewPoint, bool compile)
     {
+        const auto buildStart = std::chrono::steady_clock::now();
+
         osg::Vec2i startCell = osg::Vec2i(std::floor(center.x() - size/2.f), std::floor(center.y() - size/2.f));
 
         osg::Vec3f worldCenter = osg::Vec3f(center.x(), center.y(), 0)*ESM::Land::REAL_SIZE;
         osg::Vec3f relativeViewPoint = viewPoint - worldCenter;
 
-        std::map<ESM::RefNum, ESM::CellRef> refs;
-        ESM::ReadersCache readers;
+        std::vector<std::shared_ptr<const PagedCellRefs>> cellRefs;
+        std::map<ESM::RefNum, const PagedCellRef*> refs;
         const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
 
         for (int cellX = startCell.x(); cellX < startCell.x() + size; ++cellX)
         {
             for (int cellY = startCell.y(); cellY < startCell.y() + size; ++cellY)
             {
-                const ESM::Cell* cell = store.get<ESM::Cell>().searchStatic(cellX, cellY);
-                if (!cell) continue;
-                for (size_t i=0; i<cell->mContextList.size(); ++i)
+                cellRefs.push_back(mRefIndex.getRefs(cellX, cellY));
+                for (const PagedCellRef& ref : *cellRefs.back())
                 {
-                    try
-                    {
-                        const std::size_t index = static_cast<std::size_t>(cell->mContextList[i].index);
-                        const ESM::ReadersCache::BusyItem reader = readers.get(index);
-                        cell->restore(*reader, i);
-                        ESM::CellRef ref;
-                        ref.mRefNum.unset();
-                        ESM::MovedCellRef cMRef;
-                        cMRef.mRefNum.mIndex = 0;
-                        bool deleted = false;
-                        bool moved = false;
-                        while (ESM::Cell::getNextRef(*reader, ref, deleted, cMRef, moved, ESM::Cell::GetNextRefMode::LoadOnlyNotMoved))
-                        {
-                            if (moved)
-                                continue;
-
-                            if (std::find(cell->mMovedRefs.begin(), cell->mMovedRefs.end(), ref.mRefNum) != cell->mMovedRefs.end())
-                                continue;
-
-                            Misc::StringUtils::lowerCaseInPlace(ref.mRefID);
-                            int type = store.findStatic(ref.mRefID);
-                            if (!typeFilter(type,size>=2)) continue;
-                            if (deleted) { refs.erase(ref.mRefNum); continue; }
-                            refs[ref.mRefNum] = std::move(ref);
-                        }
-                    }
-                    catch (std::exception&)
-                    {
-                        continue;
-                    }
-                }
-                for (auto [ref, deleted] : cell->mLeasedRefs)
-                {
-                    if (deleted)
-                    {
-                        refs.erase(ref.mRefNum);
-                        continue;
-                    }
-                    Misc::StringUtils::lowerCaseInPlace(ref.mRefID);
                     int type = store.findStatic(ref.mRefID);
                     if (!typeFilter(type,size>=2)) continue;
-                    refs[ref.mRefNum] = std::move(ref);
+                    if (ref.mDeleted) { refs.erase(ref.mRefNum); continue; }
+                    refs[ref.mRefNum] = &ref;
                 }
             }
         }
@@ -486,7 +782,7 @@ namespace MWRender
         osg::Vec2f maxBound = (center + osg::Vec2f(size/2.f, size/2.f));
         struct InstanceList
         {
-            std::vector<const ESM::CellRef*> mInstances;
+            std::vector<const PagedCellRef*> mInstances;
             AnalyzeVisitor::Result mAnalyzeResult;
             bool mNeedCompile = false;
         };
@@ -507,7 +803,7 @@ namespace MWRender
             minSize *= mMinSizeMergeFactor;
         for (const auto& pair : refs)
         {
-            const ESM::CellRef& ref = pair.second;
+            const PagedCellRef& ref = *pair.second;
 
             osg::Vec3f pos = ref.mPos.asVec3();
             if (size < 1.f)
@@ -585,6 +881,7 @@ namespace MWRender
 
         osg::ref_ptr<osg::Group> group = new osg::Group;
         osg::ref_ptr<osg::Group> mergeGroup = new osg::Group;
+        osg::ref_ptr<osg::Group> instancedGroup = new osg::Group;
         osg::ref_ptr<Resource::TemplateMultiRef> templateRefs = new Resource::TemplateMultiRef;
         osgUtil::StateToCompile stateToCompile(0, nullptr);
         CopyOp copyop;
@@ -605,19 +902,34 @@ namespace MWRender
             if (minSizeMergeFactor2 > 0)
                 minSizeMerged *= minSizeMergeFactor2;
 
-            unsigned int numinstances = 0;
+            std::vector<const PagedCellRef*> instances;
+            instances.reserve(pair.second.mInstances.size());
             for (auto cref : pair.second.mInstances)
             {
-                const ESM::CellRef& ref = *cref;
-                osg::Vec3f pos = ref.mPos.asVec3();
-
-                if (!activeGrid && minSizeMerged != minSize && cnode->getBound().radius2() * cref->mScale*cref->mScale < (viewPoint-pos).length2()*minSizeMerged*minSizeMerged)
+                if (!activeGrid && minSizeMerged != minSize && cnode->getBound().radius2() * cref->mScale*cref->mScale < (viewPoint-cref->mPos.asVec3()).length2()*minSizeMerged*minSizeMerged)
                     continue;
+                instances.push_back(cref);
+            }
+
+            if (mInstancing && !activeGrid && instances.size() > 1 && addInstancedNodes(cnode, instances, copyop, worldCenter, viewPoint, *instancedGroup))
+            {
+                templateRefs->addRef(cnode);
+                if (pair.second.mNeedCompile)
+                {
+                    stateToCompile._mode = osgUtil::GLObjectsVisitor::COMPILE_STATE_ATTRIBUTES;
+                    const_cast<osg::Node*>(cnode)->accept(stateToCompile);
+                }
+                continue;
+            }
+
+            unsigned int numinstances = 0;
+            for (auto cref : instances)
+            {
+                const PagedCellRef& ref = *cref;
+                osg::Vec3f pos = ref.mPos.asVec3();
 
                 osg::Vec3f nodePos = pos - worldCenter;
-                osg::Quat nodeAttitude = osg::Quat(ref.mPos.rot[2], osg::Vec3f(0,0,-1)) *
-                                        osg::Quat(ref.mPos.rot[1], osg::Vec3f(0,-1,0)) *
-                                        osg::Quat(ref.mPos.rot[0], osg::Vec3f(-1,0,0));
+                osg::Quat nodeAttitude = getAttitude(ref.mPos);
                 osg::Vec3f nodeScale = osg::Vec3f(ref.mScale, ref.mScale, ref.mScale);
 
                 osg::ref_ptr<osg::Group> trans;
@@ -699,6 +1011,7 @@ namespace MWRender
             unsigned int options = SceneUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS|SceneUtil::Optimizer::REMOVE_REDUNDANT_NODES|SceneUtil::Optimizer::MERGE_GEOMETRY;
 
             optimizer.optimize(mergeGroup, options);
+            mSceneManager->addOptimizerStats(optimizer);
 
             group->addChild(mergeGroup);
 
@@ -714,6 +1027,27 @@ namespace MWRender
             }
         }
 
+        if (instancedGroup->getNumChildren())
+        {
+            instancedGroup->setStateSet(mInstancingStateSet);
+            instancedGroup->addCullCallback(new InstancedChunkCullCallback);
+            mSceneManager->recreateShaders(instancedGroup, "objects", true, mInstancingProgramTemplate, true);
+            mSceneManager->shareState(instancedGroup);
+
+            group->addChild(instancedGroup);
+
+            if (mDebugBatches)
+            {
+                DebugVisitor dv;
+                instancedGroup->accept(dv);
+            }
+            if (compile)
+            {
+                stateToCompile._mode = osgUtil::GLObjectsVisitor::COMPILE_STATE_ATTRIBUTES|osgUtil::GLObjectsVisitor::COMPILE_DISPLAY_LISTS;
+                instancedGroup->accept(stateToCompile);
+            }
+        }
+
         auto ico = mSceneManager->getIncrementalCompileOperation();
         if (!stateToCompile.empty() && ico)
         {
@@ -732,6 +1066,12 @@ namespace MWRender
         }
         udc->addUserObject(templateRefs);
 
+        ChunkStatsVisitor statsVisitor;
+        group->accept(statsVisitor);
+        statsVisitor.mStats->mBuildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+        statsVisitor.mStats->addTo(*mChunkStatsTotals);
+        udc->addUserObject(statsVisitor.mStats);
+
         return group;
     }
 
@@ -867,6 +1207,12 @@ namespace MWRender
     void ObjectPaging::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Object Chunk", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Object Refs", mRefIndex.getNumRefs());
+
+        std::lock_guard<std::mutex> lock(mChunkStatsTotals->mMutex);
+        stats->setAttribute(frameNumber, "Object Chunk Draws", mChunkStatsTotals->mNumDrawCalls);
+        stats->setAttribute(frameNumber, "Object Chunk Vertex Memory", mChunkStatsTotals->mVertexMemory);
+        stats->setAttribute(frameNumber, "Object Chunk Build Time", mChunkStatsTotals->mNumChunks ? mChunkStatsTotals->mBuildTime / mChunkStatsTotals->mNumChunks : 0.0);
     }
 
 }
@@ -7,10 +7,16 @@
 
 #include <mutex>
 
+#include "cellrefindex.hpp"
+
 namespace Resource
 {
     class SceneManager;
 }
+namespace osg
+{
+    class Program;
+}
 namespace MWWorld
 {
     class ESMStore;
@@ -21,11 +27,25 @@ namespace MWRender
 
     typedef std::tuple<osg::Vec2f, float, bool> ChunkId; // Center, Size, ActiveGrid
 
+    class ChunkStats;
+
+    /// Sums of the stats of all chunks alive, so reporting them does not need to walk the cache
+    struct ChunkStatsTotals : public osg::Referenced
+    {
+        std::mutex mMutex;
+        unsigned int mNumChunks = 0;
+        unsigned int mNumDrawCalls = 0;
+        std::size_t mVertexMemory = 0;
+        double mBuildTime = 0; // ms
+
+        void add(const ChunkStats& stats);
+        void remove(const ChunkStats& stats);
+    };
+
     class ObjectPaging : public Resource::GenericResourceManager<ChunkId>, public Terrain::QuadTreeWorld::ChunkManager
     {
     public:
         ObjectPaging(Resource::SceneManager* sceneManager);
-        ~ObjectPaging() = default;
 
         osg::ref_ptr<osg::Node> getChunk(float size, const osg::Vec2f& center, unsigned char lod, unsigned int lodFlags, bool activeGrid, const osg::Vec3f& viewPoint, bool compile) override;
 
@@ -57,6 +77,9 @@ namespace MWRender
         float mMinSize;
         float mMinSizeMergeFactor;
         float mMinSizeCostMultiplier;
+        bool mInstancing;
+        osg::ref_ptr<osg::StateSet> mInstancingStateSet;
+        osg::ref_ptr<osg::Program> mInstancingProgramTemplate;
 
         std::mutex mRefTrackerMutex;
         struct RefTracker
@@ -75,6 +98,10 @@ namespace MWRender
         std::mutex mSizeCacheMutex;
         typedef std::map<ESM::RefNum, float> SizeCache;
         SizeCache mSizeCache;
+
+        CellRefIndex mRefIndex;
+
+        osg::ref_ptr<ChunkStatsTotals> mChunkStatsTotals;
     };
 
     class RefnumMarker : public osg::Object
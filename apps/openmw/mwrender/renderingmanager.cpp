@@ -2,6 +2,7 @@
 
 #include <limits>
 #include <cstdlib>
+#include <filesystem>
 
 #include <osg/Light>
 #include <osg/LightModel>
@@ -369,7 +370,7 @@ namespace MWRender
     RenderingManager::RenderingManager(osgViewer::Viewer* viewer, osg::ref_ptr<osg::Group> rootNode,
         Resource::ResourceSystem* resourceSystem, SceneUtil::WorkQueue* workQueue, const std::string& resourcePath,
         DetourNavigator::Navigator& navigator, const MWWorld::GroundcoverStore& groundcoverStore,
-        SceneUtil::UnrefQueue& unrefQueue)
+        SceneUtil::UnrefQueue& unrefQueue, const std::string& userDataPath)
         : mSkyBlending(Settings::Manager::getBool("sky blending", "Fog"))
         , mViewer(viewer)
         , mRootNode(rootNode)
@@ -527,6 +528,8 @@ namespace MWRender
             mTerrain = std::make_unique<Terrain::TerrainGrid>(sceneRoot, mRootNode, mResourceSystem, mTerrainStorage.get(), Mask_Terrain, Mask_PreCompile, Mask_Debug);
 
         mTerrain->setTargetFrameRate(Settings::Manager::getFloat("target framerate", "Cells"));
+        if (Settings::Manager::getBool("composite map cache", "Terrain"))
+            mTerrain->enableCompositeMapCache(std::filesystem::path(userDataPath) / "compositemaps");
 
         if (groundcover)
         {
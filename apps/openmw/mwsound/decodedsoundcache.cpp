@@ -0,0 +1,71 @@
+#include "decodedsoundcache.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/misc/resourcehelpers.hpp>
+
+namespace MWSound
+{
+    std::shared_ptr<const DecodedSound> decodeSound(Sound_Decoder& decoder, const std::string& fname)
+    {
+        auto result = std::make_shared<DecodedSound>();
+        try
+        {
+            decoder.open(Misc::ResourceHelpers::correctSoundPath(fname, decoder.mResourceMgr));
+            decoder.getInfo(&result->mSampleRate, &result->mChannelConfig, &result->mSampleType);
+            decoder.readAll(result->mData);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to load audio from " << fname << ": " << e.what();
+            result->mData.clear();
+        }
+        return result;
+    }
+
+    std::shared_ptr<const DecodedSound> DecodedSoundCache::get(const std::string& fname)
+    {
+        const std::lock_guard lock(mMutex);
+        const auto it = mIndex.find(fname);
+        if (it == mIndex.end())
+            return nullptr;
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+        return it->second->second;
+    }
+
+    void DecodedSoundCache::insert(const std::string& fname, std::shared_ptr<const DecodedSound> sound)
+    {
+        const std::size_t size = sound->mData.size();
+        if (size > mMaxSize)
+            return;
+
+        const std::lock_guard lock(mMutex);
+        if (mIndex.find(fname) != mIndex.end())
+            return;
+
+        mEntries.emplace_front(fname, std::move(sound));
+        mIndex.emplace(fname, mEntries.begin());
+        mSize += size;
+
+        while (mSize > mMaxSize)
+        {
+            const Entry& oldest = mEntries.back();
+            mSize -= oldest.second->mData.size();
+            mIndex.erase(oldest.first);
+            mEntries.pop_back();
+        }
+    }
+
+    void DecodedSoundCache::clear()
+    {
+        const std::lock_guard lock(mMutex);
+        mIndex.clear();
+        mEntries.clear();
+        mSize = 0;
+    }
+
+    std::size_t DecodedSoundCache::getSize() const
+    {
+        const std::lock_guard lock(mMutex);
+        return mSize;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef GAME_SOUND_DECODEDSOUNDCACHE_H
+#define GAME_SOUND_DECODEDSOUNDCACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sound_decoder.hpp"
+
+namespace MWSound
+{
+    /// Fully decoded PCM data of a sound file, ready to be uploaded by the output.
+    struct DecodedSound
+    {
+        std::vector<char> mData;
+        int mSampleRate = 0;
+        ChannelConfig mChannelConfig = ChannelConfig_Mono;
+        SampleType mSampleType = SampleType_UInt8;
+    };
+
+    /// Decode the whole file. Thread safe as long as each thread uses its own decoder.
+    /// @return empty data if the file could not be decoded, the output is expected to substitute it.
+    std::shared_ptr<const DecodedSound> decodeSound(Sound_Decoder& decoder, const std::string& fname);
+
+    /// @brief Thread safe least recently used cache of decoded sounds, limited by the total size of the PCM data.
+    class DecodedSoundCache
+    {
+        public:
+            explicit DecodedSoundCache(std::size_t maxSize) : mMaxSize(maxSize) {}
+
+            std::shared_ptr<const DecodedSound> get(const std::string& fname);
+
+            void insert(const std::string& fname, std::shared_ptr<const DecodedSound> sound);
+
+            void clear();
+
+            std::size_t getSize() const;
+
+        private:
+            using Entry = std::pair<std::string, std::shared_ptr<const DecodedSound>>;
+
+            mutable std::mutex mMutex;
+            const std::size_t mMaxSize;
+            std::size_t mSize = 0;
+            // NOTE: entries are stored in front-newest order.
+            std::list<Entry> mEntries;
+            std::unordered_map<std::string, std::list<Entry>::iterator> mIndex;
+    };
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef GAME_SOUND_EMITTERMAP_H
+#define GAME_SOUND_EMITTERMAP_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace MWWorld
+{
+    struct LiveCellRefBase;
+}
+
+namespace MWSound
+{
+    /// @brief Map from objects emitting sounds to their state, stored contiguously to be walked every frame.
+    /// @note Erasing moves the last element into the freed slot, so it invalidates iterators to the last element and
+    /// doesn't keep the order.
+    template <class T>
+    class EmitterMap
+    {
+        public:
+            using Key = const MWWorld::LiveCellRefBase*;
+            using value_type = std::pair<Key, T>;
+            using iterator = typename std::vector<value_type>::iterator;
+            using const_iterator = typename std::vector<value_type>::const_iterator;
+
+            iterator begin() { return mValues.begin(); }
+            iterator end() { return mValues.end(); }
+            const_iterator begin() const { return mValues.begin(); }
+            const_iterator end() const { return mValues.end(); }
+
+            bool empty() const { return mValues.empty(); }
+            std::size_t size() const { return mValues.size(); }
+
+            iterator find(Key key)
+            {
+                const auto it = mIndex.find(key);
+                return it == mIndex.end() ? end() : begin() + it->second;
+            }
+
+            const_iterator find(Key key) const
+            {
+                const auto it = mIndex.find(key);
+                return it == mIndex.end() ? end() : begin() + it->second;
+            }
+
+            std::pair<iterator, bool> emplace(Key key, T&& value)
+            {
+                const auto [it, inserted] = mIndex.emplace(key, mValues.size());
+                if (!inserted)
+                    return {begin() + it->second, false};
+                mValues.emplace_back(key, std::move(value));
+                return {end() - 1, true};
+            }
+
+            T& operator[](Key key)
+            {
+                return emplace(key, T()).first->second;
+            }
+
+            /// @return iterator to the element that took the place of the erased one.
+            iterator erase(iterator it)
+            {
+                const std::size_t index = static_cast<std::size_t>(it - begin());
+                mIndex.erase(it->first);
+                if (index + 1 != mValues.size())
+                {
+                    *it = std::move(mValues.back());
+                    mIndex[it->first] = index;
+                }
+                mValues.pop_back();
+                return begin() + index;
+            }
+
+            void clear()
+            {
+                mValues.clear();
+                mIndex.clear();
+            }
+
+        private:
+            std::vector<value_type> mValues;
+            std::unordered_map<Key, std::size_t> mIndex;
+    };
+}
+
+#endif
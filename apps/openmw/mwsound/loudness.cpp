@@ -1,11 +1,10 @@
 #include "loudness.hpp"
 
+#include <cmath>
 #include <cstdint>
 #include <limits>
 #include <algorithm>
 
-#include "soundmanagerimp.hpp"
-
 namespace MWSound
 {
 
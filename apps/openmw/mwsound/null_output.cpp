@@ -0,0 +1,386 @@
+#include "null_output.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <components/debug/debuglog.hpp>
+
+#include "decodedsoundcache.hpp"
+#include "loudness.hpp"
+#include "sound.hpp"
+
+namespace MWSound
+{
+    namespace
+    {
+        constexpr int sLoudnessFPS = 20; // loudness values per second of audio
+    }
+
+    NullOutput::NullOutput(const MWBase::SoundManager* manager, std::size_t maxSources, bool realTime)
+        : mManager(manager)
+        , mRealTime(realTime)
+        , mSources(maxSources)
+    {
+    }
+
+    NullOutput::~NullOutput()
+    {
+        NullOutput::deinit();
+    }
+
+    std::vector<std::string> NullOutput::enumerate()
+    {
+        return {"Null output"};
+    }
+
+    bool NullOutput::init(const std::string& /*devname*/, const std::string& /*hrtfname*/, HrtfMode /*hrtfmode*/)
+    {
+        deinit();
+
+        for (Source& source : mSources)
+            mFreeSources.push_back(&source);
+        mLastUpdate = std::chrono::steady_clock::now();
+
+        Log(Debug::Info) << "Using null sound output with " << mFreeSources.size() << " sound sources";
+
+        mInitialized = true;
+        return true;
+    }
+
+    void NullOutput::deinit()
+    {
+        for (Sound* sound : mActiveSounds)
+            sound->mHandle = nullptr;
+        mActiveSounds.clear();
+        for (Stream* sound : mActiveStreams)
+            sound->mHandle = nullptr;
+        mActiveStreams.clear();
+        for (Source& source : mSources)
+            source = Source();
+        mFreeSources.clear();
+        mInitialized = false;
+    }
+
+    std::vector<std::string> NullOutput::enumerateHrtf()
+    {
+        return {};
+    }
+
+    void NullOutput::setHrtf(const std::string& /*hrtfname*/, HrtfMode /*hrtfmode*/)
+    {
+    }
+
+    std::pair<Sound_Handle, size_t> NullOutput::loadSound(const DecodedSound& sound)
+    {
+        auto buffer = std::make_unique<Buffer>();
+        if (sound.mData.empty() || sound.mSampleRate <= 0)
+        {
+            // Same as the silence substituted by the OpenAL output.
+            buffer->mSize = 8000;
+            buffer->mLength = 1.0;
+        }
+        else
+        {
+            buffer->mSize = sound.mData.size();
+            buffer->mLength = static_cast<double>(bytesToFrames(sound.mData.size(), sound.mChannelConfig,
+                sound.mSampleType)) / sound.mSampleRate;
+        }
+        mStats.mBufferMemory += buffer->mSize;
+        const std::size_t size = buffer->mSize;
+        return std::make_pair(buffer.release(), size);
+    }
+
+    size_t NullOutput::unloadSound(Sound_Handle data)
+    {
+        Buffer* const buffer = static_cast<Buffer*>(data);
+        if (buffer == nullptr)
+            return 0;
+
+        // Make sure no sources are playing this buffer before unloading it.
+        for (Sound* sound : mActiveSounds)
+        {
+            Source* const source = getSource(*sound);
+            if (source != nullptr && source->mBuffer == buffer)
+            {
+                source->mBuffer = nullptr;
+                source->mPlaying = false;
+            }
+        }
+
+        const std::size_t size = buffer->mSize;
+        mStats.mBufferMemory -= size;
+        delete buffer;
+        return size;
+    }
+
+    bool NullOutput::playSound(Sound* sound, Sound_Handle data, float offset)
+    {
+        return playBuffer(sound, data, offset);
+    }
+
+    bool NullOutput::playSound3D(Sound* sound, Sound_Handle data, float offset)
+    {
+        return playBuffer(sound, data, offset);
+    }
+
+    void NullOutput::finishSound(Sound* sound)
+    {
+        Source* const source = getSource(*sound);
+        if (source == nullptr)
+            return;
+        sound->mHandle = nullptr;
+        releaseSource(*source);
+        mActiveSounds.erase(std::find(mActiveSounds.begin(), mActiveSounds.end(), sound));
+    }
+
+    bool NullOutput::isSoundPlaying(Sound* sound)
+    {
+        const Source* const source = getSource(*sound);
+        return source != nullptr && source->mPlaying;
+    }
+
+    void NullOutput::updateSound(Sound* /*sound*/)
+    {
+    }
+
+    bool NullOutput::streamSound(DecoderPtr decoder, Stream* sound, bool getLoudnessData)
+    {
+        return playStream(std::move(decoder), sound, getLoudnessData);
+    }
+
+    bool NullOutput::streamSound3D(DecoderPtr decoder, Stream* sound, bool getLoudnessData)
+    {
+        return playStream(std::move(decoder), sound, getLoudnessData);
+    }
+
+    void NullOutput::finishStream(Stream* sound)
+    {
+        Source* const source = getSource(*sound);
+        if (source == nullptr)
+            return;
+        sound->mHandle = nullptr;
+        releaseSource(*source);
+        mActiveStreams.erase(std::find(mActiveStreams.begin(), mActiveStreams.end(), sound));
+    }
+
+    double NullOutput::getStreamDelay(Stream* /*sound*/)
+    {
+        return 0.0;
+    }
+
+    double NullOutput::getStreamOffset(Stream* sound)
+    {
+        const Source* const source = getSource(*sound);
+        return source != nullptr ? source->mOffset : 0.0;
+    }
+
+    float NullOutput::getStreamLoudness(Stream* sound)
+    {
+        const Source* const source = getSource(*sound);
+        if (source == nullptr || source->mLoudness == nullptr)
+            return 0.0f;
+        return source->mLoudness->getLoudnessAtTime(static_cast<float>(source->mOffset));
+    }
+
+    bool NullOutput::isStreamPlaying(Stream* sound)
+    {
+        const Source* const source = getSource(*sound);
+        return source != nullptr && source->mPlaying;
+    }
+
+    void NullOutput::updateStream(Stream* /*sound*/)
+    {
+    }
+
+    void NullOutput::startUpdate()
+    {
+        if (!mRealTime)
+            return;
+        const auto now = std::chrono::steady_clock::now();
+        advance(std::chrono::duration<double>(now - mLastUpdate).count());
+        mLastUpdate = now;
+    }
+
+    void NullOutput::finishUpdate()
+    {
+    }
+
+    void NullOutput::updateListener(const osg::Vec3f& /*pos*/, const osg::Vec3f& /*atdir*/,
+        const osg::Vec3f& /*updir*/, Environment /*env*/)
+    {
+    }
+
+    void NullOutput::pauseSounds(int types)
+    {
+        for (Sound* sound : mActiveSounds)
+            if (types & sound->getPlayType())
+                getSource(*sound)->mPaused = true;
+        for (Stream* sound : mActiveStreams)
+            if (types & sound->getPlayType())
+                getSource(*sound)->mPaused = true;
+    }
+
+    void NullOutput::resumeSounds(int types)
+    {
+        for (Sound* sound : mActiveSounds)
+            if (types & sound->getPlayType())
+                getSource(*sound)->mPaused = false;
+        for (Stream* sound : mActiveStreams)
+            if (types & sound->getPlayType())
+                getSource(*sound)->mPaused = false;
+    }
+
+    void NullOutput::pauseActiveDevice()
+    {
+        mDevicePaused = true;
+    }
+
+    void NullOutput::resumeActiveDevice()
+    {
+        mDevicePaused = false;
+        mLastUpdate = std::chrono::steady_clock::now();
+    }
+
+    void NullOutput::advance(double seconds)
+    {
+        if (mDevicePaused || seconds <= 0)
+            return;
+
+        for (Sound* sound : mActiveSounds)
+        {
+            Source& source = *getSource(*sound);
+            if (!source.mPlaying || source.mPaused || source.mBuffer == nullptr)
+                continue;
+            source.mOffset += seconds * getTimeScaledPitch(*sound);
+            if (source.mOffset < source.mBuffer->mLength)
+                continue;
+            if (sound->getIsLooping() && source.mBuffer->mLength > 0)
+                source.mOffset = std::fmod(source.mOffset, source.mBuffer->mLength);
+            else
+                source.mPlaying = false;
+        }
+
+        for (Stream* sound : mActiveStreams)
+        {
+            Source& source = *getSource(*sound);
+            if (!source.mPlaying || source.mPaused)
+                continue;
+            decodeStream(source, seconds * getTimeScaledPitch(*sound));
+        }
+    }
+
+    NullOutput::Source* NullOutput::getSource(const SoundBase& sound)
+    {
+        return static_cast<Source*>(sound.mHandle);
+    }
+
+    NullOutput::Source* NullOutput::acquireSource()
+    {
+        if (mFreeSources.empty())
+        {
+            ++mStats.mRejected;
+            Log(Debug::Warning) << "No free sources!";
+            return nullptr;
+        }
+        Source* const source = mFreeSources.front();
+        mFreeSources.pop_front();
+        return source;
+    }
+
+    void NullOutput::releaseSource(Source& source)
+    {
+        source = Source();
+        mFreeSources.push_back(&source);
+    }
+
+    bool NullOutput::playBuffer(Sound* sound, Sound_Handle data, float offset)
+    {
+        Source* const source = acquireSource();
+        if (source == nullptr)
+            return false;
+
+        source->mSound = sound;
+        source->mBuffer = static_cast<const Buffer*>(data);
+        source->mOffset = offset;
+        source->mPlaying = offset < source->mBuffer->mLength || sound->getIsLooping();
+
+        sound->mHandle = source;
+        mActiveSounds.push_back(sound);
+        ++mStats.mSoundsPlayed;
+        return true;
+    }
+
+    bool NullOutput::playStream(DecoderPtr decoder, Stream* sound, bool getLoudnessData)
+    {
+        if (sound->getIsLooping())
+            Log(Debug::Warning) << "Warning: cannot loop stream \"" << decoder->getName() << "\"";
+
+        int sampleRate = 0;
+        ChannelConfig chans = ChannelConfig_Mono;
+        SampleType type = SampleType_UInt8;
+        try
+        {
+            decoder->getInfo(&sampleRate, &chans, &type);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to get stream info: " << e.what();
+            return false;
+        }
+
+        Source* const source = acquireSource();
+        if (source == nullptr)
+            return false;
+
+        source->mSound = sound;
+        source->mDecoder = std::move(decoder);
+        source->mSampleRate = sampleRate;
+        source->mChannelConfig = chans;
+        source->mSampleType = type;
+        if (getLoudnessData)
+            source->mLoudness = std::make_unique<Sound_Loudness>(sLoudnessFPS, sampleRate, chans, type);
+        source->mPlaying = true;
+
+        sound->mHandle = source;
+        mActiveStreams.push_back(sound);
+        ++mStats.mStreamsPlayed;
+        return true;
+    }
+
+    double NullOutput::getTimeScaledPitch(const SoundBase& sound) const
+    {
+        const bool shouldScale = mManager != nullptr && !(sound.mParams.mFlags & PlayMode::NoScaling);
+        return shouldScale ? sound.getPitch() * mManager->getSimulationTimeScale() : sound.getPitch();
+    }
+
+    void NullOutput::decodeStream(Source& source, double seconds)
+    {
+        const std::size_t frames = static_cast<std::size_t>(seconds * source.mSampleRate);
+        const std::size_t bytes = framesToBytes(frames, source.mChannelConfig, source.mSampleType);
+        if (bytes == 0)
+            return;
+
+        mDecodeBuffer.resize(bytes);
+        std::size_t total = 0;
+        try
+        {
+            std::size_t got;
+            while (total < bytes && (got = source.mDecoder->read(mDecodeBuffer.data() + total, bytes - total)) > 0)
+                total += got;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Error decoding stream \"" << source.mDecoder->getName() << "\": " << e.what();
+        }
+        mDecodeBuffer.resize(total);
+
+        if (source.mLoudness != nullptr)
+            source.mLoudness->analyzeLoudness(mDecodeBuffer);
+
+        mStats.mDecodedBytes += total;
+        source.mOffset += static_cast<double>(bytesToFrames(total, source.mChannelConfig, source.mSampleType))
+            / source.mSampleRate;
+        if (total < bytes)
+            source.mPlaying = false;
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef GAME_SOUND_NULL_OUTPUT_H
+#define GAME_SOUND_NULL_OUTPUT_H
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sound_decoder.hpp"
+#include "sound_output.hpp"
+
+namespace MWSound
+{
+    class SoundBase;
+    class Sound_Loudness;
+
+    /// @brief Sound output that doesn't need an audio device.
+    /// @note Tracks the playback position of sounds and decodes streams like a real device would consume them, but
+    /// discards the audio. Has the same source limit as the OpenAL output, so the sound manager behaves the same.
+    class NullOutput : public Sound_Output
+    {
+    public:
+        struct Stats
+        {
+            std::size_t mSoundsPlayed = 0;
+            std::size_t mStreamsPlayed = 0;
+            std::size_t mRejected = 0;
+            std::size_t mBufferMemory = 0;
+            std::size_t mDecodedBytes = 0;
+        };
+
+        /// @param manager is used to scale pitch with the simulation time scale, can be null.
+        /// @param realTime advance playback by the elapsed wall clock time on each update, otherwise only advance()
+        /// moves it.
+        explicit NullOutput(const MWBase::SoundManager* manager, std::size_t maxSources = 256, bool realTime = true);
+        ~NullOutput() override;
+
+        std::vector<std::string> enumerate() override;
+        bool init(const std::string &devname, const std::string &hrtfname, HrtfMode hrtfmode) override;
+        void deinit() override;
+
+        std::vector<std::string> enumerateHrtf() override;
+        void setHrtf(const std::string &hrtfname, HrtfMode hrtfmode) override;
+
+        std::pair<Sound_Handle,size_t> loadSound(const DecodedSound &sound) override;
+        size_t unloadSound(Sound_Handle data) override;
+
+        bool playSound(Sound *sound, Sound_Handle data, float offset) override;
+        bool playSound3D(Sound *sound, Sound_Handle data, float offset) override;
+        void finishSound(Sound *sound) override;
+        bool isSoundPlaying(Sound *sound) override;
+        void updateSound(Sound *sound) override;
+
+        bool streamSound(DecoderPtr decoder, Stream *sound, bool getLoudnessData=false) override;
+        bool streamSound3D(DecoderPtr decoder, Stream *sound, bool getLoudnessData) override;
+        void finishStream(Stream *sound) override;
+        double getStreamDelay(Stream *sound) override;
+        double getStreamOffset(Stream *sound) override;
+        float getStreamLoudness(Stream *sound) override;
+        bool isStreamPlaying(Stream *sound) override;
+        void updateStream(Stream *sound) override;
+
+        void startUpdate() override;
+        void finishUpdate() override;
+
+        void updateListener(const osg::Vec3f &pos, const osg::Vec3f &atdir, const osg::Vec3f &updir, Environment env) override;
+
+        void pauseSounds(int types) override;
+        void resumeSounds(int types) override;
+
+        void pauseActiveDevice() override;
+        void resumeActiveDevice() override;
+
+        /// Move playback of all active sounds and streams forward, decoding the streams.
+        void advance(double seconds);
+
+        const Stats& getStats() const { return mStats; }
+
+        std::size_t getNumFreeSources() const { return mFreeSources.size(); }
+
+    private:
+        struct Buffer
+        {
+            std::size_t mSize;
+            double mLength;
+        };
+
+        struct Source
+        {
+            SoundBase* mSound = nullptr;
+            const Buffer* mBuffer = nullptr;
+            DecoderPtr mDecoder;
+            int mSampleRate = 0;
+            ChannelConfig mChannelConfig = ChannelConfig_Mono;
+            SampleType mSampleType = SampleType_UInt8;
+            std::unique_ptr<Sound_Loudness> mLoudness;
+            double mOffset = 0;
+            bool mPlaying = false;
+            bool mPaused = false;
+        };
+
+        const MWBase::SoundManager* mManager;
+        const bool mRealTime;
+        std::vector<Source> mSources;
+        std::deque<Source*> mFreeSources;
+        std::vector<Sound*> mActiveSounds;
+        std::vector<Stream*> mActiveStreams;
+        std::vector<char> mDecodeBuffer;
+        std::chrono::steady_clock::time_point mLastUpdate;
+        bool mDevicePaused = false;
+        Stats mStats;
+
+        static Source* getSource(const SoundBase& sound);
+
+        Source* acquireSource();
+
+        void releaseSource(Source& source);
+
+        bool playBuffer(Sound *sound, Sound_Handle data, float offset);
+
+        bool playStream(DecoderPtr decoder, Stream *sound, bool getLoudnessData);
+
+        double getTimeScaledPitch(const SoundBase& sound) const;
+
+        void decodeStream(Source& source, double seconds);
+    };
+}
+
+#endif
@@ -12,10 +12,10 @@
 
 #include <components/debug/debuglog.hpp>
 #include <components/misc/constants.hpp>
-#include <components/misc/resourcehelpers.hpp>
 #include <components/vfs/manager.hpp>
 
 #include "openal_output.hpp"
+#include "decodedsoundcache.hpp"
 #include "sound_decoder.hpp"
 #include "sound.hpp"
 #include "soundmanagerimp.hpp"
@@ -943,42 +943,29 @@ void OpenAL_Output::setHrtf(const std::string &hrtfname, HrtfMode hrtfmode)
 }
 
 
-std::pair<Sound_Handle,size_t> OpenAL_Output::loadSound(const std::string &fname)
+std::pair<Sound_Handle,size_t> OpenAL_Output::loadSound(const DecodedSound &sound)
 {
     getALError();
 
-    std::vector<char> data;
-    ALenum format = AL_NONE;
-    int srate = 0;
+    const char *data = sound.mData.data();
+    size_t datasize = sound.mData.size();
+    ALenum format = getALFormat(sound.mChannelConfig, sound.mSampleType);
+    int srate = sound.mSampleRate;
 
-    try
-    {
-        DecoderPtr decoder = mManager.getDecoder();
-        decoder->open(Misc::ResourceHelpers::correctSoundPath(fname, decoder->mResourceMgr));
-
-        ChannelConfig chans;
-        SampleType type;
-        decoder->getInfo(&srate, &chans, &type);
-        format = getALFormat(chans, type);
-        if(format) decoder->readAll(data);
-    }
-    catch(std::exception &e)
-    {
-        Log(Debug::Error) << "Failed to load audio from " << fname << ": " << e.what();
-    }
-
-    if(data.empty())
+    static const std::vector<char> silence(8000, -128);
+    if(datasize == 0 || !format)
     {
         // If we failed to get any usable audio, substitute with silence.
         format = AL_FORMAT_MONO8;
         srate = 8000;
-        data.assign(8000, -128);
+        data = silence.data();
+        datasize = silence.size();
     }
 
     ALint size;
     ALuint buf = 0;
     alGenBuffers(1, &buf);
-    alBufferData(buf, format, data.data(), data.size(), srate);
+    alBufferData(buf, format, data, datasize, srate);
     alGetBufferi(buf, AL_SIZE, &size);
     if(getALError() != AL_NO_ERROR)
     {
@@ -1497,7 +1484,7 @@ void OpenAL_Output::resumeSounds(int types)
 
 
 OpenAL_Output::OpenAL_Output(SoundManager &mgr)
-  : Sound_Output(mgr)
+  : mManager(mgr)
   , mDevice(nullptr), mContext(nullptr)
   , mListenerPos(0.0f, 0.0f, 0.0f), mListenerEnv(Env_Normal)
   , mWaterFilter(0), mWaterEffect(0), mDefaultEffect(0), mEffectSlot(0)
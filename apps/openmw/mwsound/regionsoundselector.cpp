@@ -6,7 +6,6 @@
 #include <algorithm>
 #include <numeric>
 
-#include "../mwbase/world.hpp"
 #include "../mwworld/esmstore.hpp"
 
 namespace MWSound
@@ -25,7 +24,7 @@ namespace MWSound
     {}
 
     std::optional<std::string> RegionSoundSelector::getNextRandom(float duration, const std::string& regionName,
-                                                                    const MWBase::World& world)
+                                                                    const MWWorld::ESMStore& store)
     {
         mTimePassed += duration;
 
@@ -42,7 +41,7 @@ namespace MWSound
             mSumChance = 0;
         }
 
-        const ESM::Region* const region = world.getStore().get<ESM::Region>().search(mLastRegionName);
+        const ESM::Region* const region = store.get<ESM::Region>().search(mLastRegionName);
 
         if (region == nullptr)
             return {};
@@ -4,9 +4,9 @@
 #include <optional>
 #include <string>
 
-namespace MWBase
+namespace MWWorld
 {
-    class World;
+    class ESMStore;
 }
 
 namespace MWSound
@@ -15,7 +15,7 @@ namespace MWSound
     {
         public:
             std::optional<std::string> getNextRandom(float duration, const std::string& regionName,
-                                                       const MWBase::World& world);
+                                                       const MWWorld::ESMStore& store);
 
             RegionSoundSelector();
 
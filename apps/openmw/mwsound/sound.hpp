@@ -47,6 +47,7 @@ namespace MWSound
         Sound_Instance mHandle = nullptr;
 
         friend class OpenAL_Output;
+        friend class NullOutput;
 
     public:
         void setPosition(const osg::Vec3f &pos) { mParams.mPos = pos; }
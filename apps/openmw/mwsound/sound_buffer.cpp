@@ -1,14 +1,16 @@
 #include "sound_buffer.hpp"
 
-#include "../mwbase/environment.hpp"
-#include "../mwbase/world.hpp"
 #include "../mwworld/esmstore.hpp"
 
+#include "soundmanagerimp.hpp"
+
 #include <components/debug/debuglog.hpp>
+#include <components/sceneutil/workqueue.hpp>
 #include <components/settings/settings.hpp>
 #include <components/vfs/manager.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 
 namespace MWSound
@@ -23,9 +25,9 @@ namespace MWSound
             float mAudioMaxDistanceMult;
         };
 
-        AudioParams makeAudioParams(const MWBase::World& world)
+        AudioParams makeAudioParams(const MWWorld::ESMStore& store)
         {
-            const auto& settings = world.getStore().get<ESM::GameSetting>();
+            const auto& settings = store.get<ESM::GameSetting>();
             AudioParams params;
             params.mAudioDefaultMinDistance = settings.find("fAudioDefaultMinDistance")->mValue.getFloat();
             params.mAudioDefaultMaxDistance = settings.find("fAudioDefaultMaxDistance")->mValue.getFloat();
@@ -33,11 +35,61 @@ namespace MWSound
             params.mAudioMaxDistanceMult = settings.find("fAudioMaxDistanceMult")->mValue.getFloat();
             return params;
         }
+
+        std::shared_ptr<const DecodedSound> getDecodedSound(DecodedSoundCache& cache, Sound_Decoder& decoder,
+            const std::string& fname)
+        {
+            std::shared_ptr<const DecodedSound> sound = cache.get(fname);
+            if (sound != nullptr)
+                return sound;
+            sound = decodeSound(decoder, fname);
+            if (!sound->mData.empty())
+                cache.insert(fname, sound);
+            return sound;
+        }
     }
 
-    SoundBufferPool::SoundBufferPool(const VFS::Manager& vfs, Sound_Output& output) :
+    class DecodeSoundWorkItem final : public SceneUtil::WorkItem
+    {
+        public:
+            DecodeSoundWorkItem(DecoderPtr decoder, const std::string& fname, DecodedSoundCache& cache)
+                : mDecoder(std::move(decoder)), mFileName(fname), mCache(cache)
+            {}
+
+            void doWork() override
+            {
+                if (!mClaimed.exchange(true))
+                    decode();
+            }
+
+            /// @return true the first time only, when the item should be queued at the front of the work queue.
+            /// Running the item again after it was claimed does nothing.
+            bool makeUrgent() { return !mUrgent.exchange(true); }
+
+            /// Only valid once isDone() returns true.
+            const std::shared_ptr<const DecodedSound>& getResult() const { return mResult; }
+
+        private:
+            DecoderPtr mDecoder;
+            std::string mFileName;
+            DecodedSoundCache& mCache;
+            std::atomic_bool mClaimed {false};
+            std::atomic_bool mUrgent {false};
+            std::shared_ptr<const DecodedSound> mResult;
+
+            void decode()
+            {
+                mResult = getDecodedSound(mCache, *mDecoder, mFileName);
+                mDecoder.reset();
+            }
+    };
+
+    SoundBufferPool::SoundBufferPool(const VFS::Manager& vfs, Sound_Output& output, SoundManager& manager) :
         mVfs(&vfs),
         mOutput(&output),
+        mManager(&manager),
+        mDecodedSounds(static_cast<std::size_t>(std::max(Settings::Manager::getInt("decoded cache max", "Sound"), 0)) * 1024 * 1024),
+        mWorkQueue(new SceneUtil::WorkQueue(1)),
         mBufferCacheMax(std::max(Settings::Manager::getInt("buffer cache max", "Sound"), 1) * 1024 * 1024),
         mBufferCacheMin(std::min(static_cast<std::size_t>(std::max(Settings::Manager::getInt("buffer cache min", "Sound"), 1)) * 1024 * 1024, mBufferCacheMax))
     {
@@ -45,6 +97,7 @@ namespace MWSound
 
     SoundBufferPool::~SoundBufferPool()
     {
+        mWorkQueue->stop();
         clear();
     }
 
@@ -62,43 +115,49 @@ namespace MWSound
 
     Sound_Buffer* SoundBufferPool::load(const std::string& soundId)
     {
-        if (mBufferNameMap.empty())
-        {
-            for (const ESM::Sound& sound : MWBase::Environment::get().getWorld()->getStore().get<ESM::Sound>())
-                insertSound(Misc::StringUtils::lowerCase(sound.mId), sound);
-        }
+        Sound_Buffer* const sfx = loadAsync(soundId);
+        if (sfx == nullptr || sfx->getHandle() != nullptr)
+            return sfx;
 
-        Sound_Buffer* sfx;
-        const auto it = mBufferNameMap.find(soundId);
-        if (it != mBufferNameMap.end())
-            sfx = it->second;
-        else
-        {
-            const ESM::Sound *sound = MWBase::Environment::get().getWorld()->getStore().get<ESM::Sound>().search(soundId);
-            if (sound == nullptr)
-                return {};
-            sfx = insertSound(soundId, *sound);
-        }
+        const auto pending = mPendingDecodes.find(sfx);
+        pending->second->waitTillDone();
+        const bool uploaded = upload(*sfx, *pending->second->getResult());
+        mPendingDecodes.erase(pending);
+        return uploaded ? sfx : nullptr;
+    }
 
-        if (sfx->getHandle() == nullptr)
-        {
-            auto [handle, size] = mOutput->loadSound(sfx->getResourceName());
-            if (handle == nullptr)
-                return {};
+    Sound_Buffer* SoundBufferPool::loadAsync(const std::string& soundId)
+    {
+        Sound_Buffer* const sfx = getSoundBuffer(soundId);
+        if (sfx != nullptr && sfx->getHandle() == nullptr)
+            queueDecode(*sfx, true);
+        return sfx;
+    }
 
-            sfx->mHandle = handle;
+    void SoundBufferPool::prefetch(const std::string& soundId)
+    {
+        Sound_Buffer* const sfx = getSoundBuffer(soundId);
+        if (sfx != nullptr && sfx->getHandle() == nullptr)
+            queueDecode(*sfx, false);
+    }
 
-            mBufferCacheSize += size;
-            if (mBufferCacheSize > mBufferCacheMax)
+    bool SoundBufferPool::isPending(Sound_Buffer& sfx) const
+    {
+        return mPendingDecodes.count(&sfx) != 0;
+    }
+
+    void SoundBufferPool::update()
+    {
+        for (auto it = mPendingDecodes.begin(); it != mPendingDecodes.end();)
+        {
+            if (!it->second->isDone())
             {
-                unloadUnused();
-                if (!mUnusedBuffers.empty() && mBufferCacheSize > mBufferCacheMax)
-                    Log(Debug::Warning) << "No unused sound buffers to free, using " << mBufferCacheSize << " bytes!";
+                ++it;
+                continue;
             }
-            mUnusedBuffers.push_front(sfx);
+            upload(*it->first, *it->second->getResult());
+            it = mPendingDecodes.erase(it);
         }
-
-        return sfx;
     }
 
     void SoundBufferPool::clear()
@@ -110,11 +169,48 @@ namespace MWSound
             sfx.mHandle = nullptr;
         }
         mUnusedBuffers.clear();
+        mPendingDecodes.clear();
+    }
+
+    void SoundBufferPool::queueDecode(Sound_Buffer& sfx, bool urgent)
+    {
+        const auto pending = mPendingDecodes.find(&sfx);
+        if (pending != mPendingDecodes.end())
+        {
+            if (urgent && !pending->second->isDone() && pending->second->makeUrgent())
+                mWorkQueue->addWorkItem(pending->second, true);
+            return;
+        }
+
+        osg::ref_ptr<DecodeSoundWorkItem> item(new DecodeSoundWorkItem(mManager->getDecoder(),
+            sfx.getResourceName(), mDecodedSounds));
+        if (urgent)
+            item->makeUrgent();
+        mWorkQueue->addWorkItem(item, urgent);
+        mPendingDecodes.emplace(&sfx, std::move(item));
+    }
+
+    Sound_Buffer* SoundBufferPool::getSoundBuffer(const std::string& soundId)
+    {
+        if (mBufferNameMap.empty())
+        {
+            for (const ESM::Sound& sound : mStore->get<ESM::Sound>())
+                insertSound(Misc::StringUtils::lowerCase(sound.mId), sound);
+        }
+
+        const auto it = mBufferNameMap.find(soundId);
+        if (it != mBufferNameMap.end())
+            return it->second;
+
+        const ESM::Sound *sound = mStore->get<ESM::Sound>().search(soundId);
+        if (sound == nullptr)
+            return nullptr;
+        return insertSound(soundId, *sound);
     }
 
     Sound_Buffer* SoundBufferPool::insertSound(const std::string& soundId, const ESM::Sound& sound)
     {
-        static const AudioParams audioParams = makeAudioParams(*MWBase::Environment::get().getWorld());
+        static const AudioParams audioParams = makeAudioParams(*mStore);
 
         float volume = static_cast<float>(std::pow(10.0, (sound.mData.mVolume / 255.0 * 3348.0 - 3348.0) / 2000.0));
         float min = sound.mData.mMinRange;
@@ -137,6 +233,25 @@ namespace MWSound
         return &sfx;
     }
 
+    bool SoundBufferPool::upload(Sound_Buffer& sfx, const DecodedSound& sound)
+    {
+        auto [handle, size] = mOutput->loadSound(sound);
+        if (handle == nullptr)
+            return false;
+
+        sfx.mHandle = handle;
+
+        mBufferCacheSize += size;
+        if (mBufferCacheSize > mBufferCacheMax)
+        {
+            unloadUnused();
+            if (!mUnusedBuffers.empty() && mBufferCacheSize > mBufferCacheMax)
+                Log(Debug::Warning) << "No unused sound buffers to free, using " << mBufferCacheSize << " bytes!";
+        }
+        mUnusedBuffers.push_front(&sfx);
+        return true;
+    }
+
     void SoundBufferPool::unloadUnused()
     {
         while (!mUnusedBuffers.empty() && mBufferCacheSize > mBufferCacheMin)
@@ -6,6 +6,9 @@
 #include <deque>
 #include <unordered_map>
 
+#include <osg/ref_ptr>
+
+#include "decodedsoundcache.hpp"
 #include "sound_output.hpp"
 
 namespace ESM
@@ -18,9 +21,20 @@ namespace VFS
     class Manager;
 }
 
+namespace MWWorld
+{
+    class ESMStore;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWSound
 {
     class SoundBufferPool;
+    class DecodeSoundWorkItem;
 
     class Sound_Buffer
     {
@@ -54,7 +68,7 @@ namespace MWSound
     class SoundBufferPool
     {
         public:
-            SoundBufferPool(const VFS::Manager& vfs, Sound_Output& output);
+            SoundBufferPool(const VFS::Manager& vfs, Sound_Output& output, SoundManager& manager);
 
             SoundBufferPool(const SoundBufferPool&) = delete;
 
@@ -66,8 +80,22 @@ namespace MWSound
 
             /// Lookup a soundId for its sound data (resource name, local volume,
             /// minRange, and maxRange), and ensure it's ready for use.
+            /// @note Blocks until the sound is decoded by the worker thread, unless it is already decoded.
             Sound_Buffer* load(const std::string& soundId);
 
+            /// Lookup a soundId for its sound data, and decode it in the background ahead of any prefetched sounds
+            /// if it isn't ready for use. The buffer has no handle until a later update() uploads it.
+            Sound_Buffer* loadAsync(const std::string& soundId);
+
+            /// Start decoding the sound in the background, so that a later load() does not have to.
+            void prefetch(const std::string& soundId);
+
+            /// Whether the sound is still being decoded in the background.
+            bool isPending(Sound_Buffer& sfx) const;
+
+            /// Upload the sounds decoded in the background. Must be called from the main thread.
+            void update();
+
             void use(Sound_Buffer& sfx)
             {
                 if (sfx.mUses++ == 0)
@@ -86,9 +114,17 @@ namespace MWSound
 
             void clear();
 
+            /// Set the ESMStore to look up sound records in. Must be called before any sound is looked up.
+            void setStore(const MWWorld::ESMStore& store) { mStore = &store; }
+
         private:
             const VFS::Manager* const mVfs;
+            const MWWorld::ESMStore* mStore = nullptr;
             Sound_Output* mOutput;
+            SoundManager* mManager;
+            DecodedSoundCache mDecodedSounds;
+            osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+            std::unordered_map<Sound_Buffer*, osg::ref_ptr<DecodeSoundWorkItem>> mPendingDecodes;
             std::deque<Sound_Buffer> mSoundBuffers;
             std::unordered_map<std::string, Sound_Buffer*> mBufferNameMap;
             std::size_t mBufferCacheMax;
@@ -97,8 +133,14 @@ namespace MWSound
             // NOTE: unused buffers are stored in front-newest order.
             std::deque<Sound_Buffer*> mUnusedBuffers;
 
+            Sound_Buffer* getSoundBuffer(const std::string& soundId);
+
+            void queueDecode(Sound_Buffer& sfx, bool urgent);
+
             inline Sound_Buffer* insertSound(const std::string& soundId, const ESM::Sound& sound);
 
+            bool upload(Sound_Buffer& sfx, const DecodedSound& sound);
+
             inline void unloadUnused();
     };
 }
@@ -11,6 +11,7 @@ namespace MWSound
 {
     class SoundManager;
     struct Sound_Decoder;
+    struct DecodedSound;
     class Sound;
     class Stream;
 
@@ -33,8 +34,6 @@ namespace MWSound
 
     class Sound_Output
     {
-        SoundManager &mManager;
-
         virtual std::vector<std::string> enumerate() = 0;
         virtual bool init(const std::string &devname, const std::string &hrtfname, HrtfMode hrtfmode) = 0;
         virtual void deinit() = 0;
@@ -42,7 +41,7 @@ namespace MWSound
         virtual std::vector<std::string> enumerateHrtf() = 0;
         virtual void setHrtf(const std::string &hrtfname, HrtfMode hrtfmode) = 0;
 
-        virtual std::pair<Sound_Handle,size_t> loadSound(const std::string &fname) = 0;
+        virtual std::pair<Sound_Handle,size_t> loadSound(const DecodedSound &sound) = 0;
         virtual size_t unloadSound(Sound_Handle data) = 0;
 
         virtual bool playSound(Sound *sound, Sound_Handle data, float offset) = 0;
@@ -77,8 +76,8 @@ namespace MWSound
     protected:
         bool mInitialized;
 
-        Sound_Output(SoundManager &mgr)
-          : mManager(mgr), mInitialized(false)
+        Sound_Output()
+          : mInitialized(false)
         { }
     public:
         virtual ~Sound_Output() { }
@@ -86,6 +85,7 @@ namespace MWSound
         bool isInitialized() const { return mInitialized; }
 
         friend class OpenAL_Output;
+        friend class NullOutput;
         friend class SoundManager;
         friend class SoundBufferPool;
     };
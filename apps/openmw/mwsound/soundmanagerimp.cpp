@@ -1,7 +1,6 @@
 #include "soundmanagerimp.hpp"
 
 #include <algorithm>
-#include <map>
 #include <numeric>
 #include <sstream>
 
@@ -27,6 +26,7 @@
 #include "sound.hpp"
 
 #include "openal_output.hpp"
+#include "null_output.hpp"
 #include "ffmpeg_decoder.hpp"
 
 
@@ -69,6 +69,13 @@ namespace MWSound
 
             return 1.0;
         }
+
+        std::unique_ptr<Sound_Output> makeOutput(SoundManager& manager)
+        {
+            if (Settings::Manager::getBool("null output", "Sound"))
+                return std::make_unique<NullOutput>(&manager);
+            return std::make_unique<OpenAL_Output>(manager);
+        }
     }
 
     // For combining PlayMode and Type flags
@@ -76,9 +83,10 @@ namespace MWSound
 
     SoundManager::SoundManager(const VFS::Manager* vfs, bool useSound)
         : mVFS(vfs)
-        , mOutput(new OpenAL_Output(*this))
+        , mStore(nullptr)
+        , mOutput(makeOutput(*this))
         , mWaterSoundUpdater(makeWaterSoundUpdaterSettings())
-        , mSoundBuffers(*vfs, *mOutput)
+        , mSoundBuffers(*vfs, *mOutput, *this)
         , mListenerUnderwater(false)
         , mListenerPos(0,0,0)
         , mListenerDir(1,0,0)
@@ -495,8 +503,15 @@ namespace MWSound
         if(!mOutput->isInitialized())
             return nullptr;
 
-        Sound_Buffer *sfx = mSoundBuffers.load(Misc::StringUtils::lowerCase(soundId));
+        std::string id = Misc::StringUtils::lowerCase(soundId);
+        Sound_Buffer *sfx = loadSound(id, mode);
         if(!sfx) return nullptr;
+        if (sfx->getHandle() == nullptr)
+        {
+            mDelayedSounds.push_back(DelayedSound {nullptr, MWWorld::ConstPtr(), std::nullopt, std::move(id), sfx,
+                                                   volume, pitch, type, mode, offset});
+            return nullptr;
+        }
 
         // Only one copy of given sound can be played at time, so stop previous copy
         stopSound(sfx, MWWorld::ConstPtr());
@@ -532,8 +547,15 @@ namespace MWSound
             return nullptr;
 
         // Look up the sound in the ESM data
-        Sound_Buffer *sfx = mSoundBuffers.load(Misc::StringUtils::lowerCase(soundId));
+        std::string id = Misc::StringUtils::lowerCase(soundId);
+        Sound_Buffer *sfx = loadSound(id, mode);
         if(!sfx) return nullptr;
+        if (sfx->getHandle() == nullptr)
+        {
+            mDelayedSounds.push_back(DelayedSound {ptr.mCell, ptr, std::nullopt, std::move(id), sfx,
+                                                   volume, pitch, type, mode, offset});
+            return nullptr;
+        }
 
         // Only one copy of given sound can be played at time on ptr, so stop previous copy
         stopSound(sfx, ptr);
@@ -574,7 +596,7 @@ namespace MWSound
         Sound* result = sound.get();
         auto it = mActiveSounds.find(ptr.mRef);
         if (it == mActiveSounds.end())
-            it = mActiveSounds.emplace(ptr.mRef, ActiveSound {ptr.mCell, {}}).first;
+            it = mActiveSounds.emplace(ptr.mRef, ActiveSound {ptr.mCell, {}, objpos}).first;
         it->second.mList.emplace_back(std::move(sound), sfx);
         mSoundBuffers.use(*sfx);
         return result;
@@ -588,8 +610,15 @@ namespace MWSound
             return nullptr;
 
         // Look up the sound in the ESM data
-        Sound_Buffer *sfx = mSoundBuffers.load(Misc::StringUtils::lowerCase(soundId));
+        std::string id = Misc::StringUtils::lowerCase(soundId);
+        Sound_Buffer *sfx = loadSound(id, mode);
         if(!sfx) return nullptr;
+        if (sfx->getHandle() == nullptr)
+        {
+            mDelayedSounds.push_back(DelayedSound {nullptr, MWWorld::ConstPtr(), initialPos, std::move(id), sfx,
+                                                   volume, pitch, type, mode, offset});
+            return nullptr;
+        }
 
         const float squaredDist = (mListenerPos - initialPos).length2();
 
@@ -639,7 +668,12 @@ namespace MWSound
         if(!mOutput->isInitialized())
             return;
 
-        Sound_Buffer *sfx = mSoundBuffers.lookup(Misc::StringUtils::lowerCase(soundId));
+        const std::string id = Misc::StringUtils::lowerCase(soundId);
+        mDelayedSounds.erase(std::remove_if(mDelayedSounds.begin(), mDelayedSounds.end(),
+            [&] (const DelayedSound& sound) { return sound.mPtr.mRef == ptr.mRef && sound.mSoundId == id; }),
+            mDelayedSounds.end());
+
+        Sound_Buffer *sfx = mSoundBuffers.lookup(id);
         if (!sfx) return;
 
         stopSound(sfx, ptr);
@@ -647,6 +681,10 @@ namespace MWSound
 
     void SoundManager::stopSound3D(const MWWorld::ConstPtr &ptr)
     {
+        mDelayedSounds.erase(std::remove_if(mDelayedSounds.begin(), mDelayedSounds.end(),
+            [&] (const DelayedSound& sound) { return sound.mPtr.mRef == ptr.mRef; }),
+            mDelayedSounds.end());
+
         SoundMap::iterator snditer = mActiveSounds.find(ptr.mRef);
         if(snditer != mActiveSounds.end())
         {
@@ -663,6 +701,14 @@ namespace MWSound
 
     void SoundManager::stopSound(const MWWorld::CellStore *cell)
     {
+        mDelayedSounds.erase(std::remove_if(mDelayedSounds.begin(), mDelayedSounds.end(),
+            [&] (const DelayedSound& sound)
+            {
+                return sound.mPtr.mRef != nullptr && sound.mPtr.mRef != MWMechanics::getPlayer().mRef
+                    && sound.mCell == cell;
+            }),
+            mDelayedSounds.end());
+
         for (auto& [ref, sound] : mActiveSounds)
         {
             if (ref != nullptr && ref != MWMechanics::getPlayer().mRef && sound.mCell == cell)
@@ -704,10 +750,16 @@ namespace MWSound
 
     bool SoundManager::getSoundPlaying(const MWWorld::ConstPtr &ptr, std::string_view soundId) const
     {
+        const std::string id = Misc::StringUtils::lowerCase(soundId);
+        const bool delayed = std::any_of(mDelayedSounds.begin(), mDelayedSounds.end(),
+            [&] (const DelayedSound& sound) { return sound.mPtr.mRef == ptr.mRef && sound.mSoundId == id; });
+        if (delayed)
+            return true;
+
         SoundMap::const_iterator snditer = mActiveSounds.find(ptr.mRef);
         if(snditer != mActiveSounds.end())
         {
-            Sound_Buffer *sfx = mSoundBuffers.lookup(Misc::StringUtils::lowerCase(soundId));
+            Sound_Buffer *sfx = mSoundBuffers.lookup(id);
             return std::find_if(snditer->second.mList.cbegin(), snditer->second.mList.cend(),
                 [this,sfx](const SoundBufferRefPair &snd) -> bool
                 { return snd.second == sfx && mOutput->isSoundPlaying(snd.first.get()); }
@@ -763,31 +815,31 @@ namespace MWSound
         mOutput->resumeActiveDevice();
     }
 
-    void SoundManager::updateRegionSound(float duration)
+    void SoundManager::updateRegionSound(float duration, const ESM::Cell& cell)
     {
-        MWBase::World *world = MWBase::Environment::get().getWorld();
-        const MWWorld::ConstPtr player = world->getPlayerPtr();
-        const ESM::Cell *cell = player.getCell()->getCell();
-
-        if (!cell->isExterior())
+        if (!cell.isExterior())
             return;
         if (mCurrentRegionSound && mOutput->isSoundPlaying(mCurrentRegionSound))
             return;
+        // The previous region sound is still waiting for its buffer
+        if (std::any_of(mDelayedSounds.begin(), mDelayedSounds.end(),
+                [] (const DelayedSound& sound) { return sound.mRegionSound; }))
+            return;
 
-        if (const auto next = mRegionSoundSelector.getNextRandom(duration, cell->mRegion, *world))
+        if (const auto next = mRegionSoundSelector.getNextRandom(duration, cell.mRegion, *mStore))
+        {
+            const std::size_t delayed = mDelayedSounds.size();
             mCurrentRegionSound = playSound(*next, 1.0f, 1.0f);
+            if (mDelayedSounds.size() > delayed)
+                mDelayedSounds.back().mRegionSound = true;
+        }
     }
 
-    void SoundManager::updateWaterSound()
+    void SoundManager::updateWaterSound(const WaterSoundUpdate& update, const ESM::Cell& cell)
     {
-        MWBase::World* world = MWBase::Environment::get().getWorld();
-        const MWWorld::ConstPtr player = world->getPlayerPtr();
-        const ESM::Cell *curcell = player.getCell()->getCell();
-        const auto update = mWaterSoundUpdater.update(player, *world);
-
         WaterSoundAction action;
         Sound_Buffer* sfx;
-        std::tie(action, sfx) = getWaterSoundAction(update, curcell);
+        std::tie(action, sfx) = getWaterSoundAction(update, &cell);
 
         switch (action)
         {
@@ -807,7 +859,7 @@ namespace MWSound
                 break;
         }
 
-        mLastCell = curcell;
+        mLastCell = &cell;
     }
 
     std::pair<SoundManager::WaterSoundAction, Sound_Buffer*> SoundManager::getWaterSoundAction(
@@ -882,7 +934,7 @@ namespace MWSound
                 mActiveSaySounds.emplace(queuesayiter->first, std::move(queuesayiter->second));
             else
                 dst->second = std::move(queuesayiter->second);
-            mSaySoundsQueue.erase(queuesayiter++);
+            queuesayiter = mSaySoundsQueue.erase(queuesayiter);
         }
 
         mTimePassed += duration;
@@ -918,7 +970,15 @@ namespace MWSound
         SoundMap::iterator snditer = mActiveSounds.begin();
         while(snditer != mActiveSounds.end())
         {
-            MWWorld::ConstPtr ptr = snditer->first;
+            // Sounds are only moved along with their emitter, most of which are static
+            bool moved = false;
+            if (snditer->first != nullptr)
+            {
+                const osg::Vec3f position = snditer->first->mData.getPosition().asVec3();
+                moved = position != snditer->second.mPosition;
+                snditer->second.mPosition = position;
+            }
+
             SoundBufferRefPairList::iterator sndidx = snditer->second.mList.begin();
             while(sndidx != snditer->second.mList.end())
             {
@@ -926,8 +986,8 @@ namespace MWSound
 
                 if (sound->getIs3D())
                 {
-                    if (!ptr.isEmpty())
-                        sound->setPosition(ptr.getRefData().getPosition().asVec3());
+                    if (moved)
+                        sound->setPosition(snditer->second.mPosition);
 
                     cull3DSound(sound);
                 }
@@ -1027,20 +1087,85 @@ namespace MWSound
     }
 
 
+    Sound_Buffer* SoundManager::loadSound(const std::string& soundId, PlayMode mode)
+    {
+        if (mode & PlayMode::Loop)
+            return mSoundBuffers.load(soundId);
+        return mSoundBuffers.loadAsync(soundId);
+    }
+
+    void SoundManager::playDelayedSounds()
+    {
+        std::vector<DelayedSound> delayed;
+        std::swap(delayed, mDelayedSounds);
+        for (DelayedSound& sound : delayed)
+        {
+            if (mSoundBuffers.isPending(*sound.mSfx))
+                mDelayedSounds.push_back(std::move(sound));
+            else if (sound.mSfx->getHandle() == nullptr)
+                continue; // failed to decode
+            else if (!sound.mPtr.isEmpty())
+                playSound3D(sound.mPtr, sound.mSoundId, sound.mVolume, sound.mPitch, sound.mType, sound.mMode, sound.mOffset);
+            else if (sound.mPosition.has_value())
+                playSound3D(*sound.mPosition, sound.mSoundId, sound.mVolume, sound.mPitch, sound.mType, sound.mMode, sound.mOffset);
+            else
+            {
+                Sound* const result = playSound(sound.mSoundId, sound.mVolume, sound.mPitch, sound.mType,
+                                                sound.mMode, sound.mOffset);
+                if (sound.mRegionSound)
+                    mCurrentRegionSound = result;
+            }
+        }
+    }
+
+    void SoundManager::preloadSound(std::string_view soundId)
+    {
+        if(!mOutput->isInitialized())
+            return;
+
+        mSoundBuffers.prefetch(Misc::StringUtils::lowerCase(soundId));
+    }
+
     void SoundManager::update(float duration)
     {
-        if(!mOutput->isInitialized() || mPlaybackPaused)
+        // Only look up the player when the sounds following it are updated
+        if (!mOutput->isInitialized() || mPlaybackPaused
+            || MWBase::Environment::get().getStateManager()->getState() == MWBase::StateManager::State_NoGame)
+        {
+            update(duration, nullptr, WaterSoundUpdate {});
+            return;
+        }
+
+        MWBase::World& world = *MWBase::Environment::get().getWorld();
+        const MWWorld::ConstPtr player = world.getPlayerPtr();
+        update(duration, player.getCell()->getCell(), mWaterSoundUpdater.update(player, world));
+    }
+
+    void SoundManager::update(float duration, const ESM::Cell* playerCell, const WaterSoundUpdate& waterSound)
+    {
+        if(!mOutput->isInitialized())
+            return;
+
+        mSoundBuffers.update();
+        playDelayedSounds();
+
+        if(mPlaybackPaused)
             return;
 
         updateSounds(duration);
-        if (MWBase::Environment::get().getStateManager()->getState()!=
-            MWBase::StateManager::State_NoGame)
+        if (playerCell != nullptr)
         {
-            updateRegionSound(duration);
-            updateWaterSound();
+            updateRegionSound(duration, *playerCell);
+            updateWaterSound(waterSound, *playerCell);
         }
     }
 
+    void SoundManager::setStore(const MWWorld::ESMStore& store)
+    {
+        mStore = &store;
+        mSoundBuffers.setStore(store);
+    }
+
 
     void SoundManager::processChangedSettings(const Settings::CategorySettingVector& settings)
     {
@@ -1100,6 +1225,15 @@ namespace MWSound
         if(snditer != mActiveSounds.end())
             snditer->second.mCell = updated.mCell;
 
+        for (DelayedSound& sound : mDelayedSounds)
+        {
+            if (sound.mPtr.mRef == old.mRef)
+            {
+                sound.mPtr = updated;
+                sound.mCell = updated.mCell;
+            }
+        }
+
         if (const auto it = mSaySoundsQueue.find(old.mRef); it != mSaySoundsQueue.end())
             it->second.mCell = updated.mCell;
 
@@ -1107,75 +1241,12 @@ namespace MWSound
             it->second.mCell = updated.mCell;
     }
 
-    // Default readAll implementation, for decoders that can't do anything
-    // better
-    void Sound_Decoder::readAll(std::vector<char> &output)
-    {
-        size_t total = output.size();
-        size_t got;
-
-        output.resize(total+32768);
-        while((got=read(&output[total], output.size()-total)) > 0)
-        {
-            total += got;
-            output.resize(total*2);
-        }
-        output.resize(total);
-    }
-
-
-    const char *getSampleTypeName(SampleType type)
-    {
-        switch(type)
-        {
-            case SampleType_UInt8: return "U8";
-            case SampleType_Int16: return "S16";
-            case SampleType_Float32: return "Float32";
-        }
-        return "(unknown sample type)";
-    }
-
-    const char *getChannelConfigName(ChannelConfig config)
-    {
-        switch(config)
-        {
-            case ChannelConfig_Mono:    return "Mono";
-            case ChannelConfig_Stereo:  return "Stereo";
-            case ChannelConfig_Quad:    return "Quad";
-            case ChannelConfig_5point1: return "5.1 Surround";
-            case ChannelConfig_7point1: return "7.1 Surround";
-        }
-        return "(unknown channel config)";
-    }
-
-    size_t framesToBytes(size_t frames, ChannelConfig config, SampleType type)
-    {
-        switch(config)
-        {
-            case ChannelConfig_Mono:    frames *= 1; break;
-            case ChannelConfig_Stereo:  frames *= 2; break;
-            case ChannelConfig_Quad:    frames *= 4; break;
-            case ChannelConfig_5point1: frames *= 6; break;
-            case ChannelConfig_7point1: frames *= 8; break;
-        }
-        switch(type)
-        {
-            case SampleType_UInt8: frames *= 1; break;
-            case SampleType_Int16: frames *= 2; break;
-            case SampleType_Float32: frames *= 4; break;
-        }
-        return frames;
-    }
-
-    size_t bytesToFrames(size_t bytes, ChannelConfig config, SampleType type)
-    {
-        return bytes / framesToBytes(1, config, type);
-    }
-
     void SoundManager::clear()
     {
         SoundManager::stopMusic();
 
+        mDelayedSounds.clear();
+
         for(SoundMap::value_type &snd : mActiveSounds)
         {
             for (SoundBufferRefPair &sndbuf : snd.second.mList)
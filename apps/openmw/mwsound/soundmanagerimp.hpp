@@ -2,10 +2,11 @@
 #define GAME_SOUND_SOUNDMANAGER_H
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
-#include <map>
 #include <unordered_map>
+#include <vector>
 
 #include <components/settings/settings.hpp>
 #include <components/misc/objectpool.hpp>
@@ -18,6 +19,7 @@
 #include "type.hpp"
 #include "volumesettings.hpp"
 #include "sound_buffer.hpp"
+#include "emittermap.hpp"
 
 namespace VFS
 {
@@ -30,6 +32,11 @@ namespace ESM
     struct Cell;
 }
 
+namespace MWWorld
+{
+    class ESMStore;
+}
+
 namespace MWSound
 {
     class Sound_Output;
@@ -45,6 +52,8 @@ namespace MWSound
     {
         const VFS::Manager* mVFS;
 
+        const MWWorld::ESMStore* mStore;
+
         std::unique_ptr<Sound_Output> mOutput;
 
         // Caches available music tracks by <playlist name, (sound files) >
@@ -69,9 +78,11 @@ namespace MWSound
         {
             const MWWorld::CellStore* mCell = nullptr;
             SoundBufferRefPairList mList;
+            // Emitter position the sounds were last moved to, to skip static emitters
+            osg::Vec3f mPosition;
         };
 
-        typedef std::map<const MWWorld::LiveCellRefBase*, ActiveSound> SoundMap;
+        typedef EmitterMap<ActiveSound> SoundMap;
         SoundMap mActiveSounds;
 
         struct SaySound
@@ -80,10 +91,28 @@ namespace MWSound
             StreamPtr mStream;
         };
 
-        typedef std::map<const MWWorld::LiveCellRefBase*, SaySound> SaySoundMap;
+        typedef EmitterMap<SaySound> SaySoundMap;
         SaySoundMap mSaySoundsQueue;
         SaySoundMap mActiveSaySounds;
 
+        // One-shot sound waiting for its buffer to be decoded in the background
+        struct DelayedSound
+        {
+            const MWWorld::CellStore* mCell;
+            MWWorld::ConstPtr mPtr; // empty for 2D sounds and sounds at a position
+            std::optional<osg::Vec3f> mPosition; // set for sounds at a position
+            std::string mSoundId;
+            Sound_Buffer* mSfx;
+            float mVolume;
+            float mPitch;
+            Type mType;
+            PlayMode mMode;
+            float mOffset;
+            bool mRegionSound = false; // becomes mCurrentRegionSound once started
+        };
+
+        std::vector<DelayedSound> mDelayedSounds;
+
         typedef std::vector<StreamPtr> TrackList;
         TrackList mActiveTracks;
 
@@ -121,6 +150,11 @@ namespace MWSound
 
         StreamPtr playVoice(DecoderPtr decoder, const osg::Vec3f &pos, bool playlocal);
 
+        // Looping sounds are waited for, since their callers keep the returned Sound to stop them
+        Sound_Buffer* loadSound(const std::string& soundId, PlayMode mode);
+
+        void playDelayedSounds();
+
         void streamMusicFull(const std::string& filename);
         void advanceMusic(const std::string& filename);
         void startRandomTitle();
@@ -128,8 +162,8 @@ namespace MWSound
         void cull3DSound(SoundBase *sound);
 
         void updateSounds(float duration);
-        void updateRegionSound(float duration);
-        void updateWaterSound();
+        void updateRegionSound(float duration, const ESM::Cell& cell);
+        void updateWaterSound(const WaterSoundUpdate& update, const ESM::Cell& cell);
         void updateMusic(float duration);
 
         float volumeFromType(Type type) const;
@@ -151,6 +185,7 @@ namespace MWSound
     protected:
         DecoderPtr getDecoder();
         friend class OpenAL_Output;
+        friend class SoundBufferPool;
 
         void stopSound(Sound_Buffer *sfx, const MWWorld::ConstPtr &ptr);
         ///< Stop the given object from playing given sound buffer.
@@ -257,7 +292,19 @@ namespace MWSound
         void pausePlayback() override;
         void resumePlayback() override;
 
+        void preloadSound(std::string_view soundId) override;
+        ///< Decode the given sound in the background, to avoid stalling when it's played for the first time.
+
         void update(float duration);
+        ///< Update the sounds, following the player through the game state in the environment.
+
+        void update(float duration, const ESM::Cell* playerCell, const WaterSoundUpdate& waterSound);
+        ///< Update the sounds for the given game state.
+        /// \param playerCell The cell of the player, nullptr if no game is running.
+        /// \param waterSound The near water sound for the player, unused if no game is running.
+
+        /// Set the ESMStore to look up sound and region records in.
+        void setStore(const MWWorld::ESMStore& store);
 
         void setListenerPosDir(const osg::Vec3f &pos, const osg::Vec3f &dir, const osg::Vec3f &up, bool underwater) override;
 
@@ -1,15 +1,32 @@
 #include "character.hpp"
 
+#include <algorithm>
 #include <cctype>
 #include <sstream>
 
 #include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
+#include <components/debug/debuglog.hpp>
 #include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
 #include <components/esm/defs.hpp>
 
 #include <components/misc/utf8stream.hpp>
 
+namespace
+{
+    // Caches the headers of all save files of a character. Is not a save file itself, so it must be skipped when
+    // looking for slots.
+    const std::string sIndexFileName = "slots.index";
+    constexpr ESM::NAME sIndexRecord = "SLOT";
+
+    std::int64_t getTimeStamp(const boost::filesystem::path& path)
+    {
+        return static_cast<std::int64_t>(boost::filesystem::last_write_time(path));
+    }
+}
+
 bool MWState::operator< (const Slot& left, const Slot& right)
 {
     return left.mTimeStamp<right.mTimeStamp;
@@ -25,26 +42,99 @@ std::string MWState::getFirstGameFile(const std::vector<std::string>& contentFil
     return "";
 }
 
-void MWState::Character::addSlot (const boost::filesystem::path& path, const std::string& game)
+std::vector<char> MWState::readScreenshot(const Slot& slot)
 {
-    Slot slot;
-    slot.mPath = path;
-    slot.mTimeStamp = boost::filesystem::last_write_time (path);
+    if (!slot.mProfile.mScreenshot.empty())
+        return slot.mProfile.mScreenshot;
 
     ESM::ESMReader reader;
     reader.open (slot.mPath.string());
 
     if (reader.getRecName()!=ESM::REC_SAVE)
-        return; // invalid save file -> ignore
+        throw std::runtime_error ("not a saved game: " + slot.mPath.string());
 
     reader.getRecHeader();
 
-    slot.mProfile.load (reader);
+    ESM::SavedGame profile;
+    profile.load (reader);
+
+    return std::move (profile.mScreenshot);
+}
+
+std::map<std::string, MWState::Character::IndexEntry> MWState::Character::readIndex() const
+{
+    std::map<std::string, IndexEntry> index;
+    const boost::filesystem::path path = mPath / sIndexFileName;
+    if (!boost::filesystem::exists (path))
+        return index;
+
+    try
+    {
+        ESM::ESMReader reader;
+        reader.open (path.string());
+
+        if (reader.getFormat()!=ESM::SavedGame::sCurrentFormat)
+            return index; // written by a different version -> read all save files again
+
+        while (reader.hasMoreRecs())
+        {
+            if (reader.getRecName()!=sIndexRecord)
+                throw std::runtime_error ("unexpected record " + reader.getRecName().toString());
+
+            reader.getRecHeader();
+
+            std::string fileName = reader.getHNString ("FILE");
+            IndexEntry entry;
+            reader.getHNT (entry.mFileSize, "SIZE");
+            reader.getHNT (entry.mTimeStamp, "MTIM");
+            entry.mProfile.load (reader);
+
+            index.emplace (std::move (fileName), std::move (entry));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        Log(Debug::Warning) << "Failed to read saved games index " << path << ": " << e.what();
+        index.clear();
+    }
+
+    return index;
+}
+
+MWState::Character::IndexEntry MWState::Character::readIndexEntry (const boost::filesystem::path& path)
+{
+    IndexEntry entry;
+    entry.mFileSize = boost::filesystem::file_size (path);
+    entry.mTimeStamp = getTimeStamp (path);
+
+    ESM::ESMReader reader;
+    reader.open (path.string());
+
+    if (reader.getRecName()!=ESM::REC_SAVE)
+        throw std::runtime_error ("not a saved game: " + path.string());
+
+    reader.getRecHeader();
+
+    entry.mProfile.load (reader);
+
+    // Screenshots are needed only for the selected slot, see readScreenshot
+    entry.mProfile.mScreenshot = std::vector<char>();
+
+    return entry;
+}
+
+bool MWState::Character::addSlot (const boost::filesystem::path& path, const IndexEntry& entry, const std::string& game)
+{
+    if (!Misc::StringUtils::ciEqual(getFirstGameFile(entry.mProfile.mContentFiles), game))
+        return false; // this file is for a different game -> ignore
 
-    if (!Misc::StringUtils::ciEqual(getFirstGameFile(slot.mProfile.mContentFiles), game))
-        return; // this file is for a different game -> ignore
+    Slot slot;
+    slot.mPath = path;
+    slot.mProfile = entry.mProfile;
+    slot.mTimeStamp = static_cast<std::time_t> (entry.mTimeStamp);
 
     mSlots.push_back (slot);
+    return true;
 }
 
 void MWState::Character::addSlot (const ESM::SavedGame& profile)
@@ -67,9 +157,15 @@ void MWState::Character::addSlot (const ESM::SavedGame& profile)
     const std::string ext = ".omwsave";
     slot.mPath = mPath / (stream.str() + ext);
 
-    // Append an index if necessary to ensure a unique file
+    // Append an index if necessary to ensure a unique file. A slot may not be on the disk yet while its save is being
+    // written in the background.
+    const auto isUsed = [&] (const boost::filesystem::path& path)
+    {
+        return boost::filesystem::exists(path) || std::any_of(mSlots.begin(), mSlots.end(),
+            [&] (const Slot& v) { return v.mPath == path; });
+    };
     int i=0;
-    while (boost::filesystem::exists(slot.mPath))
+    while (isUsed(slot.mPath))
     {
         const std::string test = stream.str() + " - " + std::to_string(++i);
         slot.mPath = mPath / (test + ext);
@@ -90,19 +186,51 @@ MWState::Character::Character (const boost::filesystem::path& saves, const std::
     }
     else
     {
+        std::map<std::string, IndexEntry> index = readIndex();
+        bool indexChanged = false;
+
         for (boost::filesystem::directory_iterator iter (mPath);
             iter!=boost::filesystem::directory_iterator(); ++iter)
         {
             boost::filesystem::path slotPath = *iter;
 
+            if (slotPath.filename()==sIndexFileName)
+                continue;
+
+            // Left behind by a save that was interrupted before it was complete
+            if (slotPath.extension()==".tmp")
+                continue;
+
             try
             {
-                addSlot (slotPath, game);
+                // Use the cached header only if the file was not changed since the index was written. Saves of other
+                // games are indexed too, so they are not read again every time.
+                std::string fileName = slotPath.filename().string();
+                const auto cached = index.find (fileName);
+                IndexEntry entry;
+                if (cached!=index.end() && cached->second.mFileSize==boost::filesystem::file_size (slotPath)
+                    && cached->second.mTimeStamp==getTimeStamp (slotPath))
+                {
+                    entry = std::move (cached->second);
+                    index.erase (cached);
+                }
+                else
+                {
+                    entry = readIndexEntry (slotPath);
+                    indexChanged = true;
+                }
+
+                addSlot (slotPath, entry, game);
+                mIndex.emplace (std::move (fileName), std::move (entry));
             }
             catch (...) {} // ignoring bad saved game files for now
         }
 
         std::sort (mSlots.begin(), mSlots.end());
+
+        // Entries left in the index are of removed files
+        if (indexChanged || !index.empty())
+            writeIndex();
     }
 }
 
@@ -140,7 +268,11 @@ void MWState::Character::deleteSlot (const Slot *slot)
 
     boost::filesystem::remove(slot->mPath);
 
+    mIndex.erase (slot->mPath.filename().string());
+
     mSlots.erase (mSlots.begin()+index);
+
+    writeIndex();
 }
 
 const MWState::Slot *MWState::Character::updateSlot (const Slot *slot, const ESM::SavedGame& profile)
@@ -164,6 +296,80 @@ const MWState::Slot *MWState::Character::updateSlot (const Slot *slot, const ESM
     return &mSlots.back();
 }
 
+void MWState::Character::updateIndex (const boost::filesystem::path& path)
+{
+    const auto slot = std::find_if (mSlots.begin(), mSlots.end(), [&] (const Slot& v) { return v.mPath == path; });
+    if (slot==mSlots.end())
+        return;
+
+    try
+    {
+        IndexEntry entry;
+        entry.mFileSize = boost::filesystem::file_size (path);
+        entry.mTimeStamp = getTimeStamp (path);
+        entry.mProfile = slot->mProfile;
+        entry.mProfile.mScreenshot.clear();
+        mIndex.insert_or_assign (path.filename().string(), std::move (entry));
+    }
+    catch (const std::exception& e)
+    {
+        Log(Debug::Warning) << "Failed to index saved game " << path << ": " << e.what();
+        return;
+    }
+
+    writeIndex();
+}
+
+void MWState::Character::writeIndex() const
+{
+    const boost::filesystem::path path = mPath / sIndexFileName;
+
+    try
+    {
+        if (mIndex.empty())
+        {
+            // Keep the directory empty, so cleanup can remove it
+            boost::filesystem::remove (path);
+            return;
+        }
+
+        std::stringstream stream;
+
+        ESM::ESMWriter writer;
+        writer.setFormat (ESM::SavedGame::sCurrentFormat);
+
+        // all unused
+        writer.setVersion (0);
+        writer.setType (0);
+        writer.setAuthor ("");
+        writer.setDescription ("");
+
+        writer.save (stream);
+
+        for (const auto& [fileName, entry] : mIndex)
+        {
+            writer.startRecord (sIndexRecord);
+            writer.writeHNString ("FILE", fileName);
+            writer.writeHNT ("SIZE", entry.mFileSize);
+            writer.writeHNT ("MTIM", entry.mTimeStamp);
+            entry.mProfile.save (writer);
+            writer.endRecord (sIndexRecord);
+        }
+
+        writer.close();
+
+        boost::filesystem::ofstream file (path, std::ios::binary);
+        file << stream.rdbuf();
+
+        if (file.fail())
+            throw std::runtime_error ("write operation failed");
+    }
+    catch (const std::exception& e)
+    {
+        Log(Debug::Warning) << "Failed to write saved games index " << path << ": " << e.what();
+    }
+}
+
 MWState::Character::SlotIterator MWState::Character::begin() const
 {
     return mSlots.rbegin();
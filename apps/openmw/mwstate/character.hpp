@@ -1,6 +1,11 @@
 #ifndef GAME_STATE_CHARACTER_H
 #define GAME_STATE_CHARACTER_H
 
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
 #include <boost/filesystem/path.hpp>
 
 #include <components/esm3/savedgame.hpp>
@@ -18,6 +23,10 @@ namespace MWState
 
     std::string getFirstGameFile(const std::vector<std::string>& contentFiles);
 
+    std::vector<char> readScreenshot(const Slot& slot);
+    ///< Return the screenshot of the slot. Slots loaded from existing files don't keep their screenshots in
+    /// memory, so it is read from the save file in this case.
+
     class Character
     {
         public:
@@ -26,10 +35,25 @@ namespace MWState
 
         private:
 
+            struct IndexEntry
+            {
+                std::uint64_t mFileSize;
+                std::int64_t mTimeStamp;
+                ESM::SavedGame mProfile;
+            };
+
             boost::filesystem::path mPath;
             std::vector<Slot> mSlots;
+            std::map<std::string, IndexEntry> mIndex;
+            ///< Headers of all save files in the directory by file name, including saves of other games.
+
+            std::map<std::string, IndexEntry> readIndex() const;
 
-            void addSlot (const boost::filesystem::path& path, const std::string& game);
+            static IndexEntry readIndexEntry (const boost::filesystem::path& path);
+
+            void writeIndex() const;
+
+            bool addSlot (const boost::filesystem::path& path, const IndexEntry& entry, const std::string& game);
 
             void addSlot (const ESM::SavedGame& profile);
 
@@ -55,6 +79,11 @@ namespace MWState
             ///
             /// \attention The \a slot pointer will be invalidated by this call.
 
+            void updateIndex (const boost::filesystem::path& path);
+            ///< Update the index entry of the slot written to \a path and write the index file of this character, so
+            /// the header doesn't have to be read from the save file the next time. Should be called after a save file
+            /// is written. Only this file is checked on the disk.
+
             SlotIterator begin() const;
             ///<  Any call to createSlot and updateSlot can invalidate the returned iterator.
 
@@ -0,0 +1,125 @@
+#include "savewriter.hpp"
+
+#include <exception>
+#include <utility>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <components/platform/file.hpp>
+
+boost::filesystem::path MWState::getTemporarySavePath(const boost::filesystem::path& path)
+{
+    boost::filesystem::path result = path;
+    result += ".tmp";
+    return result;
+}
+
+void MWState::writeFileAtomically(const boost::filesystem::path& path, const std::string& data)
+{
+    const boost::filesystem::path tmpPath = getTemporarySavePath(path);
+
+    try
+    {
+        Platform::File::ScopedHandle handle = Platform::File::create(tmpPath.string().c_str());
+        Platform::File::write(handle, data.data(), data.size());
+        // Without the sync, a crash right after the rename could leave an empty file in place of the old save.
+        Platform::File::sync(handle);
+    }
+    catch (...)
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove(tmpPath, ec);
+        throw;
+    }
+
+    boost::filesystem::rename(tmpPath, path);
+
+    // The rename itself is only durable once the directory entry is on the disk.
+    boost::filesystem::path directory = path.parent_path();
+    if (directory.empty())
+        directory = ".";
+    Platform::File::syncDirectory(directory.string().c_str());
+}
+
+MWState::SaveWriter::SaveWriter()
+    : mThread([this] { run(); })
+{
+}
+
+MWState::SaveWriter::~SaveWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShouldStop = true;
+    }
+    mHasJob.notify_all();
+    mThread.join();
+}
+
+void MWState::SaveWriter::write(Character* character, const boost::filesystem::path& path, std::string description,
+    std::string data, Duration snapshotTime)
+{
+    Job job;
+    job.mResult.mCharacter = character;
+    job.mResult.mPath = path;
+    job.mResult.mDescription = std::move(description);
+    job.mResult.mSize = data.size();
+    job.mResult.mSnapshotTime = snapshotTime;
+    job.mResult.mWriteTime = Duration::zero();
+    job.mData = std::move(data);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back(std::move(job));
+    }
+    mHasJob.notify_all();
+}
+
+std::vector<MWState::SaveWriter::Result> MWState::SaveWriter::takeFinished()
+{
+    std::vector<Result> result;
+    std::lock_guard<std::mutex> lock(mMutex);
+    result.swap(mFinished);
+    return result;
+}
+
+void MWState::SaveWriter::wait()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mHasFinished.wait(lock, [&] { return mJobs.empty() && !mWriting; });
+}
+
+void MWState::SaveWriter::run()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        // Queued writes are finished even when stopping, the game state they hold is gone otherwise.
+        mHasJob.wait(lock, [&] { return mShouldStop || !mJobs.empty(); });
+        if (mJobs.empty())
+            return;
+
+        Job job = std::move(mJobs.front());
+        mJobs.pop_front();
+        mWriting = true;
+        lock.unlock();
+
+        const auto start = std::chrono::steady_clock::now();
+        try
+        {
+            writeFileAtomically(job.mResult.mPath, job.mData);
+        }
+        catch (const std::exception& e)
+        {
+            job.mResult.mError = e.what();
+        }
+        job.mResult.mWriteTime = std::chrono::steady_clock::now() - start;
+
+        job.mData = std::string();
+
+        lock.lock();
+        mFinished.push_back(std::move(job.mResult));
+        mWriting = false;
+        mHasFinished.notify_all();
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef GAME_STATE_SAVEWRITER_H
+#define GAME_STATE_SAVEWRITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+namespace MWState
+{
+    class Character;
+
+    /// \brief Writes serialized saved games to disk in a background thread
+    ///
+    /// Every file is written to a temporary file next to it first, synced to the storage device and then renamed
+    /// over the destination, so a crash or a full disk never leaves a half-written save behind.
+    class SaveWriter
+    {
+        public:
+
+            using Duration = std::chrono::steady_clock::duration;
+
+            struct Result
+            {
+                Character* mCharacter;
+                boost::filesystem::path mPath;
+                std::string mDescription;
+                std::size_t mSize;
+                Duration mSnapshotTime;
+                Duration mWriteTime;
+                std::string mError;
+                ///< Empty when the file has been written.
+            };
+
+            SaveWriter();
+
+            SaveWriter(const SaveWriter&) = delete;
+
+            SaveWriter& operator=(const SaveWriter&) = delete;
+
+            ~SaveWriter();
+            ///< Finishes all queued writes.
+
+            void write(Character* character, const boost::filesystem::path& path, std::string description,
+                std::string data, Duration snapshotTime);
+            ///< Queue \a data to be written to \a path.
+
+            std::vector<Result> takeFinished();
+            ///< Returns the writes finished since the last call, in the order they were queued.
+
+            void wait();
+            ///< Blocks until all queued writes are finished.
+
+        private:
+
+            struct Job
+            {
+                Result mResult;
+                std::string mData;
+            };
+
+            std::mutex mMutex;
+            std::condition_variable mHasJob;
+            std::condition_variable mHasFinished;
+            std::deque<Job> mJobs;
+            std::vector<Result> mFinished;
+            bool mWriting = false;
+            bool mShouldStop = false;
+            std::thread mThread;
+
+            void run();
+    };
+
+    void writeFileAtomically(const boost::filesystem::path& path, const std::string& data);
+    ///< Write \a data to a temporary file next to \a path and rename it to \a path once it is on the disk.
+    ///
+    /// \note Throws std::exception on failure. \a path is left untouched unless only syncing its directory failed.
+
+    boost::filesystem::path getTemporarySavePath(const boost::filesystem::path& path);
+}
+
+#endif
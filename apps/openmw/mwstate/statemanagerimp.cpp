@@ -14,10 +14,10 @@
 #include <components/settings/settings.hpp>
 
 #include <osg/Image>
+#include <osg/Stats>
 
 #include <osgDB/Registry>
 
-#include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
 
 #include "../mwbase/environment.hpp"
@@ -92,10 +92,17 @@ std::map<int, int> MWState::StateManager::buildContentFileIndexMap (const ESM::E
 
 MWState::StateManager::StateManager (const boost::filesystem::path& saves, const std::vector<std::string>& contentFiles)
 : mQuitRequest (false), mAskLoadRecent(false), mState (State_NoGame), mCharacterManager (saves, contentFiles), mTimePlayed (0)
+, mLastSnapshotTime (SaveWriter::Duration::zero()), mLastWriteTime (SaveWriter::Duration::zero())
 {
 
 }
 
+MWState::StateManager::~StateManager()
+{
+    // The other managers are already gone at this point, so failures can only be logged
+    waitForSaves (false);
+}
+
 void MWState::StateManager::requestQuit()
 {
     mQuitRequest = true;
@@ -299,20 +306,12 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         if (stream.fail())
             throw std::runtime_error("Write operation failed (memory stream)");
 
-        // All good, write to file
-        boost::filesystem::ofstream filestream (slot->mPath, std::ios::binary);
-        filestream << stream.rdbuf();
-
-        if (filestream.fail())
-            throw std::runtime_error("Write operation failed (file stream)");
+        // All good, the game state is captured. Writing it to the disk doesn't need to hold up the game.
+        mLastSnapshotTime = std::chrono::steady_clock::now() - start;
+        mSaveWriter.write (character, slot->mPath, description, stream.str(), mLastSnapshotTime);
 
         Settings::Manager::setString ("character", "Saves",
             slot->mPath.parent_path().filename().string());
-
-        const auto finish = std::chrono::steady_clock::now();
-
-        Log(Debug::Info) << '\'' << description << "' is saved in "
-            << std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(finish - start).count() << "ms";
     }
     catch (const std::exception& e)
     {
@@ -325,7 +324,8 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         buttons.emplace_back("#{sOk}");
         MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
 
-        // If no file was written, clean up the slot
+        // If no file was written, clean up the slot. An earlier save to the same slot may still be being written.
+        mSaveWriter.wait();
         if (character && slot && !boost::filesystem::exists(slot->mPath))
         {
             character->deleteSlot(slot);
@@ -386,6 +386,9 @@ void MWState::StateManager::loadGame(const std::string& filepath)
 
 void MWState::StateManager::loadGame (const Character *character, const std::string& filepath)
 {
+    // The file to load may still be being written
+    waitForSaves();
+
     try
     {
         cleanup();
@@ -601,7 +604,19 @@ void MWState::StateManager::quickLoad()
 
 void MWState::StateManager::deleteGame(const MWState::Character *character, const MWState::Slot *slot)
 {
-    mCharacterManager.deleteSlot(character, slot);
+    // Deleting the last slot deletes the character, which pending saves still refer to. Finishing them may remove
+    // slots that failed to save, so look the slot up again afterwards.
+    const boost::filesystem::path path = slot->mPath;
+    waitForSaves();
+
+    for (const Slot& existing : *character)
+    {
+        if (existing.mPath == path)
+        {
+            mCharacterManager.deleteSlot(character, &existing);
+            return;
+        }
+    }
 }
 
 MWState::Character *MWState::StateManager::getCurrentCharacter ()
@@ -623,6 +638,8 @@ void MWState::StateManager::update (float duration)
 {
     mTimePlayed += duration;
 
+    processFinishedSaves();
+
     // Note: It would be nicer to trigger this from InputManager, i.e. the very beginning of the frame update.
     if (mAskLoadRecent)
     {
@@ -644,6 +661,72 @@ void MWState::StateManager::update (float duration)
     }
 }
 
+void MWState::StateManager::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+{
+    using Seconds = std::chrono::duration<double>;
+    stats.setAttribute(frameNumber, "Save Snapshot", std::chrono::duration_cast<Seconds>(mLastSnapshotTime).count());
+    stats.setAttribute(frameNumber, "Save Write", std::chrono::duration_cast<Seconds>(mLastWriteTime).count());
+}
+
+void MWState::StateManager::processFinishedSaves (bool interactive)
+{
+    for (const SaveWriter::Result& save : mSaveWriter.takeFinished())
+    {
+        mLastWriteTime = save.mWriteTime;
+
+        if (save.mError.empty())
+        {
+            try
+            {
+                save.mCharacter->updateIndex(save.mPath);
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Warning) << "Failed to update saved game index: " << e.what();
+            }
+
+            using Milliseconds = std::chrono::duration<float, std::milli>;
+            Log(Debug::Info) << '\'' << save.mDescription << "' is saved in "
+                << std::chrono::duration_cast<Milliseconds>(save.mSnapshotTime + save.mWriteTime).count() << "ms ("
+                << std::chrono::duration_cast<Milliseconds>(save.mSnapshotTime).count() << "ms to capture, "
+                << std::chrono::duration_cast<Milliseconds>(save.mWriteTime).count() << "ms to write "
+                << save.mSize << " bytes)";
+            continue;
+        }
+
+        const std::string error = "Failed to save game: " + save.mError;
+
+        Log(Debug::Error) << error;
+
+        if (interactive)
+        {
+            std::vector<std::string> buttons;
+            buttons.emplace_back("#{sOk}");
+            MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error, buttons);
+        }
+
+        // If no file was written, clean up the slot
+        if (boost::filesystem::exists(save.mPath))
+            continue;
+
+        for (const Slot& slot : *save.mCharacter)
+        {
+            if (slot.mPath == save.mPath)
+            {
+                save.mCharacter->deleteSlot(&slot);
+                save.mCharacter->cleanup();
+                break;
+            }
+        }
+    }
+}
+
+void MWState::StateManager::waitForSaves (bool interactive)
+{
+    mSaveWriter.wait();
+    processFinishedSaves(interactive);
+}
+
 bool MWState::StateManager::verifyProfile(const ESM::SavedGame& profile) const
 {
     const std::vector<std::string>& selectedContentFiles = MWBase::Environment::get().getWorld()->getContentFiles();
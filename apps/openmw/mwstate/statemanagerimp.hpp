@@ -8,6 +8,7 @@
 #include <boost/filesystem/path.hpp>
 
 #include "charactermanager.hpp"
+#include "savewriter.hpp"
 
 namespace MWState
 {
@@ -18,6 +19,9 @@ namespace MWState
             State mState;
             CharacterManager mCharacterManager;
             double mTimePlayed;
+            SaveWriter mSaveWriter;
+            SaveWriter::Duration mLastSnapshotTime;
+            SaveWriter::Duration mLastWriteTime;
 
         private:
 
@@ -29,10 +33,18 @@ namespace MWState
 
             std::map<int, int> buildContentFileIndexMap (const ESM::ESMReader& reader) const;
 
+            void processFinishedSaves (bool interactive = true);
+            ///< Update the slot index of characters with saves written in the background and report failures.
+
+            void waitForSaves (bool interactive = true);
+            ///< Block until all saves being written in the background are on the disk.
+
         public:
 
             StateManager (const boost::filesystem::path& saves, const std::vector<std::string>& contentFiles);
 
+            ~StateManager() override;
+
             void requestQuit() override;
 
             bool hasQuitRequest() const override;
@@ -57,6 +69,7 @@ namespace MWState
             ///< Write a saved game to \a slot or create a new slot if \a slot == 0.
             ///
             /// \note Slot must belong to the current character.
+            /// \note The game state is serialized immediately, but the file is written in the background.
 
             ///Saves a file, using supplied filename, overwritting if needed
             /** This is mostly used for quicksaving and autosaving, for they use the same name over and over again
@@ -85,6 +98,8 @@ namespace MWState
             CharacterIterator characterEnd() override;
 
             void update(float duration);
+
+            void reportStats(unsigned int frameNumber, osg::Stats& stats) const override;
     };
 }
 
@@ -1,5 +1,6 @@
 #include "cellpreloader.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <limits>
 
@@ -16,6 +17,9 @@
 #include <components/esm3/loadcell.hpp>
 #include <components/loadinglistener/reporter.hpp>
 
+#include "../mwbase/environment.hpp"
+#include "../mwbase/soundmanager.hpp"
+
 #include "../mwrender/landmanager.hpp"
 
 #include "cellstore.hpp"
@@ -66,6 +70,23 @@ namespace MWWorld
         std::vector<std::string>& mOut;
     };
 
+    struct ListSoundsVisitor
+    {
+        ListSoundsVisitor(std::vector<std::string>& out)
+            : mOut(out)
+        {
+        }
+
+        bool operator()(const MWWorld::Ptr& ptr)
+        {
+            ptr.getClass().getSoundsToPreload(ptr, mOut);
+
+            return true;
+        }
+
+        std::vector<std::string>& mOut;
+    };
+
     /// Worker thread item: preload models in a cell.
     class PreloadItem : public SceneUtil::WorkItem
     {
@@ -87,6 +108,15 @@ namespace MWWorld
 
             ListModelsVisitor visitor (mMeshes);
             cell->forEach(visitor);
+
+            std::vector<std::string> sounds;
+            ListSoundsVisitor soundsVisitor (sounds);
+            cell->forEach(soundsVisitor);
+            std::sort(sounds.begin(), sounds.end());
+            sounds.erase(std::unique(sounds.begin(), sounds.end()), sounds.end());
+            MWBase::SoundManager* soundManager = MWBase::Environment::get().getSoundManager();
+            for (const std::string& sound : sounds)
+                soundManager->preloadSound(sound);
         }
 
         void abort() override
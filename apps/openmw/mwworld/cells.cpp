@@ -108,7 +108,7 @@ MWWorld::Ptr MWWorld::Cells::getPtrAndCache (const std::string& name, CellStore&
     return ptr;
 }
 
-void MWWorld::Cells::writeCell (ESM::ESMWriter& writer, CellStore& cell) const
+void MWWorld::Cells::writeCell (ESM::ESMWriter& writer, CellStore& cell, FogWriteStats& fogStats) const
 {
     if (cell.getState()!=CellStore::State_Loaded)
         cell.load ();
@@ -120,7 +120,15 @@ void MWWorld::Cells::writeCell (ESM::ESMWriter& writer, CellStore& cell) const
     writer.startRecord (ESM::REC_CSTA);
     cellState.mId.save (writer);
     cellState.save (writer);
-    cell.writeFog(writer);
+    if (cell.getFog() != nullptr)
+    {
+        const auto fogStart = std::chrono::steady_clock::now();
+        const std::streampos fogPosition = writer.getPosition();
+        cell.writeFog(writer);
+        ++fogStats.mCells;
+        fogStats.mBytes += static_cast<std::size_t>(writer.getPosition() - fogPosition);
+        fogStats.mTime += std::chrono::steady_clock::now() - fogStart;
+    }
     cell.writeReferences (writer);
     writer.endRecord (ESM::REC_CSTA);
 }
@@ -395,13 +403,15 @@ int MWWorld::Cells::countSavedGameRecords() const
     return count;
 }
 
-void MWWorld::Cells::write (ESM::ESMWriter& writer, Loading::Listener& progress) const
+MWWorld::Cells::FogWriteStats MWWorld::Cells::write (ESM::ESMWriter& writer, Loading::Listener& progress) const
 {
+    FogWriteStats fogStats;
+
     for (std::map<std::pair<int, int>, CellStore>::iterator iter (mExteriors.begin());
         iter!=mExteriors.end(); ++iter)
         if (iter->second.hasState())
         {
-            writeCell (writer, iter->second);
+            writeCell (writer, iter->second, fogStats);
             progress.increaseProgress();
         }
 
@@ -409,9 +419,11 @@ void MWWorld::Cells::write (ESM::ESMWriter& writer, Loading::Listener& progress)
         iter!=mInteriors.end(); ++iter)
         if (iter->second.hasState())
         {
-            writeCell (writer, iter->second);
+            writeCell (writer, iter->second, fogStats);
             progress.increaseProgress();
         }
+
+    return fogStats;
 }
 
 struct GetCellStoreCallback : public MWWorld::CellStore::GetCellStoreCallback
@@ -1,6 +1,8 @@
 #ifndef GAME_MWWORLD_CELLS_H
 #define GAME_MWWORLD_CELLS_H
 
+#include <chrono>
+#include <cstddef>
 #include <map>
 #include <list>
 #include <string>
@@ -46,7 +48,18 @@ namespace MWWorld
 
             Ptr getPtr(CellStore& cellStore, const std::string& id, const ESM::RefNum& refNum);
 
-            void writeCell (ESM::ESMWriter& writer, CellStore& cell) const;
+        public:
+
+            struct FogWriteStats
+            {
+                std::size_t mCells = 0;
+                std::size_t mBytes = 0;
+                std::chrono::steady_clock::duration mTime {};
+            };
+
+        private:
+
+            void writeCell (ESM::ESMWriter& writer, CellStore& cell, FogWriteStats& fogStats) const;
 
         public:
 
@@ -86,7 +99,8 @@ namespace MWWorld
 
             int countSavedGameRecords() const;
 
-            void write (ESM::ESMWriter& writer, Loading::Listener& progress) const;
+            /// @return size and time of writing fog of war records, it's the largest part of most cells.
+            FogWriteStats write (ESM::ESMWriter& writer, Loading::Listener& progress) const;
 
             bool readRecord (ESM::ESMReader& reader, uint32_t type,
                 const std::map<int, int>& contentFileMap);
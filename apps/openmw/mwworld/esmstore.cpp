@@ -270,6 +270,13 @@ void ESMStore::setUp()
     mMagicEffects.setUp();
     mAttributes.setUp();
     mDialogs.setUp();
+
+    mCreatureSoundGens.clear();
+    for (const ESM::SoundGenerator& sound : mSoundGens)
+    {
+        if (!sound.mCreature.empty())
+            mCreatureSoundGens[sound.mCreature].push_back(&sound);
+    }
 }
 
 void ESMStore::validateRecords(ESM::ReadersCache& readers)
@@ -526,4 +533,13 @@ void ESMStore::removeMissingObjects(Store<T>& store)
         }
         return {ptr, true};
     }
+
+    const std::vector<const ESM::SoundGenerator*>& ESMStore::getCreatureSoundGenerators(const std::string& creatureId) const
+    {
+        static const std::vector<const ESM::SoundGenerator*> empty;
+        const auto it = mCreatureSoundGens.find(creatureId);
+        if (it == mCreatureSoundGens.end())
+            return empty;
+        return it->second;
+    }
 } // end namespace
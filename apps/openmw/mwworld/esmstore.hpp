@@ -85,6 +85,9 @@ namespace MWWorld
 
         std::unordered_map<std::string, int> mRefCount;
 
+        // Creature specific sound generators, by creature ID. Rebuilt by setUp.
+        std::unordered_map<std::string, std::vector<const ESM::SoundGenerator*>, Misc::StringUtils::CiHash, Misc::StringUtils::CiEqual> mCreatureSoundGens;
+
         std::map<int, StoreBase *> mStores;
 
         unsigned int mDynamicCount;
@@ -289,6 +292,9 @@ namespace MWWorld
         /// Actors with the same ID share spells, abilities, etc.
         /// @return The shared spell list to use for this actor and whether or not it has already been initialized.
         std::pair<std::shared_ptr<MWMechanics::SpellList>, bool> getSpellList(const std::string& id) const;
+
+        /// @return The sound generators that belong to the given creature, in load order.
+        const std::vector<const ESM::SoundGenerator*>& getCreatureSoundGenerators(const std::string& creatureId) const;
     };
 
     template <>
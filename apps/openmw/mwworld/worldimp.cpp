@@ -4,6 +4,8 @@
 #include <osg/ComputeBoundsVisitor>
 #include <osg/Timer>
 
+#include <chrono>
+
 #include <MyGUI_TextIterator.h>
 
 #include <LinearMath/btAabbUtil2.h>
@@ -191,7 +193,7 @@ namespace MWWorld
         }
 
         mRendering = std::make_unique<MWRender::RenderingManager>(viewer, rootNode, resourceSystem, workQueue,
-            resourcePath, *mNavigator, mGroundcoverStore, unrefQueue);
+            resourcePath, *mNavigator, mGroundcoverStore, unrefQueue, userDataPath);
         mProjectileManager = std::make_unique<ProjectileManager>(mRendering->getLightRoot()->asGroup(), resourceSystem, mRendering.get(), mPhysics.get());
         mRendering->preloadCommonAssets();
 
@@ -344,17 +346,20 @@ namespace MWWorld
         writer.endRecord(ESM::REC_RAND);
 
         // Active cells could have a dirty fog of war, sync it to the CellStore first
+        const auto fogSyncStart = std::chrono::steady_clock::now();
         for (CellStore* cellstore : mWorldScene->getActiveCells())
-        {
             MWBase::Environment::get().getWindowManager()->writeFog(cellstore);
-        }
+        const auto fogSyncTime = std::chrono::steady_clock::now() - fogSyncStart;
 
         MWMechanics::CreatureStats::writeActorIdCounter(writer);
 
         mStore.write (writer, progress); // dynamic Store must be written (and read) before Cells, so that
                                          // references to custom made records will be recognized
         mPlayer->write (writer, progress);
-        mCells.write (writer, progress);
+        const Cells::FogWriteStats fogStats = mCells.write (writer, progress);
+        Log(Debug::Info) << "Fog of war of " << fogStats.mCells << " cells is written in "
+            << std::chrono::duration<double, std::milli>(fogSyncTime + fogStats.mTime).count()
+            << " ms, " << fogStats.mBytes << " bytes";
         mGlobalVariables.write (writer, progress);
         mWeatherManager->write (writer, progress);
         mProjectileManager->write (writer, progress);
@@ -147,7 +147,7 @@ namespace
         const std::vector<DbRefGeometryObject> objects = makeDbRefGeometryObjects(recastMesh->getMeshSources(),
             [&] (const MeshSource& v) { return resolveMeshSource(*dbPtr, v, nextShapeId); });
         const auto tile = dbPtr->findTile(mWorldspace, tilePosition,
-                                          serialize(mSettings.mRecast, mAgentBounds, *recastMesh, objects));
+            makeTileInputHash(serialize(mSettings.mRecast, mAgentBounds, *recastMesh, objects)), {});
         ASSERT_TRUE(tile.has_value());
         EXPECT_EQ(tile->mTileId, 1);
         EXPECT_EQ(tile->mVersion, navMeshFormatVersion);
@@ -174,7 +174,7 @@ namespace
         const std::vector<DbRefGeometryObject> objects = makeDbRefGeometryObjects(recastMesh->getMeshSources(),
             [&] (const MeshSource& v) { return resolveMeshSource(*dbPtr, v, nextShapeId); });
         const auto tile = dbPtr->findTile(mWorldspace, tilePosition,
-                                          serialize(mSettings.mRecast, mAgentBounds, *recastMesh, objects));
+            makeTileInputHash(serialize(mSettings.mRecast, mAgentBounds, *recastMesh, objects)), {});
         ASSERT_FALSE(tile.has_value());
     }
 
@@ -290,7 +290,8 @@ namespace
                 if (!objects.has_value())
                     continue;
                 EXPECT_EQ(dbPtr->findTile(mWorldspace, tilePosition,
-                                          serialize(mSettings.mRecast, mAgentBounds, *recastMesh, *objects)).has_value(),
+                              makeTileInputHash(serialize(mSettings.mRecast, mAgentBounds, *recastMesh, *objects)),
+                              {}).has_value(),
                           present.find(tilePosition) != present.end())
                     << tilePosition.x() << " " << tilePosition.y() << " present=" << (present.find(tilePosition) != present.end());
             }
@@ -0,0 +1,79 @@
+#include "settings.hpp"
+
+#include <components/detournavigator/asyncpathfinder.hpp>
+#include <components/detournavigator/makenavmesh.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+    using namespace DetourNavigator::Tests;
+
+    struct DetourNavigatorAsyncPathFinderTest : Test
+    {
+        const Settings mSettings = makeSettings();
+        const AgentBounds mAgentBounds {CollisionShapeType::Aabb, {29, 29, 66}};
+        const SharedNavMeshCacheItem mNavMesh
+            = std::make_shared<GuardedNavMeshCacheItem>(makeEmptyNavMesh(mSettings), 1);
+
+        PathRequest makeRequest(const osg::Vec3f& end) const
+        {
+            return PathRequest {mAgentBounds, 28, osg::Vec3f(52, 460, 1), end, Flag_walk, AreaCosts {}, 0};
+        }
+    };
+
+    TEST_F(DetourNavigatorAsyncPathFinderTest, post_equal_to_pending_request_should_share_its_result)
+    {
+        AsyncPathFinder pathFinder(mSettings, 1, 16);
+        std::shared_future<PathResult> first;
+        std::shared_future<PathResult> second;
+        {
+            // Worker waits for the navmesh until both requests are posted
+            const auto locked = mNavMesh->lock();
+            first = pathFinder.post(mNavMesh, makeRequest(osg::Vec3f(460, 52, 1)));
+            second = pathFinder.post(mNavMesh, makeRequest(osg::Vec3f(460.25f, 52, 1)));
+        }
+        EXPECT_EQ(&first.get(), &second.get());
+        const AsyncPathFinder::Stats stats = pathFinder.getStats();
+        EXPECT_EQ(stats.mRequests, 2);
+        EXPECT_EQ(stats.mCoalesced, 1);
+        EXPECT_EQ(stats.mCacheHits, 0);
+    }
+
+    TEST_F(DetourNavigatorAsyncPathFinderTest, post_should_evict_least_recently_used_result)
+    {
+        AsyncPathFinder pathFinder(mSettings, 0, 2);
+        const PathRequest a = makeRequest(osg::Vec3f(460, 52, 1));
+        const PathRequest b = makeRequest(osg::Vec3f(400, 52, 1));
+        const PathRequest c = makeRequest(osg::Vec3f(300, 52, 1));
+        const std::shared_future<PathResult> resultA = pathFinder.post(mNavMesh, a);
+        pathFinder.post(mNavMesh, b);
+        EXPECT_EQ(&pathFinder.post(mNavMesh, a).get(), &resultA.get());
+        pathFinder.post(mNavMesh, c);
+        EXPECT_EQ(pathFinder.getStats().mCacheHits, 1);
+        EXPECT_EQ(&pathFinder.post(mNavMesh, a).get(), &resultA.get());
+        EXPECT_EQ(pathFinder.getStats().mCacheHits, 2);
+        pathFinder.post(mNavMesh, b);
+        const AsyncPathFinder::Stats stats = pathFinder.getStats();
+        EXPECT_EQ(stats.mRequests, 6);
+        EXPECT_EQ(stats.mCacheHits, 2);
+        EXPECT_EQ(stats.mCacheSize, 2);
+    }
+
+    TEST_F(DetourNavigatorAsyncPathFinderTest, post_after_navmesh_change_should_not_use_cached_result)
+    {
+        AsyncPathFinder pathFinder(mSettings, 0, 2);
+        const PathRequest request = makeRequest(osg::Vec3f(460, 52, 1));
+        const std::shared_future<PathResult> before = pathFinder.post(mNavMesh, request);
+        mNavMesh->lock()->markAsEmpty(TilePosition(0, 0));
+        const std::shared_future<PathResult> after = pathFinder.post(mNavMesh, request);
+        EXPECT_NE(&before.get(), &after.get());
+        const AsyncPathFinder::Stats stats = pathFinder.getStats();
+        EXPECT_EQ(stats.mCacheHits, 0);
+        EXPECT_EQ(stats.mCacheSize, 1);
+    }
+}
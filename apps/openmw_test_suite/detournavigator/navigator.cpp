@@ -188,6 +188,56 @@ namespace
         )) << mPath;
     }
 
+    TEST_F(DetourNavigatorNavigatorTest, find_path_async_for_empty_should_return_nav_mesh_not_found)
+    {
+        const PathRequest request {mAgentBounds, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts, mEndTolerance};
+        const PathResult result = mNavigator->findPathAsync(request).get();
+        EXPECT_EQ(result.mStatus, Status::NavMeshNotFound);
+        EXPECT_EQ(result.mPath, std::vector<osg::Vec3f>());
+    }
+
+    TEST_F(DetourNavigatorNavigatorTest, find_path_async_should_return_same_path_as_find_path_when_navmesh_changes)
+    {
+        const std::array<float, 5 * 5> heightfieldData {{
+            0,   0,    0,    0,    0,
+            0, -25,  -25,  -25,  -25,
+            0, -25, -100, -100, -100,
+            0, -25, -100, -100, -100,
+            0, -25, -100, -100, -100,
+        }};
+        const HeightfieldSurface surface = makeSquareHeightfieldSurface(heightfieldData);
+        const int cellSize = mHeightfieldTileSize * (surface.mSize - 1);
+
+        CollisionShapeInstance compound(std::make_unique<btCompoundShape>());
+        compound.shape().addChildShape(btTransform(btMatrix3x3::getIdentity(), btVector3(0, 0, 0)), new btBoxShape(btVector3(20, 20, 100)));
+
+        mNavigator->addAgent(mAgentBounds);
+        mNavigator->addHeightfield(mCellPosition, cellSize, surface);
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait(mListener, WaitConditionType::allJobsDone);
+
+        const PathRequest request {mAgentBounds, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts, mEndTolerance};
+
+        EXPECT_EQ(findPath(*mNavigator, mAgentBounds, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts, mEndTolerance, mOut),
+                  Status::Success);
+        const PathResult before = mNavigator->findPathAsync(request).get();
+        EXPECT_EQ(before.mStatus, Status::Success);
+        EXPECT_EQ(std::deque<osg::Vec3f>(before.mPath.begin(), before.mPath.end()), mPath);
+
+        mNavigator->addObject(ObjectId(&compound.shape()), ObjectShapes(compound.instance(), mObjectTransform), mTransform);
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait(mListener, WaitConditionType::allJobsDone);
+
+        mPath.clear();
+        mOut = std::back_inserter(mPath);
+        EXPECT_EQ(findPath(*mNavigator, mAgentBounds, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts, mEndTolerance, mOut),
+                  Status::Success);
+        const PathResult after = mNavigator->findPathAsync(request).get();
+        EXPECT_EQ(after.mStatus, Status::Success);
+        EXPECT_EQ(std::deque<osg::Vec3f>(after.mPath.begin(), after.mPath.end()), mPath);
+        EXPECT_NE(after.mPath, before.mPath);
+    }
+
     TEST_F(DetourNavigatorNavigatorTest, add_object_should_change_navmesh)
     {
         const std::array<float, 5 * 5> heightfieldData {{
@@ -1,13 +1,19 @@
 #include "generate.hpp"
+#include "../testing_util.hpp"
 
 #include <components/detournavigator/navmeshdb.hpp>
 #include <components/esm3/cellid.hpp>
+#include <components/misc/compression.hpp>
+#include <components/sqlite3/db.hpp>
 
 #include <DetourAlloc.h>
 
+#include <sqlite3.h>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <filesystem>
 #include <numeric>
 #include <random>
 #include <limits>
@@ -44,7 +50,7 @@ namespace
             const TilePosition tilePosition {3, 4};
             std::vector<std::byte> input = generateData();
             std::vector<std::byte> data = generateData();
-            EXPECT_EQ(mDb.insertTile(tileId, worldspace, tilePosition, version, input, data), 1);
+            EXPECT_EQ(mDb.insertTile(tileId, worldspace, tilePosition, version, makeTileInputHash(input), input, data), 1);
             return {std::move(worldspace), tilePosition, std::move(input), std::move(data)};
         }
     };
@@ -59,7 +65,7 @@ namespace
         const TileId tileId {146};
         const TileVersion version {1};
         const auto [worldspace, tilePosition, input, data] = insertTile(tileId, version);
-        const auto result = mDb.findTile(worldspace, tilePosition, input);
+        const auto result = mDb.findTile(worldspace, tilePosition, makeTileInputHash(input), input);
         ASSERT_TRUE(result.has_value());
         EXPECT_EQ(result->mTileId, tileId);
         EXPECT_EQ(result->mVersion, version);
@@ -78,7 +84,7 @@ namespace
         auto [worldspace, tilePosition, input, data] = insertTile(tileId, version);
         generateRange(data.begin(), data.end(), mRandom);
         ASSERT_EQ(mDb.updateTile(tileId, version, data), 1);
-        const auto row = mDb.getTileData(worldspace, tilePosition, input);
+        const auto row = mDb.getTileData(worldspace, tilePosition, makeTileInputHash(input), input);
         ASSERT_TRUE(row.has_value());
         EXPECT_EQ(row->mTileId, tileId);
         EXPECT_EQ(row->mVersion, version);
@@ -94,8 +100,9 @@ namespace
         const TilePosition tilePosition {3, 4};
         const std::vector<std::byte> input = generateData();
         const std::vector<std::byte> data = generateData();
-        ASSERT_EQ(mDb.insertTile(tileId, worldspace, tilePosition, version, input, data), 1);
-        EXPECT_THROW(mDb.insertTile(tileId, worldspace, tilePosition, version, input, data), std::runtime_error);
+        ASSERT_EQ(mDb.insertTile(tileId, worldspace, tilePosition, version, makeTileInputHash(input), input, data), 1);
+        EXPECT_THROW(mDb.insertTile(tileId, worldspace, tilePosition, version, makeTileInputHash(input), input, data),
+                     std::runtime_error);
     }
 
     TEST_F(DetourNavigatorNavMeshDbTest, inserted_duplicate_leaves_db_in_correct_state)
@@ -106,8 +113,9 @@ namespace
         const TilePosition tilePosition {3, 4};
         const std::vector<std::byte> input = generateData();
         const std::vector<std::byte> data = generateData();
-        ASSERT_EQ(mDb.insertTile(tileId, worldspace, tilePosition, version, input, data), 1);
-        EXPECT_THROW(mDb.insertTile(tileId, worldspace, tilePosition, version, input, data), std::runtime_error);
+        ASSERT_EQ(mDb.insertTile(tileId, worldspace, tilePosition, version, makeTileInputHash(input), input, data), 1);
+        EXPECT_THROW(mDb.insertTile(tileId, worldspace, tilePosition, version, makeTileInputHash(input), input, data),
+                     std::runtime_error);
         EXPECT_NO_THROW(insertTile(TileId {54}, version));
     }
 
@@ -119,11 +127,11 @@ namespace
         const std::vector<std::byte> input1 = generateData();
         const std::vector<std::byte> input2 = generateData();
         const std::vector<std::byte> data = generateData();
-        ASSERT_EQ(mDb.insertTile(TileId {53}, worldspace, tilePosition, version, input1, data), 1);
-        ASSERT_EQ(mDb.insertTile(TileId {54}, worldspace, tilePosition, version, input2, data), 1);
+        ASSERT_EQ(mDb.insertTile(TileId {53}, worldspace, tilePosition, version, makeTileInputHash(input1), input1, data), 1);
+        ASSERT_EQ(mDb.insertTile(TileId {54}, worldspace, tilePosition, version, makeTileInputHash(input2), input2, data), 1);
         ASSERT_EQ(mDb.deleteTilesAt(worldspace, tilePosition), 2);
-        EXPECT_FALSE(mDb.findTile(worldspace, tilePosition, input1).has_value());
-        EXPECT_FALSE(mDb.findTile(worldspace, tilePosition, input2).has_value());
+        EXPECT_FALSE(mDb.findTile(worldspace, tilePosition, makeTileInputHash(input1), input1).has_value());
+        EXPECT_FALSE(mDb.findTile(worldspace, tilePosition, makeTileInputHash(input2), input2).has_value());
     }
 
     TEST_F(DetourNavigatorNavMeshDbTest, delete_tiles_at_except_should_leave_tile_with_given_id)
@@ -136,13 +144,15 @@ namespace
         const std::vector<std::byte> leftInput = generateData();
         const std::vector<std::byte> removedInput = generateData();
         const std::vector<std::byte> data = generateData();
-        ASSERT_EQ(mDb.insertTile(leftTileId, worldspace, tilePosition, version, leftInput, data), 1);
-        ASSERT_EQ(mDb.insertTile(removedTileId, worldspace, tilePosition, version, removedInput, data), 1);
+        ASSERT_EQ(mDb.insertTile(leftTileId, worldspace, tilePosition, version, makeTileInputHash(leftInput),
+                                 leftInput, data), 1);
+        ASSERT_EQ(mDb.insertTile(removedTileId, worldspace, tilePosition, version, makeTileInputHash(removedInput),
+                                 removedInput, data), 1);
         ASSERT_EQ(mDb.deleteTilesAtExcept(worldspace, tilePosition, leftTileId), 1);
-        const auto left = mDb.findTile(worldspace, tilePosition, leftInput);
+        const auto left = mDb.findTile(worldspace, tilePosition, makeTileInputHash(leftInput), leftInput);
         ASSERT_TRUE(left.has_value());
         EXPECT_EQ(left->mTileId, leftTileId);
-        EXPECT_FALSE(mDb.findTile(worldspace, tilePosition, removedInput).has_value());
+        EXPECT_FALSE(mDb.findTile(worldspace, tilePosition, makeTileInputHash(removedInput), removedInput).has_value());
     }
 
     TEST_F(DetourNavigatorNavMeshDbTest, delete_tiles_outside_range_should_leave_tiles_inside_given_rectangle)
@@ -156,7 +166,8 @@ namespace
         {
             for (int y = -2; y <= 2; ++y)
             {
-                ASSERT_EQ(mDb.insertTile(tileId, worldspace, TilePosition {x, y}, version, input, data), 1);
+                ASSERT_EQ(mDb.insertTile(tileId, worldspace, TilePosition {x, y}, version, makeTileInputHash(input),
+                                         input, data), 1);
                 ++tileId;
             }
         }
@@ -164,10 +175,139 @@ namespace
         ASSERT_EQ(mDb.deleteTilesOutsideRange(worldspace, range), 16);
         for (int x = -2; x <= 2; ++x)
             for (int y = -2; y <= 2; ++y)
-                ASSERT_EQ(mDb.findTile(worldspace, TilePosition {x, y}, input).has_value(),
+                ASSERT_EQ(mDb.findTile(worldspace, TilePosition {x, y}, makeTileInputHash(input), input).has_value(),
                           -1 <= x && x <= 1 && -1 <= y && y <= 1) << "x=" << x << " y=" << y;
     }
 
+    TEST_F(DetourNavigatorNavMeshDbTest, tile_should_not_be_found_by_hash_of_different_input_when_input_is_verified)
+    {
+        mDb = NavMeshDb(":memory:", std::numeric_limits<std::uint64_t>::max(), true);
+        const auto [worldspace, tilePosition, input, data] = insertTile(TileId {1}, TileVersion {1});
+        const std::vector<std::byte> otherInput = generateData();
+        EXPECT_FALSE(mDb.findTile(worldspace, tilePosition, makeTileInputHash(input), otherInput).has_value());
+        EXPECT_FALSE(mDb.getTileData(worldspace, tilePosition, makeTileInputHash(input), otherInput).has_value());
+        EXPECT_TRUE(mDb.findTile(worldspace, tilePosition, makeTileInputHash(input), input).has_value());
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, tile_should_be_found_by_hash_without_input)
+    {
+        const auto [worldspace, tilePosition, input, data] = insertTile(TileId {1}, TileVersion {1});
+        const auto result = mDb.getTileData(worldspace, tilePosition, makeTileInputHash(input), {});
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(result->mData, data);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, set_content_files_should_replace_previous_ones_keeping_order)
+    {
+        mDb.setContentFiles({ContentFileHash {"morrowind.esm", generateData()}});
+        const std::vector<ContentFileHash> contentFiles {
+            ContentFileHash {"tribunal.esm", generateData()},
+            ContentFileHash {"bloodmoon.esm", generateData()},
+        };
+        mDb.setContentFiles(contentFiles);
+        EXPECT_EQ(mDb.getContentFiles(), contentFiles);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, get_tile_sources_settings_should_return_last_set_value)
+    {
+        EXPECT_EQ(mDb.getTileSourcesSettings(), std::nullopt);
+        ASSERT_EQ(mDb.setTileSourcesSettings(generateData()), 1);
+        const std::vector<std::byte> settings = generateData();
+        ASSERT_EQ(mDb.setTileSourcesSettings(settings), 1);
+        EXPECT_EQ(mDb.getTileSourcesSettings(), settings);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, find_cells_by_source_should_return_cells_with_given_source)
+    {
+        const std::string worldspace = "sys::default";
+        ASSERT_EQ(mDb.insertCellSource(worldspace, "1,2", CellSourceType::ContentFile, "a.esp"), 1);
+        ASSERT_EQ(mDb.insertCellSource(worldspace, "1,2", CellSourceType::ContentFile, "a.esp"), 0);
+        ASSERT_EQ(mDb.insertCellSource(worldspace, "3,4", CellSourceType::ContentFile, "b.esp"), 1);
+        ASSERT_EQ(mDb.insertCellSource(worldspace, "5,6", CellSourceType::RefId, "a.esp"), 1);
+        const std::vector<CellLocation> cells = mDb.findCellsBySource(CellSourceType::ContentFile, "a.esp");
+        ASSERT_EQ(cells.size(), 1);
+        EXPECT_EQ(cells[0].mWorldspace, worldspace);
+        EXPECT_EQ(cells[0].mCell, "1,2");
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, delete_cell_sources_should_remove_only_sources_of_given_cell)
+    {
+        const std::string worldspace = "sys::default";
+        ASSERT_EQ(mDb.insertCellSource(worldspace, "1,2", CellSourceType::ContentFile, "a.esp"), 1);
+        ASSERT_EQ(mDb.insertCellSource(worldspace, "1,2", CellSourceType::RefId, "a"), 1);
+        ASSERT_EQ(mDb.insertCellSource(worldspace, "3,4", CellSourceType::ContentFile, "a.esp"), 1);
+        ASSERT_EQ(mDb.deleteCellSources(worldspace, "1,2"), 2);
+        const std::vector<CellLocation> cells = mDb.findCellsBySource(CellSourceType::ContentFile, "a.esp");
+        ASSERT_EQ(cells.size(), 1);
+        EXPECT_EQ(cells[0].mCell, "3,4");
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, tile_cells_should_be_found_by_tile_and_by_cell)
+    {
+        const std::string worldspace = "sys::default";
+        ASSERT_EQ(mDb.insertTileCell(worldspace, TilePosition {1, 2}, "0,0"), 1);
+        ASSERT_EQ(mDb.insertTileCell(worldspace, TilePosition {1, 2}, "0,1"), 1);
+        ASSERT_EQ(mDb.insertTileCell(worldspace, TilePosition {1, 3}, "0,1"), 1);
+        EXPECT_THAT(mDb.getTileCells(worldspace, TilePosition {1, 2}), UnorderedElementsAre("0,0", "0,1"));
+        EXPECT_THAT(mDb.findTilesByCell(worldspace, "0,1"),
+                    UnorderedElementsAre(TilePosition(1, 2), TilePosition(1, 3)));
+        ASSERT_EQ(mDb.deleteTileCellsAt(worldspace, TilePosition {1, 2}), 2);
+        EXPECT_THAT(mDb.findTilesByCell(worldspace, "0,1"), ElementsAre(TilePosition(1, 3)));
+    }
+
+    std::string toBlobLiteral(const std::vector<std::byte>& value)
+    {
+        std::string result = "X'";
+        for (std::byte v : value)
+        {
+            constexpr char digits[] = "0123456789ABCDEF";
+            result += digits[std::to_integer<int>(v) >> 4];
+            result += digits[std::to_integer<int>(v) & 0xF];
+        }
+        return result + "'";
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, tiles_stored_by_input_should_be_found_by_input_hash_after_migration)
+    {
+        const std::string path = TestingOpenMW::temporaryFilePath("navmeshdb_migration.db");
+        std::filesystem::remove(path);
+        const std::vector<std::byte> input = generateData();
+        const std::vector<std::byte> data = generateData();
+        {
+            const Sqlite3::Db db = Sqlite3::makeDb(path, R"(
+                CREATE TABLE tiles (
+                    tile_id INTEGER PRIMARY KEY,
+                    revision INTEGER NOT NULL DEFAULT 1,
+                    worldspace TEXT NOT NULL,
+                    tile_position_x INTEGER NOT NULL,
+                    tile_position_y INTEGER NOT NULL,
+                    version INTEGER NOT NULL,
+                    input BLOB,
+                    data BLOB
+                );
+
+                CREATE UNIQUE INDEX index_unique_tiles_by_worldspace_and_tile_position_and_input
+                    ON tiles (worldspace, tile_position_x, tile_position_y, input);
+            )");
+            const std::string insert = "INSERT INTO tiles (tile_id, worldspace, tile_position_x, tile_position_y, "
+                "version, input, data) VALUES (42, 'sys::default', 3, 4, 1, " + toBlobLiteral(Misc::compress(input))
+                + ", " + toBlobLiteral(Misc::compress(data)) + ")";
+            ASSERT_EQ(sqlite3_exec(db.get(), insert.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+        }
+        {
+            NavMeshDb db(path, std::numeric_limits<std::uint64_t>::max());
+            const auto result = db.getTileData("sys::default", TilePosition {3, 4}, makeTileInputHash(input), {});
+            ASSERT_TRUE(result.has_value());
+            EXPECT_EQ(result->mTileId, TileId {42});
+            EXPECT_EQ(result->mData, data);
+        }
+        {
+            NavMeshDb db(path, std::numeric_limits<std::uint64_t>::max());
+            EXPECT_TRUE(db.findTile("sys::default", TilePosition {3, 4}, makeTileInputHash(input), {}).has_value());
+        }
+        std::filesystem::remove(path);
+    }
+
     TEST_F(DetourNavigatorNavMeshDbTest, should_support_file_size_limit)
     {
         mDb = NavMeshDb(":memory:", 4096);
@@ -11,6 +11,7 @@
 
 #include <osg/Vec3f>
 
+#include <DetourAlloc.h>
 #include <RecastAlloc.h>
 
 #include <gtest/gtest.h>
@@ -85,6 +86,11 @@ namespace
         return std::make_unique<PreparedNavMeshData>(value);
     }
 
+    NavMeshData makeNavMeshData(int size)
+    {
+        return NavMeshData(static_cast<unsigned char*>(dtAlloc(static_cast<std::size_t>(size), DT_ALLOC_PERM)), size);
+    }
+
     Mesh makeMesh()
     {
         std::vector<int> indices {{0, 1, 2}};
@@ -380,4 +386,84 @@ namespace
         EXPECT_FALSE(cache.set(mAgentBounds, mTilePosition, anotherRecastMesh, std::move(anotherData)));
         EXPECT_TRUE(cache.get(mAgentBounds, mTilePosition, mRecastMesh));
     }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, set_and_get_for_multiple_shards_should_return_cached_values)
+    {
+        const std::size_t shardsCount = 4;
+        const std::size_t tilesCount = 16;
+        const std::size_t maxSize = tilesCount * shardsCount * (mRecastMeshSize + mPreparedNavMeshDataSize);
+        NavMeshTilesCache cache(maxSize, shardsCount);
+
+        for (int i = 0; i < static_cast<int>(tilesCount); ++i)
+            ASSERT_TRUE(cache.set(mAgentBounds, TilePosition(i, 0), mRecastMesh, clone(*mPreparedNavMeshData)));
+        for (int i = 0; i < static_cast<int>(tilesCount); ++i)
+        {
+            const auto result = cache.get(mAgentBounds, TilePosition(i, 0), mRecastMesh);
+            ASSERT_TRUE(result);
+            EXPECT_EQ(result.get(), *mPreparedNavMeshData);
+        }
+        const NavMeshTilesCache::Stats stats = cache.getStats();
+        EXPECT_EQ(stats.mCachedNavMeshTiles, tilesCount);
+        EXPECT_EQ(stats.mUsedNavMeshTiles, 0u);
+        EXPECT_EQ(stats.mHitCount, tilesCount);
+        EXPECT_EQ(stats.mNavMeshCacheSize, tilesCount * (mRecastMeshSize + mPreparedNavMeshDataSize));
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, take_nav_mesh_data_should_return_put_data_for_same_off_mesh_connections)
+    {
+        const std::size_t maxSize = 1024 * 1024;
+        NavMeshTilesCache cache(maxSize);
+        const std::vector<OffMeshConnection> offMeshConnections {OffMeshConnection {{0, 0, 0}, {1, 1, 1}, AreaType_door}};
+        NavMeshData navMeshData = makeNavMeshData(42);
+        const unsigned char* const navMeshDataPtr = navMeshData.mValue.get();
+
+        cache.set(mAgentBounds, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData))
+            .putNavMeshData(std::move(navMeshData), std::vector<OffMeshConnection>(offMeshConnections));
+
+        auto result = cache.get(mAgentBounds, mTilePosition, mRecastMesh);
+        ASSERT_TRUE(result);
+        const NavMeshData taken = result.takeNavMeshData(offMeshConnections);
+        EXPECT_EQ(taken.mValue.get(), navMeshDataPtr);
+        EXPECT_EQ(taken.mSize, 42);
+        EXPECT_EQ(result.takeNavMeshData(offMeshConnections).mValue, nullptr);
+        EXPECT_EQ(cache.getStats().mReusedNavMeshData, 1u);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, take_nav_mesh_data_for_other_off_mesh_connections_should_return_empty_data)
+    {
+        const std::size_t maxSize = 1024 * 1024;
+        NavMeshTilesCache cache(maxSize);
+        const std::vector<OffMeshConnection> offMeshConnections {OffMeshConnection {{0, 0, 0}, {1, 1, 1}, AreaType_door}};
+
+        auto value = cache.set(mAgentBounds, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData));
+        ASSERT_TRUE(value);
+        value.putNavMeshData(makeNavMeshData(42), std::vector<OffMeshConnection>(offMeshConnections));
+        EXPECT_EQ(value.takeNavMeshData({}).mValue, nullptr);
+        EXPECT_NE(value.takeNavMeshData(offMeshConnections).mValue, nullptr);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, put_nav_mesh_data_should_count_its_size_in_cache_size)
+    {
+        const std::size_t maxSize = 1024 * 1024;
+        NavMeshTilesCache cache(maxSize);
+
+        auto value = cache.set(mAgentBounds, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData));
+        ASSERT_TRUE(value);
+        value.putNavMeshData(makeNavMeshData(42), {});
+        EXPECT_EQ(cache.getStats().mNavMeshCacheSize, mRecastMeshSize + mPreparedNavMeshDataSize + 42);
+        value.takeNavMeshData({});
+        EXPECT_EQ(cache.getStats().mNavMeshCacheSize, mRecastMeshSize + mPreparedNavMeshDataSize);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, put_nav_mesh_data_should_not_store_data_not_fitting_cache)
+    {
+        const std::size_t maxSize = mRecastMeshSize + mPreparedNavMeshDataSize + 41;
+        NavMeshTilesCache cache(maxSize);
+
+        auto value = cache.set(mAgentBounds, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData));
+        ASSERT_TRUE(value);
+        value.putNavMeshData(makeNavMeshData(42), {});
+        EXPECT_EQ(value.takeNavMeshData({}).mValue, nullptr);
+        EXPECT_EQ(cache.getStats().mNavMeshCacheSize, mRecastMeshSize + mPreparedNavMeshDataSize);
+    }
 }
@@ -36,6 +36,8 @@ namespace DetourNavigator
             result.mWaitUntilMinDistanceToPlayer = std::numeric_limits<int>::max();
             result.mAsyncNavMeshUpdaterThreads = 1;
             result.mMaxNavMeshTilesCacheSize = 1024 * 1024;
+            result.mAsyncPathFinderThreads = 1;
+            result.mMaxPathCacheSize = 16;
             result.mDetour.mMaxPolygonPathSize = 1024;
             result.mDetour.mMaxSmoothPathSize = 1024;
             result.mDetour.mMaxPolys = 4096;
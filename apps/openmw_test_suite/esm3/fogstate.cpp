@@ -0,0 +1,61 @@
+#include <components/esm3/fogstate.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace
+{
+    using namespace testing;
+    using namespace ESM;
+
+    constexpr std::size_t side = 32;
+
+    TEST(ESM3FogStateTest, compressFogTextureShouldStoreUnexploredTextureInFewBytes)
+    {
+        const std::vector<unsigned char> alpha(side * side, 255);
+        const std::vector<char> compressed = compressFogTexture(alpha);
+        EXPECT_LE(compressed.size(), 17);
+        EXPECT_FALSE(isPngFogTexture(compressed));
+        EXPECT_EQ(decompressFogTexture(compressed), alpha);
+    }
+
+    TEST(ESM3FogStateTest, compressFogTextureShouldSupportRandomValues)
+    {
+        std::minstd_rand random;
+        std::uniform_int_distribution<int> distribution(0, 255);
+        std::vector<unsigned char> alpha(side * side);
+        for (unsigned char& v : alpha)
+            v = static_cast<unsigned char>(distribution(random));
+        const std::vector<char> compressed = compressFogTexture(alpha);
+        EXPECT_LE(compressed.size(), 1 + alpha.size() + alpha.size() / 128);
+        EXPECT_EQ(decompressFogTexture(compressed), alpha);
+    }
+
+    TEST(ESM3FogStateTest, compressFogTextureShouldSupportMixedRunsAndLiterals)
+    {
+        std::vector<unsigned char> alpha(side * side, 255);
+        for (int i = 0; i < static_cast<int>(side); ++i)
+            for (int j = 0; j < static_cast<int>(side); ++j)
+            {
+                const int distance = (i - 16) * (i - 16) + (j - 16) * (j - 16);
+                if (distance < 64)
+                    alpha[i * side + j] = static_cast<unsigned char>(distance * 4);
+            }
+        EXPECT_EQ(decompressFogTexture(compressFogTexture(alpha)), alpha);
+    }
+
+    TEST(ESM3FogStateTest, decompressFogTextureShouldReturnEmptyForTruncatedData)
+    {
+        const std::vector<unsigned char> alpha(side * side, 255);
+        std::vector<char> compressed = compressFogTexture(alpha);
+        compressed.pop_back();
+        EXPECT_TRUE(decompressFogTexture(compressed).empty());
+    }
+
+    TEST(ESM3FogStateTest, isPngFogTextureShouldDetectPngSignature)
+    {
+        const std::vector<char> png = {'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n', '\0'};
+        EXPECT_TRUE(isPngFogTexture(png));
+    }
+}
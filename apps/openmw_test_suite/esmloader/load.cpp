@@ -133,4 +133,20 @@ namespace
         EXPECT_EQ(esmData.mLands.size(), 0);
         EXPECT_EQ(esmData.mStatics.size(), 0);
     }
+
+    TEST_F(EsmLoaderTest, loadEsmDataShouldCollectRefIdContentFilesWhenQueryLoadRefIdContentFilesIsTrue)
+    {
+        Query query;
+        query.mLoadStatics = true;
+        query.mLoadRefIdContentFiles = true;
+        ESM::ReadersCache readers;
+        ToUTF8::Utf8Encoder* const encoder = nullptr;
+        const EsmData esmData = loadEsmData(query, mContentFiles, mFileCollections, readers, encoder);
+        ASSERT_EQ(esmData.mRefIdContentFiles.size(), esmData.mStatics.size());
+        for (std::size_t i = 0; i < esmData.mStatics.size(); ++i)
+        {
+            EXPECT_EQ(esmData.mRefIdContentFiles[i].mId, esmData.mStatics[i].mId);
+            EXPECT_EQ(esmData.mRefIdContentFiles[i].mContentFile, 0);
+        }
+    }
 }
@@ -14,7 +14,7 @@ namespace
     using namespace TestingOpenMW;
 
     template <typename T>
-    T get(sol::state& lua, const std::string& luaCode)
+    T get(sol::state_view& lua, const std::string& luaCode)
     {
         return lua.safe_script("return " + luaCode).get<T>();
     }
@@ -82,7 +82,7 @@ you_have_arrows: "Arrows count: {count}"
     {
         internal::CaptureStdout();
         LuaUtil::LuaState lua{mVFS.get(), &mCfg};
-        sol::state& l = lua.sol();
+        sol::state_view& l = lua.sol();
         LuaUtil::L10nManager l10n(mVFS.get(), &lua);
         l10n.init();
         l10n.setPreferredLocales({"de", "en"});
@@ -35,6 +35,11 @@ return {
         return t.b
     end,
     print = print,
+    allocate = function()
+        bigTable = {}
+        for i = 1, 10000 do bigTable[i] = i end
+    end,
+    infiniteLoop = function() while true do end end,
 
     -- should throw an error
     incorrectRequire = function() require('counter') end,
@@ -170,6 +175,84 @@ return {
         EXPECT_EQ(LuaUtil::call(script2["apiName"]).get<std::string>(), "api2");
     }
 
+    TEST_F(LuaStateTest, InstructionLimit)
+    {
+        LuaUtil::LuaStateSettings settings;
+        settings.mInstructionLimit = 100000;
+        LuaUtil::LuaState lua(mVFS.get(), &mCfg, settings);
+        sol::object jit = lua.sol()["jit"];
+        if (jit.is<sol::table>())
+            jit.as<sol::table>()["off"]();  // The count hook is not called in JIT-compiled code.
+
+        sol::table script = lua.runInNewSandbox("bbb/tests.lua");
+        LuaUtil::LuaState::ScriptScope scope(lua, 0);
+        EXPECT_ERROR(LuaUtil::call(script["infiniteLoop"]), "instruction count exceeded");
+    }
+
+    TEST_F(LuaStateTest, Profiler)
+    {
+        LuaUtil::LuaStateSettings settings;
+        settings.mProfiler = true;
+        settings.mSmallAllocMaxSize = 1024;
+        LuaUtil::LuaState lua(mVFS.get(), &mCfg, settings);
+        sol::object jit = lua.sol()["jit"];
+        if (jit.is<sol::table>())
+            jit.as<sol::table>()["off"]();
+
+        sol::table script = lua.runInNewSandbox("bbb/tests.lua");
+        {
+            LuaUtil::LuaState::ScriptScope scope(lua, 1);
+            LuaUtil::call(script["allocate"]);
+        }
+        ASSERT_EQ(lua.getScriptStats().size(), 2);
+        EXPECT_EQ(lua.getScriptStats()[0].mMemoryUsage, 0);
+        EXPECT_GT(lua.getScriptStats()[1].mInstructionCount, 0);
+        if (lua.isMemoryTracked())
+        {
+            EXPECT_GE(lua.getScriptStats()[1].mMemoryUsage, 10000 * 8);
+            EXPECT_GE(lua.getTotalMemoryUsage(), lua.getScriptStats()[1].mMemoryUsage);
+        }
+
+        lua.updateScriptStats();
+        EXPECT_EQ(lua.getScriptStats()[1].mInstructionCount, 0);
+        EXPECT_GT(lua.getScriptStats()[1].mAvgInstructionCount, 0);
+    }
+
+    TEST_F(LuaStateTest, SharedMemoryUsage)
+    {
+        LuaUtil::LuaStateSettings settings;
+        settings.mSharedMemoryUsage = std::make_shared<std::atomic<int64_t>>(0);
+        {
+            LuaUtil::LuaState first(mVFS.get(), &mCfg, settings);
+            LuaUtil::LuaState second(mVFS.get(), &mCfg, settings);
+            if (!first.isMemoryTracked())
+                return;
+            EXPECT_EQ(*settings.mSharedMemoryUsage, first.getTotalMemoryUsage() + second.getTotalMemoryUsage());
+        }
+        EXPECT_EQ(*settings.mSharedMemoryUsage, 0);
+    }
+
+    TEST_F(LuaStateTest, MemoryLimitShouldApplyToSharedMemoryUsage)
+    {
+        constexpr int64_t limit = 64 * 1024 * 1024;
+        LuaUtil::LuaStateSettings settings;
+        settings.mMemoryLimit = limit;
+        settings.mSharedMemoryUsage = std::make_shared<std::atomic<int64_t>>(0);
+        LuaUtil::LuaState lua(mVFS.get(), &mCfg, settings);
+        if (!lua.isMemoryTracked())
+            return;
+        sol::object jit = lua.sol()["jit"];
+        if (jit.is<sol::table>())
+            jit.as<sol::table>()["off"]();  // The count hook is not called in JIT-compiled code.
+
+        sol::table script = lua.runInNewSandbox("bbb/tests.lua");
+        LuaUtil::LuaState::ScriptScope scope(lua, 0);
+        const int64_t otherStatesMemoryUsage = limit - lua.getTotalMemoryUsage();
+        *settings.mSharedMemoryUsage += otherStatesMemoryUsage;
+        EXPECT_ERROR(LuaUtil::call(script["allocate"]), "memory usage exceeded the limit");
+        *settings.mSharedMemoryUsage -= otherStatesMemoryUsage;
+    }
+
     TEST_F(LuaStateTest, GetLuaVersion)
     {
         EXPECT_THAT(LuaUtil::getLuaVersion(), HasSubstr("Lua"));
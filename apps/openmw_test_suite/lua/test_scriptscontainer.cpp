@@ -235,6 +235,27 @@ CUSTOM, PLAYER: useInterface.lua
         }
     }
 
+    TEST_F(LuaScriptsContainerTest, CallEventHandlersWithDataInLuaState)
+    {
+        LuaUtil::ScriptsContainer scripts(&mLua, "Test");
+        EXPECT_TRUE(scripts.addCustomScript(*mCfg.findId("test1.lua")));
+        EXPECT_TRUE(scripts.addCustomScript(*mCfg.findId("stopEvent.lua")));
+
+        sol::table data = mLua.sol().create_table_with("x", 0.5);
+        {
+            testing::internal::CaptureStdout();
+            scripts.receiveEvent("Event1", LuaUtil::copy(mLua.sol(), data));
+            EXPECT_EQ(internal::GetCapturedStdout(),
+                      "Test[stopEvent.lua]:\t event1 0.5\n");
+        }
+        {
+            testing::internal::CaptureStdout();
+            scripts.receiveEvent("SomeEvent", LuaUtil::copy(mLua.sol(), data));
+            EXPECT_EQ(internal::GetCapturedStdout(),
+                      "Test has received event 'SomeEvent', but there are no handlers for this event\n");
+        }
+    }
+
     TEST_F(LuaScriptsContainerTest, RemoveScript)
     {
         LuaUtil::ScriptsContainer scripts(&mLua, "Test");
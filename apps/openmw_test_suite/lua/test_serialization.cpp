@@ -271,4 +271,32 @@ namespace
         EXPECT_EQ(ry.b, 3);
     }
 
+    TEST(LuaSerializationTest, Copy)
+    {
+        sol::state lua;
+        sol::table table(lua, sol::create);
+        table["number"] = 5;
+        table["vec"] = osg::Vec3f(1, 2, 3);
+        table["ts"] = TestStruct1{1.5, 2.5};
+        table["inner"] = lua.create_table_with(1, "x", 2, true);
+        TestSerializer serializer;
+
+        EXPECT_EQ(LuaUtil::copy(lua, sol::nil), sol::nil);
+        EXPECT_ERROR(LuaUtil::copy(lua, table), "Value is not serializable.");
+        EXPECT_ERROR(LuaUtil::copy(lua, sol::make_object(lua, [](){})), "Functions are not allowed to be serialized.");
+
+        sol::table res = LuaUtil::copy(lua, table, &serializer, &serializer);
+        EXPECT_EQ(res.get<int>("number"), 5);
+        EXPECT_EQ(res.get<osg::Vec3f>("vec"), osg::Vec3f(1, 2, 3));
+        EXPECT_EQ(res.get<TestStruct1>("ts").b, 2.5);
+        sol::table inner = res["inner"];
+        EXPECT_EQ(inner.get<std::string>(1), "x");
+        EXPECT_EQ(inner.get<bool>(2), true);
+
+        // The copy doesn't share tables with the original.
+        table["inner"][1] = "y";
+        EXPECT_EQ(inner.get<std::string>(1), "x");
+        EXPECT_NE(res.get<sol::table>("inner"), table.get<sol::table>("inner"));
+    }
+
 }
@@ -76,6 +76,29 @@ namespace
         EXPECT_EQ(get<std::string>(mLua, "ro:get('x').y"), "abc");
     }
 
+    TEST(LuaUtilStorageTest, Assign)
+    {
+        sol::state mLua;
+        LuaUtil::LuaStorage::initLuaBindings(mLua);
+        LuaUtil::LuaStorage storage(mLua);
+        sol::state copyLua;
+        LuaUtil::LuaStorage::initLuaBindings(copyLua);
+        LuaUtil::LuaStorage copy(copyLua);
+
+        mLua["s1"] = storage.getMutableSection("s1");
+        mLua.safe_script("s1:set('x', { y = 'abc' })");
+        copyLua["s1"] = copy.getReadOnlySection("s1");
+        copyLua["s2"] = copy.getMutableSection("s2");
+        copyLua.safe_script("s2:set('z', 7)");
+
+        copy.assign(storage);
+        EXPECT_EQ(get<std::string>(copyLua, "s1:get('x').y"), "abc");
+        EXPECT_TRUE(get<bool>(copyLua, "s2:get('z') == nil"));
+
+        mLua.safe_script("s1:set('x', 5)");
+        EXPECT_EQ(get<std::string>(copyLua, "s1:get('x').y"), "abc");
+    }
+
     TEST(LuaUtilStorageTest, Saving)
     {
         sol::state mLua;
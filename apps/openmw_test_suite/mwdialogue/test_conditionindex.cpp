@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwdialogue/conditionindex.hpp"
+
+#include <components/esm3/loaddial.hpp>
+
+namespace
+{
+    using namespace MWDialogue;
+
+    ESM::DialInfo makeInfo(const std::string& id)
+    {
+        ESM::DialInfo info;
+        info.mId = id;
+        info.mFactionLess = false;
+        return info;
+    }
+
+    std::vector<std::string> getIds(const std::vector<const ConditionIndex::Info*>& infos)
+    {
+        std::vector<std::string> result;
+        for (const ConditionIndex::Info* info : infos)
+            result.push_back(info->mInfo->mId);
+        return result;
+    }
+
+    struct MWDialogueConditionIndexTest : ::testing::Test
+    {
+        ESM::Dialogue mDialogue;
+        ConditionIndex::Actor mActor;
+        std::vector<const ConditionIndex::Info*> mCandidates;
+
+        MWDialogueConditionIndexTest()
+        {
+            mActor.mId = "fargoth";
+            mActor.mRace = "wood elf";
+            mActor.mClass = "commoner";
+            mActor.mFaction = "";
+        }
+
+        void add(const ESM::DialInfo& info)
+        {
+            mDialogue.mInfo.push_back(info);
+        }
+    };
+
+    TEST_F(MWDialogueConditionIndexTest, should_keep_dialogue_order_across_buckets)
+    {
+        ESM::DialInfo first = makeInfo("1");
+        first.mRace = "Wood Elf";
+        add(first);
+        add(makeInfo("2"));
+        ESM::DialInfo third = makeInfo("3");
+        third.mActor = "Fargoth";
+        add(third);
+        ESM::DialInfo fourth = makeInfo("4");
+        fourth.mClass = "Commoner";
+        add(fourth);
+
+        ConditionIndex index;
+        index.add(mDialogue).getCandidates(mActor, mCandidates);
+        EXPECT_EQ(getIds(mCandidates), std::vector<std::string>({"1", "2", "3", "4"}));
+    }
+
+    TEST_F(MWDialogueConditionIndexTest, should_skip_infos_for_other_actors)
+    {
+        ESM::DialInfo other = makeInfo("1");
+        other.mActor = "hlaalu";
+        add(other);
+        ESM::DialInfo race = makeInfo("2");
+        race.mRace = "Dark Elf";
+        add(race);
+        ESM::DialInfo faction = makeInfo("3");
+        faction.mFaction = "Mages Guild";
+        faction.mRace = "Wood Elf";
+        add(faction);
+        add(makeInfo("4"));
+
+        ConditionIndex index;
+        index.add(mDialogue).getCandidates(mActor, mCandidates);
+        EXPECT_EQ(getIds(mCandidates), std::vector<std::string>({"4"}));
+    }
+
+    TEST_F(MWDialogueConditionIndexTest, creature_should_get_only_infos_for_its_id)
+    {
+        add(makeInfo("1"));
+        ESM::DialInfo own = makeInfo("2");
+        own.mActor = "mudcrab";
+        add(own);
+
+        ConditionIndex::Actor creature;
+        creature.mId = "mudcrab";
+        creature.mIsCreature = true;
+
+        ConditionIndex index;
+        index.add(mDialogue).getCandidates(creature, mCandidates);
+        EXPECT_EQ(getIds(mCandidates), std::vector<std::string>({"2"}));
+    }
+
+    TEST_F(MWDialogueConditionIndexTest, factionless_info_should_not_be_indexed_by_faction)
+    {
+        ESM::DialInfo info = makeInfo("1");
+        info.mFactionLess = true;
+        info.mFaction = "FFFF";
+        add(info);
+
+        ConditionIndex index;
+        index.add(mDialogue).getCandidates(mActor, mCandidates);
+        EXPECT_EQ(getIds(mCandidates), std::vector<std::string>({"1"}));
+    }
+
+    TEST_F(MWDialogueConditionIndexTest, should_decode_select_rules)
+    {
+        ESM::DialInfo info = makeInfo("1");
+        ESM::DialInfo::SelectStruct select;
+        select.mSelectRule = "0B000SomeLocal";
+        select.mValue.setType(ESM::VT_Int);
+        select.mValue.setInteger(3);
+        info.mSelects.push_back(select);
+        select.mSelectRule = "01244speechcraft";
+        info.mSelects.push_back(select);
+        add(info);
+
+        ConditionIndex index;
+        index.add(mDialogue).getCandidates(mActor, mCandidates);
+        ASSERT_EQ(mCandidates.size(), 1);
+        const std::vector<SelectWrapper>& selects = mCandidates.front()->mSelects;
+        ASSERT_EQ(selects.size(), 2);
+        EXPECT_EQ(selects[0].getFunction(), SelectWrapper::Function_NotCell);
+        EXPECT_EQ(selects[0].getType(), SelectWrapper::Type_Inverted);
+        EXPECT_EQ(selects[0].getName(), "somelocal");
+        EXPECT_EQ(selects[1].getFunction(), SelectWrapper::Function_PcSkill);
+        EXPECT_EQ(selects[1].getArgument(), 13);
+        EXPECT_TRUE(selects[1].selectCompare(2));
+        EXPECT_FALSE(selects[1].selectCompare(3));
+    }
+
+    TEST_F(MWDialogueConditionIndexTest, find_should_return_null_for_not_indexed_dialogue)
+    {
+        ConditionIndex index;
+        EXPECT_EQ(index.find(mDialogue), nullptr);
+        index.add(mDialogue);
+        EXPECT_NE(index.find(mDialogue), nullptr);
+    }
+}
@@ -134,3 +134,139 @@ TEST_F(KeywordSearchTest, keyword_test_russian_ascii_before)
     EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "Доложить Каю Косадесу");
 }
 
+
+TEST_F(KeywordSearchTest, keyword_test_prefix_of_other_keyword)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("foo", 1);
+    search.seed("foobar", 2);
+
+    std::string text = "foo and foobar";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    ASSERT_EQ(matches.size(), 2);
+    EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "foo");
+    EXPECT_EQ(matches[0].mValue, 1);
+    EXPECT_EQ(std::string(matches[1].mBeg, matches[1].mEnd), "foobar");
+    EXPECT_EQ(matches[1].mValue, 2);
+}
+
+TEST_F(KeywordSearchTest, keyword_test_match_after_partial_match)
+{
+    // "abcd" fails at the last character, "bc" must still be found inside it
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("abcd", 0);
+    search.seed("bc", 0);
+
+    std::string text = "abce";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "bc");
+}
+
+TEST_F(KeywordSearchTest, keyword_test_case_insensitive)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("Caius Cosades", 0);
+
+    std::string text = "Speak to CAIUS cosades in Balmora";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "CAIUS cosades");
+}
+
+TEST_F(KeywordSearchTest, keyword_test_seed_after_search)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("foo", 0);
+
+    std::string text = "foo bar";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+    EXPECT_EQ(matches.size(), 1);
+
+    search.seed("bar", 0);
+    matches.clear();
+    search.highlightKeywords(text.begin(), text.end(), matches);
+    EXPECT_EQ(matches.size(), 2);
+
+    search.clear();
+    matches.clear();
+    search.highlightKeywords(text.begin(), text.end(), matches);
+    EXPECT_TRUE(matches.empty());
+}
+
+TEST_F(KeywordSearchTest, keyword_test_contains_keyword)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("foo", 1);
+    search.seed("foobar", 2);
+
+    int value = 0;
+    EXPECT_TRUE(search.containsKeyword("FOO", value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(search.containsKeyword("foobar", value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(search.containsKeyword("foob", value));
+    EXPECT_FALSE(search.containsKeyword("", value));
+}
+
+TEST_F(KeywordSearchTest, keyword_test_one_character_keyword_at_end_of_text)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("a", 0);
+
+    std::string text = "take a";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    ASSERT_EQ(matches.size(), 2);
+    EXPECT_EQ(matches[0].mBeg - text.begin(), 1);
+    EXPECT_EQ(matches[1].mBeg - text.begin(), 5);
+    EXPECT_EQ(matches[1].mEnd, text.end());
+}
+
+TEST_F(KeywordSearchTest, keyword_test_prefix_of_other_keyword_at_end_of_text)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("foobar", 2);
+    search.seed("foo", 1);
+
+    std::string text = "ask about foo";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "foo");
+    EXPECT_EQ(matches[0].mValue, 1);
+}
+
+TEST_F(KeywordSearchTest, keyword_test_first_of_keywords_differing_in_case_wins)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("Balmora", 1);
+    search.seed("balmora", 2);
+
+    std::string text = "go to BALMORA";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(matches[0].mValue, 1);
+
+    int value = 0;
+    EXPECT_TRUE(search.containsKeyword("balmora", value));
+    EXPECT_EQ(value, 1);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <components/lua/configuration.hpp>
+#include <components/lua/scriptscontainer.hpp>
+
+#include "apps/openmw/mwlua/shardindex.hpp"
+
+#include "../testing_util.hpp"
+
+#include <set>
+
+namespace
+{
+    using namespace MWLua;
+
+    struct MWLuaShardIndexTest : ::testing::Test
+    {
+        std::unique_ptr<VFS::Manager> mVFS = TestingOpenMW::createTestVFS({});
+        LuaUtil::ScriptsConfiguration mCfg;
+        LuaUtil::LuaState mMain{mVFS.get(), &mCfg};
+        LuaUtil::LuaState mShard1{mVFS.get(), &mCfg};
+        LuaUtil::LuaState mShard2{mVFS.get(), &mCfg};
+        const LuaStates mStates{&mMain, &mShard1, &mShard2};
+
+        LuaUtil::Callback makeCallback(LuaUtil::LuaState& lua, LuaUtil::ScriptsContainer& container)
+        {
+            sol::table hiddenData(lua.sol(), sol::create);
+            hiddenData[LuaUtil::ScriptsContainer::sScriptIdKey] = LuaUtil::ScriptsContainer::ScriptId{&container, 0};
+            return LuaUtil::Callback{sol::make_object(lua.sol(), [] {}), hiddenData};
+        }
+    };
+
+    TEST_F(MWLuaShardIndexTest, player_should_always_be_in_main_state)
+    {
+        for (unsigned int i = 0; i < 10; ++i)
+            EXPECT_EQ(getShardIndex(ESM::RefNum{i, 0}, true, mStates.size()), 0);
+    }
+
+    TEST_F(MWLuaShardIndexTest, objects_should_be_in_main_state_when_there_are_no_shards)
+    {
+        for (unsigned int i = 0; i < 10; ++i)
+            EXPECT_EQ(getShardIndex(ESM::RefNum{i, 0}, false, 1), 0);
+    }
+
+    TEST_F(MWLuaShardIndexTest, objects_should_be_spread_over_all_states)
+    {
+        std::set<std::size_t> used;
+        for (unsigned int i = 0; i < 10; ++i)
+        {
+            const ESM::RefNum id{i, 1};
+            const std::size_t index = getShardIndex(id, false, mStates.size());
+            EXPECT_LT(index, mStates.size());
+            EXPECT_EQ(getShardIndex(id, false, mStates.size()), index);
+            used.insert(index);
+        }
+        EXPECT_EQ(used.size(), mStates.size());
+    }
+
+    TEST_F(MWLuaShardIndexTest, events_should_go_to_lua_state_of_receiver)
+    {
+        EXPECT_EQ(getShardIndex(mMain, mStates), 0);
+        EXPECT_EQ(getShardIndex(mShard1, mStates), 1);
+        EXPECT_EQ(getShardIndex(mShard2, mStates), 2);
+    }
+
+    TEST_F(MWLuaShardIndexTest, unknown_lua_state_should_be_main)
+    {
+        LuaUtil::LuaState other(mVFS.get(), &mCfg);
+        EXPECT_EQ(getShardIndex(other, mStates), 0);
+    }
+
+    TEST_F(MWLuaShardIndexTest, callbacks_should_go_to_lua_state_of_their_script)
+    {
+        LuaUtil::ScriptsContainer mainScripts(&mMain, "Main");
+        LuaUtil::ScriptsContainer shardScripts(&mShard2, "Shard");
+        EXPECT_EQ(getShardIndex(makeCallback(mMain, mainScripts), mStates), 0);
+        EXPECT_EQ(getShardIndex(makeCallback(mShard2, shardScripts), mStates), 2);
+    }
+
+    TEST_F(MWLuaShardIndexTest, callbacks_of_removed_scripts_should_go_to_main_state)
+    {
+        LuaUtil::ScriptsContainer shardScripts(&mShard1, "Shard");
+        LuaUtil::Callback callback = makeCallback(mShard1, shardScripts);
+        callback.mHiddenData[LuaUtil::ScriptsContainer::sScriptIdKey] = sol::nil;
+        EXPECT_EQ(getShardIndex(callback, mStates), 0);
+    }
+}
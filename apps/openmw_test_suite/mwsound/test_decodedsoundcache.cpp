@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwsound/decodedsoundcache.hpp"
+
+namespace
+{
+    using namespace MWSound;
+
+    std::shared_ptr<const DecodedSound> makeSound(std::size_t size)
+    {
+        auto result = std::make_shared<DecodedSound>();
+        result->mData.resize(size);
+        result->mSampleRate = 22050;
+        return result;
+    }
+
+    TEST(MWSoundDecodedSoundCacheTest, get_should_return_nullptr_for_missing_sound)
+    {
+        DecodedSoundCache cache(1024);
+        EXPECT_EQ(cache.get("sound/foo.wav"), nullptr);
+    }
+
+    TEST(MWSoundDecodedSoundCacheTest, get_should_return_inserted_sound)
+    {
+        DecodedSoundCache cache(1024);
+        const auto sound = makeSound(100);
+        cache.insert("sound/foo.wav", sound);
+        EXPECT_EQ(cache.get("sound/foo.wav"), sound);
+        EXPECT_EQ(cache.getSize(), 100);
+    }
+
+    TEST(MWSoundDecodedSoundCacheTest, insert_should_ignore_sound_larger_than_max_size)
+    {
+        DecodedSoundCache cache(1024);
+        cache.insert("sound/foo.wav", makeSound(2048));
+        EXPECT_EQ(cache.get("sound/foo.wav"), nullptr);
+        EXPECT_EQ(cache.getSize(), 0);
+    }
+
+    TEST(MWSoundDecodedSoundCacheTest, insert_should_evict_least_recently_used_sounds)
+    {
+        DecodedSoundCache cache(300);
+        cache.insert("sound/a.wav", makeSound(100));
+        cache.insert("sound/b.wav", makeSound(100));
+        cache.insert("sound/c.wav", makeSound(100));
+        ASSERT_NE(cache.get("sound/a.wav"), nullptr);
+        cache.insert("sound/d.wav", makeSound(100));
+        EXPECT_NE(cache.get("sound/a.wav"), nullptr);
+        EXPECT_EQ(cache.get("sound/b.wav"), nullptr);
+        EXPECT_NE(cache.get("sound/c.wav"), nullptr);
+        EXPECT_NE(cache.get("sound/d.wav"), nullptr);
+        EXPECT_EQ(cache.getSize(), 300);
+    }
+
+    TEST(MWSoundDecodedSoundCacheTest, clear_should_remove_all_sounds)
+    {
+        DecodedSoundCache cache(1024);
+        cache.insert("sound/foo.wav", makeSound(100));
+        cache.clear();
+        EXPECT_EQ(cache.get("sound/foo.wav"), nullptr);
+        EXPECT_EQ(cache.getSize(), 0);
+    }
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwsound/emittermap.hpp"
+
+#include <array>
+
+namespace
+{
+    using namespace MWSound;
+
+    const std::array<char, 4> refs {};
+
+    const MWWorld::LiveCellRefBase* getRef(std::size_t index)
+    {
+        return reinterpret_cast<const MWWorld::LiveCellRefBase*>(&refs[index]);
+    }
+
+    TEST(MWSoundEmitterMapTest, find_should_return_end_for_missing_key)
+    {
+        EmitterMap<int> map;
+        EXPECT_EQ(map.find(getRef(0)), map.end());
+    }
+
+    TEST(MWSoundEmitterMapTest, emplace_should_not_replace_existing_value)
+    {
+        EmitterMap<int> map;
+        EXPECT_TRUE(map.emplace(getRef(0), 1).second);
+        const auto [it, inserted] = map.emplace(getRef(0), 2);
+        EXPECT_FALSE(inserted);
+        EXPECT_EQ(it->second, 1);
+        EXPECT_EQ(map.size(), 1);
+    }
+
+    TEST(MWSoundEmitterMapTest, subscript_should_support_null_key)
+    {
+        EmitterMap<int> map;
+        map[nullptr] = 42;
+        ASSERT_NE(map.find(nullptr), map.end());
+        EXPECT_EQ(map.find(nullptr)->second, 42);
+    }
+
+    TEST(MWSoundEmitterMapTest, erase_should_move_last_value_into_erased_slot)
+    {
+        EmitterMap<int> map;
+        for (std::size_t i = 0; i < refs.size(); ++i)
+            map[getRef(i)] = static_cast<int>(i);
+        const auto it = map.erase(map.find(getRef(1)));
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(it->first, getRef(3));
+        EXPECT_EQ(map.find(getRef(1)), map.end());
+        EXPECT_EQ(map.find(getRef(3)), it);
+        EXPECT_EQ(map.size(), 3);
+    }
+
+    TEST(MWSoundEmitterMapTest, erase_while_iterating_should_visit_each_value_once)
+    {
+        EmitterMap<int> map;
+        for (std::size_t i = 0; i < refs.size(); ++i)
+            map[getRef(i)] = static_cast<int>(i);
+        std::array<int, 4> visited {};
+        for (auto it = map.begin(); it != map.end();)
+        {
+            ++visited[it->second];
+            if (it->second % 2 == 0)
+                it = map.erase(it);
+            else
+                ++it;
+        }
+        EXPECT_EQ(visited, (std::array<int, 4> {1, 1, 1, 1}));
+        EXPECT_EQ(map.size(), 2);
+        EXPECT_NE(map.find(getRef(1)), map.end());
+        EXPECT_NE(map.find(getRef(3)), map.end());
+    }
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwstate/character.hpp"
+
+#include "../testing_util.hpp"
+
+#include <components/esm3/esmwriter.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+
+namespace
+{
+    using namespace MWState;
+
+    const std::string game = "Morrowind.esm";
+
+    ESM::SavedGame makeProfile(const std::string& description, const std::string& contentFile = game)
+    {
+        ESM::SavedGame profile;
+        profile.mContentFiles = {contentFile};
+        profile.mPlayerName = "Player";
+        profile.mPlayerLevel = 1;
+        profile.mPlayerClassId = "warrior";
+        profile.mPlayerCell = "Balmora";
+        profile.mInGameTime = {};
+        profile.mTimePlayed = 0;
+        profile.mDescription = description;
+        profile.mScreenshot = {'j', 'p', 'g'};
+        return profile;
+    }
+
+    void writeSave(const boost::filesystem::path& path, const ESM::SavedGame& profile)
+    {
+        boost::filesystem::ofstream stream(path, std::ios::binary);
+        ESM::ESMWriter writer;
+        writer.setFormat(ESM::SavedGame::sCurrentFormat);
+        writer.save(stream);
+        writer.startRecord(ESM::REC_SAVE);
+        profile.save(writer);
+        writer.endRecord(ESM::REC_SAVE);
+        writer.close();
+    }
+
+    struct MWStateCharacterTest : ::testing::Test
+    {
+        const boost::filesystem::path mPath = TestingOpenMW::temporaryFilePath("openmw_test_character");
+        const boost::filesystem::path mSavePath = mPath / "save.omwsave";
+        const boost::filesystem::path mIndexPath = mPath / "slots.index";
+
+        MWStateCharacterTest()
+        {
+            boost::filesystem::remove_all(mPath);
+            boost::filesystem::create_directories(mPath);
+            writeSave(mSavePath, makeProfile("first"));
+        }
+
+        ~MWStateCharacterTest()
+        {
+            boost::filesystem::remove_all(mPath);
+        }
+    };
+
+    TEST_F(MWStateCharacterTest, should_write_index_for_loaded_saves)
+    {
+        const Character character(mPath, game);
+        ASSERT_EQ(std::distance(character.begin(), character.end()), 1);
+        EXPECT_EQ(character.begin()->mProfile.mDescription, "first");
+        EXPECT_TRUE(boost::filesystem::exists(mIndexPath));
+    }
+
+    TEST_F(MWStateCharacterTest, loaded_slot_should_read_screenshot_from_save_file)
+    {
+        const Character character(mPath, game);
+        ASSERT_EQ(std::distance(character.begin(), character.end()), 1);
+        EXPECT_TRUE(character.begin()->mProfile.mScreenshot.empty());
+        EXPECT_EQ(readScreenshot(*character.begin()), std::vector<char>({'j', 'p', 'g'}));
+    }
+
+    TEST_F(MWStateCharacterTest, should_use_index_for_unchanged_save)
+    {
+        {
+            const Character character(mPath, game);
+        }
+        const auto timeStamp = boost::filesystem::last_write_time(mSavePath);
+        writeSave(mSavePath, makeProfile("other"));
+        boost::filesystem::last_write_time(mSavePath, timeStamp);
+        const Character character(mPath, game);
+        ASSERT_EQ(std::distance(character.begin(), character.end()), 1);
+        EXPECT_EQ(character.begin()->mProfile.mDescription, "first");
+    }
+
+    TEST_F(MWStateCharacterTest, should_read_save_modified_after_index)
+    {
+        {
+            const Character character(mPath, game);
+        }
+        const auto timeStamp = boost::filesystem::last_write_time(mSavePath);
+        writeSave(mSavePath, makeProfile("second"));
+        boost::filesystem::last_write_time(mSavePath, timeStamp + 10);
+        const Character character(mPath, game);
+        ASSERT_EQ(std::distance(character.begin(), character.end()), 1);
+        EXPECT_EQ(character.begin()->mProfile.mDescription, "second");
+    }
+
+    TEST_F(MWStateCharacterTest, should_ignore_index_entry_for_removed_save)
+    {
+        {
+            const Character character(mPath, game);
+        }
+        boost::filesystem::remove(mSavePath);
+        const Character character(mPath, game);
+        EXPECT_EQ(character.begin(), character.end());
+    }
+
+    TEST_F(MWStateCharacterTest, deleting_last_slot_should_remove_index)
+    {
+        Character character(mPath, game);
+        ASSERT_EQ(std::distance(character.begin(), character.end()), 1);
+        character.deleteSlot(&*character.begin());
+        EXPECT_FALSE(boost::filesystem::exists(mIndexPath));
+        character.cleanup();
+        EXPECT_FALSE(boost::filesystem::exists(mPath));
+    }
+
+    TEST_F(MWStateCharacterTest, should_skip_unfinished_save_files)
+    {
+        writeSave(mPath / "other.omwsave.tmp", makeProfile("unfinished"));
+        const Character character(mPath, game);
+        ASSERT_EQ(std::distance(character.begin(), character.end()), 1);
+        EXPECT_EQ(character.begin()->mProfile.mDescription, "first");
+    }
+
+    TEST_F(MWStateCharacterTest, should_use_index_for_unchanged_save_of_other_game)
+    {
+        const boost::filesystem::path otherPath = mPath / "other.omwsave";
+        writeSave(otherPath, makeProfile("other", "Tribunal1.esm"));
+        {
+            const Character character(mPath, game);
+            ASSERT_EQ(std::distance(character.begin(), character.end()), 1);
+        }
+        const auto timeStamp = boost::filesystem::last_write_time(otherPath);
+        writeSave(otherPath, makeProfile("other", game));
+        boost::filesystem::last_write_time(otherPath, timeStamp);
+        const Character character(mPath, game);
+        ASSERT_EQ(std::distance(character.begin(), character.end()), 1);
+        EXPECT_EQ(character.begin()->mProfile.mDescription, "first");
+    }
+
+    TEST_F(MWStateCharacterTest, update_index_should_add_written_slot)
+    {
+        boost::filesystem::path path;
+        {
+            Character character(mPath, game);
+            path = character.createSlot(makeProfile("new"))->mPath;
+            writeSave(path, makeProfile("new"));
+            character.updateIndex(path);
+        }
+        const auto timeStamp = boost::filesystem::last_write_time(path);
+        writeSave(path, makeProfile("nex"));
+        boost::filesystem::last_write_time(path, timeStamp);
+        const Character character(mPath, game);
+        ASSERT_EQ(std::distance(character.begin(), character.end()), 2);
+        EXPECT_TRUE(std::any_of(character.begin(), character.end(),
+            [] (const Slot& slot) { return slot.mProfile.mDescription == "new"; }));
+    }
+
+    TEST_F(MWStateCharacterTest, new_slot_should_not_use_path_of_slot_not_written_yet)
+    {
+        Character character(mPath, game);
+        const Slot* const first = character.createSlot(makeProfile("new"));
+        const boost::filesystem::path firstPath = first->mPath;
+        const Slot* const second = character.createSlot(makeProfile("new"));
+        EXPECT_NE(second->mPath, firstPath);
+    }
+}
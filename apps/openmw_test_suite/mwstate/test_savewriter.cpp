@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwstate/savewriter.hpp"
+
+#include "../testing_util.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <iterator>
+
+namespace
+{
+    using namespace MWState;
+
+    std::string readFile(const boost::filesystem::path& path)
+    {
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    struct MWStateSaveWriterTest : ::testing::Test
+    {
+        const boost::filesystem::path mPath = TestingOpenMW::temporaryFilePath("openmw_test_savewriter");
+        const boost::filesystem::path mSavePath = mPath / "save.omwsave";
+
+        MWStateSaveWriterTest()
+        {
+            boost::filesystem::remove_all(mPath);
+            boost::filesystem::create_directories(mPath);
+        }
+
+        ~MWStateSaveWriterTest()
+        {
+            boost::filesystem::remove_all(mPath);
+        }
+    };
+
+    TEST_F(MWStateSaveWriterTest, write_file_atomically_should_replace_existing_file)
+    {
+        writeFileAtomically(mSavePath, "old");
+        writeFileAtomically(mSavePath, "new");
+        EXPECT_EQ(readFile(mSavePath), "new");
+        EXPECT_FALSE(boost::filesystem::exists(getTemporarySavePath(mSavePath)));
+    }
+
+    TEST_F(MWStateSaveWriterTest, write_file_atomically_should_throw_and_leave_no_files_on_failure)
+    {
+        const boost::filesystem::path path = mPath / "missing" / "save.omwsave";
+        EXPECT_THROW(writeFileAtomically(path, "data"), std::exception);
+        EXPECT_FALSE(boost::filesystem::exists(path));
+        EXPECT_FALSE(boost::filesystem::exists(getTemporarySavePath(path)));
+    }
+
+    TEST_F(MWStateSaveWriterTest, should_write_queued_saves_in_order)
+    {
+        SaveWriter writer;
+        writer.write(nullptr, mSavePath, "first", "1", SaveWriter::Duration::zero());
+        writer.write(nullptr, mSavePath, "second", "22", SaveWriter::Duration::zero());
+        writer.wait();
+        const std::vector<SaveWriter::Result> results = writer.takeFinished();
+        ASSERT_EQ(results.size(), 2);
+        EXPECT_EQ(results[0].mDescription, "first");
+        EXPECT_EQ(results[1].mDescription, "second");
+        EXPECT_EQ(results[1].mSize, 2);
+        EXPECT_TRUE(results[1].mError.empty());
+        EXPECT_EQ(readFile(mSavePath), "22");
+        EXPECT_TRUE(writer.takeFinished().empty());
+    }
+
+    TEST_F(MWStateSaveWriterTest, should_report_failed_write)
+    {
+        SaveWriter writer;
+        writer.write(nullptr, mPath / "missing" / "save.omwsave", "save", "data", SaveWriter::Duration::zero());
+        writer.wait();
+        const std::vector<SaveWriter::Result> results = writer.takeFinished();
+        ASSERT_EQ(results.size(), 1);
+        EXPECT_FALSE(results[0].mError.empty());
+    }
+
+    TEST_F(MWStateSaveWriterTest, destructor_should_finish_queued_saves)
+    {
+        {
+            SaveWriter writer;
+            writer.write(nullptr, mSavePath, "save", "data", SaveWriter::Duration::zero());
+        }
+        EXPECT_EQ(readFile(mSavePath), "data");
+    }
+}
@@ -0,0 +1,214 @@
+#include "apps/navmeshtool/tilesources.hpp"
+
+#include <components/detournavigator/navmeshdb.hpp>
+#include <components/esm3/loadacti.hpp>
+#include <components/esm3/loadcell.hpp>
+#include <components/esm3/loadcont.hpp>
+#include <components/esm3/loaddoor.hpp>
+#include <components/esm3/loadgmst.hpp>
+#include <components/esm3/loadland.hpp>
+#include <components/esm3/loadstat.hpp>
+#include <components/esmloader/esmdata.hpp>
+#include <components/sqlite3/db.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../testing_util.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+namespace
+{
+    using namespace testing;
+    using namespace NavMeshTool;
+    using namespace DetourNavigator;
+
+    const std::string worldspace = "sys::default";
+    const std::vector<std::byte> settings {std::byte {1}, std::byte {2}};
+
+    ContentFileHash makeContentFileHash(std::string name, unsigned char hash)
+    {
+        return ContentFileHash {std::move(name), std::vector<std::byte>(16, std::byte {hash})};
+    }
+
+    // Writes tile sources of a previous run:
+    // cell "0, 0" is defined by a.esm and covers tiles (0, 0) and (0, 1),
+    // cell "1, 0" is defined by a.esm and b.esp, has a "chair" and covers tile (1, 0),
+    // cell "2, 0" is defined by a.esm, has a "table" and covers tiles (1, 0) and (2, 0).
+    void writePreviousRun(NavMeshDb& db)
+    {
+        db.setContentFiles({makeContentFileHash("a.esm", 1), makeContentFileHash("b.esp", 2)});
+        db.setTileSourcesSettings(settings);
+
+        db.insertCellSource(worldspace, "0, 0", CellSourceType::ContentFile, "a.esm");
+        db.insertTileCell(worldspace, TilePosition(0, 0), "0, 0");
+        db.insertTileCell(worldspace, TilePosition(0, 1), "0, 0");
+
+        db.insertCellSource(worldspace, "1, 0", CellSourceType::ContentFile, "a.esm");
+        db.insertCellSource(worldspace, "1, 0", CellSourceType::ContentFile, "b.esp");
+        db.insertCellSource(worldspace, "1, 0", CellSourceType::RefId, "chair");
+        db.insertTileCell(worldspace, TilePosition(1, 0), "1, 0");
+
+        db.insertCellSource(worldspace, "2, 0", CellSourceType::ContentFile, "a.esm");
+        db.insertCellSource(worldspace, "2, 0", CellSourceType::RefId, "table");
+        db.insertTileCell(worldspace, TilePosition(1, 0), "2, 0");
+        db.insertTileCell(worldspace, TilePosition(2, 0), "2, 0");
+    }
+
+    struct NavMeshToolTileSourcesTest : Test
+    {
+        NavMeshDb mDb {":memory:", std::numeric_limits<std::uint64_t>::max()};
+        EsmLoader::EsmData mEsmData;
+
+        NavMeshToolTileSourcesTest()
+        {
+            writePreviousRun(mDb);
+        }
+
+        std::optional<Tiles> getChangedTiles(const std::vector<ContentFileHash>& contentFiles,
+            const Tiles& changedCellsTiles = {})
+        {
+            const std::optional<std::set<std::string>> changedContentFiles
+                = getChangedContentFiles(mDb, contentFiles, settings);
+            if (!changedContentFiles.has_value())
+                return {};
+            std::vector<std::string> names;
+            for (const ContentFileHash& v : contentFiles)
+                names.push_back(v.mName);
+            const std::set<std::string> changedRefIds = getChangedRefIds(mEsmData, names, *changedContentFiles);
+            const Cells changedCells = findCellsBySources(mDb, *changedContentFiles, changedRefIds);
+            return NavMeshTool::getChangedTiles(mDb, changedCells, changedCellsTiles);
+        }
+    };
+
+    TEST_F(NavMeshToolTileSourcesTest, unchanged_content_files_should_not_mark_any_tile)
+    {
+        const auto tiles = getChangedTiles({makeContentFileHash("a.esm", 1), makeContentFileHash("b.esp", 2)});
+        ASSERT_TRUE(tiles.has_value());
+        EXPECT_EQ(getTilesCount(*tiles), 0);
+    }
+
+    TEST_F(NavMeshToolTileSourcesTest, changed_content_file_should_mark_tiles_of_its_cells)
+    {
+        const auto tiles = getChangedTiles({makeContentFileHash("a.esm", 1), makeContentFileHash("b.esp", 3)});
+        ASSERT_TRUE(tiles.has_value());
+        EXPECT_EQ(*tiles, (Tiles {{worldspace, {TilePosition(1, 0)}}}));
+    }
+
+    TEST_F(NavMeshToolTileSourcesTest, removed_content_file_should_mark_tiles_of_its_cells)
+    {
+        const auto tiles = getChangedTiles({makeContentFileHash("a.esm", 1)});
+        ASSERT_TRUE(tiles.has_value());
+        EXPECT_EQ(*tiles, (Tiles {{worldspace, {TilePosition(1, 0)}}}));
+    }
+
+    TEST_F(NavMeshToolTileSourcesTest, added_content_file_should_mark_tiles_of_cells_with_its_objects)
+    {
+        mEsmData.mRefIdContentFiles.push_back(EsmLoader::RefIdContentFile {"table", 2});
+        const auto tiles = getChangedTiles({makeContentFileHash("a.esm", 1), makeContentFileHash("b.esp", 2),
+            makeContentFileHash("c.esp", 4)});
+        ASSERT_TRUE(tiles.has_value());
+        EXPECT_EQ(*tiles, (Tiles {{worldspace, {TilePosition(1, 0), TilePosition(2, 0)}}}));
+    }
+
+    TEST_F(NavMeshToolTileSourcesTest, added_content_file_should_mark_tiles_of_its_cells)
+    {
+        const Tiles newCellTiles {{worldspace, {TilePosition(3, 0)}}};
+        const auto tiles = getChangedTiles({makeContentFileHash("a.esm", 1), makeContentFileHash("b.esp", 2),
+            makeContentFileHash("c.esp", 4)}, newCellTiles);
+        ASSERT_TRUE(tiles.has_value());
+        EXPECT_EQ(*tiles, newCellTiles);
+    }
+
+    TEST_F(NavMeshToolTileSourcesTest, reordered_content_files_should_require_processing_all_tiles)
+    {
+        EXPECT_EQ(getChangedTiles({makeContentFileHash("b.esp", 2), makeContentFileHash("a.esm", 1)}), std::nullopt);
+    }
+
+    TEST_F(NavMeshToolTileSourcesTest, changed_settings_should_require_processing_all_tiles)
+    {
+        const std::vector<ContentFileHash> contentFiles {makeContentFileHash("a.esm", 1), makeContentFileHash("b.esp", 2)};
+        EXPECT_EQ(getChangedContentFiles(mDb, contentFiles, {std::byte {3}}), std::nullopt);
+    }
+
+    TEST_F(NavMeshToolTileSourcesTest, missing_tile_sources_should_require_processing_all_tiles)
+    {
+        NavMeshDb db(":memory:", std::numeric_limits<std::uint64_t>::max());
+        EXPECT_EQ(getChangedContentFiles(db, {makeContentFileHash("a.esm", 1)}, settings), std::nullopt);
+    }
+
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream stream(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    struct NavMeshToolTileSourcesDryRunTest : Test
+    {
+        const std::string mPath = TestingOpenMW::temporaryFilePath("navmeshtool_tilesources_dry_run.db");
+
+        NavMeshToolTileSourcesDryRunTest()
+        {
+            std::filesystem::remove(mPath);
+        }
+
+        ~NavMeshToolTileSourcesDryRunTest()
+        {
+            std::filesystem::remove(mPath);
+        }
+    };
+
+    TEST_F(NavMeshToolTileSourcesDryRunTest, finding_changed_tiles_should_not_write_to_db)
+    {
+        {
+            NavMeshDb db(mPath, std::numeric_limits<std::uint64_t>::max());
+            writePreviousRun(db);
+        }
+
+        const std::string before = readFile(mPath);
+        const auto modified = std::filesystem::last_write_time(mPath);
+
+        {
+            NavMeshDb db(mPath, std::numeric_limits<std::uint64_t>::max(), false, NavMeshDbMode::ReadOnly);
+            const std::vector<ContentFileHash> contentFiles {makeContentFileHash("a.esm", 1)};
+            const std::optional<std::set<std::string>> changedContentFiles
+                = getChangedContentFiles(db, contentFiles, settings);
+            ASSERT_TRUE(changedContentFiles.has_value());
+            const Cells changedCells = findCellsBySources(db, *changedContentFiles, {});
+            const Tiles tiles = NavMeshTool::getChangedTiles(db, changedCells, {});
+            EXPECT_EQ(getTilesCount(tiles), 1);
+            findCellsByTiles(db, tiles);
+        }
+
+        EXPECT_EQ(readFile(mPath), before);
+        EXPECT_EQ(std::filesystem::last_write_time(mPath), modified);
+    }
+
+    TEST_F(NavMeshToolTileSourcesDryRunTest, read_only_db_should_not_be_created)
+    {
+        EXPECT_THROW(NavMeshDb(mPath, std::numeric_limits<std::uint64_t>::max(), false, NavMeshDbMode::ReadOnly),
+            std::runtime_error);
+        EXPECT_FALSE(std::filesystem::exists(mPath));
+    }
+
+    TEST_F(NavMeshToolTileSourcesDryRunTest, read_only_db_with_old_schema_should_not_be_migrated)
+    {
+        {
+            NavMeshDb db(mPath, std::numeric_limits<std::uint64_t>::max());
+            writePreviousRun(db);
+        }
+        {
+            const Sqlite3::Db db = Sqlite3::makeDb(mPath, "pragma user_version = 0;");
+        }
+
+        const std::string before = readFile(mPath);
+
+        EXPECT_THROW(NavMeshDb(mPath, std::numeric_limits<std::uint64_t>::max(), false, NavMeshDbMode::ReadOnly),
+            std::runtime_error);
+        EXPECT_EQ(readFile(mPath), before);
+    }
+}
@@ -1,5 +1,7 @@
 #include <components/shader/shadermanager.hpp>
 
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 
 #include <gtest/gtest.h>
@@ -239,4 +241,146 @@ namespace
             EXPECT_FALSE(mManager.getShader(templateName, mDefines, osg::Shader::VERTEX));
         });
     }
+
+    TEST_F(ShaderManagerTest, get_shader_for_same_template_and_defines_should_return_cached_shader)
+    {
+        const std::string content =
+            "#version 120\n"
+            "#define FLAG @flag\n"
+            "void main() {}\n"
+        ;
+
+        withShaderFile(content, [&] (const std::string& templateName) {
+            mDefines["flag"] = "1";
+            const auto shader = mManager.getShader(templateName, mDefines, osg::Shader::VERTEX);
+            ASSERT_TRUE(shader);
+            EXPECT_EQ(mManager.getShader(templateName, mDefines, osg::Shader::VERTEX), shader);
+            mDefines["flag"] = "0";
+            EXPECT_NE(mManager.getShader(templateName, mDefines, osg::Shader::VERTEX), shader);
+            const ShaderManager::Stats stats = mManager.getStats();
+            EXPECT_EQ(stats.mTemplates, 1);
+            EXPECT_EQ(stats.mPermutations, 2);
+            EXPECT_EQ(stats.mRequests, 3);
+            EXPECT_EQ(stats.mHits, 1);
+        });
+    }
+
+    TEST_F(ShaderManagerTest, get_shader_should_use_source_cache_written_by_other_instance)
+    {
+        const std::string content =
+            "#version 120\n"
+            "#define FLAG @flag\n"
+            "void main() {}\n"
+        ;
+        const std::string cachePath = TestingOpenMW::outputFilePath("shader_source_cache_reuse");
+        std::filesystem::remove_all(cachePath);
+
+        withShaderFile(content, [&] (const std::string& templateName) {
+            mDefines["flag"] = "1";
+            mManager.setSourceCachePath(cachePath);
+            const auto shader = mManager.getShader(templateName, mDefines, osg::Shader::VERTEX);
+            ASSERT_TRUE(shader);
+            EXPECT_EQ(mManager.getStats().mSourceCacheHits, 0);
+
+            ShaderManager manager;
+            manager.setShaderPath(".");
+            manager.setSourceCachePath(cachePath);
+            const auto cached = manager.getShader(templateName, mDefines, osg::Shader::VERTEX);
+            ASSERT_TRUE(cached);
+            EXPECT_EQ(cached->getShaderSource(), shader->getShaderSource());
+            const ShaderManager::Stats stats = manager.getStats();
+            EXPECT_EQ(stats.mSourceCacheHits, 1);
+            EXPECT_EQ(stats.mTemplates, 0);
+        });
+    }
+
+    TEST_F(ShaderManagerTest, get_shader_should_not_use_source_cache_for_modified_template)
+    {
+        const std::string cachePath = TestingOpenMW::outputFilePath("shader_source_cache_modified");
+        std::filesystem::remove_all(cachePath);
+
+        withShaderFile("#version 120\nvoid main() {}\n", [&] (const std::string& templateName) {
+            mManager.setSourceCachePath(cachePath);
+            ASSERT_TRUE(mManager.getShader(templateName, mDefines, osg::Shader::VERTEX));
+        });
+
+        const std::string modified = "#version 120\nvoid main() { gl_Position = vec4(0.0); }\n";
+        withShaderFile(modified, [&] (const std::string& templateName) {
+            ShaderManager manager;
+            manager.setShaderPath(".");
+            manager.setSourceCachePath(cachePath);
+            const auto shader = manager.getShader(templateName, mDefines, osg::Shader::VERTEX);
+            ASSERT_TRUE(shader);
+            EXPECT_EQ(shader->getShaderSource(), modified);
+            EXPECT_EQ(manager.getStats().mSourceCacheHits, 0);
+        });
+    }
+
+    TEST_F(ShaderManagerTest, get_shader_should_not_use_source_cache_for_other_shader_path)
+    {
+        const std::string cachePath = TestingOpenMW::outputFilePath("shader_source_cache_other_path");
+        std::filesystem::remove_all(cachePath);
+        const std::filesystem::path otherShaderPath = TestingOpenMW::outputFilePath("shader_other_path");
+
+        withShaderFile("#version 120\nvoid main() {}\n", [&] (const std::string& templateName) {
+            mManager.setSourceCachePath(cachePath);
+            ASSERT_TRUE(mManager.getShader(templateName, mDefines, osg::Shader::VERTEX));
+
+            const std::string other = "#version 120\nvoid main() { gl_Position = vec4(0.0); }\n";
+            std::filesystem::create_directories((otherShaderPath / templateName).parent_path());
+            std::ofstream(otherShaderPath / templateName) << other;
+
+            ShaderManager manager;
+            manager.setShaderPath(otherShaderPath.string());
+            manager.setSourceCachePath(cachePath);
+            const auto shader = manager.getShader(templateName, mDefines, osg::Shader::VERTEX);
+            ASSERT_TRUE(shader);
+            EXPECT_EQ(shader->getShaderSource(), other);
+            EXPECT_EQ(manager.getStats().mSourceCacheHits, 0);
+        });
+    }
+
+    TEST_F(ShaderManagerTest, get_shader_should_ignore_source_cache_file_with_too_large_size)
+    {
+        const std::string content = "#version 120\nvoid main() {}\n";
+        const std::string cachePath = TestingOpenMW::outputFilePath("shader_source_cache_corrupted");
+        std::filesystem::remove_all(cachePath);
+
+        withShaderFile(content, [&] (const std::string& templateName) {
+            mManager.setSourceCachePath(cachePath);
+            ASSERT_TRUE(mManager.getShader(templateName, mDefines, osg::Shader::VERTEX));
+
+            for (const auto& entry : std::filesystem::directory_iterator(cachePath))
+                std::ofstream(entry.path(), std::ios::binary) << "18446744073709551615\n";
+
+            ShaderManager manager;
+            manager.setShaderPath(".");
+            manager.setSourceCachePath(cachePath);
+            const auto shader = manager.getShader(templateName, mDefines, osg::Shader::VERTEX);
+            ASSERT_TRUE(shader);
+            EXPECT_EQ(shader->getShaderSource(), content);
+            EXPECT_EQ(manager.getStats().mSourceCacheHits, 0);
+        });
+    }
+
+    TEST_F(ShaderManagerTest, set_source_cache_path_should_remove_old_files)
+    {
+        const std::filesystem::path cachePath = TestingOpenMW::outputFilePath("shader_source_cache_prune");
+        std::filesystem::remove_all(cachePath);
+        std::filesystem::create_directories(cachePath);
+        const std::filesystem::path oldFile = cachePath / "0000000000000000.glsl";
+        const std::filesystem::path newFile = cachePath / "0000000000000001.glsl";
+        const std::filesystem::path otherFile = cachePath / "other.txt";
+        for (const auto& path : {oldFile, newFile, otherFile})
+            std::ofstream(path) << "content";
+        const auto oldTime = std::filesystem::file_time_type::clock::now() - std::chrono::hours(24 * 365);
+        std::filesystem::last_write_time(oldFile, oldTime);
+        std::filesystem::last_write_time(otherFile, oldTime);
+
+        mManager.setSourceCachePath(cachePath.string());
+
+        EXPECT_FALSE(std::filesystem::exists(oldFile));
+        EXPECT_TRUE(std::filesystem::exists(newFile));
+        EXPECT_TRUE(std::filesystem::exists(otherFile));
+    }
 }
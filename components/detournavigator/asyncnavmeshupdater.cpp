@@ -57,6 +57,17 @@ namespace DetourNavigator
             }
         };
 
+        // Detour tile stored in the cache is added to the navmesh as is instead of building a copy
+        NavMeshData getNavMeshTileData(NavMeshTilesCache::Value& cached, const PreparedNavMeshData& data,
+            const std::vector<OffMeshConnection>& offMeshConnections, const AgentBounds& agentBounds,
+            const TilePosition& tile, const RecastSettings& settings)
+        {
+            if (cached)
+                if (NavMeshData result = cached.takeNavMeshData(offMeshConnections); result.mValue != nullptr)
+                    return result;
+            return makeNavMeshTileData(data, offMeshConnections, agentBounds, tile, settings);
+        }
+
         void insertPrioritizedJob(JobIt job, std::deque<JobIt>& queue)
         {
             const auto it = std::upper_bound(queue.begin(), queue.end(), job, LessByJobPriority {});
@@ -145,7 +156,7 @@ namespace DetourNavigator
         , mRecastMeshManager(recastMeshManager)
         , mOffMeshConnectionsManager(offMeshConnectionsManager)
         , mShouldStop()
-        , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize)
+        , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize, settings.mAsyncNavMeshUpdaterThreads)
         , mDbWorker(makeDbWorker(*this, std::move(db), mSettings))
     {
         for (std::size_t i = 0; i < mSettings.get().mAsyncNavMeshUpdaterThreads; ++i)
@@ -468,10 +479,13 @@ namespace DetourNavigator
             }
         }
 
-        const auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
+        auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
+
+        NavMeshData navMeshData = getNavMeshTileData(cachedNavMeshData, *preparedNavMeshDataPtr, offMeshConnections,
+            job.mAgentBounds, job.mChangedTile, mSettings.get().mRecast);
 
         const UpdateNavMeshStatus status = navMeshCacheItem.lock()->updateTile(job.mChangedTile, std::move(cachedNavMeshData),
-            makeNavMeshTileData(*preparedNavMeshDataPtr, offMeshConnections, job.mAgentBounds, job.mChangedTile, mSettings.get().mRecast));
+            std::move(navMeshData), std::move(offMeshConnections));
 
         return handleUpdateNavMeshStatus(status, job, navMeshCacheItem, *recastMesh);
     }
@@ -508,13 +522,16 @@ namespace DetourNavigator
         auto cachedNavMeshData = mNavMeshTilesCache.set(job.mAgentBounds, job.mChangedTile, *job.mRecastMesh,
                                                         std::move(preparedNavMeshData));
 
-        const auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
+        auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
 
         const PreparedNavMeshData* preparedNavMeshDataPtr = cachedNavMeshData ? &cachedNavMeshData.get() : preparedNavMeshData.get();
         assert (preparedNavMeshDataPtr != nullptr);
 
+        NavMeshData navMeshData = getNavMeshTileData(cachedNavMeshData, *preparedNavMeshDataPtr, offMeshConnections,
+            job.mAgentBounds, job.mChangedTile, mSettings.get().mRecast);
+
         const UpdateNavMeshStatus status = navMeshCacheItem.lock()->updateTile(job.mChangedTile, std::move(cachedNavMeshData),
-            makeNavMeshTileData(*preparedNavMeshDataPtr, offMeshConnections, job.mAgentBounds, job.mChangedTile, mSettings.get().mRecast));
+            std::move(navMeshData), std::move(offMeshConnections));
 
         const JobStatus result = handleUpdateNavMeshStatus(status, job, navMeshCacheItem, *job.mRecastMesh);
 
@@ -826,14 +843,15 @@ namespace DetourNavigator
     {
         Log(Debug::Debug) << "Processing db read job " << job->mId;
 
-        if (job->mInput.empty())
+        if (!job->mInputHash.has_value())
         {
             Log(Debug::Debug) << "Serializing input for job " << job->mId;
+            std::vector<std::byte> input;
             if (mWriteToDb)
             {
                 const auto objects = makeDbRefGeometryObjects(job->mRecastMesh->getMeshSources(),
                     [&] (const MeshSource& v) { return resolveMeshSource(*mDb, v, mNextShapeId); });
-                job->mInput = serialize(mRecastSettings, job->mAgentBounds, *job->mRecastMesh, objects);
+                input = serialize(mRecastSettings, job->mAgentBounds, *job->mRecastMesh, objects);
             }
             else
             {
@@ -841,11 +859,12 @@ namespace DetourNavigator
                     [&] (const MeshSource& v) { return resolveMeshSource(*mDb, v); });
                 if (!objects.has_value())
                     return;
-                job->mInput = serialize(mRecastSettings, job->mAgentBounds, *job->mRecastMesh, *objects);
+                input = serialize(mRecastSettings, job->mAgentBounds, *job->mRecastMesh, *objects);
             }
+            setInput(*job, std::move(input));
         }
 
-        job->mCachedTileData = mDb->getTileData(job->mWorldspace, job->mChangedTile, job->mInput);
+        job->mCachedTileData = mDb->getTileData(job->mWorldspace, job->mChangedTile, *job->mInputHash, job->mInput);
         ++mGetTileCount;
     }
 
@@ -859,12 +878,12 @@ namespace DetourNavigator
 
         Log(Debug::Debug) << "Processing db write job " << job->mId;
 
-        if (job->mInput.empty())
+        if (!job->mInputHash.has_value())
         {
             Log(Debug::Debug) << "Serializing input for job " << job->mId;
             const std::vector<DbRefGeometryObject> objects = makeDbRefGeometryObjects(job->mRecastMesh->getMeshSources(),
                 [&] (const MeshSource& v) { return resolveMeshSource(*mDb, v, mNextShapeId); });
-            job->mInput = serialize(mRecastSettings, job->mAgentBounds, *job->mRecastMesh, objects);
+            setInput(*job, serialize(mRecastSettings, job->mAgentBounds, *job->mRecastMesh, objects));
         }
 
         if (const auto& cachedTileData = job->mCachedTileData)
@@ -875,7 +894,7 @@ namespace DetourNavigator
             return;
         }
 
-        const auto cached = mDb->findTile(job->mWorldspace, job->mChangedTile, job->mInput);
+        const auto cached = mDb->findTile(job->mWorldspace, job->mChangedTile, *job->mInputHash, job->mInput);
         if (cached.has_value() && cached->mVersion == mVersion)
         {
             Log(Debug::Debug) << "Ignore existing db tile by job " << job->mId;
@@ -885,7 +904,14 @@ namespace DetourNavigator
         job->mGeneratedNavMeshData->mUserId = mNextTileId;
         Log(Debug::Debug) << "Insert db tile by job " << job->mId;
         mDb->insertTile(mNextTileId, job->mWorldspace, job->mChangedTile,
-                        mVersion, job->mInput, serialize(*job->mGeneratedNavMeshData));
+                        mVersion, *job->mInputHash, job->mInput, serialize(*job->mGeneratedNavMeshData));
         ++mNextTileId;
     }
+
+    void DbWorker::setInput(Job& job, std::vector<std::byte>&& input) const
+    {
+        job.mInputHash = makeTileInputHash(input);
+        if (mDb->verifiesInput())
+            job.mInput = std::move(input);
+    }
 }
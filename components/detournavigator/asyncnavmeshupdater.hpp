@@ -54,6 +54,8 @@ namespace DetourNavigator
         int mDistanceToPlayer;
         const int mDistanceToOrigin;
         JobState mState = JobState::Initial;
+        std::optional<TileInputHash> mInputHash;
+        // Serialized input is kept only when the db verifies it
         std::vector<std::byte> mInput;
         std::shared_ptr<RecastMesh> mRecastMesh;
         std::optional<TileData> mCachedTileData;
@@ -139,6 +141,8 @@ namespace DetourNavigator
         inline void processReadingJob(JobIt job);
 
         inline void processWritingJob(JobIt job);
+
+        inline void setInput(Job& job, std::vector<std::byte>&& input) const;
     };
 
     class AsyncNavMeshUpdater
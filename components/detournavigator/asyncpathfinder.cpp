@@ -0,0 +1,231 @@
+#include "asyncpathfinder.hpp"
+#include "findsmoothpath.hpp"
+#include "settings.hpp"
+#include "settingsutils.hpp"
+
+#include <components/debug/debuglog.hpp>
+
+#include <DetourNavMeshQuery.h>
+
+#include <osg/Stats>
+
+#include <cmath>
+#include <exception>
+#include <iterator>
+#include <optional>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        std::array<long, 3> roundPosition(const osg::Vec3f& value)
+        {
+            return {std::lround(value.x()), std::lround(value.y()), std::lround(value.z())};
+        }
+
+        PathResult findPath(const Settings& settings, dtNavMeshQuery& navMeshQuery,
+            const std::weak_ptr<GuardedNavMeshCacheItem>& navMeshCacheItem, const PathRequest& request,
+            std::optional<Version>& navMeshVersion)
+        {
+            PathResult result;
+            const auto navMesh = navMeshCacheItem.lock();
+            if (navMesh == nullptr)
+            {
+                result.mStatus = Status::NavMeshNotFound;
+                return result;
+            }
+            const auto locked = navMesh->lockConst();
+            navMeshVersion = locked->getVersion();
+            result.mStatus = findSmoothPath(navMeshQuery, locked->getImpl(),
+                toNavMeshCoordinates(settings.mRecast, request.mAgentBounds.mHalfExtents),
+                toNavMeshCoordinates(settings.mRecast, request.mStepSize),
+                toNavMeshCoordinates(settings.mRecast, request.mStart),
+                toNavMeshCoordinates(settings.mRecast, request.mEnd), request.mIncludeFlags, request.mAreaCosts,
+                settings, request.mEndTolerance, std::back_inserter(result.mPath));
+            return result;
+        }
+    }
+
+    AsyncPathFinder::AsyncPathFinder(const Settings& settings, std::size_t threadsCount, std::size_t maxCacheSize)
+        : mSettings(settings)
+        , mMaxCacheSize(maxCacheSize)
+    {
+        for (std::size_t i = 0; i < threadsCount; ++i)
+            mThreads.emplace_back([&] { run(); });
+    }
+
+    AsyncPathFinder::~AsyncPathFinder()
+    {
+        stop();
+    }
+
+    std::shared_future<PathResult> AsyncPathFinder::post(const SharedNavMeshCacheItem& navMeshCacheItem,
+        const PathRequest& request)
+    {
+        // Reading the version doesn't wait for workers and navmesh updates holding the navmesh lock
+        const Version navMeshVersion = navMeshCacheItem->getVersion();
+
+        const AreaCosts& areaCosts = request.mAreaCosts;
+        Key key {navMeshVersion.mGeneration, request.mAgentBounds, request.mStepSize, roundPosition(request.mStart),
+            roundPosition(request.mEnd), request.mIncludeFlags,
+            {areaCosts.mWater, areaCosts.mDoor, areaCosts.mPathgrid, areaCosts.mGround}, request.mEndTolerance};
+
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        ++mRequests;
+
+        if (const auto it = mCache.find(key); it != mCache.end())
+        {
+            if (it->second.mNavMeshVersion == navMeshVersion)
+            {
+                ++mCacheHits;
+                mCacheUsage.splice(mCacheUsage.begin(), mCacheUsage, it->second.mUsage);
+                return it->second.mResult;
+            }
+            mCacheUsage.erase(it->second.mUsage);
+            mCache.erase(it);
+        }
+
+        if (const auto it = mPending.find(key); it != mPending.end())
+        {
+            ++mCoalesced;
+            return it->second;
+        }
+
+        Job job {key, request, navMeshCacheItem, {}, std::chrono::steady_clock::now()};
+        std::shared_future<PathResult> result = job.mPromise.get_future().share();
+
+        if (mThreads.empty())
+        {
+            lock.unlock();
+            dtNavMeshQuery navMeshQuery;
+            std::optional<Version> foundVersion;
+            try
+            {
+                job.mPromise.set_value(findPath(mSettings, navMeshQuery, job.mNavMeshCacheItem, request, foundVersion));
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Error) << "AsyncPathFinder failed to find path: " << e.what();
+                foundVersion.reset();
+                job.mPromise.set_exception(std::current_exception());
+            }
+            lock.lock();
+            if (foundVersion.has_value())
+                addToCache(key, *foundVersion, result);
+            return result;
+        }
+
+        mPending.emplace(std::move(key), result);
+        mJobs.push_back(std::move(job));
+        lock.unlock();
+        mHasJob.notify_one();
+
+        return result;
+    }
+
+    void AsyncPathFinder::stop()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            mShouldStop = true;
+        }
+        mHasJob.notify_all();
+        for (auto& thread : mThreads)
+            if (thread.joinable())
+                thread.join();
+        // Waiting requests get std::future_error with broken_promise
+        mJobs.clear();
+        mPending.clear();
+    }
+
+    AsyncPathFinder::Stats AsyncPathFinder::getStats() const
+    {
+        Stats result;
+        const std::lock_guard<std::mutex> lock(mMutex);
+        result.mJobs = mJobs.size();
+        result.mRequests = mRequests;
+        result.mCoalesced = mCoalesced;
+        result.mCacheHits = mCacheHits;
+        result.mCacheSize = mCache.size();
+        result.mQueueLatency = mQueueLatency;
+        return result;
+    }
+
+    void AsyncPathFinder::run() noexcept
+    {
+        // Reinitializing a query for the same number of nodes keeps its node pool and open list
+        dtNavMeshQuery navMeshQuery;
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true)
+        {
+            mHasJob.wait(lock, [&] { return mShouldStop || !mJobs.empty(); });
+            if (mShouldStop)
+                return;
+
+            Job job = std::move(mJobs.front());
+            mJobs.pop_front();
+
+            constexpr double latencySmoothing = 0.1;
+            const std::chrono::duration<double> latency = std::chrono::steady_clock::now() - job.mPostTime;
+            mQueueLatency += (latency - mQueueLatency) * latencySmoothing;
+
+            lock.unlock();
+
+            std::optional<Version> navMeshVersion;
+            try
+            {
+                job.mPromise.set_value(findPath(mSettings, navMeshQuery, job.mNavMeshCacheItem, job.mRequest,
+                                                navMeshVersion));
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Error) << "AsyncPathFinder failed to find path: " << e.what();
+                navMeshVersion.reset();
+                job.mPromise.set_exception(std::current_exception());
+            }
+
+            lock.lock();
+
+            const auto pending = mPending.find(job.mKey);
+            if (pending == mPending.end())
+                continue;
+            if (navMeshVersion.has_value())
+                addToCache(job.mKey, *navMeshVersion, pending->second);
+            mPending.erase(pending);
+        }
+    }
+
+    void AsyncPathFinder::addToCache(const Key& key, const Version& navMeshVersion,
+        const std::shared_future<PathResult>& result)
+    {
+        if (mMaxCacheSize == 0)
+            return;
+
+        if (const auto it = mCache.find(key); it != mCache.end())
+        {
+            mCacheUsage.erase(it->second.mUsage);
+            mCache.erase(it);
+        }
+
+        while (mCache.size() >= mMaxCacheSize)
+        {
+            mCache.erase(mCacheUsage.back());
+            mCacheUsage.pop_back();
+        }
+
+        mCacheUsage.push_front(key);
+        mCache.emplace(key, CacheItem {navMeshVersion, result, mCacheUsage.begin()});
+    }
+
+    void reportStats(const AsyncPathFinder::Stats& stats, unsigned int frameNumber, osg::Stats& out)
+    {
+        out.setAttribute(frameNumber, "NavMesh PathJobs", static_cast<double>(stats.mJobs));
+        out.setAttribute(frameNumber, "NavMesh PathRequests", static_cast<double>(stats.mRequests));
+        out.setAttribute(frameNumber, "NavMesh PathCoalesced", static_cast<double>(stats.mCoalesced));
+        out.setAttribute(frameNumber, "NavMesh PathCacheHits", static_cast<double>(stats.mCacheHits));
+        out.setAttribute(frameNumber, "NavMesh PathCacheSize", static_cast<double>(stats.mCacheSize));
+        out.setAttribute(frameNumber, "NavMesh PathQueueLatency", stats.mQueueLatency.count());
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_ASYNCPATHFINDER_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_ASYNCPATHFINDER_H
+
+#include "agentbounds.hpp"
+#include "flags.hpp"
+#include "navmeshcacheitem.hpp"
+#include "pathrequest.hpp"
+#include "version.hpp"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace DetourNavigator
+{
+    struct Settings;
+
+    /**
+     * @brief AsyncPathFinder finds paths over navmesh in background threads. Each thread keeps its own dtNavMeshQuery
+     * to reuse the node pool between requests. Requests equal to a pending one share its result. Recent results are
+     * kept until the navmesh they were found on changes.
+     */
+    class AsyncPathFinder
+    {
+    public:
+        struct Stats
+        {
+            std::size_t mJobs = 0;
+            std::size_t mRequests = 0;
+            std::size_t mCoalesced = 0;
+            std::size_t mCacheHits = 0;
+            std::size_t mCacheSize = 0;
+            std::chrono::duration<double> mQueueLatency {0};
+        };
+
+        /**
+         * @param threadsCount number of background threads, with zero paths are found by post on the calling thread.
+         * @param maxCacheSize number of recent paths to keep.
+         */
+        AsyncPathFinder(const Settings& settings, std::size_t threadsCount, std::size_t maxCacheSize);
+        ~AsyncPathFinder();
+
+        /**
+         * @brief post queues a request to find a path over the given navmesh.
+         * @param request start and end points and step size are in world coordinates as for findPath. Start and
+         * end points are matched with pending and cached requests rounded to whole units.
+         * @return result with the path in world coordinates.
+         */
+        std::shared_future<PathResult> post(const SharedNavMeshCacheItem& navMeshCacheItem, const PathRequest& request);
+
+        void stop();
+
+        Stats getStats() const;
+
+    private:
+        struct Key
+        {
+            std::size_t mNavMeshGeneration;
+            AgentBounds mAgentBounds;
+            float mStepSize;
+            std::array<long, 3> mStart;
+            std::array<long, 3> mEnd;
+            Flags mIncludeFlags;
+            std::array<float, 4> mAreaCosts;
+            float mEndTolerance;
+
+            friend inline auto tie(const Key& value)
+            {
+                return std::tie(value.mNavMeshGeneration, value.mAgentBounds, value.mStepSize, value.mStart, value.mEnd,
+                    value.mIncludeFlags, value.mAreaCosts, value.mEndTolerance);
+            }
+
+            friend inline bool operator<(const Key& lhs, const Key& rhs)
+            {
+                return tie(lhs) < tie(rhs);
+            }
+        };
+
+        struct Job
+        {
+            Key mKey;
+            PathRequest mRequest;
+            std::weak_ptr<GuardedNavMeshCacheItem> mNavMeshCacheItem;
+            std::promise<PathResult> mPromise;
+            std::chrono::steady_clock::time_point mPostTime;
+        };
+
+        struct CacheItem
+        {
+            Version mNavMeshVersion;
+            std::shared_future<PathResult> mResult;
+            std::list<Key>::iterator mUsage;
+        };
+
+        const Settings& mSettings;
+        const std::size_t mMaxCacheSize;
+        mutable std::mutex mMutex;
+        std::condition_variable mHasJob;
+        bool mShouldStop = false;
+        std::deque<Job> mJobs;
+        std::map<Key, std::shared_future<PathResult>> mPending;
+        std::map<Key, CacheItem> mCache;
+        std::list<Key> mCacheUsage;
+        std::size_t mRequests = 0;
+        std::size_t mCoalesced = 0;
+        std::size_t mCacheHits = 0;
+        std::chrono::duration<double> mQueueLatency {0};
+        std::vector<std::thread> mThreads;
+
+        void run() noexcept;
+
+        void addToCache(const Key& key, const Version& navMeshVersion, const std::shared_future<PathResult>& result);
+    };
+
+    void reportStats(const AsyncPathFinder::Stats& stats, unsigned int frameNumber, osg::Stats& out);
+}
+
+#endif
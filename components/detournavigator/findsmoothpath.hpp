@@ -253,12 +253,14 @@ namespace DetourNavigator
         return Status::Success;
     }
 
+    /**
+     * @param navMeshQuery is initialized for navMesh, a query reused for multiple calls keeps its node pool.
+     */
     template <class OutputIterator>
-    Status findSmoothPath(const dtNavMesh& navMesh, const osg::Vec3f& halfExtents, const float stepSize,
-            const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags, const AreaCosts& areaCosts,
-            const Settings& settings, float endTolerance, OutputIterator out)
+    Status findSmoothPath(dtNavMeshQuery& navMeshQuery, const dtNavMesh& navMesh, const osg::Vec3f& halfExtents,
+            const float stepSize, const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags,
+            const AreaCosts& areaCosts, const Settings& settings, float endTolerance, OutputIterator out)
     {
-        dtNavMeshQuery navMeshQuery;
         if (!initNavMeshQuery(navMeshQuery, navMesh, settings.mDetour.mMaxNavMeshQueryNodes))
             return Status::InitNavMeshQueryFailed;
 
@@ -301,6 +303,16 @@ namespace DetourNavigator
 
         return partialPath ? Status::PartialPath : Status::Success;
     }
+
+    template <class OutputIterator>
+    Status findSmoothPath(const dtNavMesh& navMesh, const osg::Vec3f& halfExtents, const float stepSize,
+            const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags, const AreaCosts& areaCosts,
+            const Settings& settings, float endTolerance, OutputIterator out)
+    {
+        dtNavMeshQuery navMeshQuery;
+        return findSmoothPath(navMeshQuery, navMesh, halfExtents, stepSize, start, end, includeFlags, areaCosts,
+            settings, endTolerance, out);
+    }
 }
 
 #endif
@@ -16,7 +16,8 @@ namespace DetourNavigator
         {
             try
             {
-                db = std::make_unique<NavMeshDb>(userDataPath + "/navmesh.db", settings.mMaxDbFileSize);
+                db = std::make_unique<NavMeshDb>(userDataPath + "/navmesh.db", settings.mMaxDbFileSize,
+                                                 settings.mVerifyNavMeshDbInput);
             }
             catch (const std::exception& e)
             {
@@ -7,6 +7,7 @@
 #include "waitconditiontype.hpp"
 #include "heightfieldshape.hpp"
 #include "objecttransform.hpp"
+#include "asyncpathfinder.hpp"
 
 #include <components/resource/bulletshape.hpp>
 
@@ -194,6 +195,13 @@ namespace DetourNavigator
          */
         virtual std::map<AgentBounds, SharedNavMeshCacheItem> getNavMeshes() const = 0;
 
+        /**
+         * @brief findPathAsync finds a path like findPath but in a background thread.
+         * @param request defines the agent, the points and the surfaces to walk as arguments of findPath.
+         * @return result becomes ready when the path is found, it holds the path in world coordinates.
+         */
+        virtual std::shared_future<PathResult> findPathAsync(const PathRequest& request) = 0;
+
         virtual const Settings& getSettings() const = 0;
 
         virtual void reportStats(unsigned int frameNumber, osg::Stats& stats) const = 0;
@@ -12,6 +12,7 @@ namespace DetourNavigator
     NavigatorImpl::NavigatorImpl(const Settings& settings, std::unique_ptr<NavMeshDb>&& db)
         : mSettings(settings)
         , mNavMeshManager(mSettings, std::move(db))
+        , mAsyncPathFinder(mSettings, mSettings.mAsyncPathFinderThreads, mSettings.mMaxPathCacheSize)
         , mUpdatesEnabled(true)
     {
     }
@@ -193,9 +194,22 @@ namespace DetourNavigator
         return mSettings;
     }
 
+    std::shared_future<PathResult> NavigatorImpl::findPathAsync(const PathRequest& request)
+    {
+        const SharedNavMeshCacheItem navMesh = getNavMesh(request.mAgentBounds);
+        if (navMesh == nullptr)
+        {
+            std::promise<PathResult> result;
+            result.set_value(PathResult {Status::NavMeshNotFound, {}});
+            return result.get_future().share();
+        }
+        return mAsyncPathFinder.post(navMesh, request);
+    }
+
     void NavigatorImpl::reportStats(unsigned int frameNumber, osg::Stats& stats) const
     {
         mNavMeshManager.reportStats(frameNumber, stats);
+        DetourNavigator::reportStats(mAsyncPathFinder.getStats(), frameNumber, stats);
     }
 
     RecastMeshTiles NavigatorImpl::getRecastMeshTiles() const
@@ -60,6 +60,8 @@ namespace DetourNavigator
 
         std::map<AgentBounds, SharedNavMeshCacheItem> getNavMeshes() const override;
 
+        std::shared_future<PathResult> findPathAsync(const PathRequest& request) override;
+
         const Settings& getSettings() const override;
 
         void reportStats(unsigned int frameNumber, osg::Stats& stats) const override;
@@ -71,6 +73,7 @@ namespace DetourNavigator
     private:
         Settings mSettings;
         NavMeshManager mNavMeshManager;
+        AsyncPathFinder mAsyncPathFinder;
         bool mUpdatesEnabled;
         std::optional<TilePosition> mLastPlayerPosition;
         std::map<AgentBounds, std::size_t> mAgents;
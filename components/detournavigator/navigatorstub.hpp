@@ -91,6 +91,13 @@ namespace DetourNavigator
             return {};
         }
 
+        std::shared_future<PathResult> findPathAsync(const PathRequest& /*request*/) override
+        {
+            std::promise<PathResult> result;
+            result.set_value(PathResult {Status::NavMeshNotFound, {}});
+            return result.get_future().share();
+        }
+
         const Settings& getSettings() const override
         {
             return mDefaultSettings;
@@ -69,12 +69,14 @@ namespace DetourNavigator
     }
 
     UpdateNavMeshStatus NavMeshCacheItem::updateTile(const TilePosition& position, NavMeshTilesCache::Value&& cached,
-        NavMeshData&& navMeshData)
+        NavMeshData&& navMeshData, std::vector<OffMeshConnection>&& offMeshConnections)
     {
         const dtMeshTile* currentTile = getTile(*mImpl, position);
         if (currentTile != nullptr
             && asNavMeshTileConstView(*currentTile) == asNavMeshTileConstView(navMeshData.mValue.get()))
         {
+            if (cached)
+                cached.putNavMeshData(std::move(navMeshData), std::move(offMeshConnections));
             return UpdateNavMeshStatus::ignored;
         }
         bool removed = ::removeTile(*mImpl, position);
@@ -85,24 +87,26 @@ namespace DetourNavigator
             auto tile = mUsedTiles.find(position);
             if (tile == mUsedTiles.end())
             {
-                mUsedTiles.emplace_hint(tile, position,
-                    Tile {Version {mVersion.mRevision, 1}, std::move(cached), std::move(navMeshData)});
+                mUsedTiles.emplace_hint(tile, position, Tile {Version {mRevision, 1}, std::move(cached),
+                    std::move(navMeshData), std::move(offMeshConnections)});
             }
             else
             {
+                releaseTile(tile->second);
                 ++tile->second.mVersion.mRevision;
                 tile->second.mCached = std::move(cached);
                 tile->second.mData = std::move(navMeshData);
+                tile->second.mOffMeshConnections = std::move(offMeshConnections);
             }
-            ++mVersion.mRevision;
+            ++mRevision;
             return UpdateNavMeshStatusBuilder().added(true).removed(removed).getResult();
         }
         else
         {
             if (removed)
             {
-                mUsedTiles.erase(position);
-                ++mVersion.mRevision;
+                eraseUsedTile(position);
+                ++mRevision;
             }
             return UpdateNavMeshStatusBuilder().removed(removed).failed((addStatus & DT_OUT_OF_MEMORY) != 0).getResult();
         }
@@ -114,8 +118,8 @@ namespace DetourNavigator
         removed = mEmptyTiles.erase(position) > 0 || removed;
         if (removed)
         {
-            mUsedTiles.erase(position);
-            ++mVersion.mRevision;
+            eraseUsedTile(position);
+            ++mRevision;
         }
         return UpdateNavMeshStatusBuilder().removed(removed).getResult();
     }
@@ -126,8 +130,8 @@ namespace DetourNavigator
         removed = mEmptyTiles.insert(position).second || removed;
         if (removed)
         {
-            mUsedTiles.erase(position);
-            ++mVersion.mRevision;
+            eraseUsedTile(position);
+            ++mRevision;
         }
         return UpdateNavMeshStatusBuilder().removed(removed).getResult();
     }
@@ -136,4 +140,19 @@ namespace DetourNavigator
     {
         return mEmptyTiles.find(position) != mEmptyTiles.end();
     }
+
+    void NavMeshCacheItem::releaseTile(Tile& tile)
+    {
+        if (tile.mCached)
+            tile.mCached.putNavMeshData(std::move(tile.mData), std::move(tile.mOffMeshConnections));
+    }
+
+    void NavMeshCacheItem::eraseUsedTile(const TilePosition& position)
+    {
+        const auto it = mUsedTiles.find(position);
+        if (it == mUsedTiles.end())
+            return;
+        releaseTile(it->second);
+        mUsedTiles.erase(it);
+    }
 }
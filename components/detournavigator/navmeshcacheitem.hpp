@@ -5,13 +5,17 @@
 #include "tileposition.hpp"
 #include "navmeshtilescache.hpp"
 #include "navmeshdata.hpp"
+#include "offmeshconnection.hpp"
 #include "version.hpp"
 
 #include <components/misc/guarded.hpp>
 
+#include <atomic>
 #include <map>
 #include <iosfwd>
 #include <set>
+#include <shared_mutex>
+#include <vector>
 
 struct dtMeshTile;
 
@@ -107,7 +111,7 @@ namespace DetourNavigator
     public:
         NavMeshCacheItem(const NavMeshPtr& impl, std::size_t generation)
             : mImpl(impl)
-            , mVersion {generation, 0}
+            , mGeneration(generation)
         {
         }
 
@@ -116,10 +120,15 @@ namespace DetourNavigator
             return *mImpl;
         }
 
-        const Version& getVersion() const { return mVersion; }
+        Version getVersion() const { return Version {mGeneration, mRevision}; }
 
+        /**
+         * @brief updateTile replaces tile at the position by the given data. Data of the replaced tile is returned
+         * to its cached value to be reused by the next update with the same input.
+         * @param offMeshConnections used to build navMeshData.
+         */
         UpdateNavMeshStatus updateTile(const TilePosition& position, NavMeshTilesCache::Value&& cached,
-                                       NavMeshData&& navMeshData);
+                                       NavMeshData&& navMeshData, std::vector<OffMeshConnection>&& offMeshConnections);
 
         UpdateNavMeshStatus removeTile(const TilePosition& position);
 
@@ -141,15 +150,51 @@ namespace DetourNavigator
             Version mVersion;
             NavMeshTilesCache::Value mCached;
             NavMeshData mData;
+            std::vector<OffMeshConnection> mOffMeshConnections;
         };
 
         NavMeshPtr mImpl;
-        Version mVersion;
+        const std::size_t mGeneration;
+        // Changed only with exclusive lock but read without it by GuardedNavMeshCacheItem::getVersion
+        std::atomic<std::size_t> mRevision {0};
         std::map<TilePosition, Tile> mUsedTiles;
         std::set<TilePosition> mEmptyTiles;
+
+        // Should be called only for a tile removed from mImpl
+        static void releaseTile(Tile& tile);
+
+        void eraseUsedTile(const TilePosition& position);
+    };
+
+    /**
+     * @brief GuardedNavMeshCacheItem allows concurrent reads of the navmesh with lockConst and exclusive updates with
+     * lock. The version can be read without locking to check whether a result found on the navmesh is still valid.
+     */
+    class GuardedNavMeshCacheItem
+    {
+    public:
+        GuardedNavMeshCacheItem(const NavMeshPtr& impl, std::size_t generation)
+            : mValue(impl, generation)
+        {
+        }
+
+        Misc::Locked<NavMeshCacheItem, std::unique_lock<std::shared_mutex>> lock()
+        {
+            return {mMutex, mValue};
+        }
+
+        Misc::Locked<const NavMeshCacheItem, std::shared_lock<std::shared_mutex>> lockConst() const
+        {
+            return {mMutex, mValue};
+        }
+
+        Version getVersion() const { return mValue.getVersion(); }
+
+    private:
+        mutable std::shared_mutex mMutex;
+        NavMeshCacheItem mValue;
     };
 
-    using GuardedNavMeshCacheItem = Misc::ScopeGuarded<NavMeshCacheItem>;
     using SharedNavMeshCacheItem = std::shared_ptr<GuardedNavMeshCacheItem>;
 }
 
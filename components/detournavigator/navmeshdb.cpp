@@ -8,10 +8,16 @@
 
 #include <DetourAlloc.h>
 
+#include <extern/smhasher/MurmurHash3.h>
+
 #include <sqlite3.h>
 
 #include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
 #include <string_view>
+#include <tuple>
 #include <vector>
 
 namespace DetourNavigator
@@ -32,9 +38,6 @@ namespace DetourNavigator
                 data BLOB
             );
 
-            CREATE UNIQUE INDEX IF NOT EXISTS index_unique_tiles_by_worldspace_and_tile_position_and_input
-                ON tiles (worldspace, tile_position_x, tile_position_y, input);
-
             CREATE INDEX IF NOT EXISTS index_tiles_by_worldspace_and_tile_position
                 ON tiles (worldspace, tile_position_x, tile_position_y);
 
@@ -48,9 +51,64 @@ namespace DetourNavigator
             CREATE UNIQUE INDEX IF NOT EXISTS index_unique_shapes_by_name_and_type_and_hash
                 ON shapes (name, type, hash);
 
+            CREATE TABLE IF NOT EXISTS content_files (
+                position INTEGER PRIMARY KEY,
+                name TEXT NOT NULL,
+                hash BLOB NOT NULL
+            );
+
+            CREATE TABLE IF NOT EXISTS tile_sources_settings (
+                settings_id INTEGER PRIMARY KEY,
+                value BLOB NOT NULL
+            );
+
+            CREATE TABLE IF NOT EXISTS tile_cells (
+                worldspace TEXT NOT NULL,
+                tile_position_x INTEGER NOT NULL,
+                tile_position_y INTEGER NOT NULL,
+                cell TEXT NOT NULL
+            );
+
+            CREATE UNIQUE INDEX IF NOT EXISTS index_unique_tile_cells_by_worldspace_and_tile_position_and_cell
+                ON tile_cells (worldspace, tile_position_x, tile_position_y, cell);
+
+            CREATE INDEX IF NOT EXISTS index_tile_cells_by_worldspace_and_cell
+                ON tile_cells (worldspace, cell);
+
+            CREATE TABLE IF NOT EXISTS cell_sources (
+                worldspace TEXT NOT NULL,
+                cell TEXT NOT NULL,
+                type INTEGER NOT NULL,
+                name TEXT NOT NULL
+            );
+
+            CREATE UNIQUE INDEX IF NOT EXISTS index_unique_cell_sources_by_worldspace_and_cell_and_type_and_name
+                ON cell_sources (worldspace, cell, type, name);
+
+            CREATE INDEX IF NOT EXISTS index_cell_sources_by_type_and_name
+                ON cell_sources (type, name);
+
             COMMIT;
         )";
 
+        // Tiles were looked up by the whole compressed input before version 1
+        constexpr const char addTileInputHashMigration[] = R"(
+            ALTER TABLE tiles ADD COLUMN input_hash BLOB;
+
+            DROP INDEX IF EXISTS index_unique_tiles_by_worldspace_and_tile_position_and_input;
+        )";
+
+        constexpr const char addTileInputHashIndexMigration[] = R"(
+            CREATE UNIQUE INDEX IF NOT EXISTS index_unique_tiles_by_worldspace_and_tile_position_and_input_hash
+                ON tiles (worldspace, tile_position_x, tile_position_y, input_hash);
+        )";
+
+        constexpr const char clearTilesInputMigration[] = R"(
+            UPDATE tiles SET input = NULL;
+        )";
+
+        constexpr int schemaVersion = 1;
+
         constexpr std::string_view getMaxTileIdQuery = R"(
             SELECT max(tile_id) FROM tiles
         )";
@@ -61,7 +119,7 @@ namespace DetourNavigator
              WHERE worldspace = :worldspace
                AND tile_position_x = :tile_position_x
                AND tile_position_y = :tile_position_y
-               AND input = :input
+               AND input_hash = :input_hash
         )";
 
         constexpr std::string_view getTileDataQuery = R"(
@@ -70,12 +128,19 @@ namespace DetourNavigator
              WHERE worldspace = :worldspace
                AND tile_position_x = :tile_position_x
                AND tile_position_y = :tile_position_y
-               AND input = :input
+               AND input_hash = :input_hash
+        )";
+
+        constexpr std::string_view getTileInputQuery = R"(
+            SELECT input
+              FROM tiles
+             WHERE tile_id = :tile_id
+               AND input IS NOT NULL
         )";
 
         constexpr std::string_view insertTileQuery = R"(
-            INSERT INTO tiles ( tile_id,  worldspace,  version,  tile_position_x,  tile_position_y,  input,  data)
-                   VALUES     (:tile_id, :worldspace, :version, :tile_position_x, :tile_position_y, :input, :data)
+            INSERT INTO tiles ( tile_id,  worldspace,  version,  tile_position_x,  tile_position_y,  input_hash,  input,  data)
+                   VALUES     (:tile_id, :worldspace, :version, :tile_position_x, :tile_position_y, :input_hash, :input, :data)
         )";
 
         constexpr std::string_view updateTileQuery = R"(
@@ -128,6 +193,85 @@ namespace DetourNavigator
                    VALUES      (:shape_id, :name, :type, :hash)
         )";
 
+        constexpr std::string_view getContentFilesQuery = R"(
+            SELECT name, hash
+              FROM content_files
+             ORDER BY position
+        )";
+
+        constexpr std::string_view deleteContentFilesQuery = R"(
+            DELETE FROM content_files
+        )";
+
+        constexpr std::string_view insertContentFileQuery = R"(
+            INSERT INTO content_files ( position,  name,  hash)
+                   VALUES             (:position, :name, :hash)
+        )";
+
+        constexpr std::string_view getTileSourcesSettingsQuery = R"(
+            SELECT value
+              FROM tile_sources_settings
+             WHERE settings_id = 1
+        )";
+
+        constexpr std::string_view setTileSourcesSettingsQuery = R"(
+            INSERT OR REPLACE INTO tile_sources_settings (settings_id,  value)
+                   VALUES                                (1,           :value)
+        )";
+
+        constexpr std::string_view findCellsBySourceQuery = R"(
+            SELECT worldspace, cell
+              FROM cell_sources
+             WHERE type = :type
+               AND name = :name
+        )";
+
+        constexpr std::string_view findTilesByCellQuery = R"(
+            SELECT tile_position_x, tile_position_y
+              FROM tile_cells
+             WHERE worldspace = :worldspace
+               AND cell = :cell
+        )";
+
+        constexpr std::string_view getTileCellsQuery = R"(
+            SELECT cell
+              FROM tile_cells
+             WHERE worldspace = :worldspace
+               AND tile_position_x = :tile_position_x
+               AND tile_position_y = :tile_position_y
+        )";
+
+        constexpr std::string_view insertTileCellQuery = R"(
+            INSERT OR IGNORE INTO tile_cells ( worldspace,  tile_position_x,  tile_position_y,  cell)
+                   VALUES                    (:worldspace, :tile_position_x, :tile_position_y, :cell)
+        )";
+
+        constexpr std::string_view insertCellSourceQuery = R"(
+            INSERT OR IGNORE INTO cell_sources ( worldspace,  cell,  type,  name)
+                   VALUES                      (:worldspace, :cell, :type, :name)
+        )";
+
+        constexpr std::string_view deleteTileCellsAtQuery = R"(
+            DELETE FROM tile_cells
+             WHERE worldspace = :worldspace
+               AND tile_position_x = :tile_position_x
+               AND tile_position_y = :tile_position_y
+        )";
+
+        constexpr std::string_view deleteCellSourcesQuery = R"(
+            DELETE FROM cell_sources
+             WHERE worldspace = :worldspace
+               AND cell = :cell
+        )";
+
+        constexpr std::string_view deleteAllTileCellsQuery = R"(
+            DELETE FROM tile_cells
+        )";
+
+        constexpr std::string_view deleteAllCellSourcesQuery = R"(
+            DELETE FROM cell_sources
+        )";
+
         constexpr std::string_view vacuumQuery = R"(
             VACUUM;
         )";
@@ -152,6 +296,126 @@ namespace DetourNavigator
             if (const int ec = sqlite3_exec(&db, query.c_str(), nullptr, nullptr, nullptr); ec != SQLITE_OK)
                 throw std::runtime_error("Failed set max page count: " + std::string(sqlite3_errmsg(&db)));
         }
+
+        Sqlite3::ConstBlob toBlob(const TileInputHash& value)
+        {
+            return Sqlite3::ConstBlob {reinterpret_cast<const char*>(value.data()), static_cast<int>(value.size())};
+        }
+
+        struct GetUserVersion
+        {
+            static std::string_view text() noexcept { return "pragma user_version;"; }
+            static void bind(sqlite3&, sqlite3_stmt&) {}
+        };
+
+        struct GetTilesInputs
+        {
+            static std::string_view text() noexcept
+            {
+                return R"(
+                    SELECT tile_id, input
+                      FROM tiles
+                     WHERE tile_id > :tile_id
+                       AND input IS NOT NULL
+                     ORDER BY tile_id
+                     LIMIT :limit
+                )";
+            }
+
+            static void bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId, int limit)
+            {
+                Sqlite3::bindParameter(db, statement, ":tile_id", tileId);
+                Sqlite3::bindParameter(db, statement, ":limit", limit);
+            }
+        };
+
+        struct SetTileInputHash
+        {
+            static std::string_view text() noexcept
+            {
+                return "UPDATE tiles SET input_hash = :input_hash WHERE tile_id = :tile_id";
+            }
+
+            static void bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId, const TileInputHash& inputHash)
+            {
+                Sqlite3::bindParameter(db, statement, ":tile_id", tileId);
+                Sqlite3::bindParameter(db, statement, ":input_hash", toBlob(inputHash));
+            }
+        };
+
+        void exec(sqlite3& db, const char* query)
+        {
+            if (const int ec = sqlite3_exec(&db, query, nullptr, nullptr, nullptr); ec != SQLITE_OK)
+                throw std::runtime_error("Failed to migrate navmeshdb schema: " + std::string(sqlite3_errmsg(&db)));
+        }
+
+        void addTileInputHash(sqlite3& db, bool keepInput)
+        {
+            exec(db, addTileInputHashMigration);
+
+            Sqlite3::Statement<GetTilesInputs> getTilesInputs(db);
+            Sqlite3::Statement<SetTileInputHash> setTileInputHash(db);
+            constexpr int batchSize = 1024;
+            std::vector<std::tuple<TileId, std::vector<std::byte>>> rows;
+            TileId lastTileId {0};
+            std::size_t count = 0;
+            while (true)
+            {
+                rows.clear();
+                request(db, getTilesInputs, std::back_inserter(rows), batchSize, lastTileId, batchSize);
+                if (rows.empty())
+                    break;
+                for (const auto& [tileId, input] : rows)
+                    execute(db, setTileInputHash, tileId, makeTileInputHash(Misc::decompress(input)));
+                lastTileId = std::get<0>(rows.back());
+                count += rows.size();
+            }
+
+            exec(db, addTileInputHashIndexMigration);
+            if (!keepInput)
+                exec(db, clearTilesInputMigration);
+
+            if (count > 0)
+                Log(Debug::Info) << "Migrated " << count << " navmesh tiles to input hash keys";
+        }
+
+        Sqlite3::Db makeNavMeshDb(std::string_view path, bool verifyInput, NavMeshDbMode mode)
+        {
+            Sqlite3::Db db = mode == NavMeshDbMode::ReadOnly ? Sqlite3::makeReadOnlyDb(path)
+                                                             : Sqlite3::makeDb(path, schema);
+
+            Sqlite3::Statement<GetUserVersion> getUserVersion(*db);
+            int version = 0;
+            request(*db, getUserVersion, &version, 1);
+
+            if (version == schemaVersion)
+                return db;
+            if (mode == NavMeshDbMode::ReadOnly)
+                throw std::runtime_error("Read-only navmeshdb has schema version " + std::to_string(version)
+                                         + " instead of " + std::to_string(schemaVersion));
+            if (version > schemaVersion)
+                throw std::runtime_error("Unsupported navmeshdb schema version: " + std::to_string(version)
+                                         + " > " + std::to_string(schemaVersion));
+
+            Sqlite3::Transaction transaction(*db, Sqlite3::TransactionMode::Exclusive);
+            if (version < 1)
+                addTileInputHash(*db, verifyInput);
+            exec(*db, ("pragma user_version = " + std::to_string(schemaVersion) + ";").c_str());
+            transaction.commit();
+
+            return db;
+        }
+    }
+
+    TileInputHash makeTileInputHash(const std::vector<std::byte>& input)
+    {
+        constexpr std::array<std::uint64_t, 2> seed {0, 0};
+        std::array<std::uint64_t, 2> hash {0, 0};
+        MurmurHash3_x64_128(input.data(), static_cast<int>(input.size()), seed.data(), hash.data());
+        TileInputHash result;
+        static_assert(sizeof(result) == sizeof(hash));
+        std::memcpy(result.data(), hash.data(), sizeof(hash));
+        return result;
     }
 
     std::ostream& operator<<(std::ostream& stream, ShapeType value)
@@ -164,11 +428,13 @@ namespace DetourNavigator
         return stream << "unknown shape type (" << static_cast<std::underlying_type_t<ShapeType>>(value) << ")";
     }
 
-    NavMeshDb::NavMeshDb(std::string_view path, std::uint64_t maxFileSize)
-        : mDb(Sqlite3::makeDb(path, schema))
+    NavMeshDb::NavMeshDb(std::string_view path, std::uint64_t maxFileSize, bool verifyInput, NavMeshDbMode mode)
+        : mVerifyInput(verifyInput)
+        , mDb(makeNavMeshDb(path, verifyInput, mode))
         , mGetMaxTileId(*mDb, DbQueries::GetMaxTileId {})
         , mFindTile(*mDb, DbQueries::FindTile {})
         , mGetTileData(*mDb, DbQueries::GetTileData {})
+        , mGetTileInput(*mDb, DbQueries::GetTileInput {})
         , mInsertTile(*mDb, DbQueries::InsertTile {})
         , mUpdateTile(*mDb, DbQueries::UpdateTile {})
         , mDeleteTilesAt(*mDb, DbQueries::DeleteTilesAt {})
@@ -177,8 +443,24 @@ namespace DetourNavigator
         , mGetMaxShapeId(*mDb, DbQueries::GetMaxShapeId {})
         , mFindShapeId(*mDb, DbQueries::FindShapeId {})
         , mInsertShape(*mDb, DbQueries::InsertShape {})
+        , mGetContentFiles(*mDb, DbQueries::GetContentFiles {})
+        , mDeleteContentFiles(*mDb, DbQueries::DeleteContentFiles {})
+        , mInsertContentFile(*mDb, DbQueries::InsertContentFile {})
+        , mGetTileSourcesSettings(*mDb, DbQueries::GetTileSourcesSettings {})
+        , mSetTileSourcesSettings(*mDb, DbQueries::SetTileSourcesSettings {})
+        , mFindCellsBySource(*mDb, DbQueries::FindCellsBySource {})
+        , mFindTilesByCell(*mDb, DbQueries::FindTilesByCell {})
+        , mGetTileCells(*mDb, DbQueries::GetTileCells {})
+        , mInsertTileCell(*mDb, DbQueries::InsertTileCell {})
+        , mInsertCellSource(*mDb, DbQueries::InsertCellSource {})
+        , mDeleteTileCellsAt(*mDb, DbQueries::DeleteTileCellsAt {})
+        , mDeleteCellSources(*mDb, DbQueries::DeleteCellSources {})
+        , mDeleteAllTileCells(*mDb, DbQueries::DeleteAllTileCells {})
+        , mDeleteAllCellSources(*mDb, DbQueries::DeleteAllCellSources {})
         , mVacuum(*mDb, DbQueries::Vacuum {})
     {
+        if (mode == NavMeshDbMode::ReadOnly)
+            return;
         const std::uint64_t dbPageSize = getPageSize(*mDb);
         if (dbPageSize == 0)
             throw std::runtime_error("NavMeshDb page size is zero");
@@ -197,35 +479,40 @@ namespace DetourNavigator
         return tileId;
     }
 
-    std::optional<Tile> NavMeshDb::findTile(std::string_view worldspace,
-        const TilePosition& tilePosition, const std::vector<std::byte>& input)
+    std::optional<Tile> NavMeshDb::findTile(std::string_view worldspace, const TilePosition& tilePosition,
+        const TileInputHash& inputHash, const std::vector<std::byte>& input)
     {
         Tile result;
         auto row = std::tie(result.mTileId, result.mVersion);
-        const std::vector<std::byte> compressedInput = Misc::compress(input);
-        if (&row == request(*mDb, mFindTile, &row, 1, worldspace, tilePosition, compressedInput))
+        if (&row == request(*mDb, mFindTile, &row, 1, worldspace, tilePosition, inputHash))
+            return {};
+        if (mVerifyInput && !matchesInput(result.mTileId, input))
             return {};
         return result;
     }
 
-    std::optional<TileData> NavMeshDb::getTileData(std::string_view worldspace,
-        const TilePosition& tilePosition, const std::vector<std::byte>& input)
+    std::optional<TileData> NavMeshDb::getTileData(std::string_view worldspace, const TilePosition& tilePosition,
+        const TileInputHash& inputHash, const std::vector<std::byte>& input)
     {
         TileData result;
         auto row = std::tie(result.mTileId, result.mVersion, result.mData);
-        const std::vector<std::byte> compressedInput = Misc::compress(input);
-        if (&row == request(*mDb, mGetTileData, &row, 1, worldspace, tilePosition, compressedInput))
+        if (&row == request(*mDb, mGetTileData, &row, 1, worldspace, tilePosition, inputHash))
+            return {};
+        if (mVerifyInput && !matchesInput(result.mTileId, input))
             return {};
         result.mData = Misc::decompress(result.mData);
         return result;
     }
 
     int NavMeshDb::insertTile(TileId tileId, std::string_view worldspace, const TilePosition& tilePosition,
-        TileVersion version, const std::vector<std::byte>& input, const std::vector<std::byte>& data)
+        TileVersion version, const TileInputHash& inputHash, const std::vector<std::byte>& input,
+        const std::vector<std::byte>& data)
     {
-        const std::vector<std::byte> compressedInput = Misc::compress(input);
+        const std::vector<std::byte> compressedInput
+            = mVerifyInput && !input.empty() ? Misc::compress(input) : std::vector<std::byte>();
         const std::vector<std::byte> compressedData = Misc::compress(data);
-        return execute(*mDb, mInsertTile, tileId, worldspace, tilePosition, version, compressedInput, compressedData);
+        return execute(*mDb, mInsertTile, tileId, worldspace, tilePosition, version, inputHash, compressedInput,
+                       compressedData);
     }
 
     int NavMeshDb::updateTile(TileId tileId, TileVersion version, const std::vector<std::byte>& data)
@@ -271,11 +558,117 @@ namespace DetourNavigator
         return execute(*mDb, mInsertShape, shapeId, name, type, hash);
     }
 
+    std::vector<ContentFileHash> NavMeshDb::getContentFiles()
+    {
+        std::vector<std::tuple<std::string, std::vector<std::byte>>> rows;
+        request(*mDb, mGetContentFiles, std::back_inserter(rows), std::numeric_limits<std::size_t>::max());
+        std::vector<ContentFileHash> result;
+        result.reserve(rows.size());
+        for (auto& [name, hash] : rows)
+            result.push_back(ContentFileHash {std::move(name), std::move(hash)});
+        return result;
+    }
+
+    void NavMeshDb::setContentFiles(const std::vector<ContentFileHash>& contentFiles)
+    {
+        execute(*mDb, mDeleteContentFiles);
+        for (std::size_t i = 0; i < contentFiles.size(); ++i)
+            execute(*mDb, mInsertContentFile, static_cast<std::int64_t>(i), contentFiles[i].mName,
+                    contentFiles[i].mHash);
+    }
+
+    std::optional<std::vector<std::byte>> NavMeshDb::getTileSourcesSettings()
+    {
+        std::vector<std::byte> value;
+        if (&value == request(*mDb, mGetTileSourcesSettings, &value, 1))
+            return {};
+        return value;
+    }
+
+    int NavMeshDb::setTileSourcesSettings(const std::vector<std::byte>& value)
+    {
+        return execute(*mDb, mSetTileSourcesSettings, value);
+    }
+
+    std::vector<CellLocation> NavMeshDb::findCellsBySource(CellSourceType type, std::string_view name)
+    {
+        std::vector<std::tuple<std::string, std::string>> rows;
+        request(*mDb, mFindCellsBySource, std::back_inserter(rows), std::numeric_limits<std::size_t>::max(),
+                type, name);
+        std::vector<CellLocation> result;
+        result.reserve(rows.size());
+        for (auto& [worldspace, cell] : rows)
+            result.push_back(CellLocation {std::move(worldspace), std::move(cell)});
+        return result;
+    }
+
+    std::vector<TilePosition> NavMeshDb::findTilesByCell(std::string_view worldspace, std::string_view cell)
+    {
+        std::vector<std::tuple<int, int>> rows;
+        request(*mDb, mFindTilesByCell, std::back_inserter(rows), std::numeric_limits<std::size_t>::max(),
+                worldspace, cell);
+        std::vector<TilePosition> result;
+        result.reserve(rows.size());
+        for (const auto& [x, y] : rows)
+            result.emplace_back(x, y);
+        return result;
+    }
+
+    std::vector<std::string> NavMeshDb::getTileCells(std::string_view worldspace, const TilePosition& tilePosition)
+    {
+        std::vector<std::string> result;
+        request(*mDb, mGetTileCells, std::back_inserter(result), std::numeric_limits<std::size_t>::max(),
+                worldspace, tilePosition);
+        return result;
+    }
+
+    int NavMeshDb::insertTileCell(std::string_view worldspace, const TilePosition& tilePosition,
+        std::string_view cell)
+    {
+        return execute(*mDb, mInsertTileCell, worldspace, tilePosition, cell);
+    }
+
+    int NavMeshDb::insertCellSource(std::string_view worldspace, std::string_view cell, CellSourceType type,
+        std::string_view name)
+    {
+        return execute(*mDb, mInsertCellSource, worldspace, cell, type, name);
+    }
+
+    int NavMeshDb::deleteTileCellsAt(std::string_view worldspace, const TilePosition& tilePosition)
+    {
+        return execute(*mDb, mDeleteTileCellsAt, worldspace, tilePosition);
+    }
+
+    int NavMeshDb::deleteCellSources(std::string_view worldspace, std::string_view cell)
+    {
+        return execute(*mDb, mDeleteCellSources, worldspace, cell);
+    }
+
+    void NavMeshDb::deleteAllTileSources()
+    {
+        execute(*mDb, mDeleteAllTileCells);
+        execute(*mDb, mDeleteAllCellSources);
+    }
+
     void NavMeshDb::vacuum()
     {
         execute(*mDb, mVacuum);
     }
 
+    bool NavMeshDb::matchesInput(TileId tileId, const std::vector<std::byte>& input)
+    {
+        if (input.empty())
+            return true;
+        std::vector<std::byte> storedInput;
+        // Tiles inserted without verification have no input to compare with
+        if (&storedInput == request(*mDb, mGetTileInput, &storedInput, 1, tileId))
+            return true;
+        if (Misc::decompress(storedInput) == input)
+            return true;
+        Log(Debug::Error) << "Navmesh tile " << tileId << " input does not match the stored one with the same hash";
+        return false;
+    }
+
     namespace DbQueries
     {
         std::string_view GetMaxTileId::text() noexcept
@@ -289,12 +682,12 @@ namespace DetourNavigator
         }
 
         void FindTile::bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
-            const TilePosition& tilePosition, const std::vector<std::byte>& input)
+            const TilePosition& tilePosition, const TileInputHash& inputHash)
         {
             Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
             Sqlite3::bindParameter(db, statement, ":tile_position_x", tilePosition.x());
             Sqlite3::bindParameter(db, statement, ":tile_position_y", tilePosition.y());
-            Sqlite3::bindParameter(db, statement, ":input", input);
+            Sqlite3::bindParameter(db, statement, ":input_hash", toBlob(inputHash));
         }
 
         std::string_view GetTileData::text() noexcept
@@ -303,12 +696,22 @@ namespace DetourNavigator
         }
 
         void GetTileData::bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
-            const TilePosition& tilePosition, const std::vector<std::byte>& input)
+            const TilePosition& tilePosition, const TileInputHash& inputHash)
         {
             Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
             Sqlite3::bindParameter(db, statement, ":tile_position_x", tilePosition.x());
             Sqlite3::bindParameter(db, statement, ":tile_position_y", tilePosition.y());
-            Sqlite3::bindParameter(db, statement, ":input", input);
+            Sqlite3::bindParameter(db, statement, ":input_hash", toBlob(inputHash));
+        }
+
+        std::string_view GetTileInput::text() noexcept
+        {
+            return getTileInputQuery;
+        }
+
+        void GetTileInput::bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId)
+        {
+            Sqlite3::bindParameter(db, statement, ":tile_id", tileId);
         }
 
         std::string_view InsertTile::text() noexcept
@@ -317,15 +720,20 @@ namespace DetourNavigator
         }
 
         void InsertTile::bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId, std::string_view worldspace,
-            const TilePosition& tilePosition, TileVersion version, const std::vector<std::byte>& input,
-            const std::vector<std::byte>& data)
+            const TilePosition& tilePosition, TileVersion version, const TileInputHash& inputHash,
+            const std::vector<std::byte>& input, const std::vector<std::byte>& data)
         {
             Sqlite3::bindParameter(db, statement, ":tile_id", tileId);
             Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
             Sqlite3::bindParameter(db, statement, ":tile_position_x", tilePosition.x());
             Sqlite3::bindParameter(db, statement, ":tile_position_y", tilePosition.y());
             Sqlite3::bindParameter(db, statement, ":version", version);
-            Sqlite3::bindParameter(db, statement, ":input", input);
+            Sqlite3::bindParameter(db, statement, ":input_hash", toBlob(inputHash));
+            // Null blob pointer binds NULL
+            if (input.empty())
+                Sqlite3::bindParameter(db, statement, ":input", Sqlite3::ConstBlob {nullptr, 0});
+            else
+                Sqlite3::bindParameter(db, statement, ":input", input);
             Sqlite3::bindParameter(db, statement, ":data", data);
         }
 
@@ -416,6 +824,144 @@ namespace DetourNavigator
             Sqlite3::bindParameter(db, statement, ":hash", hash);
         }
 
+        std::string_view GetContentFiles::text() noexcept
+        {
+            return getContentFilesQuery;
+        }
+
+        std::string_view DeleteContentFiles::text() noexcept
+        {
+            return deleteContentFilesQuery;
+        }
+
+        std::string_view InsertContentFile::text() noexcept
+        {
+            return insertContentFileQuery;
+        }
+
+        void InsertContentFile::bind(sqlite3& db, sqlite3_stmt& statement, std::int64_t position,
+            std::string_view name, const std::vector<std::byte>& hash)
+        {
+            Sqlite3::bindParameter(db, statement, ":position", position);
+            Sqlite3::bindParameter(db, statement, ":name", name);
+            Sqlite3::bindParameter(db, statement, ":hash", hash);
+        }
+
+        std::string_view GetTileSourcesSettings::text() noexcept
+        {
+            return getTileSourcesSettingsQuery;
+        }
+
+        std::string_view SetTileSourcesSettings::text() noexcept
+        {
+            return setTileSourcesSettingsQuery;
+        }
+
+        void SetTileSourcesSettings::bind(sqlite3& db, sqlite3_stmt& statement, const std::vector<std::byte>& value)
+        {
+            Sqlite3::bindParameter(db, statement, ":value", value);
+        }
+
+        std::string_view FindCellsBySource::text() noexcept
+        {
+            return findCellsBySourceQuery;
+        }
+
+        void FindCellsBySource::bind(sqlite3& db, sqlite3_stmt& statement, CellSourceType type,
+            std::string_view name)
+        {
+            Sqlite3::bindParameter(db, statement, ":type", static_cast<int>(type));
+            Sqlite3::bindParameter(db, statement, ":name", name);
+        }
+
+        std::string_view FindTilesByCell::text() noexcept
+        {
+            return findTilesByCellQuery;
+        }
+
+        void FindTilesByCell::bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+            std::string_view cell)
+        {
+            Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
+            Sqlite3::bindParameter(db, statement, ":cell", cell);
+        }
+
+        std::string_view GetTileCells::text() noexcept
+        {
+            return getTileCellsQuery;
+        }
+
+        void GetTileCells::bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+            const TilePosition& tilePosition)
+        {
+            Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
+            Sqlite3::bindParameter(db, statement, ":tile_position_x", tilePosition.x());
+            Sqlite3::bindParameter(db, statement, ":tile_position_y", tilePosition.y());
+        }
+
+        std::string_view InsertTileCell::text() noexcept
+        {
+            return insertTileCellQuery;
+        }
+
+        void InsertTileCell::bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+            const TilePosition& tilePosition, std::string_view cell)
+        {
+            Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
+            Sqlite3::bindParameter(db, statement, ":tile_position_x", tilePosition.x());
+            Sqlite3::bindParameter(db, statement, ":tile_position_y", tilePosition.y());
+            Sqlite3::bindParameter(db, statement, ":cell", cell);
+        }
+
+        std::string_view InsertCellSource::text() noexcept
+        {
+            return insertCellSourceQuery;
+        }
+
+        void InsertCellSource::bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+            std::string_view cell, CellSourceType type, std::string_view name)
+        {
+            Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
+            Sqlite3::bindParameter(db, statement, ":cell", cell);
+            Sqlite3::bindParameter(db, statement, ":type", static_cast<int>(type));
+            Sqlite3::bindParameter(db, statement, ":name", name);
+        }
+
+        std::string_view DeleteTileCellsAt::text() noexcept
+        {
+            return deleteTileCellsAtQuery;
+        }
+
+        void DeleteTileCellsAt::bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+            const TilePosition& tilePosition)
+        {
+            Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
+            Sqlite3::bindParameter(db, statement, ":tile_position_x", tilePosition.x());
+            Sqlite3::bindParameter(db, statement, ":tile_position_y", tilePosition.y());
+        }
+
+        std::string_view DeleteCellSources::text() noexcept
+        {
+            return deleteCellSourcesQuery;
+        }
+
+        void DeleteCellSources::bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+            std::string_view cell)
+        {
+            Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
+            Sqlite3::bindParameter(db, statement, ":cell", cell);
+        }
+
+        std::string_view DeleteAllTileCells::text() noexcept
+        {
+            return deleteAllTileCellsQuery;
+        }
+
+        std::string_view DeleteAllCellSources::text() noexcept
+        {
+            return deleteAllCellSourcesQuery;
+        }
+
         std::string_view Vacuum::text() noexcept
         {
             return vacuumQuery;
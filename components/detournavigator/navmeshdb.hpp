@@ -11,11 +11,13 @@
 #include <components/sqlite3/transaction.hpp>
 #include <components/sqlite3/types.hpp>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <utility>
@@ -32,6 +34,11 @@ namespace DetourNavigator
     using TileVersion = Misc::StrongTypedef<std::int64_t, struct TileVersionTag>;
     using ShapeId = Misc::StrongTypedef<std::int64_t, struct ShapeIdTag>;
 
+    // 128 bit hash of serialized tile input used as a part of the tile key instead of the input itself
+    using TileInputHash = std::array<std::byte, 16>;
+
+    TileInputHash makeTileInputHash(const std::vector<std::byte>& input);
+
     struct Tile
     {
         TileId mTileId;
@@ -53,6 +60,29 @@ namespace DetourNavigator
 
     std::ostream& operator<<(std::ostream& stream, ShapeType value);
 
+    enum class CellSourceType
+    {
+        ContentFile = 1,
+        RefId = 2,
+    };
+
+    struct ContentFileHash
+    {
+        std::string mName;
+        std::vector<std::byte> mHash;
+
+        friend inline bool operator==(const ContentFileHash& lhs, const ContentFileHash& rhs)
+        {
+            return std::tie(lhs.mName, lhs.mHash) == std::tie(rhs.mName, rhs.mHash);
+        }
+    };
+
+    struct CellLocation
+    {
+        std::string mWorldspace;
+        std::string mCell;
+    };
+
     namespace DbQueries
     {
         struct GetMaxTileId
@@ -65,22 +95,28 @@ namespace DetourNavigator
         {
             static std::string_view text() noexcept;
             static void bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
-                const TilePosition& tilePosition, const std::vector<std::byte>& input);
+                const TilePosition& tilePosition, const TileInputHash& inputHash);
         };
 
         struct GetTileData
         {
             static std::string_view text() noexcept;
             static void bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
-                const TilePosition& tilePosition, const std::vector<std::byte>& input);
+                const TilePosition& tilePosition, const TileInputHash& inputHash);
+        };
+
+        struct GetTileInput
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId);
         };
 
         struct InsertTile
         {
             static std::string_view text() noexcept;
             static void bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId, std::string_view worldspace,
-                const TilePosition& tilePosition, TileVersion version, const std::vector<std::byte>& input,
-                const std::vector<std::byte>& data);
+                const TilePosition& tilePosition, TileVersion version, const TileInputHash& inputHash,
+                const std::vector<std::byte>& input, const std::vector<std::byte>& data);
         };
 
         struct UpdateTile
@@ -131,6 +167,97 @@ namespace DetourNavigator
                 ShapeType type, const Sqlite3::ConstBlob& hash);
         };
 
+        struct GetContentFiles
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3&, sqlite3_stmt&) {}
+        };
+
+        struct DeleteContentFiles
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3&, sqlite3_stmt&) {}
+        };
+
+        struct InsertContentFile
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, std::int64_t position, std::string_view name,
+                const std::vector<std::byte>& hash);
+        };
+
+        struct GetTileSourcesSettings
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3&, sqlite3_stmt&) {}
+        };
+
+        struct SetTileSourcesSettings
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, const std::vector<std::byte>& value);
+        };
+
+        struct FindCellsBySource
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, CellSourceType type, std::string_view name);
+        };
+
+        struct FindTilesByCell
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+                std::string_view cell);
+        };
+
+        struct GetTileCells
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+                const TilePosition& tilePosition);
+        };
+
+        struct InsertTileCell
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+                const TilePosition& tilePosition, std::string_view cell);
+        };
+
+        struct InsertCellSource
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+                std::string_view cell, CellSourceType type, std::string_view name);
+        };
+
+        struct DeleteTileCellsAt
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+                const TilePosition& tilePosition);
+        };
+
+        struct DeleteCellSources
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, std::string_view worldspace,
+                std::string_view cell);
+        };
+
+        struct DeleteAllTileCells
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3&, sqlite3_stmt&) {}
+        };
+
+        struct DeleteAllCellSources
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3&, sqlite3_stmt&) {}
+        };
+
         struct Vacuum
         {
             static std::string_view text() noexcept;
@@ -138,23 +265,41 @@ namespace DetourNavigator
         };
     }
 
+    enum class NavMeshDbMode
+    {
+        ReadWrite,
+        ReadOnly,
+    };
+
     class NavMeshDb
     {
     public:
-        explicit NavMeshDb(std::string_view path, std::uint64_t maxFileSize);
+        /**
+         * @param verifyInput store serialized tile input along with its hash and check that the stored input matches
+         * the given one when a tile is found to detect hash collisions. Increases the db size a lot, so intended only
+         * for debugging.
+         * @param mode ReadOnly opens an existing db without creating or migrating its schema and throws when the db
+         * is missing or has another schema version.
+         */
+        explicit NavMeshDb(std::string_view path, std::uint64_t maxFileSize, bool verifyInput = false,
+            NavMeshDbMode mode = NavMeshDbMode::ReadWrite);
+
+        bool verifiesInput() const { return mVerifyInput; }
 
         Sqlite3::Transaction startTransaction(Sqlite3::TransactionMode mode = Sqlite3::TransactionMode::Default);
 
         TileId getMaxTileId();
 
-        std::optional<Tile> findTile(std::string_view worldspace,
-            const TilePosition& tilePosition, const std::vector<std::byte>& input);
+        // input is used only when verifiesInput is true, may be empty otherwise
+        std::optional<Tile> findTile(std::string_view worldspace, const TilePosition& tilePosition,
+            const TileInputHash& inputHash, const std::vector<std::byte>& input);
 
-        std::optional<TileData> getTileData(std::string_view worldspace,
-            const TilePosition& tilePosition, const std::vector<std::byte>& input);
+        std::optional<TileData> getTileData(std::string_view worldspace, const TilePosition& tilePosition,
+            const TileInputHash& inputHash, const std::vector<std::byte>& input);
 
         int insertTile(TileId tileId, std::string_view worldspace, const TilePosition& tilePosition,
-            TileVersion version, const std::vector<std::byte>& input, const std::vector<std::byte>& data);
+            TileVersion version, const TileInputHash& inputHash, const std::vector<std::byte>& input,
+            const std::vector<std::byte>& data);
 
         int updateTile(TileId tileId, TileVersion version, const std::vector<std::byte>& data);
 
@@ -170,13 +315,40 @@ namespace DetourNavigator
 
         int insertShape(ShapeId shapeId, std::string_view name, ShapeType type, const Sqlite3::ConstBlob& hash);
 
+        std::vector<ContentFileHash> getContentFiles();
+
+        void setContentFiles(const std::vector<ContentFileHash>& contentFiles);
+
+        std::optional<std::vector<std::byte>> getTileSourcesSettings();
+
+        int setTileSourcesSettings(const std::vector<std::byte>& value);
+
+        std::vector<CellLocation> findCellsBySource(CellSourceType type, std::string_view name);
+
+        std::vector<TilePosition> findTilesByCell(std::string_view worldspace, std::string_view cell);
+
+        std::vector<std::string> getTileCells(std::string_view worldspace, const TilePosition& tilePosition);
+
+        int insertTileCell(std::string_view worldspace, const TilePosition& tilePosition, std::string_view cell);
+
+        int insertCellSource(std::string_view worldspace, std::string_view cell, CellSourceType type,
+            std::string_view name);
+
+        int deleteTileCellsAt(std::string_view worldspace, const TilePosition& tilePosition);
+
+        int deleteCellSources(std::string_view worldspace, std::string_view cell);
+
+        void deleteAllTileSources();
+
         void vacuum();
 
     private:
+        bool mVerifyInput;
         Sqlite3::Db mDb;
         Sqlite3::Statement<DbQueries::GetMaxTileId> mGetMaxTileId;
         Sqlite3::Statement<DbQueries::FindTile> mFindTile;
         Sqlite3::Statement<DbQueries::GetTileData> mGetTileData;
+        Sqlite3::Statement<DbQueries::GetTileInput> mGetTileInput;
         Sqlite3::Statement<DbQueries::InsertTile> mInsertTile;
         Sqlite3::Statement<DbQueries::UpdateTile> mUpdateTile;
         Sqlite3::Statement<DbQueries::DeleteTilesAt> mDeleteTilesAt;
@@ -185,7 +357,23 @@ namespace DetourNavigator
         Sqlite3::Statement<DbQueries::GetMaxShapeId> mGetMaxShapeId;
         Sqlite3::Statement<DbQueries::FindShapeId> mFindShapeId;
         Sqlite3::Statement<DbQueries::InsertShape> mInsertShape;
+        Sqlite3::Statement<DbQueries::GetContentFiles> mGetContentFiles;
+        Sqlite3::Statement<DbQueries::DeleteContentFiles> mDeleteContentFiles;
+        Sqlite3::Statement<DbQueries::InsertContentFile> mInsertContentFile;
+        Sqlite3::Statement<DbQueries::GetTileSourcesSettings> mGetTileSourcesSettings;
+        Sqlite3::Statement<DbQueries::SetTileSourcesSettings> mSetTileSourcesSettings;
+        Sqlite3::Statement<DbQueries::FindCellsBySource> mFindCellsBySource;
+        Sqlite3::Statement<DbQueries::FindTilesByCell> mFindTilesByCell;
+        Sqlite3::Statement<DbQueries::GetTileCells> mGetTileCells;
+        Sqlite3::Statement<DbQueries::InsertTileCell> mInsertTileCell;
+        Sqlite3::Statement<DbQueries::InsertCellSource> mInsertCellSource;
+        Sqlite3::Statement<DbQueries::DeleteTileCellsAt> mDeleteTileCellsAt;
+        Sqlite3::Statement<DbQueries::DeleteCellSources> mDeleteCellSources;
+        Sqlite3::Statement<DbQueries::DeleteAllTileCells> mDeleteAllTileCells;
+        Sqlite3::Statement<DbQueries::DeleteAllCellSources> mDeleteAllCellSources;
         Sqlite3::Statement<DbQueries::Vacuum> mVacuum;
+
+        bool matchesInput(TileId tileId, const std::vector<std::byte>& input);
     };
 }
 
@@ -1,31 +1,61 @@
 #include "navmeshtilescache.hpp"
 
+#include <components/misc/hash.hpp>
+
 #include <osg/Stats>
 
+#include <algorithm>
 #include <cstring>
 
 namespace DetourNavigator
 {
-    NavMeshTilesCache::NavMeshTilesCache(const std::size_t maxNavMeshDataSize)
-        : mMaxNavMeshDataSize(maxNavMeshDataSize), mUsedNavMeshDataSize(0), mFreeNavMeshDataSize(0),
-          mHitCount(0), mGetCount(0) {}
+    namespace
+    {
+        std::size_t getHash(const AgentBounds& agentBounds, const TilePosition& changedTile,
+            const RecastMesh& recastMesh)
+        {
+            std::size_t result = recastMesh.getHash();
+            Misc::hashCombine(result, agentBounds.mShapeType);
+            Misc::hashCombine(result, agentBounds.mHalfExtents.x());
+            Misc::hashCombine(result, agentBounds.mHalfExtents.y());
+            Misc::hashCombine(result, agentBounds.mHalfExtents.z());
+            Misc::hashCombine(result, changedTile.x());
+            Misc::hashCombine(result, changedTile.y());
+            return result;
+        }
+
+        std::size_t getSize(const std::vector<OffMeshConnection>& value)
+        {
+            return value.size() * sizeof(OffMeshConnection);
+        }
+    }
+
+    NavMeshTilesCache::NavMeshTilesCache(std::size_t maxNavMeshDataSize, std::size_t shardsCount)
+        : mShards(std::max(shardsCount, std::size_t {1}))
+    {
+        for (Shard& shard : mShards)
+            shard.mMaxSize = maxNavMeshDataSize / mShards.size();
+    }
 
     NavMeshTilesCache::Value NavMeshTilesCache::get(const AgentBounds& agentBounds, const TilePosition& changedTile,
         const RecastMesh& recastMesh)
     {
-        const std::lock_guard<std::mutex> lock(mMutex);
+        const std::size_t hash = getHash(agentBounds, changedTile, recastMesh);
+        Shard& shard = mShards[hash % mShards.size()];
+
+        const std::lock_guard<std::mutex> lock(shard.mMutex);
 
-        ++mGetCount;
+        ++shard.mGetCount;
 
-        const auto tile = mValues.find(std::tie(agentBounds, changedTile, recastMesh));
-        if (tile == mValues.end())
+        Item* const item = findItem(shard, hash, agentBounds, changedTile, recastMesh);
+        if (item == nullptr)
             return Value();
 
-        acquireItemUnsafe(tile->second);
+        acquireItemUnsafe(shard, *item);
 
-        ++mHitCount;
+        ++shard.mHitCount;
 
-        return Value(*this, tile->second);
+        return Value(*this, *item);
     }
 
     NavMeshTilesCache::Value NavMeshTilesCache::set(const AgentBounds& agentBounds, const TilePosition& changedTile,
@@ -34,47 +64,63 @@ namespace DetourNavigator
         const auto itemSize = sizeof(RecastMesh) + getSize(recastMesh)
             + (value == nullptr ? 0 : sizeof(PreparedNavMeshData) + getSize(*value));
 
-        const std::lock_guard<std::mutex> lock(mMutex);
+        const std::size_t hash = getHash(agentBounds, changedTile, recastMesh);
+        const std::size_t shardIndex = hash % mShards.size();
+        Shard& shard = mShards[shardIndex];
 
-        if (itemSize > mFreeNavMeshDataSize + (mMaxNavMeshDataSize - mUsedNavMeshDataSize))
+        const std::lock_guard<std::mutex> lock(shard.mMutex);
+
+        if (itemSize > shard.mFreeSize + (shard.mMaxSize - shard.mUsedSize))
             return Value();
 
-        while (!mFreeItems.empty() && mUsedNavMeshDataSize + itemSize > mMaxNavMeshDataSize)
-            removeLeastRecentlyUsed();
+        if (Item* const item = findItem(shard, hash, agentBounds, changedTile, recastMesh))
+        {
+            acquireItemUnsafe(shard, *item);
+            ++shard.mGetCount;
+            ++shard.mHitCount;
+            return Value(*this, *item);
+        }
+
+        while (shard.mLeastRecentlyUsed != nullptr && shard.mUsedSize + itemSize > shard.mMaxSize)
+            removeLeastRecentlyUsed(shard);
 
         RecastMeshData key {recastMesh.getMesh(), recastMesh.getWater(),
                     recastMesh.getHeightfields(), recastMesh.getFlatHeightfields()};
 
-        const auto iterator = mFreeItems.emplace(mFreeItems.end(), agentBounds, changedTile, std::move(key), itemSize);
-        const auto emplaced = mValues.emplace(std::make_tuple(agentBounds, changedTile, std::cref(iterator->mRecastMeshData)), iterator);
-
-        if (!emplaced.second)
+        Item* item = nullptr;
+        if (shard.mRemovedItems.empty())
+        {
+            item = &shard.mItems.emplace_back(shardIndex, hash, agentBounds, changedTile, std::move(key), itemSize);
+        }
+        else
         {
-            mFreeItems.erase(iterator);
-            acquireItemUnsafe(emplaced.first->second);
-            ++mGetCount;
-            ++mHitCount;
-            return Value(*this, emplaced.first->second);
+            item = shard.mRemovedItems.back();
+            shard.mRemovedItems.pop_back();
+            *item = Item(shardIndex, hash, agentBounds, changedTile, std::move(key), itemSize);
         }
 
-        iterator->mPreparedNavMeshData = std::move(value);
-        ++iterator->mUseCount;
-        mUsedNavMeshDataSize += itemSize;
-        mBusyItems.splice(mBusyItems.end(), mFreeItems, iterator);
+        shard.mValues.emplace(hash, item);
+
+        item->mPreparedNavMeshData = std::move(value);
+        item->mUseCount = 1;
+        shard.mUsedSize += itemSize;
+        ++shard.mBusyItems;
 
-        return Value(*this, iterator);
+        return Value(*this, *item);
     }
 
     NavMeshTilesCache::Stats NavMeshTilesCache::getStats() const
     {
-        Stats result;
+        Stats result {};
+        for (const Shard& shard : mShards)
         {
-            const std::lock_guard<std::mutex> lock(mMutex);
-            result.mNavMeshCacheSize = mUsedNavMeshDataSize;
-            result.mUsedNavMeshTiles = mBusyItems.size();
-            result.mCachedNavMeshTiles = mFreeItems.size();
-            result.mHitCount = mHitCount;
-            result.mGetCount = mGetCount;
+            const std::lock_guard<std::mutex> lock(shard.mMutex);
+            result.mNavMeshCacheSize += shard.mUsedSize;
+            result.mUsedNavMeshTiles += shard.mBusyItems;
+            result.mCachedNavMeshTiles += shard.mFreeItems;
+            result.mHitCount += shard.mHitCount;
+            result.mGetCount += shard.mGetCount;
+            result.mReusedNavMeshData += shard.mReusedNavMeshData;
         }
         return result;
     }
@@ -84,42 +130,141 @@ namespace DetourNavigator
         out.setAttribute(frameNumber, "NavMesh CacheSize", static_cast<double>(stats.mNavMeshCacheSize));
         out.setAttribute(frameNumber, "NavMesh UsedTiles", static_cast<double>(stats.mUsedNavMeshTiles));
         out.setAttribute(frameNumber, "NavMesh CachedTiles", static_cast<double>(stats.mCachedNavMeshTiles));
+        out.setAttribute(frameNumber, "NavMesh ReusedTiles", static_cast<double>(stats.mReusedNavMeshData));
         if (stats.mGetCount > 0)
             out.setAttribute(frameNumber, "NavMesh CacheHitRate", static_cast<double>(stats.mHitCount) / stats.mGetCount * 100.0);
     }
 
-    void NavMeshTilesCache::removeLeastRecentlyUsed()
+    NavMeshTilesCache::Item* NavMeshTilesCache::findItem(Shard& shard, std::size_t hash,
+        const AgentBounds& agentBounds, const TilePosition& changedTile, const RecastMesh& recastMesh) const
+    {
+        const auto [begin, end] = shard.mValues.equal_range(hash);
+        const auto it = std::find_if(begin, end, [&] (const auto& v)
+        {
+            const Item& item = *v.second;
+            return item.mAgentBounds == agentBounds && item.mChangedTile == changedTile
+                && item.mRecastMeshData == recastMesh;
+        });
+        return it == end ? nullptr : it->second;
+    }
+
+    void NavMeshTilesCache::removeLeastRecentlyUsed(Shard& shard)
     {
-        const auto& item = mFreeItems.back();
+        Item& item = *shard.mLeastRecentlyUsed;
 
-        const auto value = mValues.find(std::tie(item.mAgentBounds, item.mChangedTile, item.mRecastMeshData));
-        if (value == mValues.end())
+        const auto [begin, end] = shard.mValues.equal_range(item.mHash);
+        const auto value = std::find_if(begin, end, [&] (const auto& v) { return v.second == &item; });
+        if (value == end)
             return;
 
-        mUsedNavMeshDataSize -= item.mSize;
-        mFreeNavMeshDataSize -= item.mSize;
+        shard.mUsedSize -= item.mSize + item.mNavMeshDataSize;
+        shard.mFreeSize -= item.mSize + item.mNavMeshDataSize;
+        --shard.mFreeItems;
 
-        mValues.erase(value);
-        mFreeItems.pop_back();
+        shard.mValues.erase(value);
+
+        shard.mLeastRecentlyUsed = item.mPrev;
+        if (item.mPrev != nullptr)
+            item.mPrev->mNext = nullptr;
+        else
+            shard.mMostRecentlyUsed = nullptr;
+
+        // Release memory now instead of waiting for the storage to be reused
+        item.mRecastMeshData = RecastMeshData {Mesh({}, {}, {}), {}, {}, {}};
+        item.mPreparedNavMeshData.reset();
+        item.mNavMeshData = NavMeshData();
+        item.mOffMeshConnections.clear();
+        item.mPrev = nullptr;
+        shard.mRemovedItems.push_back(&item);
+    }
+
+    void NavMeshTilesCache::acquireItemUnsafe(Shard& shard, Item& item)
+    {
+        if (++item.mUseCount > 1)
+            return;
+
+        if (item.mPrev != nullptr)
+            item.mPrev->mNext = item.mNext;
+        else
+            shard.mMostRecentlyUsed = item.mNext;
+        if (item.mNext != nullptr)
+            item.mNext->mPrev = item.mPrev;
+        else
+            shard.mLeastRecentlyUsed = item.mPrev;
+        item.mPrev = nullptr;
+        item.mNext = nullptr;
+
+        shard.mFreeSize -= item.mSize + item.mNavMeshDataSize;
+        --shard.mFreeItems;
+        ++shard.mBusyItems;
     }
 
-    void NavMeshTilesCache::acquireItemUnsafe(ItemIterator iterator)
+    void NavMeshTilesCache::releaseItem(Item& item)
     {
-        if (++iterator->mUseCount > 1)
+        Shard& shard = mShards[item.mShard];
+
+        // Use count is changed only under the lock so a concurrent get can't see a released but not yet free item
+        const std::lock_guard<std::mutex> lock(shard.mMutex);
+
+        if (--item.mUseCount > 0)
             return;
 
-        mBusyItems.splice(mBusyItems.end(), mFreeItems, iterator);
-        mFreeNavMeshDataSize -= iterator->mSize;
+        item.mNext = shard.mMostRecentlyUsed;
+        if (shard.mMostRecentlyUsed != nullptr)
+            shard.mMostRecentlyUsed->mPrev = &item;
+        else
+            shard.mLeastRecentlyUsed = &item;
+        shard.mMostRecentlyUsed = &item;
+
+        shard.mFreeSize += item.mSize + item.mNavMeshDataSize;
+        ++shard.mFreeItems;
+        --shard.mBusyItems;
+    }
+
+    NavMeshData NavMeshTilesCache::takeNavMeshData(Item& item, const std::vector<OffMeshConnection>& offMeshConnections)
+    {
+        Shard& shard = mShards[item.mShard];
+
+        const std::lock_guard<std::mutex> lock(shard.mMutex);
+
+        if (item.mNavMeshData.mValue == nullptr || item.mOffMeshConnections != offMeshConnections)
+            return NavMeshData();
+
+        shard.mUsedSize -= item.mNavMeshDataSize;
+        item.mNavMeshDataSize = 0;
+        item.mOffMeshConnections.clear();
+        ++shard.mReusedNavMeshData;
+
+        return std::move(item.mNavMeshData);
     }
 
-    void NavMeshTilesCache::releaseItem(ItemIterator iterator)
+    void NavMeshTilesCache::putNavMeshData(Item& item, NavMeshData&& value,
+        std::vector<OffMeshConnection>&& offMeshConnections)
     {
-        if (--iterator->mUseCount > 0)
+        if (value.mValue == nullptr)
+            return;
+
+        const std::size_t size = static_cast<std::size_t>(value.mSize) + getSize(offMeshConnections);
+
+        Shard& shard = mShards[item.mShard];
+
+        const std::lock_guard<std::mutex> lock(shard.mMutex);
+
+        // Replace previous tile, the new one is more likely to match current off mesh connections
+        shard.mUsedSize -= item.mNavMeshDataSize;
+        item.mNavMeshData = NavMeshData();
+        item.mOffMeshConnections.clear();
+        item.mNavMeshDataSize = 0;
+
+        if (size > shard.mFreeSize + (shard.mMaxSize - shard.mUsedSize))
             return;
 
-        const std::lock_guard<std::mutex> lock(mMutex);
+        while (shard.mLeastRecentlyUsed != nullptr && shard.mUsedSize + size > shard.mMaxSize)
+            removeLeastRecentlyUsed(shard);
 
-        mFreeItems.splice(mFreeItems.begin(), mBusyItems, iterator);
-        mFreeNavMeshDataSize += iterator->mSize;
+        item.mNavMeshData = std::move(value);
+        item.mOffMeshConnections = std::move(offMeshConnections);
+        item.mNavMeshDataSize = size;
+        shard.mUsedSize += size;
     }
 }
@@ -5,13 +5,14 @@
 #include "recastmesh.hpp"
 #include "tileposition.hpp"
 #include "agentbounds.hpp"
+#include "navmeshdata.hpp"
+#include "offmeshconnection.hpp"
 
-#include <atomic>
-#include <map>
-#include <list>
+#include <deque>
 #include <mutex>
 #include <cassert>
 #include <cstring>
+#include <unordered_map>
 #include <vector>
 
 namespace osg
@@ -29,39 +30,43 @@ namespace DetourNavigator
         std::vector<FlatHeightfield> mFlatHeightfields;
     };
 
-    inline bool operator <(const RecastMeshData& lhs, const RecastMeshData& rhs)
+    inline bool operator ==(const RecastMeshData& lhs, const RecastMesh& rhs)
     {
         return std::tie(lhs.mMesh, lhs.mWater, lhs.mHeightfields, lhs.mFlatHeightfields)
-                < std::tie(rhs.mMesh, rhs.mWater, rhs.mHeightfields, rhs.mFlatHeightfields);
-    }
-
-    inline bool operator <(const RecastMeshData& lhs, const RecastMesh& rhs)
-    {
-        return std::tie(lhs.mMesh, lhs.mWater, lhs.mHeightfields, lhs.mFlatHeightfields)
-                < std::tie(rhs.getMesh(), rhs.getWater(), rhs.getHeightfields(), rhs.getFlatHeightfields());
-    }
-
-    inline bool operator <(const RecastMesh& lhs, const RecastMeshData& rhs)
-    {
-        return std::tie(lhs.getMesh(), lhs.getWater(), lhs.getHeightfields(), lhs.getFlatHeightfields())
-                < std::tie(rhs.mMesh, rhs.mWater, rhs.mHeightfields, rhs.mFlatHeightfields);
+                == std::tie(rhs.getMesh(), rhs.getWater(), rhs.getHeightfields(), rhs.getFlatHeightfields());
     }
 
+    /**
+     * @brief NavMeshTilesCache keeps prepared navmesh data for recast meshes and detour tiles built from it.
+     * Items are split into shards by the hash of agent bounds, tile position and recast mesh content. Each shard
+     * has own lock, LRU list of unused items and an equal part of the max size. Storage of removed items is reused
+     * by new ones.
+     */
     class NavMeshTilesCache
     {
     public:
         struct Item
         {
-            std::atomic<std::int64_t> mUseCount;
+            std::size_t mShard;
+            std::size_t mHash;
+            std::size_t mUseCount = 0;
             AgentBounds mAgentBounds;
             TilePosition mChangedTile;
             RecastMeshData mRecastMeshData;
             std::unique_ptr<PreparedNavMeshData> mPreparedNavMeshData;
             std::size_t mSize;
-
-            Item(const AgentBounds& agentBounds, const TilePosition& changedTile,
+            // Detour tile built from mPreparedNavMeshData with mOffMeshConnections and not used by any navmesh
+            NavMeshData mNavMeshData;
+            std::vector<OffMeshConnection> mOffMeshConnections;
+            std::size_t mNavMeshDataSize = 0;
+            // Links of unused items list ordered from the most to the least recently used
+            Item* mPrev = nullptr;
+            Item* mNext = nullptr;
+
+            Item(std::size_t shard, std::size_t hash, const AgentBounds& agentBounds, const TilePosition& changedTile,
                  RecastMeshData&& recastMeshData, std::size_t size)
-                : mUseCount(0)
+                : mShard(shard)
+                , mHash(hash)
                 , mAgentBounds(agentBounds)
                 , mChangedTile(changedTile)
                 , mRecastMeshData(std::move(recastMeshData))
@@ -69,23 +74,21 @@ namespace DetourNavigator
             {}
         };
 
-        using ItemIterator = std::list<Item>::iterator;
-
         class Value
         {
         public:
             Value()
-                : mOwner(nullptr), mIterator() {}
+                : mOwner(nullptr), mItem(nullptr) {}
 
-            Value(NavMeshTilesCache& owner, ItemIterator iterator)
-                : mOwner(&owner), mIterator(iterator)
+            Value(NavMeshTilesCache& owner, Item& item)
+                : mOwner(&owner), mItem(&item)
             {
             }
 
             Value(const Value& other) = delete;
 
             Value(Value&& other)
-                : mOwner(other.mOwner), mIterator(other.mIterator)
+                : mOwner(other.mOwner), mItem(other.mItem)
             {
                 other.mOwner = nullptr;
             }
@@ -93,7 +96,7 @@ namespace DetourNavigator
             ~Value()
             {
                 if (mOwner)
-                    mOwner->releaseItem(mIterator);
+                    mOwner->releaseItem(*mItem);
             }
 
             Value& operator =(const Value& other) = delete;
@@ -101,10 +104,10 @@ namespace DetourNavigator
             Value& operator =(Value&& other)
             {
                 if (mOwner)
-                    mOwner->releaseItem(mIterator);
+                    mOwner->releaseItem(*mItem);
 
                 mOwner = other.mOwner;
-                mIterator = other.mIterator;
+                mItem = other.mItem;
 
                 other.mOwner = nullptr;
 
@@ -113,7 +116,26 @@ namespace DetourNavigator
 
             const PreparedNavMeshData& get() const
             {
-                return *mIterator->mPreparedNavMeshData;
+                return *mItem->mPreparedNavMeshData;
+            }
+
+            /**
+             * @brief takeNavMeshData gives away detour tile stored by putNavMeshData to be added to a navmesh
+             * without building it again.
+             * @return empty data when there is no stored tile or it was built with other off mesh connections.
+             */
+            NavMeshData takeNavMeshData(const std::vector<OffMeshConnection>& offMeshConnections)
+            {
+                return mOwner->takeNavMeshData(*mItem, offMeshConnections);
+            }
+
+            /**
+             * @brief putNavMeshData stores detour tile built from this value when it is removed from a navmesh.
+             * Tile is dropped when it does not fit the cache.
+             */
+            void putNavMeshData(NavMeshData&& value, std::vector<OffMeshConnection>&& offMeshConnections)
+            {
+                mOwner->putNavMeshData(*mItem, std::move(value), std::move(offMeshConnections));
             }
 
             operator bool() const
@@ -123,7 +145,7 @@ namespace DetourNavigator
 
         private:
             NavMeshTilesCache* mOwner;
-            ItemIterator mIterator;
+            Item* mItem;
         };
 
         struct Stats
@@ -133,9 +155,14 @@ namespace DetourNavigator
             std::size_t mCachedNavMeshTiles;
             std::size_t mHitCount;
             std::size_t mGetCount;
+            std::size_t mReusedNavMeshData;
         };
 
-        NavMeshTilesCache(const std::size_t maxNavMeshDataSize);
+        /**
+         * @param maxNavMeshDataSize total size limit split equally between shards.
+         * @param shardsCount number of independently locked parts, more shards reduce contention between threads.
+         */
+        explicit NavMeshTilesCache(std::size_t maxNavMeshDataSize, std::size_t shardsCount = 1);
 
         Value get(const AgentBounds& agentBounds, const TilePosition& changedTile,
             const RecastMesh& recastMesh);
@@ -146,21 +173,38 @@ namespace DetourNavigator
         Stats getStats() const;
 
     private:
-        mutable std::mutex mMutex;
-        std::size_t mMaxNavMeshDataSize;
-        std::size_t mUsedNavMeshDataSize;
-        std::size_t mFreeNavMeshDataSize;
-        std::size_t mHitCount;
-        std::size_t mGetCount;
-        std::list<Item> mBusyItems;
-        std::list<Item> mFreeItems;
-        std::map<std::tuple<AgentBounds, TilePosition, std::reference_wrapper<const RecastMeshData>>, ItemIterator, std::less<>> mValues;
+        struct Shard
+        {
+            mutable std::mutex mMutex;
+            std::size_t mMaxSize = 0;
+            std::size_t mUsedSize = 0;
+            std::size_t mFreeSize = 0;
+            std::size_t mHitCount = 0;
+            std::size_t mGetCount = 0;
+            std::size_t mReusedNavMeshData = 0;
+            std::size_t mBusyItems = 0;
+            std::size_t mFreeItems = 0;
+            Item* mMostRecentlyUsed = nullptr;
+            Item* mLeastRecentlyUsed = nullptr;
+            std::deque<Item> mItems;
+            std::vector<Item*> mRemovedItems;
+            std::unordered_multimap<std::size_t, Item*> mValues;
+        };
+
+        std::vector<Shard> mShards;
+
+        Item* findItem(Shard& shard, std::size_t hash, const AgentBounds& agentBounds,
+            const TilePosition& changedTile, const RecastMesh& recastMesh) const;
+
+        void removeLeastRecentlyUsed(Shard& shard);
+
+        void acquireItemUnsafe(Shard& shard, Item& item);
 
-        void removeLeastRecentlyUsed();
+        void releaseItem(Item& item);
 
-        void acquireItemUnsafe(ItemIterator iterator);
+        NavMeshData takeNavMeshData(Item& item, const std::vector<OffMeshConnection>& offMeshConnections);
 
-        void releaseItem(ItemIterator iterator);
+        void putNavMeshData(Item& item, NavMeshData&& value, std::vector<OffMeshConnection>&& offMeshConnections);
     };
 
     void reportStats(const NavMeshTilesCache::Stats& stats, unsigned int frameNumber, osg::Stats& out);
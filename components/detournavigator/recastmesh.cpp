@@ -1,10 +1,68 @@
 #include "recastmesh.hpp"
 #include "exceptions.hpp"
 
+#include <components/misc/hash.hpp>
+
 #include <Recast.h>
 
+#include <string_view>
+
 namespace DetourNavigator
 {
+    namespace
+    {
+        // Bytes of -0.0f and 0.0f are different so equal values may have different hashes, that only gives a miss
+        template <class T>
+        void hashCombineBytes(std::size_t& seed, const std::vector<T>& values)
+        {
+            Misc::hashCombine(seed, std::string_view(reinterpret_cast<const char*>(values.data()),
+                                                     values.size() * sizeof(T)));
+        }
+
+        void hashCombine(std::size_t& seed, const osg::Vec2i& value)
+        {
+            Misc::hashCombine(seed, value.x());
+            Misc::hashCombine(seed, value.y());
+        }
+
+        std::size_t makeHash(const Mesh& mesh, const std::vector<CellWater>& water,
+            const std::vector<Heightfield>& heightfields, const std::vector<FlatHeightfield>& flatHeightfields)
+        {
+            std::size_t result = 0;
+            hashCombineBytes(result, mesh.getIndices());
+            hashCombineBytes(result, mesh.getVertices());
+            hashCombineBytes(result, mesh.getAreaTypes());
+            Misc::hashCombine(result, water.size());
+            for (const CellWater& v : water)
+            {
+                hashCombine(result, v.mCellPosition);
+                Misc::hashCombine(result, v.mWater.mCellSize);
+                Misc::hashCombine(result, v.mWater.mLevel);
+            }
+            Misc::hashCombine(result, heightfields.size());
+            for (const Heightfield& v : heightfields)
+            {
+                hashCombine(result, v.mCellPosition);
+                Misc::hashCombine(result, v.mCellSize);
+                Misc::hashCombine(result, v.mLength);
+                Misc::hashCombine(result, v.mMinHeight);
+                Misc::hashCombine(result, v.mMaxHeight);
+                hashCombineBytes(result, v.mHeights);
+                Misc::hashCombine(result, v.mOriginalSize);
+                Misc::hashCombine(result, v.mMinX);
+                Misc::hashCombine(result, v.mMinY);
+            }
+            Misc::hashCombine(result, flatHeightfields.size());
+            for (const FlatHeightfield& v : flatHeightfields)
+            {
+                hashCombine(result, v.mCellPosition);
+                Misc::hashCombine(result, v.mCellSize);
+                Misc::hashCombine(result, v.mHeight);
+            }
+            return result;
+        }
+    }
+
     Mesh::Mesh(std::vector<int>&& indices, std::vector<float>&& vertices, std::vector<AreaType>&& areaTypes)
     {
         if (indices.size() / 3 != areaTypes.size())
@@ -33,5 +91,6 @@ namespace DetourNavigator
         mHeightfields.shrink_to_fit();
         for (Heightfield& v : mHeightfields)
             v.mHeights.shrink_to_fit();
+        mHash = makeHash(mMesh, mWater, mHeightfields, mFlatHeightfields);
     }
 }
@@ -42,6 +42,12 @@ namespace DetourNavigator
                     < std::tie(rhs.mIndices, rhs.mVertices, rhs.mAreaTypes);
         }
 
+        friend inline bool operator==(const Mesh& lhs, const Mesh& rhs) noexcept
+        {
+            return std::tie(lhs.mIndices, lhs.mVertices, lhs.mAreaTypes)
+                    == std::tie(rhs.mIndices, rhs.mVertices, rhs.mAreaTypes);
+        }
+
         friend inline std::size_t getSize(const Mesh& value) noexcept
         {
             return value.mIndices.size() * sizeof(int)
@@ -62,6 +68,11 @@ namespace DetourNavigator
         return tie(lhs) < tie(rhs);
     }
 
+    inline bool operator==(const Water& lhs, const Water& rhs) noexcept
+    {
+        return lhs.mCellSize == rhs.mCellSize && lhs.mLevel == rhs.mLevel;
+    }
+
     struct CellWater
     {
         osg::Vec2i mCellPosition;
@@ -74,6 +85,11 @@ namespace DetourNavigator
         return tie(lhs) < tie(rhs);
     }
 
+    inline bool operator==(const CellWater& lhs, const CellWater& rhs) noexcept
+    {
+        return lhs.mCellPosition == rhs.mCellPosition && lhs.mWater == rhs.mWater;
+    }
+
     inline osg::Vec2f getWaterShift2d(const osg::Vec2i& cellPosition, int cellSize)
     {
         return osg::Vec2f((cellPosition.x() + 0.5f) * cellSize, (cellPosition.y() + 0.5f) * cellSize);
@@ -108,6 +124,11 @@ namespace DetourNavigator
         return makeTuple(lhs) < makeTuple(rhs);
     }
 
+    inline bool operator==(const Heightfield& lhs, const Heightfield& rhs) noexcept
+    {
+        return makeTuple(lhs) == makeTuple(rhs);
+    }
+
     struct FlatHeightfield
     {
         osg::Vec2i mCellPosition;
@@ -121,6 +142,12 @@ namespace DetourNavigator
         return tie(lhs) < tie(rhs);
     }
 
+    inline bool operator==(const FlatHeightfield& lhs, const FlatHeightfield& rhs) noexcept
+    {
+        return lhs.mCellPosition == rhs.mCellPosition && lhs.mCellSize == rhs.mCellSize
+            && lhs.mHeight == rhs.mHeight;
+    }
+
     struct MeshSource
     {
         osg::ref_ptr<const Resource::BulletShape> mShape;
@@ -164,6 +191,9 @@ namespace DetourNavigator
 
         const std::vector<MeshSource>& getMeshSources() const noexcept { return mMeshSources; }
 
+        // Hash of mesh, water and heightfields, generation, revision and sources are not included
+        std::size_t getHash() const noexcept { return mHash; }
+
     private:
         std::size_t mGeneration;
         std::size_t mRevision;
@@ -172,6 +202,7 @@ namespace DetourNavigator
         std::vector<Heightfield> mHeightfields;
         std::vector<FlatHeightfield> mFlatHeightfields;
         std::vector<MeshSource> mMeshSources;
+        std::size_t mHash;
 
         friend inline std::size_t getSize(const RecastMesh& value) noexcept
         {
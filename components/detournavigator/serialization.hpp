@@ -22,6 +22,8 @@ namespace DetourNavigator
     std::vector<std::byte> serialize(const RecastSettings& settings, const AgentBounds& agentBounds,
         const RecastMesh& recastMesh, const std::vector<DbRefGeometryObject>& dbRefGeometryObjects);
 
+    std::vector<std::byte> serialize(const RecastSettings& settings, const AgentBounds& agentBounds);
+
     std::vector<std::byte> serialize(const PreparedNavMeshData& value);
 
     bool deserialize(const std::vector<std::byte>& data, PreparedNavMeshData& value);
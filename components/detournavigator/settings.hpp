@@ -41,12 +41,15 @@ namespace DetourNavigator
         bool mEnableNavMeshFileNameRevision = false;
         bool mEnableNavMeshDiskCache = false;
         bool mWriteToNavMeshDb = false;
+        bool mVerifyNavMeshDbInput = false;
         RecastSettings mRecast;
         DetourSettings mDetour;
         int mWaitUntilMinDistanceToPlayer = 0;
         int mMaxTilesNumber = 0;
         std::size_t mAsyncNavMeshUpdaterThreads = 0;
         std::size_t mMaxNavMeshTilesCacheSize = 0;
+        std::size_t mAsyncPathFinderThreads = 0;
+        std::size_t mMaxPathCacheSize = 0;
         std::string mRecastMeshPathPrefix;
         std::string mNavMeshPathPrefix;
         std::chrono::milliseconds mMinUpdateInterval;
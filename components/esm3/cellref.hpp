@@ -1,6 +1,8 @@
 #ifndef OPENMW_ESM_CELLREF_H
 #define OPENMW_ESM_CELLREF_H
 
+#include <cstdint>
+#include <functional>
 #include <limits>
 #include <string>
 
@@ -134,4 +136,17 @@ namespace ESM
 
 }
 
+namespace std
+{
+    template <>
+    struct hash<ESM::RefNum>
+    {
+        std::size_t operator ()(const ESM::RefNum& value) const noexcept
+        {
+            return hash<std::uint64_t>()(static_cast<std::uint64_t>(value.mIndex)
+                | static_cast<std::uint64_t>(static_cast<std::uint32_t>(value.mContentFile)) << 32);
+        }
+    };
+}
+
 #endif
@@ -46,6 +46,9 @@ class ESMWriter
         // It is a good idea to compare this with the value you wrote into the header (setRecordCount)
         // It should be the record count you set + 1 (1 additional record for the TES3 header)
         int getRecordCount() { return mRecordCount; }
+
+        // Position in the output stream, the difference of two positions is the size of what's written in between
+        std::streampos getPosition() const { return mStream->tellp(); }
         void setFormat (int format);
 
         void clearMaster();
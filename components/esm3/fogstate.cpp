@@ -8,6 +8,11 @@
 #include <components/debug/debuglog.hpp>
 #include <components/files/memorystream.hpp>
 
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
 #include "savedgame.hpp"
 
 namespace ESM
@@ -73,7 +78,7 @@ void FogState::load (ESMReader &esm)
 
         size_t imageSize = esm.getSubSize()-sizeof(int)*2;
         tex.mImageData.resize(imageSize);
-        esm.getExact(&tex.mImageData[0], imageSize);
+        esm.getExact(tex.mImageData.data(), imageSize);
 
         if (dataFormat < 7)
             convertFogOfWar(tex.mImageData);
@@ -94,9 +99,86 @@ void FogState::save (ESMWriter &esm, bool interiorCell) const
         esm.startSubRecord("FTEX");
         esm.writeT(it->mX);
         esm.writeT(it->mY);
-        esm.write(&it->mImageData[0], it->mImageData.size());
+        esm.write(it->mImageData.data(), it->mImageData.size());
         esm.endRecord("FTEX");
     }
 }
 
+bool isPngFogTexture(const std::vector<char>& imageData)
+{
+    constexpr char signature[] = {'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n'};
+    return imageData.size() >= sizeof(signature) && std::memcmp(imageData.data(), signature, sizeof(signature)) == 0;
+}
+
+// The first byte is the texture side length, it can't be equal to the first byte of the PNG signature.
+// Then a control byte n is followed by n + 1 literal values for n < 128 or by a single value repeated n - 126 times.
+std::vector<char> compressFogTexture(const std::vector<unsigned char>& alpha)
+{
+    const std::size_t side = static_cast<std::size_t>(std::lround(std::sqrt(static_cast<double>(alpha.size()))));
+    if (side * side != alpha.size() || side == 0 || side > 127)
+        throw std::invalid_argument("Invalid fog texture size: " + std::to_string(alpha.size()));
+
+    std::vector<char> result;
+    result.reserve(1 + alpha.size() + alpha.size() / 128 + 1);
+    result.push_back(static_cast<char>(side));
+
+    std::size_t i = 0;
+    while (i < alpha.size())
+    {
+        std::size_t run = 1;
+        while (i + run < alpha.size() && run < 129 && alpha[i + run] == alpha[i])
+            ++run;
+        if (run >= 2)
+        {
+            result.push_back(static_cast<char>(run + 126));
+            result.push_back(static_cast<char>(alpha[i]));
+            i += run;
+            continue;
+        }
+        // Literals continue until a run of 3 equal values, shorter runs don't take less space
+        std::size_t end = i + 1;
+        while (end < alpha.size() && end - i < 128
+            && !(end + 2 < alpha.size() && alpha[end] == alpha[end + 1] && alpha[end] == alpha[end + 2]))
+            ++end;
+        result.push_back(static_cast<char>(end - i - 1));
+        result.insert(result.end(), alpha.begin() + i, alpha.begin() + end);
+        i = end;
+    }
+
+    return result;
+}
+
+std::vector<unsigned char> decompressFogTexture(const std::vector<char>& imageData)
+{
+    if (imageData.empty())
+        return {};
+    const std::size_t side = static_cast<unsigned char>(imageData.front());
+    const std::size_t size = side * side;
+    std::vector<unsigned char> result;
+    result.reserve(size);
+    std::size_t i = 1;
+    while (i < imageData.size())
+    {
+        const std::size_t control = static_cast<unsigned char>(imageData[i++]);
+        if (control < 128)
+        {
+            const std::size_t count = control + 1;
+            if (i + count > imageData.size() || result.size() + count > size)
+                return {};
+            result.insert(result.end(), imageData.begin() + i, imageData.begin() + i + count);
+            i += count;
+        }
+        else
+        {
+            const std::size_t count = control - 126;
+            if (i >= imageData.size() || result.size() + count > size)
+                return {};
+            result.insert(result.end(), count, static_cast<unsigned char>(imageData[i++]));
+        }
+    }
+    if (result.size() != size)
+        return {};
+    return result;
+}
+
 }
@@ -1,6 +1,7 @@
 #ifndef OPENMW_ESM_FOGSTATE_H
 #define OPENMW_ESM_FOGSTATE_H
 
+#include <cstddef>
 #include <vector>
 
 namespace ESM
@@ -11,9 +12,18 @@ namespace ESM
     struct FogTexture
     {
         int mX, mY; // Only used for interior cells
+        // Compressed with compressFogTexture, empty for a fully unexplored texture. PNG image before format 22.
         std::vector<char> mImageData;
     };
 
+    bool isPngFogTexture(const std::vector<char>& imageData);
+
+    /// Compress alpha values of a square fog of war texture using PackBits run-length encoding.
+    std::vector<char> compressFogTexture(const std::vector<unsigned char>& alpha);
+
+    /// @return alpha values of a square texture, empty on invalid data.
+    std::vector<unsigned char> decompressFogTexture(const std::vector<char>& imageData);
+
     // format 0, saved games only
     // Fog of war state
     struct FogState
@@ -6,7 +6,7 @@
 namespace ESM
 {
 
-int SavedGame::sCurrentFormat = 21;
+int SavedGame::sCurrentFormat = 22;
 
 void SavedGame::load (ESMReader &esm)
 {
@@ -50,7 +50,7 @@ void SavedGame::save (ESMWriter &esm) const
          esm.writeHNString ("DEPE", *iter);
 
     esm.startSubRecord("SCRN");
-    esm.write(&mScreenshot[0], mScreenshot.size());
+    esm.write(mScreenshot.data(), mScreenshot.size());
     esm.endRecord("SCRN");
 }
 
@@ -1,5 +1,7 @@
 #include "storage.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <set>
 
 #include <osg/Image>
@@ -13,13 +15,121 @@
 namespace ESMTerrain
 {
 
+    /// @brief Lands used while building a single chunk. Cells of the chunk and its direct neighbours live in a flat grid,
+    /// anything further away falls back to a map.
     class LandCache
     {
     public:
         typedef std::map<std::pair<int, int>, osg::ref_ptr<const LandObject> > Map;
+
+        LandCache(int minX, int minY, int size)
+            : mMinX(minX)
+            , mMinY(minY)
+            , mSize(size)
+            , mGrid(static_cast<std::size_t>(size * size))
+        {
+        }
+
+        const LandObject* find(int cellX, int cellY, bool& found) const
+        {
+            if (const GridEntry* entry = getGridEntry(cellX, cellY))
+            {
+                found = entry->mLoaded;
+                return entry->mLand.get();
+            }
+            const auto it = mMap.find(std::make_pair(cellX, cellY));
+            found = it != mMap.end();
+            return found ? it->second.get() : nullptr;
+        }
+
+        const LandObject* insert(int cellX, int cellY, osg::ref_ptr<const LandObject>&& land)
+        {
+            if (GridEntry* entry = getGridEntry(cellX, cellY))
+            {
+                entry->mLoaded = true;
+                entry->mLand = std::move(land);
+                return entry->mLand.get();
+            }
+            return mMap.insert_or_assign(std::make_pair(cellX, cellY), std::move(land)).first->second.get();
+        }
+
+    private:
+        struct GridEntry
+        {
+            bool mLoaded = false;
+            osg::ref_ptr<const LandObject> mLand;
+        };
+
+        int mMinX;
+        int mMinY;
+        int mSize;
+        std::vector<GridEntry> mGrid;
         Map mMap;
+
+        const GridEntry* getGridEntry(int cellX, int cellY) const
+        {
+            return const_cast<LandCache*>(this)->getGridEntry(cellX, cellY);
+        }
+
+        GridEntry* getGridEntry(int cellX, int cellY)
+        {
+            const int x = cellX - mMinX;
+            const int y = cellY - mMinY;
+            if (x < 0 || y < 0 || x >= mSize || y >= mSize)
+                return nullptr;
+            return &mGrid[static_cast<std::size_t>(y * mSize + x)];
+        }
     };
 
+    namespace
+    {
+        // The kernels below work on one row of source vertices at a time and keep every component in its own
+        // contiguous array, so that the loops have no dependencies between iterations and get vectorized.
+        struct NormalRow
+        {
+            std::array<float, ESM::Land::LAND_SIZE> mX;
+            std::array<float, ESM::Land::LAND_SIZE> mY;
+            std::array<float, ESM::Land::LAND_SIZE> mZ;
+        };
+
+        void loadHeightRow(const float* heights, std::size_t stride, std::size_t count, float* result)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                result[i] = heights[i * stride];
+        }
+
+        void loadNormalRow(const ESM::Land::VNML* normals, std::size_t stride, std::size_t count, NormalRow& result)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                result.mX[i] = normals[i * stride * 3];
+                result.mY[i] = normals[i * stride * 3 + 1];
+                result.mZ[i] = normals[i * stride * 3 + 2];
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const float length = std::sqrt(result.mX[i] * result.mX[i] + result.mY[i] * result.mY[i] + result.mZ[i] * result.mZ[i]);
+                const float scale = length > 0 ? 1.f / length : 1.f;
+                result.mX[i] *= scale;
+                result.mY[i] *= scale;
+                result.mZ[i] *= scale;
+            }
+        }
+
+        void loadColourRow(const unsigned char* colours, std::size_t stride, std::size_t count, osg::Vec4ub* result)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                result[i] = osg::Vec4ub(colours[i * stride * 3], colours[i * stride * 3 + 1], colours[i * stride * 3 + 2], 255);
+        }
+
+        int getLandCacheSize(float chunkSize)
+        {
+            // The chunk's cells plus one neighbouring cell on each side
+            return static_cast<int>(std::ceil(chunkSize)) + 2;
+        }
+    }
+
     LandObject::LandObject()
         : mLand(nullptr)
         , mLoadFlags(0)
@@ -190,20 +300,24 @@ namespace ESMTerrain
         normals->resize(numVerts*numVerts);
         colours->resize(numVerts*numVerts);
 
-        osg::Vec3f normal;
-        osg::Vec4ub color;
+        const float vertScale = size * Constants::CellSizeInUnits / float(numVerts - 1);
+        const float vertOffset = 0.5f * size * Constants::CellSizeInUnits;
 
-        float vertY = 0;
-        float vertX = 0;
+        std::array<float, ESM::Land::LAND_SIZE> heightRow;
+        NormalRow normalRow;
+        std::array<osg::Vec4ub, ESM::Land::LAND_SIZE> colourRow;
 
-        LandCache cache;
+        size_t vertY = 0;
+        size_t vertX = 0;
+
+        LandCache cache(startCellX - 1, startCellY - 1, getLandCacheSize(size));
 
         bool alteration = useAlteration();
 
-        float vertY_ = 0; // of current cell corner
+        size_t vertY_ = 0; // of current cell corner
         for (int cellY = startCellY; cellY < startCellY + std::ceil(size); ++cellY)
         {
-            float vertX_ = 0; // of current cell corner
+            size_t vertX_ = 0; // of current cell corner
             for (int cellX = startCellX; cellX < startCellX + std::ceil(size); ++cellX)
             {
                 const LandObject* land = getLand(cellX, cellY, cache);
@@ -233,39 +347,50 @@ namespace ESMTerrain
                 int rowEnd = std::min(static_cast<int>(rowStart + std::min(1.f, size) * (ESM::Land::LAND_SIZE-1) + 1), static_cast<int>(ESM::Land::LAND_SIZE));
                 int colEnd = std::min(static_cast<int>(colStart + std::min(1.f, size) * (ESM::Land::LAND_SIZE-1) + 1), static_cast<int>(ESM::Land::LAND_SIZE));
 
+                const size_t rowCount = rowStart < rowEnd ? (rowEnd - rowStart + increment - 1) / increment : 0;
+
                 vertY = vertY_;
                 for (int col=colStart; col<colEnd; col += increment)
                 {
-                    vertX = vertX_;
-                    for (int row=rowStart; row<rowEnd; row += increment)
+                    assert(col >= 0 && col < ESM::Land::LAND_SIZE);
+                    assert(vertY < numVerts);
+                    assert(vertX_ + rowCount <= numVerts);
+
+                    const int srcIndex = col * ESM::Land::LAND_SIZE + rowStart;
+
+                    if (heightData)
+                        loadHeightRow(heightData->mHeights + srcIndex, increment, rowCount, heightRow.data());
+                    else
+                        std::fill_n(heightRow.begin(), rowCount, defaultHeight);
+
+                    if (normalData)
+                        loadNormalRow(normalData->mNormals + srcIndex * 3, increment, rowCount, normalRow);
+                    else
                     {
-                        int srcArrayIndex = col*ESM::Land::LAND_SIZE*3+row*3;
+                        std::fill_n(normalRow.mX.begin(), rowCount, 0.f);
+                        std::fill_n(normalRow.mY.begin(), rowCount, 0.f);
+                        std::fill_n(normalRow.mZ.begin(), rowCount, 1.f);
+                    }
 
-                        assert(row >= 0 && row < ESM::Land::LAND_SIZE);
-                        assert(col >= 0 && col < ESM::Land::LAND_SIZE);
+                    if (colourData)
+                        loadColourRow(colourData->mColours + srcIndex * 3, increment, rowCount, colourRow.data());
+                    else
+                        std::fill_n(colourRow.begin(), rowCount, osg::Vec4ub(255, 255, 255, 255));
 
-                        assert (vertX < numVerts);
-                        assert (vertY < numVerts);
+                    const float posY = vertY * vertScale - vertOffset;
 
-                        float height = defaultHeight;
-                        if (heightData)
-                            height = heightData->mHeights[col*ESM::Land::LAND_SIZE + row];
+                    vertX = vertX_;
+                    int row = rowStart;
+                    for (size_t i = 0; i < rowCount; ++i, row += increment, ++vertX)
+                    {
+                        const unsigned int dstIndex = static_cast<unsigned int>(vertX*numVerts + vertY);
+
+                        float height = heightRow[i];
                         if (alteration)
                             height += getAlteredHeight(col, row);
-                        (*positions)[static_cast<unsigned int>(vertX*numVerts + vertY)]
-                            = osg::Vec3f((vertX / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
-                                         (vertY / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
-                                         height);
+                        (*positions)[dstIndex] = osg::Vec3f(vertX * vertScale - vertOffset, posY, height);
 
-                        if (normalData)
-                        {
-                            for (int i=0; i<3; ++i)
-                                normal[i] = normalData->mNormals[srcArrayIndex+i];
-
-                            normal.normalize();
-                        }
-                        else
-                            normal = osg::Vec3f(0,0,1);
+                        osg::Vec3f normal(normalRow.mX[i], normalRow.mY[i], normalRow.mZ[i]);
 
                         // Normals apparently don't connect seamlessly between cells
                         if (col == ESM::Land::LAND_SIZE-1 || row == ESM::Land::LAND_SIZE-1)
@@ -277,19 +402,9 @@ namespace ESMTerrain
 
                         assert(normal.z() > 0);
 
-                        (*normals)[static_cast<unsigned int>(vertX*numVerts + vertY)] = normal;
+                        (*normals)[dstIndex] = normal;
 
-                        if (colourData)
-                        {
-                            for (int i=0; i<3; ++i)
-                                color[i] = colourData->mColours[srcArrayIndex+i];
-                        }
-                        else
-                        {
-                            color.r() = 255;
-                            color.g() = 255;
-                            color.b() = 255;
-                        }
+                        osg::Vec4ub& color = colourRow[i];
                         if (alteration)
                             adjustColor(col, row, heightData, color); //Does nothing by default, override in OpenMW-CS
 
@@ -299,9 +414,7 @@ namespace ESMTerrain
 
                         color.a() = 255;
 
-                        (*colours)[static_cast<unsigned int>(vertX*numVerts + vertY)] = color;
-
-                        ++vertX;
+                        (*colours)[dstIndex] = color;
                     }
                     ++vertY;
                 }
@@ -388,7 +501,7 @@ namespace ESMTerrain
         const int imageScaleFactor = 2;
         const int blendmapImageSize = blendmapSize * imageScaleFactor;
 
-        LandCache cache;
+        LandCache cache(cellX - 1, cellY - 1, getLandCacheSize(chunkSize));
         std::map<UniqueTextureId, unsigned int> textureIndicesMap;
 
         for (int y=0; y<blendmapSize; y++)
@@ -525,14 +638,11 @@ namespace ESMTerrain
 
     const LandObject* Storage::getLand(int cellX, int cellY, LandCache& cache)
     {
-        LandCache::Map::iterator found = cache.mMap.find(std::make_pair(cellX, cellY));
-        if (found != cache.mMap.end())
-            return found->second;
-        else
-        {
-            found = cache.mMap.insert(std::make_pair(std::make_pair(cellX, cellY), getLand(cellX, cellY))).first;
-            return found->second;
-        }
+        bool found = false;
+        const LandObject* land = cache.find(cellX, cellY, found);
+        if (found)
+            return land;
+        return cache.insert(cellX, cellY, getLand(cellX, cellY));
     }
 
     void Storage::adjustColor(int col, int row, const ESM::Land::LandData *heightData, osg::Vec4ub& color) const
@@ -544,14 +654,27 @@ namespace ESMTerrain
         return 0;
     }
 
+    const Storage::LayerInfoEntry* Storage::findLayerInfo(std::size_t bucket, const std::string& texture) const
+    {
+        for (const LayerInfoEntry* entry = mLayerInfoBuckets[bucket].load(std::memory_order_acquire); entry != nullptr; entry = entry->mNext)
+            if (entry->mTexture == texture)
+                return entry;
+        return nullptr;
+    }
+
     Terrain::LayerInfo Storage::getLayerInfo(const std::string& texture)
     {
-        std::lock_guard<std::mutex> lock(mLayerInfoMutex);
+        const std::size_t bucket = std::hash<std::string>{}(texture) % sLayerInfoBuckets;
 
         // Already have this cached?
-        std::map<std::string, Terrain::LayerInfo>::iterator found = mLayerInfoMap.find(texture);
-        if (found != mLayerInfoMap.end())
-            return found->second;
+        if (const LayerInfoEntry* entry = findLayerInfo(bucket, texture))
+            return entry->mInfo;
+
+        std::lock_guard<std::mutex> lock(mLayerInfoMutex);
+
+        // Another thread might have added it while we were waiting for the lock
+        if (const LayerInfoEntry* entry = findLayerInfo(bucket, texture))
+            return entry->mInfo;
 
         Terrain::LayerInfo info;
         info.mParallax = false;
@@ -587,7 +710,9 @@ namespace ESMTerrain
             }
         }
 
-        mLayerInfoMap[texture] = info;
+        auto entry = std::make_unique<LayerInfoEntry>(LayerInfoEntry {texture, info, mLayerInfoBuckets[bucket].load(std::memory_order_relaxed)});
+        mLayerInfoBuckets[bucket].store(entry.get(), std::memory_order_release);
+        mLayerInfoEntries.push_back(std::move(entry));
 
         return info;
     }
@@ -1,8 +1,12 @@
 #ifndef COMPONENTS_ESM_TERRAIN_STORAGE_H
 #define COMPONENTS_ESM_TERRAIN_STORAGE_H
 
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include <components/terrain/storage.hpp>
 
@@ -132,9 +136,23 @@ namespace ESMTerrain
         inline UniqueTextureId getVtexIndexAt(int cellX, int cellY, int x, int y, LandCache&);
         std::string getTextureName (UniqueTextureId id);
 
-        std::map<std::string, Terrain::LayerInfo> mLayerInfoMap;
+        // Insert-only hash table: lookups walk the buckets without locking, so once every land texture
+        // has been seen getLayerInfo never blocks. Only inserting a new entry takes mLayerInfoMutex.
+        struct LayerInfoEntry
+        {
+            std::string mTexture;
+            Terrain::LayerInfo mInfo;
+            const LayerInfoEntry* mNext;
+        };
+
+        static constexpr std::size_t sLayerInfoBuckets = 256;
+
+        std::array<std::atomic<const LayerInfoEntry*>, sLayerInfoBuckets> mLayerInfoBuckets {};
+        std::vector<std::unique_ptr<LayerInfoEntry>> mLayerInfoEntries;
         std::mutex mLayerInfoMutex;
 
+        const LayerInfoEntry* findLayerInfo(std::size_t bucket, const std::string& texture) const;
+
         std::string mNormalMapPattern;
         std::string mNormalHeightMapPattern;
         bool mAutoUseNormalMaps;
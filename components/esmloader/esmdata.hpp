@@ -3,6 +3,8 @@
 
 #include <components/esm/defs.hpp>
 
+#include <cstddef>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -26,6 +28,13 @@ namespace EsmLoader
         ESM::RecNameInts mType;
     };
 
+    /// Content file with a record of a static object, including deleted and overridden records
+    struct RefIdContentFile
+    {
+        std::string mId;
+        std::size_t mContentFile;
+    };
+
     struct EsmData
     {
         std::vector<ESM::Activator> mActivators;
@@ -36,6 +45,7 @@ namespace EsmLoader
         std::vector<ESM::Land> mLands;
         std::vector<ESM::Static> mStatics;
         std::vector<RefIdWithType> mRefIdTypes;
+        std::vector<RefIdContentFile> mRefIdContentFiles;
 
         EsmData() = default;
         EsmData(const EsmData&) = delete;
@@ -152,15 +152,27 @@ namespace EsmLoader
             Records<ESM::GameSetting> mGameSettings;
             Records<ESM::Land> mLands;
             Records<ESM::Static> mStatics;
+            std::vector<RefIdContentFile> mRefIdContentFiles;
         };
 
+        template <class T>
+        void loadRecord(const Query& query, ESM::ESMReader& reader, Records<T>& records,
+            std::vector<RefIdContentFile>& refIdContentFiles)
+        {
+            const std::size_t size = records.size();
+            loadRecord(reader, records);
+            if (query.mLoadRefIdContentFiles && records.size() != size)
+                refIdContentFiles.push_back(RefIdContentFile {records.back().mValue.mId,
+                                                              static_cast<std::size_t>(reader.getIndex())});
+        }
+
         void loadRecord(const Query& query, const ESM::NAME& name, ESM::ESMReader& reader, ShallowContent& content)
         {
             switch (name.toInt())
             {
                 case ESM::REC_ACTI:
                     if (query.mLoadActivators)
-                        return loadRecord(reader, content.mActivators);
+                        return loadRecord(query, reader, content.mActivators, content.mRefIdContentFiles);
                     break;
                 case ESM::REC_CELL:
                     if (query.mLoadCells)
@@ -168,11 +180,11 @@ namespace EsmLoader
                     break;
                 case ESM::REC_CONT:
                     if (query.mLoadContainers)
-                        return loadRecord(reader, content.mContainers);
+                        return loadRecord(query, reader, content.mContainers, content.mRefIdContentFiles);
                     break;
                 case ESM::REC_DOOR:
                     if (query.mLoadDoors)
-                        return loadRecord(reader, content.mDoors);
+                        return loadRecord(query, reader, content.mDoors, content.mRefIdContentFiles);
                     break;
                 case ESM::REC_GMST:
                     if (query.mLoadGameSettings)
@@ -184,7 +196,7 @@ namespace EsmLoader
                     break;
                 case ESM::REC_STAT:
                     if (query.mLoadStatics)
-                        return loadRecord(reader, content.mStatics);
+                        return loadRecord(query, reader, content.mStatics, content.mRefIdContentFiles);
                     break;
             }
 
@@ -345,6 +357,12 @@ namespace EsmLoader
 
         addRefIdsTypes(result);
 
+        if (query.mLoadRefIdContentFiles)
+        {
+            result.mRefIdContentFiles = std::move(content.mRefIdContentFiles);
+            std::stable_sort(result.mRefIdContentFiles.begin(), result.mRefIdContentFiles.end(), LessById {});
+        }
+
         std::ostringstream prepared;
 
         if (query.mLoadActivators)
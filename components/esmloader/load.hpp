@@ -36,6 +36,7 @@ namespace EsmLoader
         bool mLoadGameSettings = false;
         bool mLoadLands = false;
         bool mLoadStatics = false;
+        bool mLoadRefIdContentFiles = false;
     };
 
     EsmData loadEsmData(const Query& query, const std::vector<std::string>& contentFiles,
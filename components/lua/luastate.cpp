@@ -4,6 +4,7 @@
 #include <luajit.h>
 #endif // NO_LUAJIT
 
+#include <cstdlib>
 #include <filesystem>
 
 #include <components/debug/debuglog.hpp>
@@ -50,8 +51,38 @@ namespace LuaUtil
         "type", "unpack", "xpcall", "rawequal", "rawget", "rawset", "setmetatable"};
     static const std::string safePackages[] = {"coroutine", "math", "string", "table"};
 
-    LuaState::LuaState(const VFS::Manager* vfs, const ScriptsConfiguration* conf) : mConf(conf), mVFS(vfs)
+    static constexpr int countHookStep = 1000;
+
+    // Address is used as a key in the Lua registry to find LuaState from a hook.
+    static const char luaStateRegistryKey = 0;
+
+    lua_State* LuaState::createLuaRuntime(LuaState* luaState)
+    {
+        lua_State* L = lua_newstate(&trackingAllocator, luaState);
+        if (L)
+        {
+            luaState->mMemoryTracked = true;
+            return L;
+        }
+        Log(Debug::Warning) << "Custom memory allocator is not supported by this Lua implementation; "
+                               "memory usage of Lua scripts will not be tracked";
+        return luaL_newstate();
+    }
+
+    LuaState::LuaState(const VFS::Manager* vfs, const ScriptsConfiguration* conf, const LuaStateSettings& settings)
+        : mSettings(settings)
+        , mLuaHolder(createLuaRuntime(this))
+        , mLua(mLuaHolder.get())
+        , mConf(conf)
+        , mVFS(vfs)
     {
+        lua_State* L = mLuaHolder.get();
+        lua_pushlightuserdata(L, const_cast<char*>(&luaStateRegistryKey));
+        lua_pushlightuserdata(L, this);
+        lua_rawset(L, LUA_REGISTRYINDEX);
+        if (mSettings.mProfiler || mSettings.mInstructionLimit > 0 || (mMemoryTracked && mSettings.mMemoryLimit > 0))
+            lua_sethook(L, &countHook, LUA_MASKCOUNT, countHookStep);
+
         mLua.open_libraries(sol::lib::base, sol::lib::coroutine, sol::lib::math, sol::lib::bit32,
                             sol::lib::string, sol::lib::table, sol::lib::os, sol::lib::debug);
 
@@ -147,6 +178,137 @@ namespace LuaUtil
         mSandboxEnv = sol::nil;
     }
 
+    void* LuaState::trackingAllocator(void* ud, void* ptr, size_t osize, size_t nsize)
+    {
+        LuaState* self = static_cast<LuaState*>(ud);
+        const uint64_t smallAllocMaxSize = self->mSettings.mSmallAllocMaxSize;
+
+        if (!ptr)
+            osize = 0;  // Lua passes the type of the new object in osize if ptr is nullptr.
+        const int64_t memDiff = static_cast<int64_t>(nsize) - static_cast<int64_t>(osize);
+        const int scriptId = self->mActiveScriptIdStack.empty() ? -1 : self->mActiveScriptIdStack.back();
+        std::atomic<int64_t>* sharedMemoryUsage = self->mSettings.mSharedMemoryUsage.get();
+
+        // Failing the allocation here would make Lua panic if it is made outside of a protected call (for example when
+        // the engine pushes arguments of a call). So the allocation succeeds and countHook raises an error in the script.
+        if (memDiff > 0 && !self->mMemoryLimitReported && self->isMemoryLimitExceeded(memDiff))
+        {
+            Log(Debug::Error) << "Lua memory usage exceeded the limit of " << self->mSettings.mMemoryLimit << " bytes"
+                              << (scriptId >= 0 && static_cast<size_t>(scriptId) < self->mConf->size()
+                                  ? " in " + (*self->mConf)[scriptId].mScriptPath : std::string())
+                              << "; to change the limit set \"[Lua] memory limit\" in settings.cfg";
+            self->mMemoryLimitReported = true;
+        }
+
+        void* newPtr = nullptr;
+        if (nsize == 0)
+            std::free(ptr);
+        else
+        {
+            newPtr = std::realloc(ptr, nsize);
+            if (!newPtr)
+                return nullptr;
+        }
+        self->mTotalMemoryUsage += memDiff;
+        if (sharedMemoryUsage != nullptr)
+            sharedMemoryUsage->fetch_add(memDiff, std::memory_order_relaxed);
+
+        if (!self->mSettings.mProfiler)
+            return newPtr;
+
+        // Big allocations made outside of any script and all small allocations are counted as not attributed.
+        int owner = scriptId;
+        auto it = osize > smallAllocMaxSize ? self->mBigAllocOwners.find(ptr) : self->mBigAllocOwners.end();
+        if (it != self->mBigAllocOwners.end())
+        {
+            owner = it->second;  // Reallocation doesn't change the owner.
+            self->getScriptStats(owner).mMemoryUsage -= osize;
+            self->mBigAllocOwners.erase(it);
+        }
+        else
+            self->mSmallAllocMemoryUsage -= osize;
+
+        if (nsize > smallAllocMaxSize && owner >= 0)
+        {
+            self->getScriptStats(owner).mMemoryUsage += nsize;
+            self->mBigAllocOwners.emplace(newPtr, owner);
+        }
+        else
+            self->mSmallAllocMemoryUsage += nsize;
+
+        return newPtr;
+    }
+
+    void LuaState::countHook(lua_State* L, lua_Debug* /*ar*/)
+    {
+        lua_pushlightuserdata(L, const_cast<char*>(&luaStateRegistryKey));
+        lua_rawget(L, LUA_REGISTRYINDEX);
+        LuaState* self = static_cast<LuaState*>(lua_touserdata(L, -1));
+        lua_pop(L, 1);
+        if (self == nullptr || self->mActiveScriptIdStack.empty())
+            return;
+        if (self->mSettings.mProfiler)
+            self->getScriptStats(self->mActiveScriptIdStack.back()).mInstructionCount += countHookStep;
+        self->mWatchdogInstructionCounter += countHookStep;
+        if (self->mSettings.mInstructionLimit > 0 && self->mWatchdogInstructionCounter > self->mSettings.mInstructionLimit)
+        {
+            lua_pushstring(L, "Lua instruction count exceeded, probably an infinite loop in a script. "
+                              "To change the limit set \"[Lua] instruction limit per call\" in settings.cfg");
+            lua_error(L);
+        }
+        if (self->isMemoryLimitExceeded(0))
+        {
+            // Garbage is not a reason to abort the script
+            lua_gc(L, LUA_GCCOLLECT, 0);
+            if (self->isMemoryLimitExceeded(0))
+            {
+                lua_pushstring(L, "Lua memory usage exceeded the limit. "
+                                  "To change the limit set \"[Lua] memory limit\" in settings.cfg");
+                lua_error(L);
+            }
+        }
+    }
+
+    bool LuaState::isMemoryLimitExceeded(int64_t extra) const
+    {
+        const uint64_t memoryLimit = mSettings.mMemoryLimit;
+        if (memoryLimit == 0 || !mMemoryTracked)
+            return false;
+        const int64_t memoryUsage = mSettings.mSharedMemoryUsage != nullptr
+            ? mSettings.mSharedMemoryUsage->load(std::memory_order_relaxed) : mTotalMemoryUsage;
+        return memoryUsage + extra > 0 && static_cast<uint64_t>(memoryUsage + extra) > memoryLimit;
+    }
+
+    ScriptStats& LuaState::getScriptStats(int scriptId)
+    {
+        if (static_cast<size_t>(scriptId) >= mScriptStats.size())
+            mScriptStats.resize(scriptId + 1);
+        return mScriptStats[scriptId];
+    }
+
+    void LuaState::updateScriptStats()
+    {
+        constexpr float smoothing = 0.1f;
+        for (ScriptStats& stats : mScriptStats)
+        {
+            stats.mAvgInstructionCount += (stats.mInstructionCount - stats.mAvgInstructionCount) * smoothing;
+            stats.mInstructionCount = 0;
+        }
+    }
+
+    LuaState::ScriptScope::ScriptScope(LuaState& lua, int scriptId)
+        : mLua(lua)
+    {
+        if (mLua.mActiveScriptIdStack.empty())
+            mLua.mWatchdogInstructionCounter = 0;
+        mLua.mActiveScriptIdStack.push_back(scriptId);
+    }
+
+    LuaState::ScriptScope::~ScriptScope()
+    {
+        mLua.mActiveScriptIdStack.pop_back();
+    }
+
     sol::table makeReadOnly(const sol::table& table, bool strictIndex)
     {
         if (table == sol::nil)
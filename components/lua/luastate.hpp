@@ -1,7 +1,12 @@
 #ifndef COMPONENTS_LUA_LUASTATE_H
 #define COMPONENTS_LUA_LUASTATE_H
 
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include <sol/sol.hpp>
 
@@ -17,6 +22,23 @@ namespace LuaUtil
 
     std::string getLuaVersion();
 
+    struct LuaStateSettings
+    {
+        uint64_t mInstructionLimit = 0;  // 0 is unlimited
+        uint64_t mMemoryLimit = 0;  // 0 is unlimited
+        uint64_t mSmallAllocMaxSize = 1024;  // allocations of this size or less are not attributed to scripts
+        bool mProfiler = false;  // attribute memory usage and executed instructions to scripts
+        // If set, mMemoryLimit is applied to the sum of memory used by all Lua states sharing the counter.
+        std::shared_ptr<std::atomic<int64_t>> mSharedMemoryUsage;
+    };
+
+    struct ScriptStats
+    {
+        int64_t mMemoryUsage = 0;  // bytes in allocations bigger than LuaStateSettings::mSmallAllocMaxSize
+        int64_t mInstructionCount = 0;  // since the last call of LuaState::updateScriptStats
+        float mAvgInstructionCount = 0;  // per LuaState::updateScriptStats period
+    };
+
     // Holds Lua state.
     // Provides additional features:
     //   - Load scripts from the virtual filesystem;
@@ -29,14 +51,45 @@ namespace LuaUtil
     //         Lua libraries (only source, no dll's) in the virtual filesystem;
     //   - Make `print` to add the script name to every message and
     //         write to the Log rather than directly to stdout;
+    //   - Track memory usage and executed instructions of every script (see LuaStateSettings).
     class LuaState
     {
     public:
-        explicit LuaState(const VFS::Manager* vfs, const ScriptsConfiguration* conf);
+        explicit LuaState(const VFS::Manager* vfs, const ScriptsConfiguration* conf,
+                          const LuaStateSettings& settings = LuaStateSettings{});
+        LuaState(const LuaState&) = delete;
+        LuaState(LuaState&&) = delete;
         ~LuaState();
 
-        // Returns underlying sol::state.
-        sol::state& sol() { return mLua; }
+        // Returns underlying sol::state_view.
+        sol::state_view& sol() { return mLua; }
+
+        // While an instance exists, memory allocations and executed Lua instructions are attributed to the script.
+        // ScriptsContainer creates it around every call to a script.
+        class ScriptScope
+        {
+        public:
+            ScriptScope(LuaState& lua, int scriptId);
+            ~ScriptScope();
+            ScriptScope(const ScriptScope&) = delete;
+
+        private:
+            LuaState& mLua;
+        };
+
+        const LuaStateSettings& getSettings() const { return mSettings; }
+
+        // False if the Lua implementation doesn't support custom allocators (LuaJIT without GC64).
+        // In this case memory usage is not tracked and the memory limit is not applied.
+        bool isMemoryTracked() const { return mMemoryTracked; }
+        int64_t getTotalMemoryUsage() const { return mTotalMemoryUsage; }
+        int64_t getSmallAllocMemoryUsage() const { return mSmallAllocMemoryUsage; }
+
+        // Indexed by script id in ScriptsConfiguration.
+        const std::vector<ScriptStats>& getScriptStats() const { return mScriptStats; }
+
+        // Should be called once per frame. Updates ScriptStats::mAvgInstructionCount and resets instruction counters.
+        void updateScriptStats();
 
         // Can be used by a C++ function that is called from Lua to get the Lua traceback.
         // Makes no sense if called not from Lua code.
@@ -90,9 +143,41 @@ namespace LuaUtil
         template <typename... Args>
         friend sol::protected_function_result call(const sol::protected_function& fn, Args&&... args);
 
+        static lua_State* createLuaRuntime(LuaState* luaState);
+        static void* trackingAllocator(void* ud, void* ptr, size_t osize, size_t nsize);
+        static void countHook(lua_State* L, lua_Debug* ar);
+
+        bool isMemoryLimitExceeded(int64_t extra) const;
+
+        ScriptStats& getScriptStats(int scriptId);
+
         sol::function loadScriptAndCache(const std::string& path);
 
-        sol::state mLua;
+        class LuaStateHolder
+        {
+        public:
+            explicit LuaStateHolder(lua_State* L) : mL(L) { sol::set_default_state(L); }
+            ~LuaStateHolder() { lua_close(mL); }
+            LuaStateHolder(const LuaStateHolder&) = delete;
+            lua_State* get() const { return mL; }
+
+        private:
+            lua_State* mL;
+        };
+
+        // Used by the allocator, so should be declared before mLuaHolder to outlive the Lua state.
+        const LuaStateSettings mSettings;
+        bool mMemoryTracked = false;
+        bool mMemoryLimitReported = false;
+        int64_t mTotalMemoryUsage = 0;
+        int64_t mSmallAllocMemoryUsage = 0;
+        std::unordered_map<const void*, int> mBigAllocOwners;
+        std::vector<ScriptStats> mScriptStats;
+        std::vector<int> mActiveScriptIdStack;
+        uint64_t mWatchdogInstructionCounter = 0;
+
+        LuaStateHolder mLuaHolder;
+        sol::state_view mLua;
         const ScriptsConfiguration* mConf;
         sol::table mSandboxEnv;
         std::map<std::string, sol::bytecode> mCompiledScripts;
@@ -75,6 +75,7 @@ namespace LuaUtil
 
         try
         {
+            LuaState::ScriptScope scope(mLua, scriptId);
             sol::object scriptOutput = mLua.runInNewSandbox(path, mNamePrefix, mAPI, script.mHiddenData);
             if (scriptOutput == sol::nil)
                 return true;
@@ -188,11 +189,13 @@ namespace LuaUtil
         }
         if (prev && script.mOnOverride)
         {
+            LuaState::ScriptScope scope(mLua, scriptId);
             try { LuaUtil::call(*script.mOnOverride, *prev->mInterface); }
             catch (std::exception& e) { printError(scriptId, "onInterfaceOverride failed", e); }
         }
         if (next && next->mOnOverride)
         {
+            LuaState::ScriptScope scope(mLua, nextId);
             try { LuaUtil::call(*next->mOnOverride, *script.mInterface); }
             catch (std::exception& e) { printError(nextId, "onInterfaceOverride failed", e); }
         }
@@ -226,6 +229,7 @@ namespace LuaUtil
                 sol::object prevInterface = sol::nil;
                 if (prev)
                     prevInterface = *prev->mInterface;
+                LuaState::ScriptScope scope(mLua, nextId);
                 try { LuaUtil::call(*next->mOnOverride, prevInterface); }
                 catch (std::exception& e) { printError(nextId, "onInterfaceOverride failed", e); }
             }
@@ -258,12 +262,9 @@ namespace LuaUtil
 
     void ScriptsContainer::receiveEvent(std::string_view eventName, std::string_view eventData)
     {
-        auto it = mEventHandlers.find(eventName);
-        if (it == mEventHandlers.end())
-        {
-            Log(Debug::Warning) << mNamePrefix << " has received event '" << eventName << "', but there are no handlers for this event";
+        EventHandlerList* list = findEventHandlers(eventName);
+        if (list == nullptr)
             return;
-        }
         sol::object data;
         try
         {
@@ -274,12 +275,35 @@ namespace LuaUtil
             Log(Debug::Error) << mNamePrefix << " can not parse eventData for '" << eventName << "': " << e.what();
             return;
         }
-        EventHandlerList& list = it->second;
+        callEventHandlers(*list, eventName, data);
+    }
+
+    void ScriptsContainer::receiveEvent(std::string_view eventName, const sol::object& eventData)
+    {
+        EventHandlerList* list = findEventHandlers(eventName);
+        if (list != nullptr)
+            callEventHandlers(*list, eventName, eventData);
+    }
+
+    ScriptsContainer::EventHandlerList* ScriptsContainer::findEventHandlers(std::string_view eventName)
+    {
+        auto it = mEventHandlers.find(eventName);
+        if (it == mEventHandlers.end())
+        {
+            Log(Debug::Warning) << mNamePrefix << " has received event '" << eventName << "', but there are no handlers for this event";
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    void ScriptsContainer::callEventHandlers(EventHandlerList& list, std::string_view eventName, const sol::object& eventData)
+    {
         for (int i = list.size() - 1; i >= 0; --i)
         {
             try
             {
-                sol::object res = LuaUtil::call(list[i].mFn, data);
+                LuaState::ScriptScope scope(mLua, list[i].mScriptId);
+                sol::object res = LuaUtil::call(list[i].mFn, eventData);
                 if (res != sol::nil && !res.as<bool>())
                     break;  // Skip other handlers if 'false' was returned.
             }
@@ -301,6 +325,7 @@ namespace LuaUtil
     {
         try
         {
+            LuaState::ScriptScope scope(mLua, scriptId);
             LuaUtil::call(onInit, deserialize(mLua.sol(), data, mSerializer));
         }
         catch (std::exception& e) { printError(scriptId, "onInit failed", e); }
@@ -335,6 +360,7 @@ namespace LuaUtil
             {
                 try
                 {
+                    LuaState::ScriptScope scope(mLua, scriptId);
                     sol::object state = LuaUtil::call(*script.mOnSave);
                     savedScript.mData = serialize(state, mSerializer);
                 }
@@ -392,6 +418,7 @@ namespace LuaUtil
             {
                 try
                 {
+                    LuaState::ScriptScope scope(mLua, scriptId);
                     sol::object state = deserialize(mLua.sol(), scriptInfo.mSavedData->mData, mSavedDataDeserializer);
                     sol::object initializationData =
                         deserialize(mLua.sol(), scriptInfo.mInitData, mSerializer);
@@ -498,6 +525,7 @@ namespace LuaUtil
     {
         try
         {
+            LuaState::ScriptScope scope(mLua, t.mScriptId);
             Script& script = getScript(t.mScriptId);
             if (t.mSerializable)
             {
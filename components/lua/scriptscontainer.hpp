@@ -84,6 +84,8 @@ namespace LuaUtil
         ScriptsContainer(ScriptsContainer&&) = delete;
         virtual ~ScriptsContainer();
 
+        LuaState& getLuaState() const { return mLua; }
+
         void setAutoStartConf(ScriptIdsWithInitializationData conf) { mAutoStartScripts = std::move(conf); }
         const ScriptIdsWithInitializationData& getAutoStartConf() const { return mAutoStartScripts; }
 
@@ -112,6 +114,10 @@ namespace LuaUtil
         // (including `nil`) has no effect.
         void receiveEvent(std::string_view eventName, std::string_view eventData);
 
+        // Same as above, but takes event data that is already in this Lua state. It should be a copy made
+        // by `LuaUtil::copy` with this container's serializer, so the handlers can not modify the sender's data.
+        void receiveEvent(std::string_view eventName, const sol::object& eventData);
+
         // Serializer defines how to serialize/deserialize userdata. If serializer is not provided,
         // only built-in types and types from util package can be serialized.
         void setSerializer(const UserdataSerializer* serializer) { mSerializer = serializer; }
@@ -171,7 +177,11 @@ namespace LuaUtil
         {
             for (Handler& handler : handlers.mList)
             {
-                try { LuaUtil::call(handler.mFn, args...); }
+                try
+                {
+                    LuaState::ScriptScope scope(mLua, handler.mScriptId);
+                    LuaUtil::call(handler.mFn, args...);
+                }
                 catch (std::exception& e)
                 {
                     Log(Debug::Error) << mNamePrefix << "[" << scriptPath(handler.mScriptId) << "] "
@@ -188,6 +198,8 @@ namespace LuaUtil
         LuaUtil::LuaState& mLua;
 
     private:
+        friend struct Callback;
+
         struct Script
         {
             std::optional<sol::function> mOnSave;
@@ -218,6 +230,10 @@ namespace LuaUtil
         // Returns script by id (throws an exception if doesn't exist)
         Script& getScript(int scriptId);
 
+        // Returns handlers of the event or nullptr if there are no handlers.
+        EventHandlerList* findEventHandlers(std::string_view eventName);
+        void callEventHandlers(EventHandlerList& list, std::string_view eventName, const sol::object& eventData);
+
         void printError(int scriptId, std::string_view msg, const std::exception& e);
         const std::string& scriptPath(int scriptId) const { return mLua.getConfiguration()[scriptId].mScriptPath; }
         void callOnInit(int scriptId, const sol::function& onInit, std::string_view data);
@@ -259,8 +275,13 @@ namespace LuaUtil
         template <typename... Args>
         sol::object call(Args&&... args) const
         {
-            if (isValid())
+            sol::object id = mHiddenData[ScriptsContainer::sScriptIdKey];
+            if (id != sol::nil)
+            {
+                const ScriptsContainer::ScriptId& scriptId = id.as<ScriptsContainer::ScriptId>();
+                LuaState::ScriptScope scope(scriptId.mContainer->mLua, scriptId.mIndex);
                 return LuaUtil::call(mFunc, std::forward<Args>(args)...);
+            }
             else
                 Log(Debug::Debug) << "Ignored callback to the removed script "
                                   << mHiddenData.get<std::string>(ScriptsContainer::sScriptDebugNameKey);
@@ -362,6 +362,55 @@ namespace LuaUtil
         return res;
     }
 
+    static sol::object copyUserdata(lua_State* lua, const sol::userdata& data,
+                                    const UserdataSerializer* customSerializer, const UserdataSerializer* customDeserializer)
+    {
+        if (data.is<osg::Vec2f>())
+            return sol::make_object(lua, data.as<osg::Vec2f>());
+        if (data.is<osg::Vec3f>())
+            return sol::make_object(lua, data.as<osg::Vec3f>());
+        if (data.is<TransformM>())
+            return sol::make_object(lua, data.as<TransformM>());
+        if (data.is<TransformQ>())
+            return sol::make_object(lua, data.as<TransformQ>());
+        if (data.is<osg::Vec4f>())
+            return sol::make_object(lua, data.as<osg::Vec4f>());
+        if (data.is<Misc::Color>())
+            return sol::make_object(lua, data.as<Misc::Color>());
+
+        // Custom userdata can change its type on the way (e.g. GObject -> LObject), so it goes through the serializers.
+        BinaryData binaryData;
+        binaryData.push_back(FORMAT_VERSION);
+        serializeUserdata(binaryData, data, customSerializer);
+        return deserialize(lua, binaryData, customDeserializer);
+    }
+
+    static sol::object copy(lua_State* lua, const sol::object& obj, const UserdataSerializer* customSerializer,
+                            const UserdataSerializer* customDeserializer, int recursionCounter)
+    {
+        if (obj.get_type() == sol::type::lightuserdata)
+            throw std::runtime_error("Light userdata is not allowed to be serialized.");
+        if (obj.is<sol::function>())
+            throw std::runtime_error("Functions are not allowed to be serialized.");
+        else if (obj.is<sol::userdata>())
+            return copyUserdata(lua, obj, customSerializer, customDeserializer);
+        else if (obj.is<sol::lua_table>())
+        {
+            if (recursionCounter >= 32)
+                throw std::runtime_error("Can not serialize more than 32 nested tables. Likely the table contains itself.");
+            sol::table table = obj;
+            sol::table res(lua, sol::create);
+            for (auto& [key, value] : table)
+                res.raw_set(copy(lua, key, customSerializer, customDeserializer, recursionCounter + 1),
+                            copy(lua, value, customSerializer, customDeserializer, recursionCounter + 1));
+            return res;
+        }
+        else if (obj.is<double>() || obj.is<std::string_view>() || obj.is<bool>())
+            return obj;  // Immutable, so can be shared.
+        else
+            throw std::runtime_error("Unknown Lua type.");
+    }
+
     sol::object deserialize(lua_State* lua, std::string_view binaryData,
                             const UserdataSerializer* customSerializer, bool readOnly)
     {
@@ -377,4 +426,12 @@ namespace LuaUtil
         return sol::stack::pop<sol::object>(lua);
     }
 
+    sol::object copy(lua_State* lua, const sol::object& obj, const UserdataSerializer* customSerializer,
+                     const UserdataSerializer* customDeserializer)
+    {
+        if (obj == sol::nil)
+            return sol::nil;
+        return copy(lua, obj, customSerializer, customDeserializer, 0);
+    }
+
 }
@@ -52,6 +52,11 @@ namespace LuaUtil
     sol::object deserialize(lua_State* lua, std::string_view binaryData,
                             const UserdataSerializer* customSerializer = nullptr, bool readOnly = false);
 
+    // Makes a deep copy of a serializable value within the same Lua state. The result is the same as
+    // `deserialize(lua, serialize(obj, customSerializer), customDeserializer)`, but without the intermediate binary data.
+    sol::object copy(lua_State* lua, const sol::object&, const UserdataSerializer* customSerializer = nullptr,
+                     const UserdataSerializer* customDeserializer = nullptr);
+
 }
 
 #endif // COMPONENTS_LUA_SERIALIZATION_H
@@ -155,6 +155,22 @@ namespace LuaUtil
         }
     }
 
+    void LuaStorage::assign(const LuaStorage& source)
+    {
+        for (auto& [_, section] : mData)
+        {
+            section->mCallbacks.clear();
+            section->mValues.clear();
+        }
+        for (const auto& [sectionName, sourceSection] : source.mData)
+        {
+            const std::shared_ptr<Section>& section = getSection(sectionName);
+            section->mPermanent = sourceSection->mPermanent;
+            for (const auto& [key, value] : sourceSection->mValues)
+                section->mValues[key] = Value(value.getCopy(mLua));
+        }
+    }
+
     void LuaStorage::load(const std::string& path)
     {
         assert(mData.empty());  // Shouldn't be used before loading
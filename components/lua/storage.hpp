@@ -18,6 +18,10 @@ namespace LuaUtil
         explicit LuaStorage(lua_State* lua) : mLua(lua) {}
 
         void clearTemporaryAndRemoveCallbacks();
+
+        // Makes this storage a copy of `source` and removes all callbacks. `source` can belong to another Lua state.
+        void assign(const LuaStorage& source);
+
         void load(const std::string& path);
         void save(const std::string& path) const;
 
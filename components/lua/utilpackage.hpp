@@ -22,7 +22,7 @@ namespace LuaUtil
     inline TransformM asTransform(const osg::Matrixf& m) { return {m}; }
     inline TransformQ asTransform(const osg::Quat& q) { return {q}; }
 
-    sol::table initUtilPackage(sol::state&);
+    sol::table initUtilPackage(sol::state_view&);
 
 }
 
@@ -8,11 +8,11 @@
 
 namespace Misc
 {
-    template <class T>
+    template <class T, class Lock = std::unique_lock<std::mutex>>
     class Locked
     {
         public:
-            Locked(std::mutex& mutex, std::remove_reference_t<T>& value)
+            Locked(typename Lock::mutex_type& mutex, std::remove_reference_t<T>& value)
                 : mLock(mutex), mValue(value)
             {}
 
@@ -32,7 +32,7 @@ namespace Misc
             }
 
         private:
-            std::unique_lock<std::mutex> mLock;
+            Lock mLock;
             std::reference_wrapper<std::remove_reference_t<T>> mValue;
     };
 
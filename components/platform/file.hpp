@@ -20,6 +20,9 @@ namespace Platform::File {
 
     Handle open(const char* filename);
 
+    /// Opens a file for writing, creating it or truncating an existing one.
+    Handle create(const char* filename);
+
     void close(Handle handle);
 
     size_t size(Handle handle);
@@ -29,6 +32,15 @@ namespace Platform::File {
 
     size_t read(Handle handle, void* data, size_t size);
 
+    /// Writes all of the data, throws if any of it can't be written.
+    void write(Handle handle, const void* data, size_t size);
+
+    /// Makes sure everything written so far has reached the storage device.
+    void sync(Handle handle);
+
+    /// Makes sure files created or renamed in the directory so far have reached the storage device.
+    void syncDirectory(const char* path);
+
     class ScopedHandle
     {
         Handle mHandle{ Handle::Invalid };
@@ -45,6 +45,22 @@ namespace Platform::File {
         return static_cast<Handle>(handle);
     }
 
+    Handle create(const char* filename)
+    {
+#ifdef O_BINARY
+        static const int openFlags = O_WRONLY | O_CREAT | O_TRUNC | O_BINARY;
+#else
+        static const int openFlags = O_WRONLY | O_CREAT | O_TRUNC;
+#endif
+
+        auto handle = ::open(filename, openFlags, 0644);
+        if (handle == -1)
+        {
+            throw std::runtime_error(std::string("Failed to open '") + filename + "' for writing: " + strerror(errno));
+        }
+        return static_cast<Handle>(handle);
+    }
+
     void close(Handle handle)
     {
         auto nativeHandle = getNativeHandle(handle);
@@ -99,4 +115,45 @@ namespace Platform::File {
         return amount;
     }
 
+    void write(Handle handle, const void* data, size_t size)
+    {
+        auto nativeHandle = getNativeHandle(handle);
+
+        const char* begin = static_cast<const char*>(data);
+        size_t written = 0;
+        while (written < size)
+        {
+            const auto amount = ::write(nativeHandle, begin + written, size - written);
+            if (amount == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error("An attempt to write " + std::to_string(size) + " bytes failed: " + strerror(errno));
+            }
+            written += static_cast<size_t>(amount);
+        }
+    }
+
+    void sync(Handle handle)
+    {
+        auto nativeHandle = getNativeHandle(handle);
+
+        if (::fsync(nativeHandle) == -1)
+        {
+            throw std::runtime_error("An fsync() call failed: " + std::string(strerror(errno)));
+        }
+    }
+
+    void syncDirectory(const char* path)
+    {
+        ScopedHandle handle(open(path));
+
+        // Some file systems can't sync directories, there is nothing more to do for them.
+        if (::fsync(getNativeHandle(handle)) == -1 && errno != EINVAL)
+        {
+            throw std::runtime_error(std::string("An fsync() call for directory '") + path + "' failed: "
+                + strerror(errno));
+        }
+    }
+
 }
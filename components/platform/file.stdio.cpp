@@ -36,6 +36,16 @@ namespace Platform::File {
         return static_cast<Handle>(reinterpret_cast<intptr_t>(handle));
     }
 
+    Handle create(const char* filename)
+    {
+        FILE* handle = fopen(filename, "wb");
+        if (handle == nullptr)
+        {
+            throw std::runtime_error(std::string("Failed to open '") + filename + "' for writing: " + strerror(errno));
+        }
+        return static_cast<Handle>(reinterpret_cast<intptr_t>(handle));
+    }
+
     void close(Handle handle)
     {
         auto nativeHandle = getNativeHandle(handle);
@@ -88,4 +98,30 @@ namespace Platform::File {
         return static_cast<size_t>(amount);
     }
 
+    void write(Handle handle, const void* data, size_t size)
+    {
+        auto nativeHandle = getNativeHandle(handle);
+
+        if (fwrite(data, 1, size, nativeHandle) != size)
+        {
+            throw std::runtime_error(std::string("An attempt to write ") + std::to_string(size) + " bytes failed: " + strerror(errno));
+        }
+    }
+
+    void sync(Handle handle)
+    {
+        auto nativeHandle = getNativeHandle(handle);
+
+        // Standard C has no way to reach the device, flushing the stream is the best it can do.
+        if (fflush(nativeHandle) != 0)
+        {
+            throw std::runtime_error(std::string("An fflush() call failed: ") + strerror(errno));
+        }
+    }
+
+    void syncDirectory(const char* /*path*/)
+    {
+        // Standard C has no notion of directories.
+    }
+
 }
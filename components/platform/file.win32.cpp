@@ -4,6 +4,7 @@
 #include <string>
 #include <stdexcept>
 #include <boost/locale.hpp>
+#include <algorithm>
 #include <cassert>
 
 namespace Platform::File {
@@ -37,6 +38,17 @@ namespace Platform::File {
         return static_cast<Handle>(reinterpret_cast<intptr_t>(handle));
     }
 
+    Handle create(const char* filename)
+    {
+        std::wstring wname = boost::locale::conv::utf_to_utf<wchar_t>(filename);
+        HANDLE handle = CreateFileW(wname.c_str(), GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error(std::string("Failed to open '") + filename + "' for writing: " + std::to_string(GetLastError()));
+        }
+        return static_cast<Handle>(reinterpret_cast<intptr_t>(handle));
+    }
+
     void close(Handle handle)
     {
         auto nativeHandle = getNativeHandle(handle);
@@ -94,4 +106,33 @@ namespace Platform::File {
 
         return bytesRead;
     }
+
+    void write(Handle handle, const void* data, size_t size)
+    {
+        auto nativeHandle = getNativeHandle(handle);
+
+        const char* begin = static_cast<const char*>(data);
+        size_t written = 0;
+        while (written < size)
+        {
+            DWORD bytesWritten{};
+            const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - written, 1 << 30));
+            if (!WriteFile(nativeHandle, begin + written, chunk, &bytesWritten, nullptr))
+                throw std::runtime_error(std::string("A write operation on a file failed: ") + std::to_string(GetLastError()));
+            written += bytesWritten;
+        }
+    }
+
+    void sync(Handle handle)
+    {
+        auto nativeHandle = getNativeHandle(handle);
+
+        if (!FlushFileBuffers(nativeHandle))
+            throw std::runtime_error(std::string("A flush operation on a file failed: ") + std::to_string(GetLastError()));
+    }
+
+    void syncDirectory(const char* /*path*/)
+    {
+        // Windows has no way to flush a directory, NTFS journals renames on its own.
+    }
 }
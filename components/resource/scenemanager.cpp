@@ -40,6 +40,7 @@
 #include <components/sceneutil/depth.hpp>
 #include <components/sceneutil/riggeometryosgaextension.hpp>
 #include <components/sceneutil/extradata.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
 #include <components/shader/shadervisitor.hpp>
 #include <components/shader/shadermanager.hpp>
@@ -347,6 +348,8 @@ namespace Resource
         , mConvertAlphaTestToAlphaToCoverage(false)
         , mSupportsNormalsRT(false)
         , mSharedStateManager(new SharedStateManager)
+        , mMainThreadId(std::this_thread::get_id())
+        , mOptimizerPassTimes(SceneUtil::Optimizer::NUM_PASSES, 0.0)
         , mImageManager(imageManager)
         , mNifFileManager(nifFileManager)
         , mMinFilter(osg::Texture::LINEAR_MIPMAP_LINEAR)
@@ -367,11 +370,12 @@ namespace Resource
         return mForceShaders;
     }
 
-    void SceneManager::recreateShaders(osg::ref_ptr<osg::Node> node, const std::string& shaderPrefix, bool forceShadersForNode, const osg::Program* programTemplate)
+    void SceneManager::recreateShaders(osg::ref_ptr<osg::Node> node, const std::string& shaderPrefix, bool forceShadersForNode, const osg::Program* programTemplate, bool instancing)
     {
         osg::ref_ptr<Shader::ShaderVisitor> shaderVisitor(createShaderVisitor(shaderPrefix));
         shaderVisitor->setAllowedToModifyStateSets(false);
         shaderVisitor->setProgramTemplate(programTemplate);
+        shaderVisitor->setInstancing(instancing);
         if (forceShadersForNode)
             shaderVisitor->setForceShaders(true);
         node->accept(*shaderVisitor);
@@ -728,6 +732,37 @@ namespace Resource
         mSharedStateMutex.unlock();
     }
 
+    class SceneManager::OptimizeTemplateWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        OptimizeTemplateWorkItem(SceneManager* sceneManager, const std::string& normalized, bool compile)
+            : mSceneManager(sceneManager)
+            , mNormalized(normalized)
+            , mCompile(compile)
+        {
+        }
+
+        void doWork() override
+        {
+            try
+            {
+                mSceneManager->getTemplate(mNormalized, mCompile);
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Error) << "Failed to optimize '" << mNormalized << "': " << e.what();
+            }
+
+            const std::lock_guard<std::mutex> lock(mSceneManager->mPendingOptimizationsMutex);
+            mSceneManager->mPendingOptimizations.erase(mNormalized);
+        }
+
+    private:
+        SceneManager* mSceneManager;
+        std::string mNormalized;
+        bool mCompile;
+    };
+
     osg::ref_ptr<const osg::Node> SceneManager::getTemplate(const std::string &name, bool compile)
     {
         std::string normalized = mVFS->normalizeFilename(name);
@@ -735,68 +770,87 @@ namespace Resource
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
         if (obj)
             return osg::ref_ptr<const osg::Node>(static_cast<osg::Node*>(obj.get()));
-        else
+
+        // The optimizer takes too long for a frame. Give the caller an unoptimized template and leave caching the
+        // optimized one to a worker thread.
+        if (mWorkQueue != nullptr && std::this_thread::get_id() == mMainThreadId && canOptimize(normalized))
         {
-            osg::ref_ptr<osg::Node> loaded;
-            try
+            bool pending = false;
             {
-                loaded = load(normalized, mVFS, mImageManager, mNifFileManager);
-
-                SceneUtil::ProcessExtraDataVisitor extraDataVisitor(this);
-                loaded->accept(extraDataVisitor);
+                const std::lock_guard<std::mutex> lock(mPendingOptimizationsMutex);
+                pending = !mPendingOptimizations.insert(normalized).second;
             }
-            catch (const std::exception& e)
-            {
-                static osg::ref_ptr<osg::Node> errorMarkerNode = [&] {
-                    static const char* const sMeshTypes[] = { "nif", "osg", "osgt", "osgb", "osgx", "osg2", "dae" };
+            if (!pending)
+                mWorkQueue->addWorkItem(new OptimizeTemplateWorkItem(this, normalized, compile));
+            return loadTemplate(name, normalized, compile, false);
+        }
 
-                    for (unsigned int i=0; i<sizeof(sMeshTypes)/sizeof(sMeshTypes[0]); ++i)
-                    {
-                        normalized = "meshes/marker_error." + std::string(sMeshTypes[i]);
-                        if (mVFS->exists(normalized))
-                            return load(normalized, mVFS, mImageManager, mNifFileManager);
-                    }
-                    Files::IMemStream file(Misc::errorMarker.data(), Misc::errorMarker.size());
-                    return loadNonNif("error_marker.osgt", file, mImageManager);
-                }();
+        osg::ref_ptr<osg::Node> loaded = loadTemplate(name, normalized, compile, true);
+        mCache->addEntryToObjectCache(normalized, loaded);
+        return loaded;
+    }
 
-                Log(Debug::Error) << "Failed to load '" << name << "': " << e.what() << ", using marker_error instead";
-                loaded = static_cast<osg::Node*>(errorMarkerNode->clone(osg::CopyOp::DEEP_COPY_ALL));
-            }
+    osg::ref_ptr<osg::Node> SceneManager::loadTemplate(const std::string& name, std::string& normalized, bool compile, bool optimize)
+    {
+        osg::ref_ptr<osg::Node> loaded;
+        try
+        {
+            loaded = load(normalized, mVFS, mImageManager, mNifFileManager);
+
+            SceneUtil::ProcessExtraDataVisitor extraDataVisitor(this);
+            loaded->accept(extraDataVisitor);
+        }
+        catch (const std::exception& e)
+        {
+            static osg::ref_ptr<osg::Node> errorMarkerNode = [&] {
+                static const char* const sMeshTypes[] = { "nif", "osg", "osgt", "osgb", "osgx", "osg2", "dae" };
 
-            // set filtering settings
-            SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsVisitor);
-            SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsControllerVisitor);
+                for (unsigned int i=0; i<sizeof(sMeshTypes)/sizeof(sMeshTypes[0]); ++i)
+                {
+                    normalized = "meshes/marker_error." + std::string(sMeshTypes[i]);
+                    if (mVFS->exists(normalized))
+                        return load(normalized, mVFS, mImageManager, mNifFileManager);
+                }
+                Files::IMemStream file(Misc::errorMarker.data(), Misc::errorMarker.size());
+                return loadNonNif("error_marker.osgt", file, mImageManager);
+            }();
 
-            SceneUtil::ReplaceDepthVisitor replaceDepthVisitor;
-            loaded->accept(replaceDepthVisitor);
+            Log(Debug::Error) << "Failed to load '" << name << "': " << e.what() << ", using marker_error instead";
+            loaded = static_cast<osg::Node*>(errorMarkerNode->clone(osg::CopyOp::DEEP_COPY_ALL));
+        }
 
-            osg::ref_ptr<Shader::ShaderVisitor> shaderVisitor (createShaderVisitor());
-            loaded->accept(*shaderVisitor);
+        // set filtering settings
+        SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+        loaded->accept(setFilterSettingsVisitor);
+        SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+        loaded->accept(setFilterSettingsControllerVisitor);
 
-            if (canOptimize(normalized))
-            {
-                SceneUtil::Optimizer optimizer;
-                optimizer.setSharedStateManager(mSharedStateManager, &mSharedStateMutex);
-                optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
+        SceneUtil::ReplaceDepthVisitor replaceDepthVisitor;
+        loaded->accept(replaceDepthVisitor);
 
-                static const unsigned int options = getOptimizationOptions()|SceneUtil::Optimizer::SHARE_DUPLICATE_STATE;
+        osg::ref_ptr<Shader::ShaderVisitor> shaderVisitor (createShaderVisitor());
+        loaded->accept(*shaderVisitor);
 
-                optimizer.optimize(loaded, options);
-            }
-            else
-                shareState(loaded);
+        if (optimize && canOptimize(normalized))
+        {
+            SceneUtil::Optimizer optimizer;
+            optimizer.setSharedStateManager(mSharedStateManager, &mSharedStateMutex);
+            optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
 
-            if (compile && mIncrementalCompileOperation)
-                mIncrementalCompileOperation->add(loaded);
-            else
-                loaded->getBound();
+            static const unsigned int options = getOptimizationOptions()|SceneUtil::Optimizer::SHARE_DUPLICATE_STATE;
 
-            mCache->addEntryToObjectCache(normalized, loaded);
-            return loaded;
+            optimizer.optimize(loaded, options);
+            addOptimizerStats(optimizer);
         }
+        else
+            shareState(loaded);
+
+        if (compile && mIncrementalCompileOperation)
+            mIncrementalCompileOperation->add(loaded);
+        else
+            loaded->getBound();
+
+        return loaded;
     }
 
     osg::ref_ptr<osg::Node> SceneManager::getInstance(const std::string& name)
@@ -858,6 +912,11 @@ namespace Resource
         mSharedStateManager->releaseGLObjects(state);
     }
 
+    void SceneManager::setWorkQueue(SceneUtil::WorkQueue* workQueue)
+    {
+        mWorkQueue = workQueue;
+    }
+
     void SceneManager::setIncrementalCompileOperation(osgUtil::IncrementalCompileOperation *ico)
     {
         mIncrementalCompileOperation = ico;
@@ -984,6 +1043,33 @@ namespace Resource
         }
 
         stats->setAttribute(frameNumber, "Node", mCache->getCacheSize());
+
+        mShaderManager->reportStats(frameNumber, *stats);
+
+        {
+            std::lock_guard<std::mutex> lock(mOptimizerStatsMutex);
+            stats->setAttribute(frameNumber, "Optimizer Runs", mOptimizerRuns);
+            stats->setAttribute(frameNumber, "Optimizer MainThread", mOptimizerMainThreadRuns);
+            // Average time per run in milliseconds
+            if (mOptimizerRuns > 0)
+                for (std::size_t i = 0; i < mOptimizerPassTimes.size(); ++i)
+                    stats->setAttribute(frameNumber,
+                        SceneUtil::Optimizer::getPassStatName(static_cast<SceneUtil::Optimizer::Pass>(i)),
+                        mOptimizerPassTimes[i] / mOptimizerRuns * 1000.0);
+        }
+    }
+
+    void SceneManager::addOptimizerStats(const SceneUtil::Optimizer& optimizer)
+    {
+        const bool mainThread = std::this_thread::get_id() == mMainThreadId;
+
+        std::lock_guard<std::mutex> lock(mOptimizerStatsMutex);
+        const SceneUtil::Optimizer::PassTimes& passTimes = optimizer.getPassTimes();
+        for (std::size_t i = 0; i < passTimes.size(); ++i)
+            mOptimizerPassTimes[i] += passTimes[i];
+        ++mOptimizerRuns;
+        if (mainThread)
+            ++mOptimizerMainThreadRuns;
     }
 
     Shader::ShaderVisitor *SceneManager::createShaderVisitor(const std::string& shaderPrefix)
@@ -5,6 +5,9 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
 
 #include <osg/ref_ptr>
 #include <osg/Node>
@@ -38,6 +41,12 @@ namespace Shader
     class ShaderVisitor;
 }
 
+namespace SceneUtil
+{
+    class Optimizer;
+    class WorkQueue;
+}
+
 namespace Resource
 {
     class TemplateRef : public osg::Object
@@ -77,7 +86,7 @@ namespace Resource
         Shader::ShaderManager& getShaderManager();
 
         /// Re-create shaders for this node, need to call this if alpha testing, texture stages or vertex color mode have changed.
-        void recreateShaders(osg::ref_ptr<osg::Node> node, const std::string& shaderPrefix = "objects", bool forceShadersForNode = false, const osg::Program* programTemplate = nullptr);
+        void recreateShaders(osg::ref_ptr<osg::Node> node, const std::string& shaderPrefix = "objects", bool forceShadersForNode = false, const osg::Program* programTemplate = nullptr, bool instancing = false);
 
         /// Applying shaders to a node may replace some fixed-function state.
         /// This restores it.
@@ -132,6 +141,8 @@ namespace Resource
         /// Get a read-only copy of this scene "template"
         /// @note If the given filename does not exist or fails to load, an error marker mesh will be used instead.
         ///  If even the error marker mesh can not be found, an exception is thrown.
+        /// @note A miss on the thread that created the SceneManager returns an unoptimized template that is not
+        ///  cached, when there is a work queue. The optimized template is cached by a worker thread instead.
         /// @note Thread safe.
         osg::ref_ptr<const osg::Node> getTemplate(const std::string& name, bool compile=true);
 
@@ -166,6 +177,10 @@ namespace Resource
         /// in cases where multiple contexts are used over the lifetime of the application.
         void releaseGLObjects(osg::State* state) override;
 
+        /// Work queue used to optimize templates the thread that created the SceneManager misses.
+        /// Without one, templates are optimized on the thread loading them.
+        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+
         /// Set up an IncrementalCompileOperation for background compiling of loaded scenes.
         void setIncrementalCompileOperation(osgUtil::IncrementalCompileOperation* ico);
 
@@ -195,6 +210,11 @@ namespace Resource
 
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
+        /// Adds the pass times of a finished optimizer to the reported stats. Runs on the thread that created
+        /// the SceneManager are counted separately as they are not hidden by the loading threads. They only happen
+        /// when there is no work queue.
+        void addOptimizerStats(const SceneUtil::Optimizer& optimizer);
+
         void setSupportsNormalsRT(bool supports) { mSupportsNormalsRT = supports; }
         bool getSupportsNormalsRT() const { return mSupportsNormalsRT; }
 
@@ -203,8 +223,14 @@ namespace Resource
 
     private:
 
+        class OptimizeTemplateWorkItem;
+
         Shader::ShaderVisitor* createShaderVisitor(const std::string& shaderPrefix = "objects");
 
+        /// Load and prepare a template without looking it up in or adding it to the cache.
+        /// @param normalized Is replaced by the error marker's name when the template fails to load.
+        osg::ref_ptr<osg::Node> loadTemplate(const std::string& name, std::string& normalized, bool compile, bool optimize);
+
         std::unique_ptr<Shader::ShaderManager> mShaderManager;
         bool mForceShaders;
         bool mClampLighting;
@@ -224,6 +250,16 @@ namespace Resource
         osg::ref_ptr<Resource::SharedStateManager> mSharedStateManager;
         mutable std::mutex mSharedStateMutex;
 
+        const std::thread::id mMainThreadId;
+        mutable std::mutex mOptimizerStatsMutex;
+        std::vector<double> mOptimizerPassTimes;
+        std::size_t mOptimizerRuns = 0;
+        std::size_t mOptimizerMainThreadRuns = 0;
+
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        std::mutex mPendingOptimizationsMutex;
+        std::set<std::string> mPendingOptimizations;
+
         Resource::ImageManager* mImageManager;
         Resource::NifFileManager* mNifFileManager;
 
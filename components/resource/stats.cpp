@@ -15,6 +15,7 @@
 #include <osgViewer/Renderer>
 
 #include <components/myguiplatform/myguidatamanager.hpp>
+#include <components/sceneutil/optimizer.hpp>
 
 #include <components/vfs/manager.hpp>
 
@@ -411,49 +412,81 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
         _resourceStatsChildNum = _switch->getNumChildren();
         _switch->addChild(group, false);
 
-        static const std::vector<std::string> statNames({
-            "FrameNumber",
-            "",
-            "Compiling",
-            "WorkQueue",
-            "WorkThread",
-            "UnrefQueue",
-            "",
-            "Texture",
-            "StateSet",
-            "Node",
-            "Shape",
-            "Shape Instance",
-            "Image",
-            "Nif",
-            "Keyframe",
-            "",
-            "Groundcover Chunk",
-            "Object Chunk",
-            "Terrain Chunk",
-            "Terrain Texture",
-            "Land",
-            "Composite",
-            "",
-            "NavMesh Jobs",
-            "NavMesh Waiting",
-            "NavMesh Pushed",
-            "NavMesh Processing",
-            "NavMesh DbJobs",
-            "NavMesh DbCacheHitRate",
-            "NavMesh CacheSize",
-            "NavMesh UsedTiles",
-            "NavMesh CachedTiles",
-            "NavMesh CacheHitRate",
-            "",
-            "Mechanics Actors",
-            "Mechanics Objects",
-            "",
-            "Physics Actors",
-            "Physics Objects",
-            "Physics Projectiles",
-            "Physics HeightFields",
-        });
+        static const std::vector<std::string> statNames = [] {
+            std::vector<std::string> names({
+                "FrameNumber",
+                "",
+                "Compiling",
+                "WorkQueue",
+                "WorkThread",
+                "UnrefQueue",
+                "",
+                "Texture",
+                "StateSet",
+                "Node",
+                "Shape",
+                "Shape Instance",
+                "Image",
+                "Nif",
+                "Keyframe",
+                "Shader Template",
+                "Shader Permutation",
+                "Shader CacheHitRate",
+                "Shader Cached Source",
+                "Optimizer Runs",
+                "Optimizer MainThread",
+            });
+            for (unsigned int pass = 0; pass < SceneUtil::Optimizer::NUM_PASSES; ++pass)
+                names.push_back(SceneUtil::Optimizer::getPassStatName(static_cast<SceneUtil::Optimizer::Pass>(pass)));
+            names.insert(names.end(), {
+                "",
+                "Groundcover Chunk",
+                "Groundcover Refs",
+                "Object Chunk",
+                "Object Refs",
+                "Object Chunk Draws",
+                "Object Chunk Vertex Memory",
+                "Object Chunk Build Time",
+                "Terrain Chunk",
+                "Terrain Vertices",
+                "Terrain Texture",
+                "Land",
+                "Composite",
+                "Terrain Traversal",
+                "Terrain Nodes Evaluated",
+                "Terrain Nodes Reused",
+                "",
+                "NavMesh Jobs",
+                "NavMesh Waiting",
+                "NavMesh Pushed",
+                "NavMesh Processing",
+                "NavMesh DbJobs",
+                "NavMesh DbCacheHitRate",
+                "NavMesh CacheSize",
+                "NavMesh UsedTiles",
+                "NavMesh CachedTiles",
+                "NavMesh ReusedTiles",
+                "NavMesh CacheHitRate",
+                "NavMesh PathJobs",
+                "NavMesh PathRequests",
+                "NavMesh PathCoalesced",
+                "NavMesh PathCacheHits",
+                "NavMesh PathCacheSize",
+                "NavMesh PathQueueLatency",
+                "",
+                "Mechanics Actors",
+                "Mechanics Objects",
+                "",
+                "Physics Actors",
+                "Physics Objects",
+                "Physics Projectiles",
+                "Physics HeightFields",
+                "",
+                "Save Snapshot",
+                "Save Write",
+            });
+            return names;
+        }();
 
         static const auto longest = std::max_element(statNames.begin(), statNames.end(),
             [] (const std::string& lhs, const std::string& rhs) { return lhs.size() < rhs.size(); });
@@ -54,6 +54,25 @@ void Optimizer::reset()
 {
 }
 
+const char* Optimizer::getPassName(Pass pass)
+{
+    // indexed by Pass
+    static const char* const names[NUM_PASSES] = {
+        "FlattenTransforms",
+        "ShareState",
+        "RemoveNodes",
+        "MergeGeometry",
+        "VertexPostTransform",
+        "VertexPreTransform",
+    };
+    return names[pass];
+}
+
+std::string Optimizer::getPassStatName(Pass pass)
+{
+    return std::string("Optimizer ") + getPassName(pass);
+}
+
 void Optimizer::optimize(osg::Node* node, unsigned int options)
 {
     StatsVisitor stats;
@@ -66,91 +85,114 @@ void Optimizer::optimize(osg::Node* node, unsigned int options)
         stats.print(osg::notify(osg::NOTICE));
     }
 
-    if (options & FLATTEN_STATIC_TRANSFORMS)
+    struct PassEntry
     {
-        OSG_INFO<<"Optimizer::optimize() doing FLATTEN_STATIC_TRANSFORMS"<<std::endl;
-
-        int i=0;
-        bool result = false;
-        do
-        {
-            OSG_DEBUG << "** RemoveStaticTransformsVisitor *** Pass "<<i<<std::endl;
-            FlattenStaticTransformsVisitor fstv(this);
-            node->accept(fstv);
-            result = fstv.removeTransforms(node);
-            ++i;
-        } while (result);
-
-        // now combine any adjacent static transforms.
-        CombineStaticTransformsVisitor cstv(this);
-        node->accept(cstv);
-        cstv.removeTransforms(node);
-    }
-
-    if (options & SHARE_DUPLICATE_STATE && _sharedStateManager)
+        unsigned int _option;
+        void (Optimizer::*_run)(osg::Node*);
+    };
+
+    // indexed by Pass
+    static const PassEntry passes[NUM_PASSES] = {
+        { FLATTEN_STATIC_TRANSFORMS, &Optimizer::flattenStaticTransforms },
+        { SHARE_DUPLICATE_STATE, &Optimizer::shareDuplicateState },
+        { REMOVE_REDUNDANT_NODES, &Optimizer::removeRedundantNodes },
+        { MERGE_GEOMETRY, &Optimizer::mergeGeometry },
+        { VERTEX_POSTTRANSFORM, &Optimizer::vertexPostTransform },
+        { VERTEX_PRETRANSFORM, &Optimizer::vertexPreTransform },
+    };
+
+    osg::Timer* timer = osg::Timer::instance();
+    for (unsigned int pass=0; pass<NUM_PASSES; ++pass)
     {
-        if (_sharedStateMutex) _sharedStateMutex->lock();
-        _sharedStateManager->share(node);
-        if (_sharedStateMutex) _sharedStateMutex->unlock();
-    }
+        const PassEntry& entry = passes[pass];
+        if (!(options & entry._option))
+            continue;
 
-    if (options & REMOVE_REDUNDANT_NODES)
-    {
-        OSG_INFO<<"Optimizer::optimize() doing REMOVE_REDUNDANT_NODES"<<std::endl;
+        const char* name = getPassName(static_cast<Pass>(pass));
+        OSG_INFO<<"Optimizer::optimize() doing "<<name<<std::endl;
 
-        RemoveEmptyNodesVisitor renv(this);
-        node->accept(renv);
-        renv.removeEmptyNodes();
+        osg::Timer_t startTick = timer->tick();
+        (this->*entry._run)(node);
+        double duration = timer->delta_s(startTick, timer->tick());
+        _passTimes[pass] += duration;
 
-        RemoveRedundantNodesVisitor rrnv(this);
-        node->accept(rrnv);
-        rrnv.removeRedundantNodes();
+        OSG_INFO<<name<<" took "<<duration<<std::endl;
+    }
 
-        MergeGroupsVisitor mgrp(this);
-        node->accept(mgrp);
+    if (osg::getNotifyLevel()>=osg::INFO)
+    {
+        stats.reset();
+        node->accept(stats);
+        stats.totalUpStats();
+        OSG_NOTICE<<std::endl<<"Stats after:"<<std::endl;
+        stats.print(osg::notify(osg::NOTICE));
     }
+}
 
-    if (options & MERGE_GEOMETRY)
+void Optimizer::flattenStaticTransforms(osg::Node* node)
+{
+    int i=0;
+    bool result = false;
+    do
     {
-        OSG_INFO<<"Optimizer::optimize() doing MERGE_GEOMETRY"<<std::endl;
+        OSG_DEBUG << "** RemoveStaticTransformsVisitor *** Pass "<<i<<std::endl;
+        FlattenStaticTransformsVisitor fstv(this);
+        node->accept(fstv);
+        result = fstv.removeTransforms(node);
+        ++i;
+    } while (result);
+
+    // now combine any adjacent static transforms.
+    CombineStaticTransformsVisitor cstv(this);
+    node->accept(cstv);
+    cstv.removeTransforms(node);
+}
 
-        osg::Timer_t startTick = osg::Timer::instance()->tick();
+void Optimizer::shareDuplicateState(osg::Node* node)
+{
+    if (!_sharedStateManager)
+        return;
 
-        MergeGeometryVisitor mgv(this);
-        mgv.setTargetMaximumNumberOfVertices(1000000);
-        mgv.setMergeAlphaBlending(_mergeAlphaBlending);
-        mgv.setViewPoint(_viewPoint);
-        node->accept(mgv);
+    if (_sharedStateMutex) _sharedStateMutex->lock();
+    _sharedStateManager->share(node);
+    if (_sharedStateMutex) _sharedStateMutex->unlock();
+}
 
-        osg::Timer_t endTick = osg::Timer::instance()->tick();
+void Optimizer::removeRedundantNodes(osg::Node* node)
+{
+    RemoveEmptyNodesVisitor renv(this);
+    node->accept(renv);
+    renv.removeEmptyNodes();
 
-        OSG_INFO<<"MERGE_GEOMETRY took "<<osg::Timer::instance()->delta_s(startTick,endTick)<<std::endl;
-    }
+    RemoveRedundantNodesVisitor rrnv(this);
+    node->accept(rrnv);
+    rrnv.removeRedundantNodes();
 
-    if (options & VERTEX_POSTTRANSFORM)
-    {
-        OSG_INFO<<"Optimizer::optimize() doing VERTEX_POSTTRANSFORM"<<std::endl;
-        VertexCacheVisitor vcv;
-        node->accept(vcv);
-        vcv.optimizeVertices();
-    }
+    MergeGroupsVisitor mgrp(this);
+    node->accept(mgrp);
+}
 
-    if (options & VERTEX_PRETRANSFORM)
-    {
-        OSG_INFO<<"Optimizer::optimize() doing VERTEX_PRETRANSFORM"<<std::endl;
-        VertexAccessOrderVisitor vaov;
-        node->accept(vaov);
-        vaov.optimizeOrder();
-    }
+void Optimizer::mergeGeometry(osg::Node* node)
+{
+    MergeGeometryVisitor mgv(this);
+    mgv.setTargetMaximumNumberOfVertices(1000000);
+    mgv.setMergeAlphaBlending(_mergeAlphaBlending);
+    mgv.setViewPoint(_viewPoint);
+    node->accept(mgv);
+}
 
-    if (osg::getNotifyLevel()>=osg::INFO)
-    {
-        stats.reset();
-        node->accept(stats);
-        stats.totalUpStats();
-        OSG_NOTICE<<std::endl<<"Stats after:"<<std::endl;
-        stats.print(osg::notify(osg::NOTICE));
-    }
+void Optimizer::vertexPostTransform(osg::Node* node)
+{
+    VertexCacheVisitor vcv;
+    node->accept(vcv);
+    vcv.optimizeVertices();
+}
+
+void Optimizer::vertexPreTransform(osg::Node* node)
+{
+    VertexAccessOrderVisitor vaov;
+    node->accept(vaov);
+    vaov.optimizeOrder();
 }
 
 
@@ -648,6 +690,51 @@ osg::Array* cloneArray(osg::Array* array, osg::VertexBufferObject*& vbo, const o
     return array;
 }
 
+osg::Array* reserveArray(osg::Array* array, unsigned int numElements, osg::VertexBufferObject*& vbo, const osg::Geometry* geom)
+{
+    if (!array || array->getBinding()==osg::Array::BIND_OVERALL)
+        return array;
+    if (array->referenceCount() > 1)
+        array = cloneArray(array, vbo, geom);
+    array->reserveArray(numElements);
+    return array;
+}
+
+/// Size the arrays of the geometry the others are merged into for all of them up front,
+/// so that merging appends into contiguous storage instead of reallocating it per merged geometry.
+template <class Iterator>
+void reserveMergedGeometry(osg::Geometry& lhs, Iterator begin, Iterator end)
+{
+    unsigned int numVertices = 0;
+    std::size_t numPrimitiveSets = 0;
+    for (Iterator itr = begin; itr != end; ++itr)
+    {
+        const osg::Geometry& geom = **itr;
+        numVertices += geom.getVertexArray() ? geom.getVertexArray()->getNumElements() : 0;
+        numPrimitiveSets += geom.getNumPrimitiveSets();
+    }
+
+    osg::VertexBufferObject* vbo = nullptr;
+    if (osg::Array* array = lhs.getVertexArray())
+        lhs.setVertexArray(reserveArray(array, numVertices, vbo, &lhs));
+    if (osg::Array* array = lhs.getNormalArray())
+        lhs.setNormalArray(reserveArray(array, numVertices, vbo, &lhs));
+    if (osg::Array* array = lhs.getColorArray())
+        lhs.setColorArray(reserveArray(array, numVertices, vbo, &lhs));
+    if (osg::Array* array = lhs.getSecondaryColorArray())
+        lhs.setSecondaryColorArray(reserveArray(array, numVertices, vbo, &lhs));
+    if (osg::Array* array = lhs.getFogCoordArray())
+        lhs.setFogCoordArray(reserveArray(array, numVertices, vbo, &lhs));
+    for (unsigned int unit=0; unit<lhs.getNumTexCoordArrays(); ++unit)
+        if (osg::Array* array = lhs.getTexCoordArray(unit))
+            lhs.setTexCoordArray(unit, reserveArray(array, numVertices, vbo, &lhs));
+    for (unsigned int unit=0; unit<lhs.getNumVertexAttribArrays(); ++unit)
+        if (osg::Array* array = lhs.getVertexAttribArray(unit))
+            lhs.setVertexAttribArray(unit, reserveArray(array, numVertices, vbo, &lhs));
+
+    lhs.getPrimitiveSetList().reserve(numPrimitiveSets);
+}
+
 void Optimizer::FlattenStaticTransformsVisitor::apply(osg::Geometry& geometry)
 {
     if(isOperationPermissibleForObject(&geometry))
@@ -1380,6 +1467,8 @@ bool Optimizer::MergeGeometryVisitor::mergeGroup(osg::Group& group)
                     DuplicateList::iterator ditr = duplicateList.begin();
                     osg::ref_ptr<osg::Geometry> lhs = *ditr++;
                     group.addChild(lhs.get());
+                    if (duplicateList.size() > 1)
+                        reserveMergedGeometry(*lhs, duplicateList.begin(), duplicateList.end());
                     for(;
                         ditr != duplicateList.end();
                         ++ditr)
@@ -1480,6 +1569,16 @@ bool Optimizer::MergeGeometryVisitor::mergeGroup(osg::Group& group)
                         lhs = clonePrimitive(lhs, ebo, geom);
                         primitives[lhsNo] = lhs;
 
+                        // reserve indices for the whole run of primitives to be combined with lhs at once
+                        osg::DrawElements* elements = lhs->getDrawElements();
+                        if (elements && rhsNo==lhsNo+1)
+                        {
+                            unsigned int numIndices = 0;
+                            for (unsigned int i=lhsNo; i<primitives.size() && primitives[i]->getType()==lhs->getType() && primitives[i]->getMode()==lhs->getMode(); ++i)
+                                numIndices += primitives[i]->getNumIndices();
+                            elements->reserveElements(numIndices);
+                        }
+
                         switch(lhs->getType())
                         {
                         case(osg::PrimitiveSet::DrawArraysPrimitiveType):
@@ -24,6 +24,8 @@
 
 //#include <osgUtil/Export>
 
+#include <array>
+#include <string>
 #include <set>
 #include <mutex>
 
@@ -129,6 +131,29 @@ class Optimizer
 
         void setSharedStateManager(osgDB::SharedStateManager* sharedStateManager, std::mutex* sharedStateMutex) { _sharedStateMutex = sharedStateMutex; _sharedStateManager = sharedStateManager; }
 
+        /** Passes run by optimize(), in the order they are run.*/
+        enum Pass
+        {
+            FLATTEN_STATIC_TRANSFORMS_PASS,
+            SHARE_DUPLICATE_STATE_PASS,
+            REMOVE_REDUNDANT_NODES_PASS,
+            MERGE_GEOMETRY_PASS,
+            VERTEX_POSTTRANSFORM_PASS,
+            VERTEX_PRETRANSFORM_PASS,
+            NUM_PASSES
+        };
+
+        /** Short name of a Pass, used in log messages.*/
+        static const char* getPassName(Pass pass);
+
+        /** Name of the profiler stat reporting time spent in a Pass.*/
+        static std::string getPassStatName(Pass pass);
+
+        /** Seconds spent in each Pass, summed over all optimize() calls.*/
+        typedef std::array<double, NUM_PASSES> PassTimes;
+
+        const PassTimes& getPassTimes() const { return _passTimes; }
+
         /** Reset internal data to initial state - the getPermissibleOptionsMap is cleared.*/
         void reset();
 
@@ -269,6 +294,15 @@ class Optimizer
         osgDB::SharedStateManager* _sharedStateManager;
         mutable std::mutex* _sharedStateMutex;
 
+        PassTimes _passTimes = {};
+
+        void flattenStaticTransforms(osg::Node* node);
+        void shareDuplicateState(osg::Node* node);
+        void removeRedundantNodes(osg::Node* node);
+        void mergeGeometry(osg::Node* node);
+        void vertexPostTransform(osg::Node* node);
+        void vertexPreTransform(osg::Node* node);
+
     public:
 
         /** Flatten Static Transform nodes by applying their transform to the
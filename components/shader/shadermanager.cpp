@@ -2,18 +2,214 @@
 
 #include <fstream>
 #include <algorithm>
+#include <chrono>
 #include <sstream>
 #include <regex>
 #include <filesystem>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <thread>
 
 #include <osg/Program>
+#include <osg/Stats>
 
 #include <components/debug/debuglog.hpp>
+#include <components/misc/hash.hpp>
 #include <components/misc/stringops.hpp>
 #include <components/settings/settings.hpp>
 
 namespace Shader
 {
+    namespace
+    {
+        constexpr std::string_view sourceCacheFormat = "OpenMW preprocessed shader 2";
+
+        // Cache files are read before their key is checked so sizes stored in them are not trusted
+        constexpr std::size_t maxSourceCacheStringSize = 16 * 1024 * 1024;
+        constexpr std::size_t maxSourceCacheListSize = 1024;
+
+        // Files not used for this long are removed, then the least recently used ones until the rest fits the size
+        constexpr std::chrono::hours maxSourceCacheFileAge(24 * 30);
+        constexpr std::uintmax_t maxSourceCacheSize = 64 * 1024 * 1024;
+
+        std::size_t getPermutationHash(const std::string& templateName, const ShaderManager::DefineMap& defines)
+        {
+            // DefineMap is ordered so equal sets of defines give the same hash
+            std::size_t result = std::hash<std::string>()(templateName);
+            for (const auto& [name, value] : defines)
+            {
+                Misc::hashCombine(result, name);
+                Misc::hashCombine(result, value);
+            }
+            return result;
+        }
+
+        void writeString(std::ostream& stream, std::string_view value)
+        {
+            stream << value.size() << '\n' << value << '\n';
+        }
+
+        bool readString(std::istream& stream, std::string& value)
+        {
+            std::size_t size = 0;
+            if (!(stream >> size) || size > maxSourceCacheStringSize || stream.get() != '\n')
+                return false;
+            value.resize(size);
+            return stream.read(value.data(), static_cast<std::streamsize>(size)) && stream.get() == '\n';
+        }
+
+        void writeDefines(std::ostream& stream, const ShaderManager::DefineMap& defines)
+        {
+            stream << defines.size() << '\n';
+            for (const auto& [name, value] : defines)
+            {
+                writeString(stream, name);
+                writeString(stream, value);
+            }
+        }
+
+        // Everything the preprocessed source depends on besides the content of template files
+        std::string makeSourceCacheKey(const std::filesystem::path& shaderPath, const std::string& templateName,
+            const ShaderManager::DefineMap& defines, const ShaderManager::DefineMap& globalDefines)
+        {
+            std::ostringstream stream;
+            writeString(stream, sourceCacheFormat);
+            writeString(stream, shaderPath.string());
+            writeString(stream, templateName);
+            writeDefines(stream, defines);
+            writeDefines(stream, globalDefines);
+            return stream.str();
+        }
+
+        std::filesystem::path getSourceCacheFilePath(const std::filesystem::path& cachePath, const std::string& key)
+        {
+            // The key is stored in the file so a hash collision gives only a miss
+            return cachePath / Misc::StringUtils::format("%016zx.glsl", std::hash<std::string>()(key));
+        }
+
+        std::optional<std::pair<std::uintmax_t, std::int64_t>> getFileStamp(const std::filesystem::path& path)
+        {
+            std::error_code ec;
+            const std::uintmax_t size = std::filesystem::file_size(path, ec);
+            if (ec)
+                return {};
+            const auto writeTime = std::filesystem::last_write_time(path, ec);
+            if (ec)
+                return {};
+            return std::make_pair(size, static_cast<std::int64_t>(writeTime.time_since_epoch().count()));
+        }
+
+        std::filesystem::path getCanonicalPath(const std::filesystem::path& path)
+        {
+            std::error_code ec;
+            std::filesystem::path result = std::filesystem::weakly_canonical(path, ec);
+            if (ec)
+                return std::filesystem::absolute(path, ec).lexically_normal();
+            return result;
+        }
+
+        bool isInDirectory(const std::filesystem::path& file, const std::filesystem::path& directory)
+        {
+            const std::filesystem::path relative = file.lexically_relative(directory);
+            return !relative.empty() && *relative.begin() != "..";
+        }
+
+        bool readSourceCache(const std::filesystem::path& path, const std::string& key,
+            const std::filesystem::path& shaderPath, std::string& source, std::vector<std::string>& linkedShaderTemplateNames)
+        {
+            std::ifstream stream(path, std::ios::binary);
+            if (!stream)
+                return false;
+
+            std::string storedKey;
+            if (!readString(stream, storedKey) || storedKey != key)
+                return false;
+
+            std::size_t filesCount = 0;
+            if (!(stream >> filesCount) || filesCount > maxSourceCacheListSize || stream.get() != '\n')
+                return false;
+            for (std::size_t i = 0; i < filesCount; ++i)
+            {
+                std::string file;
+                std::uintmax_t size = 0;
+                std::int64_t writeTime = 0;
+                if (!readString(stream, file) || !(stream >> size >> writeTime) || stream.get() != '\n')
+                    return false;
+                if (!isInDirectory(getCanonicalPath(file), shaderPath))
+                    return false;
+                if (getFileStamp(std::filesystem::path(file)) != std::make_pair(size, writeTime))
+                    return false;
+            }
+
+            std::size_t linkedCount = 0;
+            if (!(stream >> linkedCount) || linkedCount > maxSourceCacheListSize || stream.get() != '\n')
+                return false;
+            std::vector<std::string> linked(linkedCount);
+            for (std::string& name : linked)
+                if (!readString(stream, name))
+                    return false;
+
+            if (!readString(stream, source))
+                return false;
+
+            linkedShaderTemplateNames = std::move(linked);
+            return true;
+        }
+
+        void pruneSourceCache(const std::filesystem::path& cachePath)
+        {
+            struct CacheFile
+            {
+                std::filesystem::path mPath;
+                std::uintmax_t mSize;
+                std::filesystem::file_time_type mWriteTime;
+            };
+
+            const auto now = std::filesystem::file_time_type::clock::now();
+            std::vector<CacheFile> files;
+            std::uintmax_t totalSize = 0;
+            std::error_code ec;
+            for (std::filesystem::directory_iterator it(cachePath, ec), end; !ec && it != end; it.increment(ec))
+            {
+                const std::filesystem::directory_entry& entry = *it;
+                const std::filesystem::path& path = entry.path();
+                if (path.extension() != ".glsl" && path.extension() != ".tmp")
+                    continue;
+                std::error_code entryEc;
+                const std::uintmax_t size = entry.file_size(entryEc);
+                if (entryEc)
+                    continue;
+                const std::filesystem::file_time_type writeTime = entry.last_write_time(entryEc);
+                if (entryEc)
+                    continue;
+                // Temporary files of a running process are renamed right after being written
+                if (now - writeTime > maxSourceCacheFileAge
+                    || (path.extension() == ".tmp" && now - writeTime > std::chrono::hours(1)))
+                {
+                    std::filesystem::remove(path, entryEc);
+                    continue;
+                }
+                if (path.extension() == ".tmp")
+                    continue;
+                files.push_back(CacheFile {path, size, writeTime});
+                totalSize += size;
+            }
+
+            if (totalSize <= maxSourceCacheSize)
+                return;
+
+            std::sort(files.begin(), files.end(),
+                [] (const CacheFile& l, const CacheFile& r) { return l.mWriteTime < r.mWriteTime; });
+            for (const CacheFile& file : files)
+            {
+                if (totalSize <= maxSourceCacheSize)
+                    break;
+                if (std::filesystem::remove(file.mPath, ec))
+                    totalSize -= file.mSize;
+            }
+        }
+    }
 
     ShaderManager::ShaderManager()
     {
@@ -22,6 +218,23 @@ namespace Shader
     void ShaderManager::setShaderPath(const std::string &path)
     {
         mPath = path;
+        mCanonicalPath = getCanonicalPath(path);
+    }
+
+    void ShaderManager::setSourceCachePath(const std::string& path)
+    {
+        mSourceCachePath.clear();
+        if (path.empty())
+            return;
+        std::error_code ec;
+        std::filesystem::create_directories(path, ec);
+        if (ec)
+        {
+            Log(Debug::Warning) << "Failed to create shader source cache directory " << path << ": " << ec.message();
+            return;
+        }
+        pruneSourceCache(path);
+        mSourceCachePath = path;
     }
 
     bool addLineDirectivesAfterConditionalBlocks(std::string& source)
@@ -68,7 +281,8 @@ namespace Shader
     // Recursively replaces include statements with the actual source of the included files.
     // Adjusts #line statements accordingly and detects cyclic includes.
     // includingFiles is the set of files that include this file directly or indirectly, and is intentionally not a reference to allow automatic cleanup.
-    static bool parseIncludes(const std::filesystem::path& shaderPath, std::string& source, const std::string& fileName, int& fileNumber, std::set<std::filesystem::path> includingFiles)
+    // Paths of all opened files are added to includedFiles.
+    static bool parseIncludes(const std::filesystem::path& shaderPath, std::string& source, const std::string& fileName, int& fileNumber, std::set<std::filesystem::path> includingFiles, std::vector<std::filesystem::path>& includedFiles)
     {
         // An include is cyclic if it is being included by itself
         if (includingFiles.insert(shaderPath/fileName).second == false)
@@ -123,12 +337,13 @@ namespace Shader
                 return false;
             }
             int includedFileNumber = fileNumber++;
+            includedFiles.push_back(includePath);
 
             std::stringstream buffer;
             buffer << includeFstream.rdbuf();
             std::string stringRepresentation = buffer.str();
             if (!addLineDirectivesAfterConditionalBlocks(stringRepresentation)
-                || !parseIncludes(shaderPath, stringRepresentation, includeFilename, fileNumber, includingFiles))
+                || !parseIncludes(shaderPath, stringRepresentation, includeFilename, fileNumber, includingFiles, includedFiles))
             {
                 Log(Debug::Error) << "In file included from " << fileName << "." << lineNumber;
                 return false;
@@ -355,9 +570,9 @@ namespace Shader
         return true;
     }
 
-    osg::ref_ptr<osg::Shader> ShaderManager::getShader(const std::string &templateName, const ShaderManager::DefineMap &defines, osg::Shader::Type shaderType)
+    const ShaderManager::Template* ShaderManager::getTemplate(const std::string& templateName)
     {
-        std::unique_lock<std::mutex> lock(mMutex);
+        const std::lock_guard<std::mutex> lock(mTemplatesMutex);
 
         // read the template if we haven't already
         TemplateMap::iterator templateIt = mShaderTemplates.find(templateName);
@@ -377,39 +592,143 @@ namespace Shader
             // parse includes
             int fileNumber = 1;
             std::string source = buffer.str();
+            std::vector<std::filesystem::path> files {path};
             if (!addLineDirectivesAfterConditionalBlocks(source)
-                || !parseIncludes(std::filesystem::path(mPath), source, templateName, fileNumber, {}))
+                || !parseIncludes(std::filesystem::path(mPath), source, templateName, fileNumber, {}, files))
                 return nullptr;
 
-            templateIt = mShaderTemplates.insert(std::make_pair(templateName, source)).first;
+            Template value {std::move(source), {}};
+            for (const std::filesystem::path& file : files)
+                if (const auto stamp = getFileStamp(file))
+                    value.mFiles.push_back(TemplateFile {file, stamp->first, stamp->second});
+
+            templateIt = mShaderTemplates.emplace(templateName, std::move(value)).first;
         }
 
-        ShaderMap::iterator shaderIt = mShaders.find(std::make_pair(templateName, defines));
-        if (shaderIt == mShaders.end())
+        // Templates are never removed so the pointer stays valid
+        return &templateIt->second;
+    }
+
+    bool ShaderManager::createSource(std::string& source, std::vector<std::string>& linkedShaderTemplateNames,
+        const std::string& templateName, const DefineMap& defines)
+    {
+        std::string cacheKey;
+        std::filesystem::path cacheFilePath;
+        if (!mSourceCachePath.empty())
         {
-            std::string shaderSource = templateIt->second;
-            std::vector<std::string> linkedShaderNames;
-            if (!createSourceFromTemplate(shaderSource, linkedShaderNames, templateName, defines))
+            cacheKey = makeSourceCacheKey(mCanonicalPath, templateName, defines, mGlobalDefines);
+            cacheFilePath = getSourceCacheFilePath(mSourceCachePath, cacheKey);
+            if (readSourceCache(cacheFilePath, cacheKey, mCanonicalPath, source, linkedShaderTemplateNames))
             {
-                // Add to the cache anyway to avoid logging the same error over and over.
-                mShaders.insert(std::make_pair(std::make_pair(templateName, defines), nullptr));
-                return nullptr;
+                // Write time tells which files are used when the cache is pruned
+                std::error_code ec;
+                std::filesystem::last_write_time(cacheFilePath, std::filesystem::file_time_type::clock::now(), ec);
+                ++mSourceCacheHits;
+                return true;
+            }
+            linkedShaderTemplateNames.clear();
+        }
+
+        const Template* const shaderTemplate = getTemplate(templateName);
+        if (shaderTemplate == nullptr)
+            return false;
+
+        source = shaderTemplate->mSource;
+        if (!createSourceFromTemplate(source, linkedShaderTemplateNames, templateName, defines))
+            return false;
+
+        if (cacheFilePath.empty())
+            return true;
+
+        // Write to a temporary file first so other threads and processes never read a partially written source
+        std::filesystem::path tmpPath = cacheFilePath;
+        tmpPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+        {
+            std::ofstream stream(tmpPath, std::ios::binary);
+            writeString(stream, cacheKey);
+            stream << shaderTemplate->mFiles.size() << '\n';
+            for (const TemplateFile& file : shaderTemplate->mFiles)
+            {
+                writeString(stream, getCanonicalPath(file.mPath).string());
+                stream << file.mSize << ' ' << file.mWriteTime << '\n';
+            }
+            stream << linkedShaderTemplateNames.size() << '\n';
+            for (const std::string& name : linkedShaderTemplateNames)
+                writeString(stream, name);
+            writeString(stream, source);
+            if (!stream)
+            {
+                Log(Debug::Warning) << "Failed to write shader source cache file " << tmpPath.string();
+                return true;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, cacheFilePath, ec);
+        if (ec)
+        {
+            Log(Debug::Warning) << "Failed to write shader source cache file " << cacheFilePath.string() << ": " << ec.message();
+            std::filesystem::remove(tmpPath, ec);
+        }
+
+        return true;
+    }
+
+    osg::ref_ptr<osg::Shader> ShaderManager::getShader(const std::string &templateName, const ShaderManager::DefineMap &defines, osg::Shader::Type shaderType)
+    {
+        const std::size_t hash = getPermutationHash(templateName, defines);
+        Shard& shard = mShards[hash % mShards.size()];
+
+        const auto find = [&] () -> const Permutation*
+        {
+            const auto [begin, end] = shard.mPermutations.equal_range(hash);
+            const auto it = std::find_if(begin, end, [&] (const auto& v)
+            {
+                return v.second.mTemplateName == templateName && v.second.mDefines == defines;
+            });
+            return it == end ? nullptr : &it->second;
+        };
+
+        {
+            const std::lock_guard<std::mutex> lock(shard.mMutex);
+            ++shard.mRequests;
+            if (const Permutation* const permutation = find())
+            {
+                ++shard.mHits;
+                return permutation->mShader;
             }
+        }
 
-            osg::ref_ptr<osg::Shader> shader (new osg::Shader(shaderType));
-            shader->setShaderSource(shaderSource);
-            // Assign a unique prefix to allow the SharedStateManager to compare shaders efficiently.
-            // Append shader source filename for debugging.
-            static unsigned int counter = 0;
-            shader->setName(Misc::StringUtils::format("%u %s", counter++, templateName));
+        std::string shaderSource;
+        std::vector<std::string> linkedShaderNames;
+        if (!createSource(shaderSource, linkedShaderNames, templateName, defines))
+        {
+            // Add to the cache anyway to avoid logging the same error over and over.
+            const std::lock_guard<std::mutex> lock(shard.mMutex);
+            if (const Permutation* const permutation = find())
+                return permutation->mShader;
+            shard.mPermutations.emplace(hash, Permutation {templateName, defines, nullptr});
+            return nullptr;
+        }
 
-            lock.unlock();
-            getLinkedShaders(shader, linkedShaderNames, defines);
-            lock.lock();
+        osg::ref_ptr<osg::Shader> shader (new osg::Shader(shaderType));
+        shader->setShaderSource(shaderSource);
+        // Assign a unique prefix to allow the SharedStateManager to compare shaders efficiently.
+        // Append shader source filename for debugging.
+        static std::atomic<unsigned int> counter {0};
+        shader->setName(Misc::StringUtils::format("%u %s", counter++, templateName));
 
-            shaderIt = mShaders.insert(std::make_pair(std::make_pair(templateName, defines), shader)).first;
+        getLinkedShaders(shader, linkedShaderNames, defines);
+
+        const std::lock_guard<std::mutex> lock(shard.mMutex);
+        // Another thread could create the same shader meanwhile, keep the first one to share state sets
+        if (const Permutation* const permutation = find())
+        {
+            const std::lock_guard<std::mutex> linkedLock(mMutex);
+            mLinkedShaders.erase(shader);
+            return permutation->mShader;
         }
-        return shaderIt->second;
+        shard.mPermutations.emplace(hash, Permutation {templateName, defines, shader});
+        return shader;
     }
 
     osg::ref_ptr<osg::Program> ShaderManager::getProgram(osg::ref_ptr<osg::Shader> vertexShader, osg::ref_ptr<osg::Shader> fragmentShader, const osg::Program* programTemplate)
@@ -446,33 +765,44 @@ namespace Shader
     void ShaderManager::setGlobalDefines(DefineMap & globalDefines)
     {
         mGlobalDefines = globalDefines;
-        for (const auto& [key, shader]: mShaders)
-        {
-            std::string templateId = key.first;
-            ShaderManager::DefineMap defines = key.second;
-            if (shader == nullptr)
-                // I'm not sure how to handle a shader that was already broken as there's no way to get a potential replacement to the nodes that need it.
-                continue;
-            std::string shaderSource = mShaderTemplates[templateId];
-            std::vector<std::string> linkedShaderNames;
-            if (!createSourceFromTemplate(shaderSource, linkedShaderNames, templateId, defines))
-                // We just broke the shader and there's no way to force existing objects back to fixed-function mode as we would when creating the shader.
-                // If we put a nullptr in the shader map, we just lose the ability to put a working one in later.
-                continue;
-            shader->setShaderSource(shaderSource);
-
-            getLinkedShaders(shader, linkedShaderNames, defines);
+        for (Shard& shard : mShards)
+        {
+            std::vector<std::pair<const Permutation*, osg::ref_ptr<osg::Shader>>> shaders;
+            {
+                const std::lock_guard<std::mutex> lock(shard.mMutex);
+                for (const auto& [hash, permutation] : shard.mPermutations)
+                    if (permutation.mShader != nullptr)
+                        shaders.emplace_back(&permutation, permutation.mShader);
+                    // I'm not sure how to handle a shader that was already broken as there's no way to get a potential replacement to the nodes that need it.
+            }
+            // Permutations are never removed and getLinkedShaders may add new ones to this shard
+            for (const auto& [permutation, shader] : shaders)
+            {
+                std::string shaderSource;
+                std::vector<std::string> linkedShaderNames;
+                if (!createSource(shaderSource, linkedShaderNames, permutation->mTemplateName, permutation->mDefines))
+                    // We just broke the shader and there's no way to force existing objects back to fixed-function mode as we would when creating the shader.
+                    // If we put a nullptr in the shader map, we just lose the ability to put a working one in later.
+                    continue;
+                shader->setShaderSource(shaderSource);
+
+                getLinkedShaders(shader, linkedShaderNames, permutation->mDefines);
+            }
         }
     }
 
     void ShaderManager::releaseGLObjects(osg::State *state)
     {
-        std::lock_guard<std::mutex> lock(mMutex);
-        for (const auto& [_, shader] : mShaders)
+        for (const Shard& shard : mShards)
         {
-            if (shader != nullptr)
-                shader->releaseGLObjects(state);
+            const std::lock_guard<std::mutex> lock(shard.mMutex);
+            for (const auto& [_, permutation] : shard.mPermutations)
+            {
+                if (permutation.mShader != nullptr)
+                    permutation.mShader->releaseGLObjects(state);
+            }
         }
+        std::lock_guard<std::mutex> lock(mMutex);
         for (const auto& [_, program] : mPrograms)
             program->releaseGLObjects(state);
     }
@@ -488,16 +818,19 @@ namespace Shader
 
     void ShaderManager::getLinkedShaders(osg::ref_ptr<osg::Shader> shader, const std::vector<std::string>& linkedShaderNames, const DefineMap& defines)
     {
-        mLinkedShaders.erase(shader);
-        if (linkedShaderNames.empty())
-            return;
-
+        ShaderList linkedShaders;
         for (auto& linkedShaderName : linkedShaderNames)
         {
             auto linkedShader = getShader(linkedShaderName, defines, shader->getType());
             if (linkedShader)
-                mLinkedShaders[shader].emplace_back(linkedShader);
+                linkedShaders.emplace_back(linkedShader);
         }
+
+        const std::lock_guard<std::mutex> lock(mMutex);
+        if (linkedShaders.empty())
+            mLinkedShaders.erase(shader);
+        else
+            mLinkedShaders[shader] = std::move(linkedShaders);
     }
 
     void ShaderManager::addLinkedShaders(osg::ref_ptr<osg::Shader> shader, osg::ref_ptr<osg::Program> program)
@@ -535,4 +868,32 @@ namespace Shader
         return unit;
     }
 
+    ShaderManager::Stats ShaderManager::getStats() const
+    {
+        Stats result;
+        {
+            const std::lock_guard<std::mutex> lock(mTemplatesMutex);
+            result.mTemplates = mShaderTemplates.size();
+        }
+        for (const Shard& shard : mShards)
+        {
+            const std::lock_guard<std::mutex> lock(shard.mMutex);
+            result.mPermutations += shard.mPermutations.size();
+            result.mRequests += shard.mRequests;
+            result.mHits += shard.mHits;
+        }
+        result.mSourceCacheHits = mSourceCacheHits;
+        return result;
+    }
+
+    void ShaderManager::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        const Stats value = getStats();
+        stats.setAttribute(frameNumber, "Shader Template", static_cast<double>(value.mTemplates));
+        stats.setAttribute(frameNumber, "Shader Permutation", static_cast<double>(value.mPermutations));
+        stats.setAttribute(frameNumber, "Shader Cached Source", static_cast<double>(value.mSourceCacheHits));
+        if (value.mRequests > 0)
+            stats.setAttribute(frameNumber, "Shader CacheHitRate", static_cast<double>(value.mHits) / value.mRequests * 100.0);
+    }
+
 }
@@ -6,12 +6,22 @@
 #include <mutex>
 #include <vector>
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
 
 #include <osg/ref_ptr>
 
 #include <osg/Shader>
 #include <osg/Program>
 
+namespace osg
+{
+    class Stats;
+}
+
 namespace Shader
 {
 
@@ -25,8 +35,22 @@ namespace Shader
 
         void setShaderPath(const std::string& path);
 
+        /// Set the directory to keep preprocessed shader sources between runs, empty path disables it.
+        /// @par A source is used only when the shader template and included files are not modified since it was written.
+        /// Old and least recently used files are removed from the directory when it is set.
+        void setSourceCachePath(const std::string& path);
+
         typedef std::map<std::string, std::string> DefineMap;
 
+        struct Stats
+        {
+            std::size_t mTemplates = 0;
+            std::size_t mPermutations = 0;
+            std::size_t mRequests = 0;
+            std::size_t mHits = 0;
+            std::size_t mSourceCacheHits = 0;
+        };
+
         /// Create or retrieve a shader instance.
         /// @param shaderTemplate The filename of the shader template.
         /// @param defines Define values that can be retrieved by the shader template.
@@ -67,21 +91,65 @@ namespace Shader
 
         int reserveGlobalTextureUnits(Slot slot);
 
+        Stats getStats() const;
+
+        void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
+
     private:
+        struct TemplateFile
+        {
+            std::filesystem::path mPath;
+            std::uintmax_t mSize;
+            std::int64_t mWriteTime;
+        };
+
+        struct Template
+        {
+            std::string mSource;
+            // Template file and all included files as they were when read
+            std::vector<TemplateFile> mFiles;
+        };
+
+        // Shader created from a template for a set of defines
+        struct Permutation
+        {
+            std::string mTemplateName;
+            DefineMap mDefines;
+            osg::ref_ptr<osg::Shader> mShader;
+        };
+
+        // Permutations are looked up by hash of the template name and defines and split into independently locked shards
+        struct Shard
+        {
+            mutable std::mutex mMutex;
+            std::unordered_multimap<std::size_t, Permutation> mPermutations;
+            std::size_t mRequests = 0;
+            std::size_t mHits = 0;
+        };
+
+        static constexpr std::size_t sShardsCount = 16;
+
         void getLinkedShaders(osg::ref_ptr<osg::Shader> shader, const std::vector<std::string>& linkedShaderNames, const DefineMap& defines);
         void addLinkedShaders(osg::ref_ptr<osg::Shader> shader, osg::ref_ptr<osg::Program> program);
 
+        const Template* getTemplate(const std::string& templateName);
+
+        bool createSource(std::string& source, std::vector<std::string>& linkedShaderTemplateNames, const std::string& templateName, const DefineMap& defines);
+
         std::string mPath;
+        std::filesystem::path mCanonicalPath;
+
+        std::filesystem::path mSourceCachePath;
 
         DefineMap mGlobalDefines;
 
-        // <name, code>
-        typedef std::map<std::string, std::string> TemplateMap;
+        typedef std::map<std::string, Template> TemplateMap;
         TemplateMap mShaderTemplates;
+        mutable std::mutex mTemplatesMutex;
+
+        std::array<Shard, sShardsCount> mShards;
 
-        typedef std::pair<std::string, DefineMap> MapKey;
-        typedef std::map<MapKey, osg::ref_ptr<osg::Shader> > ShaderMap;
-        ShaderMap mShaders;
+        std::atomic<std::size_t> mSourceCacheHits {0};
 
         typedef std::map<std::pair<osg::ref_ptr<osg::Shader>, osg::ref_ptr<osg::Shader> >, osg::ref_ptr<osg::Program> > ProgramMap;
         ProgramMap mPrograms;
@@ -90,6 +158,7 @@ namespace Shader
         typedef std::map<osg::ref_ptr<osg::Shader>, ShaderList> LinkedShadersMap;
         LinkedShadersMap mLinkedShaders;
 
+        // Guards mPrograms and mLinkedShaders
         std::mutex mMutex;
 
         osg::ref_ptr<const osg::Program> mProgramTemplate;
@@ -171,6 +171,7 @@ namespace Shader
         , mApplyLightingToEnvMaps(false)
         , mConvertAlphaTestToAlphaToCoverage(false)
         , mSupportsNormalsRT(false)
+        , mInstancing(false)
         , mShaderManager(shaderManager)
         , mImageManager(imageManager)
         , mDefaultShaderPrefix(defaultShaderPrefix)
@@ -658,6 +659,7 @@ namespace Shader
         }
 
         defineMap["softParticles"] = reqs.mSoftParticles ? "1" : "0";
+        defineMap["instancing"] = mInstancing ? "1" : "0";
 
         Stereo::Manager::instance().shaderStereoDefines(defineMap);
 
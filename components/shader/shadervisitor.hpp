@@ -50,6 +50,10 @@ namespace Shader
 
         void setSupportsNormalsRT(bool supports) { mSupportsNormalsRT = supports; }
 
+        /// Generate programs that read a per-instance offset/scale and rotation from vertex attributes.
+        /// @note The program template must bind "aInstanceOffset" and "aInstanceRotation".
+        void setInstancing(bool instancing) { mInstancing = instancing; }
+
         void apply(osg::Node& node) override;
 
         void apply(osg::Drawable& drawable) override;
@@ -77,6 +81,8 @@ namespace Shader
 
         bool mSupportsNormalsRT;
 
+        bool mInstancing;
+
         ShaderManager& mShaderManager;
         Resource::ImageManager& mImageManager;
 
@@ -13,22 +13,35 @@ namespace Sqlite3
         sqlite3_close_v2(handle);
     }
 
-    Db makeDb(std::string_view path, const char* schema)
+    namespace
     {
-        sqlite3* handle = nullptr;
-        // All uses of NavMeshDb are protected by a mutex (navmeshtool) or serialized in a single thread (DbWorker)
-        // so additional synchronization between threads is not required and SQLITE_OPEN_NOMUTEX can be used.
-        // This is unsafe to use NavMeshDb without external synchronization because of internal state.
-        const int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
-        if (const int ec = sqlite3_open_v2(std::string(path).c_str(), &handle, flags, nullptr); ec != SQLITE_OK)
+        Db openDb(std::string_view path, int flags)
         {
-            const std::string message(sqlite3_errmsg(handle));
-            sqlite3_close(handle);
-            throw std::runtime_error("Failed to open database: " + message);
+            sqlite3* handle = nullptr;
+            // All uses of NavMeshDb are protected by a mutex (navmeshtool) or serialized in a single thread (DbWorker)
+            // so additional synchronization between threads is not required and SQLITE_OPEN_NOMUTEX can be used.
+            // This is unsafe to use NavMeshDb without external synchronization because of internal state.
+            if (const int ec = sqlite3_open_v2(std::string(path).c_str(), &handle, flags | SQLITE_OPEN_NOMUTEX, nullptr);
+                ec != SQLITE_OK)
+            {
+                const std::string message(sqlite3_errmsg(handle));
+                sqlite3_close(handle);
+                throw std::runtime_error("Failed to open database: " + message);
+            }
+            return Db(handle);
         }
-        Db result(handle);
+    }
+
+    Db makeDb(std::string_view path, const char* schema)
+    {
+        Db result = openDb(path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
         if (const int ec = sqlite3_exec(result.get(), schema, nullptr, nullptr, nullptr); ec != SQLITE_OK)
-            throw std::runtime_error("Failed create database schema: " + std::string(sqlite3_errmsg(handle)));
+            throw std::runtime_error("Failed create database schema: " + std::string(sqlite3_errmsg(result.get())));
         return result;
     }
+
+    Db makeReadOnlyDb(std::string_view path)
+    {
+        return openDb(path, SQLITE_OPEN_READONLY);
+    }
 }
@@ -16,6 +16,9 @@ namespace Sqlite3
     using Db = std::unique_ptr<sqlite3, CloseSqlite3>;
 
     Db makeDb(std::string_view path, const char* schema);
+
+    // Opens an existing database without creating it or its schema, any write to it fails
+    Db makeReadOnlyDb(std::string_view path);
 }
 
 #endif
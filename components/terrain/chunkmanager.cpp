@@ -9,6 +9,12 @@
 #include <components/resource/scenemanager.hpp>
 
 #include <components/sceneutil/lightmanager.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
 
 #include "terraindrawable.hpp"
 #include "material.hpp"
@@ -19,6 +25,57 @@
 namespace Terrain
 {
 
+namespace
+{
+    class ChunkVertexData : public osg::Object
+    {
+    public:
+        ChunkVertexData() = default;
+
+        ChunkVertexData(const ChunkVertexData& copy, const osg::CopyOp& copyop)
+            : osg::Object(copy, copyop)
+            , mPositions(copy.mPositions)
+            , mNormals(copy.mNormals)
+            , mColors(copy.mColors)
+        {
+        }
+
+        META_Object(Terrain, ChunkVertexData)
+
+        osg::ref_ptr<osg::Vec3Array> mPositions;
+        osg::ref_ptr<osg::Vec3Array> mNormals;
+        osg::ref_ptr<osg::Vec4ubArray> mColors;
+    };
+
+    osg::ref_ptr<osg::Array> cloneArray(const osg::Array* array)
+    {
+        return static_cast<osg::Array*>(array->clone(osg::CopyOp::DEEP_COPY_ALL));
+    }
+
+    // Size and modification time of the file providing a texture, or of the BSA containing it
+    std::array<std::int64_t, 2> getFileStamp(const VFS::Manager& vfs, const std::string& name, const std::string& archive)
+    {
+        std::filesystem::path path;
+        try
+        {
+            path = vfs.getAbsoluteFileName(name);
+            if (!std::filesystem::is_regular_file(path))
+            {
+                constexpr std::string_view bsaPrefix = "BSA: ";
+                if (archive.compare(0, bsaPrefix.size(), bsaPrefix) != 0)
+                    return {0, 0};
+                path = archive.substr(bsaPrefix.size());
+            }
+            return {static_cast<std::int64_t>(std::filesystem::file_size(path)),
+                    static_cast<std::int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count())};
+        }
+        catch (const std::exception&)
+        {
+            return {0, 0};
+        }
+    }
+}
+
 ChunkManager::ChunkManager(Storage *storage, Resource::SceneManager *sceneMgr, TextureManager* textureManager, CompositeMapRenderer* renderer)
     : GenericResourceManager<ChunkId>(nullptr)
     , mStorage(storage)
@@ -29,6 +86,7 @@ ChunkManager::ChunkManager(Storage *storage, Resource::SceneManager *sceneMgr, T
     , mCompositeMapSize(512)
     , mCompositeMapLevel(1.f)
     , mMaxCompGeometrySize(1.f)
+    , mVertexCache(new Resource::GenericObjectCache<ChunkVertexDataId>)
 {
     mMultiPassRoot = new osg::StateSet;
     mMultiPassRoot->setRenderingHint(osg::StateSet::OPAQUE_BIN);
@@ -72,12 +130,23 @@ osg::ref_ptr<osg::Node> ChunkManager::getChunk(float size, const osg::Vec2f& cen
 void ChunkManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
 {
     stats->setAttribute(frameNumber, "Terrain Chunk", mCache->getCacheSize());
+    stats->setAttribute(frameNumber, "Terrain Vertices", mVertexCache->getCacheSize());
+}
+
+void ChunkManager::updateCache(double referenceTime)
+{
+    GenericResourceManager<ChunkId>::updateCache(referenceTime);
+
+    mVertexCache->updateTimeStampOfObjectsInCacheWithExternalReferences(referenceTime);
+    mVertexCache->removeExpiredObjectsInCache(referenceTime - mExpiryDelay);
 }
 
 void ChunkManager::clearCache()
 {
     GenericResourceManager<ChunkId>::clearCache();
 
+    mVertexCache->clear();
+
     mBufferCache.clearCache();
 }
 
@@ -101,23 +170,36 @@ osg::ref_ptr<osg::Texture2D> ChunkManager::createCompositeMapRTT()
     return texture;
 }
 
-void ChunkManager::createCompositeMapGeometry(float chunkSize, const osg::Vec2f& chunkCenter, const osg::Vec4f& texCoords, CompositeMap& compositeMap)
+void ChunkManager::collectCompositeMapLeaves(float chunkSize, const osg::Vec2f& chunkCenter, const osg::Vec4f& texCoords, std::vector<CompositeMapLeaf>& leaves)
 {
     if (chunkSize > mMaxCompGeometrySize)
     {
-        createCompositeMapGeometry(chunkSize/2.f, chunkCenter + osg::Vec2f(chunkSize/4.f, chunkSize/4.f), osg::Vec4f(texCoords.x() + texCoords.z()/2.f, texCoords.y(), texCoords.z()/2.f, texCoords.w()/2.f), compositeMap);
-        createCompositeMapGeometry(chunkSize/2.f, chunkCenter + osg::Vec2f(-chunkSize/4.f, chunkSize/4.f), osg::Vec4f(texCoords.x(), texCoords.y(), texCoords.z()/2.f, texCoords.w()/2.f), compositeMap);
-        createCompositeMapGeometry(chunkSize/2.f, chunkCenter + osg::Vec2f(chunkSize/4.f, -chunkSize/4.f), osg::Vec4f(texCoords.x() + texCoords.z()/2.f, texCoords.y()+texCoords.w()/2.f, texCoords.z()/2.f, texCoords.w()/2.f), compositeMap);
-        createCompositeMapGeometry(chunkSize/2.f, chunkCenter + osg::Vec2f(-chunkSize/4.f, -chunkSize/4.f), osg::Vec4f(texCoords.x(), texCoords.y()+texCoords.w()/2.f, texCoords.z()/2.f, texCoords.w()/2.f), compositeMap);
+        collectCompositeMapLeaves(chunkSize/2.f, chunkCenter + osg::Vec2f(chunkSize/4.f, chunkSize/4.f), osg::Vec4f(texCoords.x() + texCoords.z()/2.f, texCoords.y(), texCoords.z()/2.f, texCoords.w()/2.f), leaves);
+        collectCompositeMapLeaves(chunkSize/2.f, chunkCenter + osg::Vec2f(-chunkSize/4.f, chunkSize/4.f), osg::Vec4f(texCoords.x(), texCoords.y(), texCoords.z()/2.f, texCoords.w()/2.f), leaves);
+        collectCompositeMapLeaves(chunkSize/2.f, chunkCenter + osg::Vec2f(chunkSize/4.f, -chunkSize/4.f), osg::Vec4f(texCoords.x() + texCoords.z()/2.f, texCoords.y()+texCoords.w()/2.f, texCoords.z()/2.f, texCoords.w()/2.f), leaves);
+        collectCompositeMapLeaves(chunkSize/2.f, chunkCenter + osg::Vec2f(-chunkSize/4.f, -chunkSize/4.f), osg::Vec4f(texCoords.x(), texCoords.y()+texCoords.w()/2.f, texCoords.z()/2.f, texCoords.w()/2.f), leaves);
     }
     else
     {
+        CompositeMapLeaf& leaf = leaves.emplace_back();
+        leaf.mChunkSize = chunkSize;
+        leaf.mChunkCenter = chunkCenter;
+        leaf.mTexCoords = texCoords;
+        mStorage->getBlendmaps(chunkSize, chunkCenter, leaf.mBlendmaps, leaf.mLayers);
+    }
+}
+
+void ChunkManager::createCompositeMapGeometry(const std::vector<CompositeMapLeaf>& leaves, CompositeMap& compositeMap)
+{
+    for (const CompositeMapLeaf& leaf : leaves)
+    {
+        const osg::Vec4f& texCoords = leaf.mTexCoords;
         float left = texCoords.x()*2.f-1;
         float top = texCoords.y()*2.f-1;
         float width = texCoords.z()*2.f;
         float height = texCoords.w()*2.f;
 
-        std::vector<osg::ref_ptr<osg::StateSet> > passes = createPasses(chunkSize, chunkCenter, true);
+        std::vector<osg::ref_ptr<osg::StateSet> > passes = createPasses(leaf.mChunkSize, leaf.mLayers, leaf.mBlendmaps, true);
         for (std::vector<osg::ref_ptr<osg::StateSet> >::iterator it = passes.begin(); it != passes.end(); ++it)
         {
             osg::ref_ptr<osg::Geometry> geom = osg::createTexturedQuadGeometry(osg::Vec3(left,top,0), osg::Vec3(width,0,0), osg::Vec3(0,height,0));
@@ -132,12 +214,56 @@ void ChunkManager::createCompositeMapGeometry(float chunkSize, const osg::Vec2f&
     }
 }
 
+const ChunkManager::TextureStamp& ChunkManager::getTextureStamp(const std::string& texture)
+{
+    const std::lock_guard<std::mutex> lock(mTextureStampsMutex);
+    const auto found = mTextureStamps.find(texture);
+    if (found != mTextureStamps.end())
+        return found->second;
+
+    // Finding the archive scans every archive, and the files don't change while the game is running
+    const VFS::Manager& vfs = *mSceneManager->getVFS();
+    TextureStamp stamp;
+    stamp.mArchive = vfs.getArchive(texture);
+    stamp.mFileStamp = getFileStamp(vfs, texture, stamp.mArchive);
+    return mTextureStamps.emplace(texture, std::move(stamp)).first->second;
+}
+
+void ChunkManager::hashCompositeMapGeometry(const std::vector<CompositeMapLeaf>& leaves, CompositeMapKey& key)
+{
+    for (const CompositeMapLeaf& leaf : leaves)
+    {
+        hashCompositeMapData(key, leaf.mTexCoords.ptr(), 4 * sizeof(float));
+
+        const float blendmapScale = mStorage->getBlendmapScale(leaf.mChunkSize);
+        hashCompositeMapData(key, &blendmapScale, sizeof(blendmapScale));
+
+        // A texture replacer or an edited texture changes the composite map without changing the land data,
+        // so take the texture's origin and its file stamp into account
+        for (const LayerInfo& layer : leaf.mLayers)
+        {
+            const TextureStamp& stamp = getTextureStamp(layer.mDiffuseMap);
+            hashCompositeMapData(key, layer.mDiffuseMap);
+            hashCompositeMapData(key, stamp.mArchive);
+            hashCompositeMapData(key, stamp.mFileStamp.data(), sizeof(stamp.mFileStamp));
+        }
+
+        for (const osg::ref_ptr<osg::Image>& blendmap : leaf.mBlendmaps)
+            hashCompositeMapData(key, blendmap->data(), blendmap->getTotalSizeInBytes());
+    }
+}
+
 std::vector<osg::ref_ptr<osg::StateSet> > ChunkManager::createPasses(float chunkSize, const osg::Vec2f &chunkCenter, bool forCompositeMap)
 {
     std::vector<LayerInfo> layerList;
     std::vector<osg::ref_ptr<osg::Image> > blendmaps;
     mStorage->getBlendmaps(chunkSize, chunkCenter, blendmaps, layerList);
+    return createPasses(chunkSize, layerList, blendmaps, forCompositeMap);
+}
 
+std::vector<osg::ref_ptr<osg::StateSet> > ChunkManager::createPasses(float chunkSize, const std::vector<LayerInfo>& layerList,
+    const std::vector<osg::ref_ptr<osg::Image>>& blendmaps, bool forCompositeMap)
+{
     bool useShaders = mSceneManager->getForceShaders();
     if (!mSceneManager->getClampLighting())
         useShaders = true; // always use shaders when lighting is unclamped, this is to avoid lighting seams between a terrain chunk with normal maps and one without normal maps
@@ -185,41 +311,59 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
 {
     osg::ref_ptr<TerrainDrawable> geometry (new TerrainDrawable);
 
-    if (!templateGeometry)
+    osg::ref_ptr<osg::Array> positions;
+    osg::ref_ptr<osg::Array> normals;
+    osg::ref_ptr<osg::Array> colors;
+
+    if (templateGeometry)
     {
-        osg::ref_ptr<osg::Vec3Array> positions (new osg::Vec3Array);
-        osg::ref_ptr<osg::Vec3Array> normals (new osg::Vec3Array);
-        osg::ref_ptr<osg::Vec4ubArray> colors (new osg::Vec4ubArray);
-        colors->setNormalize(true);
-
-        mStorage->fillVertexBuffers(lod, chunkSize, chunkCenter, positions, normals, colors);
-
-        osg::ref_ptr<osg::VertexBufferObject> vbo (new osg::VertexBufferObject);
-        positions->setVertexBufferObject(vbo);
-        normals->setVertexBufferObject(vbo);
-        colors->setVertexBufferObject(vbo);
-    
-        geometry->setVertexArray(positions);
-        geometry->setNormalArray(normals, osg::Array::BIND_PER_VERTEX);
-        geometry->setColorArray(colors, osg::Array::BIND_PER_VERTEX);
+        // Unfortunately we need to copy vertex data because of poor coupling with VertexBufferObject.
+        positions = cloneArray(templateGeometry->getVertexArray());
+        normals = cloneArray(templateGeometry->getNormalArray());
+        colors = cloneArray(templateGeometry->getColorArray());
     }
     else
     {
-        // Unfortunately we need to copy vertex data because of poor coupling with VertexBufferObject.
-        osg::ref_ptr<osg::Array> positions = static_cast<osg::Array*>(templateGeometry->getVertexArray()->clone(osg::CopyOp::DEEP_COPY_ALL));
-        osg::ref_ptr<osg::Array> normals = static_cast<osg::Array*>(templateGeometry->getNormalArray()->clone(osg::CopyOp::DEEP_COPY_ALL));
-        osg::ref_ptr<osg::Array> colors = static_cast<osg::Array*>(templateGeometry->getColorArray()->clone(osg::CopyOp::DEEP_COPY_ALL));
-
-        osg::ref_ptr<osg::VertexBufferObject> vbo (new osg::VertexBufferObject);
-        positions->setVertexBufferObject(vbo);
-        normals->setVertexBufferObject(vbo);
-        colors->setVertexBufferObject(vbo);
-    
-        geometry->setVertexArray(positions);
-        geometry->setNormalArray(normals, osg::Array::BIND_PER_VERTEX);
-        geometry->setColorArray(colors, osg::Array::BIND_PER_VERTEX);
+        const ChunkVertexDataId vertexDataId(chunkCenter, lod);
+        osg::ref_ptr<osg::Object> cached = mVertexCache->getRefFromObjectCache(vertexDataId);
+        if (cached)
+        {
+            // Same as for the template geometry, copying is still a lot cheaper than generating the vertices again.
+            const ChunkVertexData& vertexData = static_cast<const ChunkVertexData&>(*cached);
+            positions = cloneArray(vertexData.mPositions);
+            normals = cloneArray(vertexData.mNormals);
+            colors = cloneArray(vertexData.mColors);
+
+            // Reset the time stamp, so the entry is kept for another expiry delay since its last use
+            mVertexCache->addEntryToObjectCache(vertexDataId, cached);
+        }
+        else
+        {
+            osg::ref_ptr<ChunkVertexData> vertexData = new ChunkVertexData;
+            vertexData->mPositions = new osg::Vec3Array;
+            vertexData->mNormals = new osg::Vec3Array;
+            vertexData->mColors = new osg::Vec4ubArray;
+            vertexData->mColors->setNormalize(true);
+
+            mStorage->fillVertexBuffers(lod, chunkSize, chunkCenter, vertexData->mPositions, vertexData->mNormals, vertexData->mColors);
+
+            positions = vertexData->mPositions;
+            normals = vertexData->mNormals;
+            colors = vertexData->mColors;
+
+            mVertexCache->addEntryToObjectCache(vertexDataId, vertexData);
+        }
     }
-    
+
+    osg::ref_ptr<osg::VertexBufferObject> vbo (new osg::VertexBufferObject);
+    positions->setVertexBufferObject(vbo);
+    normals->setVertexBufferObject(vbo);
+    colors->setVertexBufferObject(vbo);
+
+    geometry->setVertexArray(positions);
+    geometry->setNormalArray(normals, osg::Array::BIND_PER_VERTEX);
+    geometry->setColorArray(colors, osg::Array::BIND_PER_VERTEX);
+
     geometry->setUseDisplayList(false);
     geometry->setUseVertexBufferObjects(true);
 
@@ -255,12 +399,36 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
             osg::ref_ptr<CompositeMap> compositeMap = new CompositeMap;
             compositeMap->mTexture = createCompositeMapRTT();
 
-            createCompositeMapGeometry(chunkSize, chunkCenter, osg::Vec4f(0,0,1,1), *compositeMap);
-
-            mCompositeMapRenderer->addCompositeMap(compositeMap.get(), false);
+            std::vector<CompositeMapLeaf> leaves;
+            collectCompositeMapLeaves(chunkSize, chunkCenter, osg::Vec4f(0,0,1,1), leaves);
+
+            osg::ref_ptr<osg::Image> cachedImage;
+            if (mCompositeMapCache)
+            {
+                CompositeMapKey key {0, 0};
+                hashCompositeMapData(key, &mCompositeMapSize, sizeof(mCompositeMapSize));
+                hashCompositeMapGeometry(leaves, key);
+                cachedImage = mCompositeMapCache->load(key);
+                compositeMap->mCacheKey = key;
+                compositeMap->mStoreInCache = cachedImage == nullptr;
+            }
+
+            if (cachedImage)
+            {
+                compositeMap->mTexture->setImage(cachedImage);
+                // The texture is never re-uploaded, so don't keep the decoded image around
+                compositeMap->mTexture->setUnRefImageDataAfterApply(true);
+            }
+            else
+            {
+                createCompositeMapGeometry(leaves, *compositeMap);
+
+                mCompositeMapRenderer->addCompositeMap(compositeMap.get(), false);
+
+                geometry->setCompositeMapRenderer(mCompositeMapRenderer);
+            }
 
             geometry->setCompositeMap(compositeMap);
-            geometry->setCompositeMapRenderer(mCompositeMapRenderer);
 
             TextureLayer layer;
             layer.mDiffuseMap = compositeMap->mTexture;
@@ -1,16 +1,25 @@
 #ifndef OPENMW_COMPONENTS_TERRAIN_CHUNKMANAGER_H
 #define OPENMW_COMPONENTS_TERRAIN_CHUNKMANAGER_H
 
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
 #include <tuple>
+#include <vector>
 
 #include <components/resource/resourcemanager.hpp>
 
 #include "buffercache.hpp"
+#include "compositemapcache.hpp"
+#include "defs.hpp"
 #include "quadtreeworld.hpp"
 
 namespace osg
 {
     class Group;
+    class Image;
     class Texture2D;
 }
 
@@ -29,6 +38,7 @@ namespace Terrain
     class TerrainDrawable;
 
     typedef std::tuple<osg::Vec2f, unsigned char, unsigned int> ChunkId; // Center, Lod, Lod Flags
+    typedef std::tuple<osg::Vec2f, unsigned char> ChunkVertexDataId; // Center, Lod
 
     /// @brief Handles loading and caching of terrain chunks
     class ChunkManager : public Resource::GenericResourceManager<ChunkId>, public QuadTreeWorld::ChunkManager
@@ -41,12 +51,15 @@ namespace Terrain
         void setCompositeMapSize(unsigned int size) { mCompositeMapSize = size; }
         void setCompositeMapLevel(float level) { mCompositeMapLevel = level; }
         void setMaxCompositeGeometrySize(float maxCompGeometrySize) { mMaxCompGeometrySize = maxCompGeometrySize; }
+        void setCompositeMapCache(CompositeMapCache* cache) { mCompositeMapCache = cache; }
 
         void setNodeMask(unsigned int mask) { mNodeMask = mask; }
         unsigned int getNodeMask() override { return mNodeMask; }
 
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
+        void updateCache(double referenceTime) override;
+
         void clearCache() override;
 
         void releaseGLObjects(osg::State* state) override;
@@ -56,18 +69,54 @@ namespace Terrain
 
         osg::ref_ptr<osg::Texture2D> createCompositeMapRTT();
 
-        void createCompositeMapGeometry(float chunkSize, const osg::Vec2f& chunkCenter, const osg::Vec4f& texCoords, CompositeMap& map);
+        /// Land textures and blendmaps of one quad of the composite geometry
+        struct CompositeMapLeaf
+        {
+            float mChunkSize;
+            osg::Vec2f mChunkCenter;
+            osg::Vec4f mTexCoords;
+            std::vector<LayerInfo> mLayers;
+            std::vector<osg::ref_ptr<osg::Image>> mBlendmaps;
+        };
+
+        void collectCompositeMapLeaves(float chunkSize, const osg::Vec2f& chunkCenter, const osg::Vec4f& texCoords, std::vector<CompositeMapLeaf>& leaves);
+
+        void createCompositeMapGeometry(const std::vector<CompositeMapLeaf>& leaves, CompositeMap& map);
+
+        /// Archive of a texture file and the size and modification time of the file providing it
+        struct TextureStamp
+        {
+            std::string mArchive;
+            std::array<std::int64_t, 2> mFileStamp;
+        };
+
+        /// Looked up once per texture for the session.
+        /// @note Thread safe.
+        const TextureStamp& getTextureStamp(const std::string& texture);
+
+        /// Hash the inputs of the composite geometry, without loading any textures.
+        void hashCompositeMapGeometry(const std::vector<CompositeMapLeaf>& leaves, CompositeMapKey& key);
 
         std::vector<osg::ref_ptr<osg::StateSet> > createPasses(float chunkSize, const osg::Vec2f& chunkCenter, bool forCompositeMap);
 
+        std::vector<osg::ref_ptr<osg::StateSet> > createPasses(float chunkSize, const std::vector<LayerInfo>& layerList,
+            const std::vector<osg::ref_ptr<osg::Image>>& blendmaps, bool forCompositeMap);
+
         Terrain::Storage* mStorage;
         Resource::SceneManager* mSceneManager;
         TextureManager* mTextureManager;
         CompositeMapRenderer* mCompositeMapRenderer;
+        osg::ref_ptr<CompositeMapCache> mCompositeMapCache;
         BufferCache mBufferCache;
 
+        // Vertex data does not depend on the lod flags, so chunks that only differ in their neighbours' lods share it
+        osg::ref_ptr<Resource::GenericObjectCache<ChunkVertexDataId>> mVertexCache;
+
         osg::ref_ptr<osg::StateSet> mMultiPassRoot;
 
+        std::mutex mTextureStampsMutex;
+        std::map<std::string, TextureStamp> mTextureStamps;
+
         unsigned int mNodeMask;
 
         unsigned int mCompositeMapSize;
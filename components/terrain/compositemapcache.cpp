@@ -0,0 +1,241 @@
+#include "compositemapcache.hpp"
+
+#include <osg/Image>
+
+#include <extern/smhasher/MurmurHash3.h>
+
+#include <components/debug/debuglog.hpp>
+#include <components/misc/compression.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace Terrain
+{
+
+namespace
+{
+    constexpr char sMagic[] = {'O', 'M', 'W', 'C', 'M', 'A', 'P', '1'};
+
+    // Files not used for this long are removed, then the least recently used ones until the rest fits the size
+    constexpr std::chrono::hours sMaxFileAge(24 * 30);
+    constexpr std::uintmax_t sMaxCacheSize = 512 * 1024 * 1024;
+
+    struct Header
+    {
+        char mMagic[sizeof(sMagic)];
+        CompositeMapKey mKey;
+        std::int32_t mWidth;
+        std::int32_t mHeight;
+    };
+
+    class SaveCompositeMapWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        SaveCompositeMapWorkItem(const std::filesystem::path& path, const CompositeMapKey& key, osg::ref_ptr<osg::Image> image)
+            : mPath(path)
+            , mKey(key)
+            , mImage(std::move(image))
+        {
+        }
+
+        void doWork() override
+        {
+            if (mImage->getPixelFormat() != GL_RGB || mImage->getDataType() != GL_UNSIGNED_BYTE)
+            {
+                Log(Debug::Warning) << "Unexpected composite map pixel format, not storing it in cache";
+                return;
+            }
+
+            try
+            {
+                const std::size_t dataSize = static_cast<std::size_t>(mImage->s()) * mImage->t() * 3;
+                std::vector<std::byte> data(dataSize);
+                std::memcpy(data.data(), mImage->data(), dataSize);
+                const std::vector<std::byte> compressed = Misc::compress(data);
+
+                Header header;
+                std::memcpy(header.mMagic, sMagic, sizeof(sMagic));
+                header.mKey = mKey;
+                header.mWidth = mImage->s();
+                header.mHeight = mImage->t();
+
+                std::filesystem::create_directories(mPath.parent_path());
+
+                // Write to a temporary file first, so that a crash can't leave a truncated file with a valid name
+                std::filesystem::path tmpPath = mPath;
+                tmpPath += ".tmp";
+                {
+                    std::ofstream file(tmpPath, std::ios::binary);
+                    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                    file.write(reinterpret_cast<const char*>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+                    if (!file)
+                        throw std::runtime_error("failed to write " + tmpPath.string());
+                }
+                std::filesystem::rename(tmpPath, mPath);
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Warning) << "Failed to store composite map in cache: " << e.what();
+            }
+        }
+
+    private:
+        std::filesystem::path mPath;
+        CompositeMapKey mKey;
+        osg::ref_ptr<osg::Image> mImage;
+    };
+
+    class PruneCompositeMapCacheWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        explicit PruneCompositeMapCacheWorkItem(const std::filesystem::path& path)
+            : mPath(path)
+        {
+        }
+
+        void doWork() override
+        {
+            struct CacheFile
+            {
+                std::filesystem::path mPath;
+                std::uintmax_t mSize;
+                std::filesystem::file_time_type mWriteTime;
+            };
+
+            const auto now = std::filesystem::file_time_type::clock::now();
+            std::vector<CacheFile> files;
+            std::uintmax_t totalSize = 0;
+            std::error_code ec;
+            for (std::filesystem::directory_iterator it(mPath, ec), end; !ec && it != end; it.increment(ec))
+            {
+                const std::filesystem::directory_entry& entry = *it;
+                const std::filesystem::path& path = entry.path();
+                if (path.extension() != ".cmap" && path.extension() != ".tmp")
+                    continue;
+                std::error_code entryEc;
+                const std::uintmax_t size = entry.file_size(entryEc);
+                if (entryEc)
+                    continue;
+                const std::filesystem::file_time_type writeTime = entry.last_write_time(entryEc);
+                if (entryEc)
+                    continue;
+                // Temporary files of a running process are renamed right after being written
+                if (now - writeTime > sMaxFileAge
+                    || (path.extension() == ".tmp" && now - writeTime > std::chrono::hours(1)))
+                {
+                    std::filesystem::remove(path, entryEc);
+                    continue;
+                }
+                if (path.extension() == ".tmp")
+                    continue;
+                files.push_back(CacheFile {path, size, writeTime});
+                totalSize += size;
+            }
+
+            if (totalSize <= sMaxCacheSize)
+                return;
+
+            std::sort(files.begin(), files.end(),
+                [] (const CacheFile& l, const CacheFile& r) { return l.mWriteTime < r.mWriteTime; });
+            for (const CacheFile& file : files)
+            {
+                if (totalSize <= sMaxCacheSize)
+                    break;
+                if (std::filesystem::remove(file.mPath, ec))
+                    totalSize -= file.mSize;
+            }
+        }
+
+    private:
+        std::filesystem::path mPath;
+    };
+}
+
+void hashCompositeMapData(CompositeMapKey& key, const void* data, std::size_t size)
+{
+    CompositeMapKey result {0, 0};
+    MurmurHash3_x64_128(data, static_cast<int>(size), key.data(), result.data());
+    key = result;
+}
+
+void hashCompositeMapData(CompositeMapKey& key, std::string_view value)
+{
+    const std::uint64_t size = value.size();
+    hashCompositeMapData(key, &size, sizeof(size));
+    hashCompositeMapData(key, value.data(), value.size());
+}
+
+CompositeMapCache::CompositeMapCache(const std::filesystem::path& path)
+    : mPath(path)
+    , mWorkQueue(new SceneUtil::WorkQueue(1))
+{
+    // Queued before any save, so files written by this run are never removed
+    mWorkQueue->addWorkItem(new PruneCompositeMapCacheWorkItem(path));
+}
+
+CompositeMapCache::~CompositeMapCache()
+{
+}
+
+std::filesystem::path CompositeMapCache::getFilePath(const CompositeMapKey& key) const
+{
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(16) << key[0] << std::setw(16) << key[1] << ".cmap";
+    return mPath / name.str();
+}
+
+osg::ref_ptr<osg::Image> CompositeMapCache::load(const CompositeMapKey& key) const
+{
+    const std::filesystem::path filePath = getFilePath(key);
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file)
+        return nullptr;
+
+    try
+    {
+        Header header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+                || std::memcmp(header.mMagic, sMagic, sizeof(sMagic)) != 0 || header.mKey != key
+                || header.mWidth <= 0 || header.mHeight <= 0)
+            throw std::runtime_error("invalid header");
+
+        std::vector<std::byte> compressed((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (compressed.size() < sizeof(std::size_t))
+            throw std::runtime_error("truncated data");
+
+        const std::vector<std::byte> data = Misc::decompress(compressed);
+        const std::size_t dataSize = static_cast<std::size_t>(header.mWidth) * header.mHeight * 3;
+        if (data.size() != dataSize)
+            throw std::runtime_error("unexpected image size");
+
+        osg::ref_ptr<osg::Image> image = new osg::Image;
+        image->allocateImage(header.mWidth, header.mHeight, 1, GL_RGB, GL_UNSIGNED_BYTE);
+        std::memcpy(image->data(), data.data(), dataSize);
+
+        // Write time tells which files are used when the cache is pruned
+        file.close();
+        std::error_code ec;
+        std::filesystem::last_write_time(filePath, std::filesystem::file_time_type::clock::now(), ec);
+
+        return image;
+    }
+    catch (const std::exception& e)
+    {
+        Log(Debug::Warning) << "Ignoring cached composite map " << filePath << ": " << e.what();
+        return nullptr;
+    }
+}
+
+void CompositeMapCache::save(const CompositeMapKey& key, osg::ref_ptr<osg::Image> image)
+{
+    mWorkQueue->addWorkItem(new SaveCompositeMapWorkItem(getFilePath(key), key, std::move(image)));
+}
+
+}
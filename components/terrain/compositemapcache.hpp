@@ -0,0 +1,61 @@
+#ifndef OPENMW_COMPONENTS_TERRAIN_COMPOSITEMAPCACHE_H
+#define OPENMW_COMPONENTS_TERRAIN_COMPOSITEMAPCACHE_H
+
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace osg
+{
+    class Image;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
+namespace Terrain
+{
+
+    /// Hash of everything that affects the contents of a composite map: blendmaps, layer textures and their origin,
+    /// texture coordinates of the composite geometry and the composite map resolution.
+    using CompositeMapKey = std::array<std::uint64_t, 2>;
+
+    void hashCompositeMapData(CompositeMapKey& key, const void* data, std::size_t size);
+
+    void hashCompositeMapData(CompositeMapKey& key, std::string_view value);
+
+    /**
+     * @brief Keeps rendered composite maps on disk, so distant terrain does not have to wait for them to be rendered again on the next run.
+     * @note Files are named after their key, so changed land data or settings simply produce new files.
+     */
+    class CompositeMapCache : public osg::Referenced
+    {
+    public:
+        explicit CompositeMapCache(const std::filesystem::path& path);
+        ~CompositeMapCache();
+
+        /// @return nullptr if there is no valid file for this key
+        /// @note Thread safe.
+        osg::ref_ptr<osg::Image> load(const CompositeMapKey& key) const;
+
+        /// Compress and write the image in a background thread.
+        /// @note Thread safe.
+        void save(const CompositeMapKey& key, osg::ref_ptr<osg::Image> image);
+
+    private:
+        std::filesystem::path mPath;
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+
+        std::filesystem::path getFilePath(const CompositeMapKey& key) const;
+    };
+
+}
+
+#endif
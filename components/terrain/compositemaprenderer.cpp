@@ -1,14 +1,24 @@
 #include "compositemaprenderer.hpp"
 
+#include <osg/BufferObject>
 #include <osg/FrameBufferObject>
+#include <osg/FrameStamp>
+#include <osg/Image>
 #include <osg/Texture2D>
 #include <osg/RenderInfo>
 
 #include <algorithm>
+#include <cstring>
 
 namespace Terrain
 {
 
+namespace
+{
+    // Frames to wait before mapping a readback buffer, so that the copy has been executed by then and mapping doesn't stall
+    constexpr unsigned int sReadbackDelay = 3;
+}
+
 CompositeMapRenderer::CompositeMapRenderer()
     : mTargetFrameRate(120)
     , mMinimumTimeAvailable(0.0025)
@@ -35,6 +45,9 @@ void CompositeMapRenderer::drawImplementation(osg::RenderInfo &renderInfo) const
     double availableTime = std::max((targetFrameTime - dt)*conservativeTimeRatio,
                                     mMinimumTimeAvailable);
 
+    if (!mPendingReadbacks.empty())
+        finishReadbacks(*renderInfo.getState());
+
     std::lock_guard<std::mutex> lock(mMutex);
 
     if (mImmediateCompileSet.empty() && mCompileSet.empty())
@@ -137,13 +150,88 @@ void CompositeMapRenderer::compile(CompositeMap &compositeMap, osg::RenderInfo &
                 break;
         }
     }
-    if (compositeMap.mCompiled == compositeMap.mDrawables.size())
+    const bool done = compositeMap.mCompiled == compositeMap.mDrawables.size();
+    if (done)
         compositeMap.mDrawables = std::vector<osg::ref_ptr<osg::Drawable>>();
 
     state.haveAppliedAttribute(osg::StateAttribute::VIEWPORT);
 
     GLuint fboId = state.getGraphicsContext() ? state.getGraphicsContext()->getDefaultFboId() : 0;
     ext->glBindFramebuffer(GL_FRAMEBUFFER_EXT, fboId);
+
+    if (done && compositeMap.mStoreInCache && mCompositeMapCache)
+    {
+        compositeMap.mStoreInCache = false;
+        startReadback(compositeMap, state);
+    }
+}
+
+void CompositeMapRenderer::startReadback(const CompositeMap& compositeMap, osg::State& state) const
+{
+    osg::GLExtensions* ext = state.get<osg::GLExtensions>();
+    if (!ext->isBufferObjectSupported || !ext->glMapBuffer || state.getFrameStamp() == nullptr)
+        return;
+
+    const int width = compositeMap.mTexture->getTextureWidth();
+    const int height = compositeMap.mTexture->getTextureHeight();
+
+    GLuint buffer = 0;
+    ext->glGenBuffers(1, &buffer);
+    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, buffer);
+    ext->glBufferData(GL_PIXEL_PACK_BUFFER_ARB, static_cast<GLsizeiptr>(width) * height * 3, nullptr, GL_STREAM_READ_ARB);
+
+    // With a pixel pack buffer bound this only queues the copy, it doesn't wait for the composite map to be rendered
+    state.applyTextureAttribute(0, compositeMap.mTexture);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    mPendingReadbacks.push_back(PendingReadback {compositeMap.mCacheKey, width, height, buffer, state.getFrameStamp()->getFrameNumber()});
+}
+
+void CompositeMapRenderer::finishReadbacks(osg::State& state) const
+{
+    osg::GLExtensions* ext = state.get<osg::GLExtensions>();
+    const unsigned int frameNumber = state.getFrameStamp() ? state.getFrameStamp()->getFrameNumber() : 0;
+
+    auto it = mPendingReadbacks.begin();
+    for (; it != mPendingReadbacks.end(); ++it)
+    {
+        if (frameNumber < it->mFrameNumber + sReadbackDelay)
+            break;
+
+        ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, it->mBuffer);
+        if (const void* data = ext->glMapBuffer(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB))
+        {
+            osg::ref_ptr<osg::Image> image = new osg::Image;
+            image->allocateImage(it->mWidth, it->mHeight, 1, GL_RGB, GL_UNSIGNED_BYTE);
+            std::memcpy(image->data(), data, image->getTotalSizeInBytes());
+            ext->glUnmapBuffer(GL_PIXEL_PACK_BUFFER_ARB);
+            // Compression and writing are done by the cache's own thread
+            mCompositeMapCache->save(it->mKey, image);
+        }
+        ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+        ext->glDeleteBuffers(1, &it->mBuffer);
+    }
+
+    // Readbacks are started in frame order, so the remaining ones are all too recent
+    mPendingReadbacks.erase(mPendingReadbacks.begin(), it);
+}
+
+void CompositeMapRenderer::releaseGLObjects(osg::State* state) const
+{
+    osg::Drawable::releaseGLObjects(state);
+    // Without a state there is no context to delete the buffers in. The composite maps are simply rendered again on
+    // the next run.
+    if (state != nullptr)
+    {
+        osg::GLExtensions* ext = state->get<osg::GLExtensions>();
+        for (const PendingReadback& readback : mPendingReadbacks)
+            ext->glDeleteBuffers(1, &readback.mBuffer);
+    }
+    mPendingReadbacks.clear();
 }
 
 void CompositeMapRenderer::setMinimumTimeAvailableForCompile(double time)
@@ -186,6 +274,8 @@ unsigned int CompositeMapRenderer::getCompileSetSize() const
 
 CompositeMap::CompositeMap()
     : mCompiled(0)
+    , mStoreInCache(false)
+    , mCacheKey {0, 0}
 {
 }
 
@@ -5,6 +5,9 @@
 
 #include <set>
 #include <mutex>
+#include <vector>
+
+#include "compositemapcache.hpp"
 
 namespace osg
 {
@@ -24,6 +27,10 @@ namespace Terrain
         std::vector<osg::ref_ptr<osg::Drawable> > mDrawables;
         osg::ref_ptr<osg::Texture2D> mTexture;
         unsigned int mCompiled;
+
+        /// If set, the texture is read back once fully compiled and stored in the CompositeMapCache under mCacheKey
+        bool mStoreInCache;
+        CompositeMapKey mCacheKey;
     };
 
     /**
@@ -53,7 +60,25 @@ namespace Terrain
 
         unsigned int getCompileSetSize() const;
 
+        void setCompositeMapCache(CompositeMapCache* cache) { mCompositeMapCache = cache; }
+
+        void releaseGLObjects(osg::State* state = nullptr) const override;
+
     private:
+        /// A composite map copied into a pixel buffer object, to be mapped once the GPU is done with it
+        struct PendingReadback
+        {
+            CompositeMapKey mKey;
+            int mWidth;
+            int mHeight;
+            GLuint mBuffer;
+            unsigned int mFrameNumber;
+        };
+
+        void startReadback(const CompositeMap& compositeMap, osg::State& state) const;
+
+        void finishReadbacks(osg::State& state) const;
+
         float mTargetFrameRate;
         double mMinimumTimeAvailable;
         mutable osg::Timer mTimer;
@@ -66,6 +91,10 @@ namespace Terrain
         mutable std::mutex mMutex;
 
         osg::ref_ptr<osg::FrameBufferObject> mFBO;
+
+        osg::ref_ptr<CompositeMapCache> mCompositeMapCache;
+
+        mutable std::vector<PendingReadback> mPendingReadbacks;
     };
 
 }
@@ -30,6 +30,10 @@ namespace Terrain
             StopTraversalAndUse
         };
         virtual ReturnValue isSufficientDetail(QuadTreeNode *node, float dist) = 0;
+
+        /// @return how far the view point can move before isSufficientDetail() may return a different result for this node.
+        /// @note The default of 0 makes incremental traversals always re-evaluate the node.
+        virtual float getValidityDistance(QuadTreeNode *node, float dist) { return 0.f; }
     };
 
     class ViewData;
@@ -5,6 +5,8 @@
 #include <osg/PolygonMode>
 #include <osg/Material>
 
+#include <chrono>
+#include <cmath>
 #include <limits>
 
 #include <components/misc/constants.hpp>
@@ -66,23 +68,28 @@ public:
 
     ReturnValue isSufficientDetail(QuadTreeNode* node, float dist) override
     {
-        const osg::Vec2f& center = node->getCenter();
-        bool activeGrid = (center.x() > mActiveGrid.x() && center.y() > mActiveGrid.y() && center.x() < mActiveGrid.z() && center.y() < mActiveGrid.w());
-
-        if (node->getSize()>1)
-        {
-            float halfSize = node->getSize()/2;
-            osg::Vec4i nodeBounds (static_cast<int>(center.x() - halfSize), static_cast<int>(center.y() - halfSize), static_cast<int>(center.x() + halfSize), static_cast<int>(center.y() + halfSize));
-            bool intersects = (std::max(nodeBounds.x(), mActiveGrid.x()) < std::min(nodeBounds.z(), mActiveGrid.z()) && std::max(nodeBounds.y(), mActiveGrid.y()) < std::min(nodeBounds.w(), mActiveGrid.w()));
-            // to prevent making chunks who will cross the activegrid border
-            if (intersects)
-                return Deeper;
-        }
+        // to prevent making chunks who will cross the activegrid border
+        if (intersectsActiveGrid(node))
+            return Deeper;
         dist = std::max(0.f, dist + mDistanceModifier);
-        if (dist > mViewDistance && !activeGrid) // for Scene<->ObjectPaging sync the activegrid must remain loaded
+        if (dist > mViewDistance && !isInActiveGrid(node)) // for Scene<->ObjectPaging sync the activegrid must remain loaded
             return StopTraversal;
         return getNativeLodLevel(node, mMinSize) <= convertDistanceToLodLevel(dist, mMinSize, mFactor) ? StopTraversalAndUse : Deeper;
     }
+    float getValidityDistance(QuadTreeNode* node, float dist) override
+    {
+        if (intersectsActiveGrid(node))
+            return std::numeric_limits<float>::max();
+        dist = std::max(0.f, dist + mDistanceModifier);
+        float validityDistance = std::numeric_limits<float>::max();
+        if (!isInActiveGrid(node))
+            validityDistance = std::abs(dist - mViewDistance);
+        // convertDistanceToLodLevel() reaches the native LOD level of the node at this distance
+        unsigned int nativeLodLevel = getNativeLodLevel(node, mMinSize);
+        if (nativeLodLevel > 0)
+            validityDistance = std::min(validityDistance, std::abs(dist - Constants::CellSizeInUnits * mMinSize * mFactor * static_cast<float>(1u << nativeLodLevel)));
+        return validityDistance;
+    }
     static unsigned int getNativeLodLevel(const QuadTreeNode* node, float minSize)
     {
         return Log2(static_cast<unsigned int>(node->getSize()/minSize));
@@ -93,6 +100,21 @@ public:
     }
 
 private:
+    bool isInActiveGrid(const QuadTreeNode* node) const
+    {
+        const osg::Vec2f& center = node->getCenter();
+        return center.x() > mActiveGrid.x() && center.y() > mActiveGrid.y() && center.x() < mActiveGrid.z() && center.y() < mActiveGrid.w();
+    }
+    bool intersectsActiveGrid(const QuadTreeNode* node) const
+    {
+        if (node->getSize() <= 1)
+            return false;
+        const osg::Vec2f& center = node->getCenter();
+        float halfSize = node->getSize()/2;
+        osg::Vec4i nodeBounds (static_cast<int>(center.x() - halfSize), static_cast<int>(center.y() - halfSize), static_cast<int>(center.x() + halfSize), static_cast<int>(center.y() + halfSize));
+        return std::max(nodeBounds.x(), mActiveGrid.x()) < std::min(nodeBounds.z(), mActiveGrid.z()) && std::max(nodeBounds.y(), mActiveGrid.y()) < std::min(nodeBounds.w(), mActiveGrid.w());
+    }
+
     float mFactor;
     float mMinSize;
     float mViewDistance;
@@ -450,9 +472,12 @@ void QuadTreeWorld::accept(osg::NodeVisitor &nv)
     ViewData *vd = mViewDataMap->getViewData(viewer, viewPoint, mActiveGrid, needsUpdate);
     if (needsUpdate)
     {
-        vd->reset();
+        const auto traversalStart = std::chrono::steady_clock::now();
         DefaultLodCallback lodCallback(mLodFactor, mMinSize, mViewDistance, mActiveGrid);
-        mRootNode->traverseNodes(vd, viewPoint, &lodCallback);
+        vd->traverse(mRootNode, &lodCallback);
+        mTraversalTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - traversalStart).count();
+        mNumEvaluatedNodes += vd->getNumEvaluatedNodes();
+        mNumReusedNodes += vd->getNumReusedNodes();
     }
 
     const float cellWorldSize = mStorage->getCellWorldSize();
@@ -554,6 +579,9 @@ void QuadTreeWorld::reportStats(unsigned int frameNumber, osg::Stats *stats)
 {
     if (mCompositeMapRenderer)
         stats->setAttribute(frameNumber, "Composite", mCompositeMapRenderer->getCompileSetSize());
+    stats->setAttribute(frameNumber, "Terrain Traversal", mTraversalTime.exchange(0) / 1000.0);
+    stats->setAttribute(frameNumber, "Terrain Nodes Evaluated", mNumEvaluatedNodes.exchange(0));
+    stats->setAttribute(frameNumber, "Terrain Nodes Reused", mNumReusedNodes.exchange(0));
 }
 
 void QuadTreeWorld::loadCell(int x, int y)
@@ -86,6 +86,11 @@ namespace Terrain
         float mMinSize;
         bool mDebugTerrainChunks;
         std::unique_ptr<DebugChunkManager> mDebugChunkManager;
+
+        // accumulated by the cull traversals since the last reportStats()
+        std::atomic<long long> mTraversalTime {0}; // microseconds
+        std::atomic<unsigned int> mNumEvaluatedNodes {0};
+        std::atomic<unsigned int> mNumReusedNodes {0};
     };
 
 }
@@ -1,5 +1,8 @@
 #include "viewdata.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #include "quadtreenode.hpp"
 
 namespace Terrain
@@ -11,6 +14,8 @@ ViewData::ViewData()
     , mChanged(false)
     , mHasViewPoint(false)
     , mWorldUpdateRevision(0)
+    , mNumEvaluatedNodes(0)
+    , mNumReusedNodes(0)
 {
 }
 
@@ -27,6 +32,7 @@ void ViewData::copyFrom(const ViewData& other)
     mViewPoint = other.mViewPoint;
     mActiveGrid = other.mActiveGrid;
     mWorldUpdateRevision = other.mWorldUpdateRevision;
+    mTraversal = other.mTraversal;
 }
 
 void ViewData::add(QuadTreeNode *node)
@@ -41,6 +47,76 @@ void ViewData::add(QuadTreeNode *node)
         mChanged = true;
 }
 
+void ViewData::traverse(QuadTreeNode* rootNode, LodCallback* lodCallback)
+{
+    reset();
+    mNumEvaluatedNodes = 0;
+    mNumReusedNodes = 0;
+
+    mPreviousTraversal.swap(mTraversal);
+    mTraversal.clear();
+    unsigned int previous = 0;
+    traverseNode(rootNode, lodCallback, previous);
+    mPreviousTraversal.clear();
+}
+
+float ViewData::traverseNode(QuadTreeNode* node, LodCallback* lodCallback, unsigned int& previous)
+{
+    if (!node->hasValidBounds())
+        return std::numeric_limits<float>::max();
+
+    // The previous traversal visited the nodes in the same order, so a node it visited is always found at the cursor.
+    const ViewDataTraversalRecord* record = nullptr;
+    if (previous < mPreviousTraversal.size() && mPreviousTraversal[previous].mNode == node)
+        record = &mPreviousTraversal[previous];
+
+    if (record)
+    {
+        float moved = (mViewPoint - record->mViewPoint).length();
+        if (moved < record->mValidityDistance)
+        {
+            const unsigned int offset = mTraversal.size();
+            for (unsigned int i = previous; i < record->mEnd; ++i)
+            {
+                ViewDataTraversalRecord& copy = mTraversal.emplace_back(mPreviousTraversal[i]);
+                copy.mEnd = copy.mEnd - previous + offset;
+                if (copy.mUse)
+                    add(copy.mNode);
+            }
+            mNumReusedNodes += record->mEnd - previous;
+            previous = record->mEnd;
+            return record->mValidityDistance - moved;
+        }
+    }
+
+    ++mNumEvaluatedNodes;
+    const float dist = node->distance(mViewPoint);
+    const unsigned int index = mTraversal.size();
+    mTraversal.push_back({node, mViewPoint, lodCallback->getValidityDistance(node, dist), 0, false});
+    if (record)
+        ++previous;
+
+    float validityDistance = mTraversal[index].mValidityDistance;
+    LodCallback::ReturnValue lodResult = lodCallback->isSufficientDetail(node, dist);
+    if (lodResult == LodCallback::Deeper && node->getNumChildren())
+    {
+        for (unsigned int i=0; i<node->getNumChildren(); ++i)
+            validityDistance = std::min(validityDistance, traverseNode(node->getChild(i), lodCallback, previous));
+    }
+    else if (lodResult != LodCallback::StopTraversal)
+    {
+        mTraversal[index].mUse = true;
+        add(node);
+    }
+
+    if (record)
+        previous = record->mEnd;
+
+    mTraversal[index].mValidityDistance = validityDistance;
+    mTraversal[index].mEnd = mTraversal.size();
+    return validityDistance;
+}
+
 void ViewData::setViewPoint(const osg::Vec3f &viewPoint)
 {
     mViewPoint = viewPoint;
@@ -68,6 +144,7 @@ void ViewData::clear()
     mLastUsageTimeStamp = 0;
     mChanged = false;
     mHasViewPoint = false;
+    mTraversal.clear();
 }
 
 bool ViewData::suitableToUse(const osg::Vec4i &activeGrid) const
@@ -105,52 +182,64 @@ bool ViewDataEntry::set(QuadTreeNode *node)
 ViewData *ViewDataMap::getViewData(osg::Object *viewer, const osg::Vec3f& viewPoint, const osg::Vec4i &activeGrid, bool& needsUpdate)
 {
     ViewerMap::const_iterator found = mViewers.find(viewer);
-    ViewData* vd = nullptr;
-    if (found == mViewers.end())
-    {
-        vd = createOrReuseView();
-        mViewers[viewer] = vd;
-    }
-    else
-        vd = found->second;
+    ViewData* vd = found != mViewers.end() ? found->second : nullptr;
     needsUpdate = false;
 
-    if (!(vd->suitableToUse(activeGrid) && (vd->getViewPoint()-viewPoint).length2() < mReuseDistance*mReuseDistance && vd->getWorldUpdateRevision() >= mWorldUpdateRevision))
+    if (vd && vd->suitableToUse(activeGrid) && (vd->getViewPoint()-viewPoint).length2() < mReuseDistance*mReuseDistance && vd->getWorldUpdateRevision() >= mWorldUpdateRevision)
+        return vd;
+
+    float shortestDist = viewer ? mReuseDistance*mReuseDistance : std::numeric_limits<float>::max();
+    ViewData* mostSuitableView = nullptr;
+    for (ViewData* other : mUsedViews)
     {
-        float shortestDist = viewer ? mReuseDistance*mReuseDistance : std::numeric_limits<float>::max();
-        const ViewData* mostSuitableView = nullptr;
-        for (const ViewData* other : mUsedViews)
+        if (other->suitableToUse(activeGrid) && other->getWorldUpdateRevision() >= mWorldUpdateRevision)
         {
-            if (other->suitableToUse(activeGrid) && other->getWorldUpdateRevision() >= mWorldUpdateRevision)
+            float dist = (viewPoint-other->getViewPoint()).length2();
+            if (dist < shortestDist)
             {
-                float dist = (viewPoint-other->getViewPoint()).length2();
-                if (dist < shortestDist)
-                {
-                    shortestDist = dist;
-                    mostSuitableView = other;
-                }
+                shortestDist = dist;
+                mostSuitableView = other;
             }
         }
-        if (mostSuitableView && mostSuitableView != vd)
-        {
-            vd->copyFrom(*mostSuitableView);
-            return vd;
-        }
-        else if (!mostSuitableView)
-        {
-            if (vd->getWorldUpdateRevision() != mWorldUpdateRevision)
-            {
-                vd->setWorldUpdateRevision(mWorldUpdateRevision);
-                vd->clear();
-            }
-            vd->setViewPoint(viewPoint);
-            vd->setActiveGrid(activeGrid);
-            needsUpdate = true;
-        }
     }
+    if (mostSuitableView)
+    {
+        // The LOD selection only depends on the view point, so the shadow and water reflection cameras
+        // share the selection of the main camera rather than copying it.
+        mViewers[viewer] = mostSuitableView;
+        return mostSuitableView;
+    }
+
+    if (!vd)
+    {
+        vd = createOrReuseView();
+        mViewers[viewer] = vd;
+    }
+    else if (isShared(vd))
+    {
+        // Do not move the selection other viewers are using, but keep its traversal for the incremental update
+        ViewData* ownView = createOrReuseView();
+        ownView->copyFrom(*vd);
+        vd = ownView;
+        mViewers[viewer] = vd;
+    }
+
+    if (vd->getWorldUpdateRevision() != mWorldUpdateRevision)
+    {
+        vd->setWorldUpdateRevision(mWorldUpdateRevision);
+        vd->clear();
+    }
+    vd->setViewPoint(viewPoint);
+    vd->setActiveGrid(activeGrid);
+    needsUpdate = true;
     return vd;
 }
 
+bool ViewDataMap::isShared(const ViewData* vd) const
+{
+    return std::count_if(mViewers.begin(), mViewers.end(), [vd] (const auto& pair) { return pair.second == vd; }) > 1;
+}
+
 ViewData *ViewDataMap::createOrReuseView()
 {
     ViewData* vd = nullptr;
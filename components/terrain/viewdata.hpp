@@ -12,6 +12,7 @@ namespace Terrain
 {
 
     class QuadTreeNode;
+    class LodCallback;
 
     struct ViewDataEntry
     {
@@ -25,6 +26,20 @@ namespace Terrain
         osg::ref_ptr<osg::Node> mRenderingNode;
     };
 
+    /// LOD decision made for a QuadTreeNode during the last traversal of a ViewData, stored in traversal order.
+    struct ViewDataTraversalRecord
+    {
+        QuadTreeNode* mNode;
+        /// The view point the decisions of this subtree are valid for.
+        osg::Vec3f mViewPoint;
+        /// How far the view point can move away from mViewPoint before any decision within this subtree may change.
+        float mValidityDistance;
+        /// Index of the first record after this subtree.
+        unsigned int mEnd;
+        /// The node was added to the view.
+        bool mUse;
+    };
+
     class ViewData : public View
     {
     public:
@@ -33,6 +48,13 @@ namespace Terrain
 
         void add(QuadTreeNode* node);
 
+        /// Rebuild the entries for the current view point by traversing the quad tree.
+        /// @note Subtrees whose LOD selection can not have changed since the last traversal are not evaluated again.
+        void traverse(QuadTreeNode* rootNode, LodCallback* lodCallback);
+
+        unsigned int getNumEvaluatedNodes() const { return mNumEvaluatedNodes; }
+        unsigned int getNumReusedNodes() const { return mNumReusedNodes; }
+
         void reset() override;
 
         bool suitableToUse(const osg::Vec4i& activeGrid) const;
@@ -60,21 +82,27 @@ namespace Terrain
         void setViewPoint(const osg::Vec3f& viewPoint);
         const osg::Vec3f& getViewPoint() const { return mViewPoint; }
 
-        void setActiveGrid(const osg::Vec4i &grid) { if (grid != mActiveGrid) {mActiveGrid = grid;mEntries.clear();mNumEntries=0;} }
+        void setActiveGrid(const osg::Vec4i &grid) { if (grid != mActiveGrid) {mActiveGrid = grid;mEntries.clear();mNumEntries=0;mTraversal.clear();} }
         const osg::Vec4i &getActiveGrid() const { return mActiveGrid;}
 
         unsigned int getWorldUpdateRevision() const { return mWorldUpdateRevision; }
         void setWorldUpdateRevision(int updateRevision) { mWorldUpdateRevision = updateRevision; }
 
     private:
+        float traverseNode(QuadTreeNode* node, LodCallback* lodCallback, unsigned int& previous);
+
         std::vector<ViewDataEntry> mEntries;
         unsigned int mNumEntries;
+        std::vector<ViewDataTraversalRecord> mTraversal;
+        std::vector<ViewDataTraversalRecord> mPreviousTraversal;
         double mLastUsageTimeStamp;
         bool mChanged;
         osg::Vec3f mViewPoint;
         bool mHasViewPoint;
         osg::Vec4i mActiveGrid;
         unsigned int mWorldUpdateRevision;
+        unsigned int mNumEvaluatedNodes;
+        unsigned int mNumReusedNodes;
     };
 
     class ViewDataMap : public osg::Referenced
@@ -98,6 +126,8 @@ namespace Terrain
         float getReuseDistance() const { return mReuseDistance; }
 
     private:
+        bool isShared(const ViewData* vd) const;
+
         std::list<ViewData> mViewVector;
 
         typedef std::map<osg::ref_ptr<osg::Object>, ViewData*> ViewerMap;
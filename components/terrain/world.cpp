@@ -10,6 +10,7 @@
 #include "texturemanager.hpp"
 #include "chunkmanager.hpp"
 #include "compositemaprenderer.hpp"
+#include "compositemapcache.hpp"
 #include "heightcull.hpp"
 
 namespace Terrain
@@ -119,6 +120,16 @@ void World::setTargetFrameRate(float rate)
     mCompositeMapRenderer->setTargetFrameRate(rate);
 }
 
+void World::enableCompositeMapCache(const std::filesystem::path& path)
+{
+    if (!mChunkManager)
+        return;
+
+    osg::ref_ptr<CompositeMapCache> cache = new CompositeMapCache(path);
+    mChunkManager->setCompositeMapCache(cache);
+    mCompositeMapRenderer->setCompositeMapCache(cache);
+}
+
 float World::getHeightAt(const osg::Vec3f &worldPos)
 {
     return mStorage->getHeightAt(worldPos);
@@ -5,6 +5,7 @@
 #include <osg/Referenced>
 #include <osg/Vec3f>
 
+#include <filesystem>
 #include <memory>
 #include <set>
 
@@ -57,6 +58,9 @@ namespace Terrain
         /// See CompositeMapRenderer::setTargetFrameRate
         void setTargetFrameRate(float rate);
 
+        /// Load composite maps from and store them to the directory at \a path instead of rendering them every run.
+        void enableCompositeMapCache(const std::filesystem::path& path);
+
         /// Apply the scene manager's texture filtering settings to all cached textures.
         /// @note Thread safe.
         void updateTextureFiltering();
@@ -41,4 +41,16 @@
 -- @function [parent=#debug] setNavMeshRenderMode
 -- @param #NAV_MESH_RENDER_MODE value
 
+---
+-- Resource usage of a script, collected if the setting "[Lua] lua profiler" is enabled
+-- @type ScriptStats
+-- @field #string path Path to the script in the virtual file system
+-- @field #number memoryUsage Memory in bytes held by the script, allocations up to "[Lua] small alloc max size" are not counted
+-- @field #number instructionCount Average number of Lua instructions executed by the script per frame (approximate)
+
+---
+-- Returns resource usage of all scripts that use any, aggregated over all objects the script is attached to
+-- @function [parent=#debug] getScriptStats
+-- @return #list<#ScriptStats>
+
 return nil
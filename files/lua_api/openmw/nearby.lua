@@ -26,6 +26,28 @@
 -- Everything that can be picked up in the nearby.
 -- @field [parent=#nearby] openmw.core#ObjectList items
 
+---
+-- Positions of all objects in the list, in one call. Faster than reading `object.position` in a loop.
+-- The coordinates are returned as plain numbers, so no vector is created per object.
+-- @function [parent=#nearby] getPositions
+-- @param openmw.core#ObjectList list
+-- @return #list<#number> Flat list of coordinates: x, y and z of the object with index `i` are at `3*i-2`, `3*i-1` and `3*i`.
+-- @usage local positions = nearby.getPositions(nearby.actors)
+-- for i, actor in ipairs(nearby.actors) do
+--     print(actor, util.vector3(positions[3*i-2], positions[3*i-1], positions[3*i]))
+-- end
+
+---
+-- Select the objects from a list that match the given criteria. The order of objects is preserved.
+-- @function [parent=#nearby] selectObjects
+-- @param openmw.core#ObjectList list
+-- @param #table options A table with optional criteria:  
+-- `type` - the type of objects to select (e.g. `types.NPC`);  
+-- `position` - the point `maxDistance` is measured from;  
+-- `maxDistance` - select only the objects that are not farther than this from `position`.
+-- @return openmw.core#ObjectList
+-- @usage local npcs = nearby.selectObjects(nearby.actors, {type = types.NPC, position = self.position, maxDistance = 1000})
+
 ---
 -- @type COLLISION_TYPE
 -- @field [parent=#COLLISION_TYPE] #number World
@@ -71,6 +93,55 @@
 --     radius = 10,
 -- })
 
+---
+-- Cast several rays in one call. Each ray is handled the same way as in `castRay`.
+-- @function [parent=#nearby] castRays
+-- @param from Start point of all rays (openmw.util#Vector3) or a list of start points, one per ray.
+-- @param #list<openmw.util#Vector3> to End points of the rays, or a flat list of their coordinates as returned by `getPositions`.
+-- @param #table options An optional table with the same options as in `castRay`, applied to all rays.
+-- @return #list<#RayCastingResult> Result of each ray, in the same order as in `to`.
+-- @usage local results = nearby.castRays(self.position, nearby.getPositions(nearby.actors), {ignore=self})
+
+---
+-- Options of the spatial queries (`getObjectsInRadius`, `getObjectsInBox`, `getObjectsInCone`).
+-- The queries use the bounds of collision shapes to find candidates, so objects without collisions are never found.
+-- An object is included in the result if its position is within the area.
+-- @type ObjectQueryOptions
+-- @field #table type Select only objects of this type (see @{openmw.types#types}), optional.
+-- @field #number collisionType Object types to search among (see @{openmw.nearby#COLLISION_TYPE}),
+-- World+Door+Actor by default.
+-- @field #number limit Return at most this number of objects, the nearest ones; optional.
+
+---
+-- Find objects within a sphere. The result is sorted by distance from the center, so with `limit`
+-- it gives the nearest objects.
+-- @function [parent=#nearby] getObjectsInRadius
+-- @param openmw.util#Vector3 center
+-- @param #number radius
+-- @param #ObjectQueryOptions options (optional)
+-- @return openmw.core#ObjectList
+-- @usage local nearestNpcs = nearby.getObjectsInRadius(self.position, 2000, {type = types.NPC, limit = 3})
+
+---
+-- Find objects within an axis-aligned box. The result is sorted by distance from the center of the box.
+-- @function [parent=#nearby] getObjectsInBox
+-- @param openmw.util#Vector3 min The corner with the lowest coordinates.
+-- @param openmw.util#Vector3 max The corner with the highest coordinates.
+-- @param #ObjectQueryOptions options (optional)
+-- @return openmw.core#ObjectList
+
+---
+-- Find objects within a cone. The result is sorted by distance from the origin.
+-- @function [parent=#nearby] getObjectsInCone
+-- @param openmw.util#Vector3 origin The apex of the cone.
+-- @param openmw.util#Vector3 direction The axis of the cone.
+-- @param #number angle The angle between the axis and the side of the cone, in radians.
+-- @param #number maxDistance The length of the cone.
+-- @param #ObjectQueryOptions options (optional)
+-- @return openmw.core#ObjectList
+-- @usage local visibleActors = nearby.getObjectsInCone(self.position, viewDirection, math.rad(45), 3000,
+--     {collisionType = nearby.COLLISION_TYPE.Actor})
+
 ---
 -- Cast ray from one point to another and find the first visual intersection with anything in the scene.
 -- As opposite to `castRay` can find an intersection with an object without collisions.
@@ -66,15 +66,35 @@ varying vec3 passNormal;
 #include "lighting.glsl"
 #include "depth.glsl"
 
+#if @instancing
+// xyz: position relative to the chunk, w: uniform scale
+attribute vec4 aInstanceOffset;
+// rotation quaternion
+attribute vec4 aInstanceRotation;
+
+vec3 rotateByQuat(in vec4 q, in vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+#endif
+
 void main(void)
 {
-    gl_Position = mw_modelToClip(gl_Vertex);
+#if @instancing
+    vec4 vertex = vec4(rotateByQuat(aInstanceRotation, gl_Vertex.xyz) * aInstanceOffset.w + aInstanceOffset.xyz, 1.0);
+    vec3 normal = rotateByQuat(aInstanceRotation, gl_Normal);
+#else
+    vec4 vertex = gl_Vertex;
+    vec3 normal = gl_Normal;
+#endif
 
-    vec4 viewPos = mw_modelToView(gl_Vertex);
+    gl_Position = mw_modelToClip(vertex);
+
+    vec4 viewPos = mw_modelToView(vertex);
     gl_ClipVertex = viewPos;
 
 #if (@envMap || !PER_PIXEL_LIGHTING || @shadows_enabled)
-    vec3 viewNormal = normalize((gl_NormalMatrix * gl_Normal).xyz);
+    vec3 viewNormal = normalize((gl_NormalMatrix * normal).xyz);
 #endif
 
 #if @envMap
@@ -106,8 +126,12 @@ void main(void)
 
 #if @normalMap
     normalMapUV = (gl_TextureMatrix[@normalMapUV] * gl_MultiTexCoord@normalMapUV).xy;
+#if @instancing
+    passTangent = vec4(rotateByQuat(aInstanceRotation, gl_MultiTexCoord7.xyz), gl_MultiTexCoord7.w);
+#else
     passTangent = gl_MultiTexCoord7.xyzw;
 #endif
+#endif
 
 #if @bumpMap
     bumpMapUV = (gl_TextureMatrix[@bumpMapUV] * gl_MultiTexCoord@bumpMapUV).xy;
@@ -123,7 +147,7 @@ void main(void)
 
     passColor = gl_Color;
     passViewPos = viewPos.xyz;
-    passNormal = gl_Normal.xyz;
+    passNormal = normal;
 
 #if !PER_PIXEL_LIGHTING
     vec3 diffuseLight, ambientLight;